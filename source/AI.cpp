@@ -16,6 +16,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Command.h"
 #include "DistanceMap.h"
 #include "Flotsam.h"
+#include "GameData.h"
 #include "Government.h"
 #include "Hardpoint.h"
 #include "Mask.h"
@@ -25,7 +26,9 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Planet.h"
 #include "PlayerInfo.h"
 #include "Point.h"
+#include "Politics.h"
 #include "Preferences.h"
+#include "Profiler.h"
 #include "Random.h"
 #include "Ship.h"
 #include "ShipEvent.h"
@@ -301,7 +304,7 @@ namespace {
 
 
 
-AI::AI(const List<Ship> &ships, const List<Minable> &minables, const List<Flotsam> &flotsam)
+AI::AI(const List<Ship> &ships, const List<Minable> &minables, const Pool<shared_ptr<Flotsam>> &flotsam)
 	: ships(ships), minables(minables), flotsam(flotsam)
 {
 }
@@ -496,6 +499,7 @@ void AI::ClearOrders()
 
 void AI::Step(const PlayerInfo &player, Command &activeCommands)
 {
+	PROFILE_SCOPE("AI::Step");
 	// First, figure out the comparative strengths of the present governments.
 	const System *playerSystem = player.GetSystem();
 	map<const Government *, int64_t> strength;
@@ -1090,6 +1094,7 @@ bool AI::HasHelper(const Ship &ship, const bool needsFuel)
 // Pick a new target for the given ship.
 shared_ptr<Ship> AI::FindTarget(const Ship &ship) const
 {
+	PROFILE_SCOPE("AI::FindTarget");
 	// If this ship has no government, it has no enemies.
 	shared_ptr<Ship> target;
 	const Government *gov = ship.GetGovernment();
@@ -1288,17 +1293,21 @@ vector<shared_ptr<Ship>> AI::GetShipsList(const Ship &ship, bool targetEnemies,
 	const auto it = rosters.find(ship.GetGovernment());
 	if(it != rosters.end() && !it->second.empty())
 	{
-		targets.reserve(it->second.size());
+		size_t count = 0;
+		for(const auto *roster : it->second)
+			count += roster->size();
+		targets.reserve(count);
 		
 		const System *here = ship.GetSystem();
 		const Point &p = ship.Position();
-		for(const auto &target : it->second)
-			if(target->IsTargetable() && target->GetSystem() == here
-					&& !(target->IsHyperspacing() && target->Velocity().Length() > 10.)
-					&& p.Distance(target->Position()) < maxRange
-					&& (ship.IsYours() || !target->GetPersonality().IsMarked())
-					&& (target->IsYours() || !ship.GetPersonality().IsMarked()))
-				targets.emplace_back(target);
+		for(const auto *roster : it->second)
+			for(const auto &target : *roster)
+				if(target->IsTargetable() && target->GetSystem() == here
+						&& !(target->IsHyperspacing() && target->Velocity().Length() > 10.)
+						&& p.Distance(target->Position()) < maxRange
+						&& (ship.IsYours() || !target->GetPersonality().IsMarked())
+						&& (target->IsYours() || !ship.GetPersonality().IsMarked()))
+					targets.emplace_back(target);
 	}
 	
 	return targets;
@@ -1368,6 +1377,7 @@ bool AI::FollowOrders(Ship &ship, Command &command) const
 
 void AI::MoveIndependent(Ship &ship, Command &command) const
 {
+	PROFILE_SCOPE("AI::MoveIndependent");
 	shared_ptr<const Ship> target = ship.GetTargetShip();
 	// NPCs should not be beyond the "fence" unless their target is
 	// fairly close to it (or they are intended to be there).
@@ -1549,6 +1559,7 @@ void AI::MoveIndependent(Ship &ship, Command &command) const
 
 void AI::MoveEscort(Ship &ship, Command &command) const
 {
+	PROFILE_SCOPE("AI::MoveEscort");
 	const Ship &parent = *ship.GetParent();
 	bool hasFuelCapacity = ship.Attributes().Get("fuel capacity") && ship.JumpFuel();
 	bool isStaying = ship.GetPersonality().IsStaying() || !hasFuelCapacity;
@@ -2709,6 +2720,7 @@ Point AI::TargetAim(const Ship &ship, const Body &target)
 // Aim the given ship's turrets.
 void AI::AimTurrets(const Ship &ship, Command &command, bool opportunistic) const
 {
+	PROFILE_SCOPE("AI::AimTurrets");
 	// First, get the set of potential hostile ships.
 	auto targets = vector<const Body *>();
 	const Ship *currentTarget = ship.GetTargetShip().get();
@@ -2847,6 +2859,7 @@ void AI::AimTurrets(const Ship &ship, Command &command, bool opportunistic) cons
 // Fire whichever of the given ship's weapons can hit a hostile target.
 void AI::AutoFire(const Ship &ship, Command &command, bool secondary) const
 {
+	PROFILE_SCOPE("AI::AutoFire");
 	const Personality &person = ship.GetPersonality();
 	if(person.IsPacifist() || ship.CannotAct())
 		return;
@@ -3112,6 +3125,7 @@ double AI::RendezvousTime(const Point &p, const Point &v, double vp)
 
 void AI::MovePlayer(Ship &ship, const PlayerInfo &player, Command &activeCommands)
 {
+	PROFILE_SCOPE("AI::MovePlayer");
 	Command command;
 	bool shift = activeCommands.Has(Command::SHIFT);
 	
@@ -3669,6 +3683,7 @@ bool AI::Has(const Ship &ship, const Government *government, int type) const
 
 void AI::UpdateStrengths(map<const Government *, int64_t> &strength, const System *playerSystem)
 {
+	PROFILE_SCOPE("AI::UpdateStrengths");
 	// Tally the strength of a government by the cost of its present and able ships.
 	governmentRosters.clear();
 	for(const auto &it : ships)
@@ -3731,20 +3746,18 @@ void AI::UpdateStrengths(map<const Government *, int64_t> &strength, const Syste
 // Cache various lists of all targetable ships in the player's system for this Step.
 void AI::CacheShipLists()
 {
+	PROFILE_SCOPE("AI::CacheShipLists");
 	allyLists.clear();
 	enemyLists.clear();
+	// Politics caches which governments are hostile, so this only needs to
+	// sort each government's roster into the right list, without copying it.
+	const Politics &politics = GameData::GetPolitics();
 	for(const auto &git : governmentRosters)
 	{
-		allyLists.emplace(git.first, vector<shared_ptr<Ship>>());
-		allyLists.at(git.first).reserve(ships.size());
-		enemyLists.emplace(git.first, vector<shared_ptr<Ship>>());
-		enemyLists.at(git.first).reserve(ships.size());
+		RosterList &allies = allyLists[git.first];
+		RosterList &enemies = enemyLists[git.first];
 		for(const auto &oit : governmentRosters)
-		{
-			auto &list = git.first->IsEnemy(oit.first)
-					? enemyLists[git.first] : allyLists[git.first];
-			list.insert(list.end(), oit.second.begin(), oit.second.end());
-		}
+			(politics.IsEnemy(git.first, oit.first) ? enemies : allies).push_back(&oit.second);
 	}
 }
 
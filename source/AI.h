@@ -15,6 +15,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "Command.h"
 #include "Point.h"
+#include "Pool.h"
 
 #include <cstdint>
 #include <list>
@@ -48,7 +49,7 @@ public:
 template <class Type>
 	using List = std::list<std::shared_ptr<Type>>;
 	// Constructor, giving the AI access to various object lists.
-	AI(const List<Ship> &ships, const List<Minable> &minables, const List<Flotsam> &flotsam);
+	AI(const List<Ship> &ships, const List<Minable> &minables, const Pool<std::shared_ptr<Flotsam>> &flotsam);
 	
 	// Fleet commands from the player.
 	void IssueShipTarget(const PlayerInfo &player, const std::shared_ptr<Ship> &target);
@@ -180,7 +181,7 @@ private:
 	// Data from the game engine.
 	const List<Ship> &ships;
 	const List<Minable> &minables;
-	const List<Flotsam> &flotsam;
+	const Pool<std::shared_ptr<Flotsam>> &flotsam;
 	
 	// The current step count for the AI, ranging from 0 to 30. Its value
 	// helps limit how often certain actions occur (such as changing targets).
@@ -221,8 +222,11 @@ private:
 	std::map<const Government *, int64_t> enemyStrength;
 	std::map<const Government *, int64_t> allyStrength;
 	std::map<const Government *, std::vector<std::shared_ptr<Ship>>> governmentRosters;
-	std::map<const Government *, std::vector<std::shared_ptr<Ship>>> enemyLists;
-	std::map<const Government *, std::vector<std::shared_ptr<Ship>>> allyLists;
+	// For each government, the rosters of the governments that are its enemies
+	// or allies. These point into governmentRosters rather than copying it.
+	typedef std::vector<const std::vector<std::shared_ptr<Ship>> *> RosterList;
+	std::map<const Government *, RosterList> enemyLists;
+	std::map<const Government *, RosterList> allyLists;
 };
 
 
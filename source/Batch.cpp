@@ -0,0 +1,253 @@
+/* Batch.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "Batch.h"
+
+#include "DataFile.h"
+#include "Editor.h"
+#include "Files.h"
+#include "GameData.h"
+#include "imgui.h"
+#include "PlayerInfo.h"
+#include "UI.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#ifndef ES_NO_THREADS
+#include <thread>
+#endif // ES_NO_THREADS
+
+using namespace std;
+
+namespace {
+	// Quote the given argument so that the shell passes it on unchanged.
+	string Quote(const string &argument)
+	{
+#ifdef _WIN32
+		string quoted = "\"";
+		for(char c : argument)
+		{
+			if(c == '"')
+				quoted += '\\';
+			quoted += c;
+		}
+		return quoted + '"';
+#else
+		string quoted = "'";
+		for(char c : argument)
+		{
+			if(c == '\'')
+				quoted += "'\\''";
+			else
+				quoted += c;
+		}
+		return quoted + '\'';
+#endif
+	}
+	
+	double SecondsSince(chrono::steady_clock::time_point start)
+	{
+		return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	}
+}
+
+
+
+// Load the script from the given file, or from the given data.
+bool Batch::Load(const string &path)
+{
+	if(!Files::Exists(path))
+	{
+		Files::LogError("Batch script \"" + path + "\" not found.");
+		return false;
+	}
+	this->path = path;
+	return Load(DataFile(path));
+}
+
+
+
+bool Batch::Load(const DataFile &file)
+{
+	plugins.clear();
+	edits.clear();
+	for(const DataNode &node : file)
+	{
+		const string &key = node.Token(0);
+		if(key == "plugin" && node.Size() >= 2)
+			plugins.push_back(node.Token(1));
+		else if(key == "edit")
+			for(const DataNode &child : node)
+			{
+				if(child.Size() >= 2)
+					edits.push_back(child);
+				else
+					child.PrintTrace("Skipping edit without a name:");
+			}
+		else if(key == "rename" && node.Size() >= 4)
+			edits.push_back(node);
+		else
+			node.PrintTrace("Skipping unrecognized batch node:");
+	}
+	if(plugins.empty())
+	{
+		Files::LogError("Batch script \"" + path + "\" does not name any plugins.");
+		return false;
+	}
+	return true;
+}
+
+
+
+const vector<string> &Batch::Plugins() const
+{
+	return plugins;
+}
+
+
+
+// The plugins that the given worker out of the given number processes.
+vector<string> Batch::Share(int worker, int workers) const
+{
+	vector<string> share;
+	for(size_t i = worker; i < plugins.size(); i += max(workers, 1))
+		share.push_back(plugins[i]);
+	return share;
+}
+
+
+
+// Start the given number of worker processes, with the same arguments as this
+// one, and wait for all of them to finish.
+bool Batch::Spawn(const char * const *argv, int jobs) const
+{
+	const auto start = chrono::steady_clock::now();
+	// By default, there is one worker for every processor.
+	if(jobs <= 0)
+#ifndef ES_NO_THREADS
+		jobs = min(thread::hardware_concurrency(), 8u);
+#else
+		jobs = 1;
+#endif // ES_NO_THREADS
+	jobs = max(1, min<int>(jobs, plugins.size()));
+	string command;
+	for(const char * const *it = argv; *it; ++it)
+		command += Quote(*it) + " ";
+	
+	atomic<int> failed(0);
+	auto Work = [&](int worker) -> void
+	{
+		string workerCommand = command + "--batch-worker " + to_string(worker) + " --jobs " + to_string(jobs);
+#ifdef _WIN32
+		// The command interpreter removes the first and last quote of a command.
+		workerCommand = "\"" + workerCommand + "\"";
+#endif
+		if(system(workerCommand.c_str()))
+			++failed;
+	};
+
+#ifndef ES_NO_THREADS
+	vector<thread> threads;
+	for(int i = 1; i < jobs; ++i)
+		threads.emplace_back(Work, i);
+	Work(0);
+	for(thread &it : threads)
+		it.join();
+#else
+	for(int i = 0; i < jobs; ++i)
+		Work(i);
+#endif // ES_NO_THREADS
+
+	const double seconds = SecondsSince(start);
+	cout << "Processed " << plugins.size() << " plugins with " << jobs << " workers in "
+		<< fixed << setprecision(2) << seconds << " s (" << plugins.size() / seconds << " plugins per second)." << endl;
+	if(failed)
+		cout << failed << " of the workers failed." << endl;
+	return !failed;
+}
+
+
+
+// Process the plugins of the given worker, in this process.
+bool Batch::Run(int worker, int workers) const
+{
+	const auto start = chrono::steady_clock::now();
+	const vector<string> share = Share(worker, workers);
+	int failed = 0;
+	
+	// The editor sets up the style of its windows, so it needs an ImGui context
+	// even though nothing is ever drawn.
+	ImGui::CreateContext();
+	{
+		PlayerInfo player;
+		UI menu;
+		UI ui;
+		Editor editor(player, menu, ui);
+		for(const string &plugin : share)
+			if(!Process(editor, plugin))
+				++failed;
+	}
+	ImGui::DestroyContext();
+	
+	if(workers == 1)
+	{
+		const double seconds = SecondsSince(start);
+		cout << "Processed " << share.size() << " plugins in " << fixed << setprecision(2) << seconds << " s ("
+			<< share.size() / seconds << " plugins per second)." << endl;
+	}
+	return !failed;
+}
+
+
+
+// Apply every edit to the given plugin, and save it.
+bool Batch::Process(Editor &editor, const string &plugin) const
+{
+	const auto start = chrono::steady_clock::now();
+	// The changes that the editor can recover are the user's, so they are
+	// neither applied nor replaced by the script's.
+	if(!editor.OpenPlugin(plugin, false))
+	{
+		Files::LogError("Plugin \"" + plugin + "\" not found.");
+		return false;
+	}
+	
+	int applied = 0;
+	bool hasSystems = false;
+	for(const DataNode &node : edits)
+	{
+		// Only the objects that a plugin defines are renamed in it.
+		if(node.Token(0) == "rename")
+			applied += editor.Rename(node.Token(1), node.Token(2), node.Token(3));
+		else if(editor.Apply(node))
+		{
+			++applied;
+			hasSystems |= node.Token(0) == "system";
+		}
+		else
+			node.PrintTrace("Skipping edit of an object that the editor can't save:");
+	}
+	// The neighbors of the systems are updated once every edit has been made.
+	if(hasSystems)
+		GameData::UpdateSystems();
+	
+	editor.SaveAll();
+	editor.WriteAll();
+	cout << "\"" << plugin << "\": " << applied << " of " << edits.size() << " edits in "
+		<< fixed << setprecision(2) << 1000. * SecondsSince(start) << " ms." << endl;
+	return true;
+}
@@ -0,0 +1,72 @@
+/* Batch.h
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef BATCH_H_
+#define BATCH_H_
+
+#include "DataNode.h"
+
+#include <string>
+#include <vector>
+
+class DataFile;
+class Editor;
+
+
+
+// Class representing a script of edits that is applied to a list of plugins
+// without a window ("--batch"). A script is a data file like this:
+//   plugin "My Plugin"
+//   edit
+//   	outfit "Laser"
+//   		cost 5000
+//   rename outfit "Laser" "Blaster"
+// Each plugin is opened in the editor, every edit is made to it in order, and
+// it is saved through the editors, which writes all of its objects the same
+// way the editor does. Any unsaved changes that the editor logged for crash
+// recovery are the user's, so they are left alone. Since the game data can
+// only hold one set of plugins, plugins are processed in parallel by separate
+// worker processes.
+class Batch {
+public:
+	// Load the script from the given file, or from the given data.
+	bool Load(const std::string &path);
+	bool Load(const DataFile &file);
+	
+	const std::vector<std::string> &Plugins() const;
+	// The plugins that the given worker out of the given number processes.
+	std::vector<std::string> Share(int worker, int workers) const;
+	
+	// Start the given number of worker processes, with the same arguments as
+	// this one, and wait for all of them to finish. If the number isn't given,
+	// there is one for each processor. Returns false if any of them failed.
+	bool Spawn(const char * const *argv, int jobs) const;
+	// Process the plugins of the given worker, in this process. The game data
+	// must already be loaded. Returns false if any of them failed.
+	bool Run(int worker = 0, int workers = 1) const;
+	
+	
+private:
+	// Apply every edit to the given plugin, and save it.
+	bool Process(Editor &editor, const std::string &plugin) const;
+	
+	
+private:
+	std::string path;
+	std::vector<std::string> plugins;
+	// The definitions to load and the objects to rename, in order.
+	std::vector<DataNode> edits;
+};
+
+
+
+#endif
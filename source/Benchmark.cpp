@@ -0,0 +1,146 @@
+/* Benchmark.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "Benchmark.h"
+
+#include "DataNode.h"
+#include "Engine.h"
+#include "Files.h"
+#include "Fleet.h"
+#include "GameData.h"
+#include "PlayerInfo.h"
+#include "Random.h"
+#include "Ship.h"
+#include "System.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <list>
+#include <memory>
+
+using namespace std;
+
+
+
+void Benchmark::Load(const DataNode &node)
+{
+	if(node.Size() < 2)
+	{
+		node.PrintTrace("Skipping unnamed benchmark:");
+		return;
+	}
+	name = node.Token(1);
+	
+	for(const DataNode &child : node)
+	{
+		const string &key = child.Token(0);
+		bool hasValue = child.Size() >= 2;
+		if(key == "system" && hasValue)
+			system = GameData::Systems().Get(child.Token(1));
+		else if(key == "fleet" && hasValue)
+		{
+			int count = (child.Size() >= 3 ? child.Value(2) : 1);
+			for(const DataNode &grand : child)
+				if(grand.Token(0) == "count" && grand.Size() >= 2)
+					count = grand.Value(1);
+				else
+					grand.PrintTrace("Skipping unrecognized attribute:");
+			fleets.emplace_back(GameData::Fleets().Get(child.Token(1)), max(1, count));
+		}
+		else if(key == "steps" && hasValue)
+			steps = max(1, static_cast<int>(child.Value(1)));
+		else if(key == "seed" && hasValue)
+			seed = static_cast<uint64_t>(child.Value(1));
+		else
+			child.PrintTrace("Skipping unrecognized attribute:");
+	}
+}
+
+
+
+const string &Benchmark::Name() const
+{
+	return name;
+}
+
+
+
+// Run the benchmark for the given number of steps, or for the number of steps
+// it defines if that is zero, and print the timing results. Returns false if
+// the benchmark could not be run.
+bool Benchmark::Run(int steps) const
+{
+	if(!system || !system->IsValid())
+	{
+		Files::LogError("Benchmark \"" + name + "\" does not have a valid system.");
+		return false;
+	}
+	for(const auto &it : fleets)
+		if(!it.first->IsValid())
+		{
+			Files::LogError("Benchmark \"" + name + "\" uses an invalid fleet \"" + it.first->Name() + "\".");
+			return false;
+		}
+	if(steps <= 0)
+		steps = this->steps;
+	
+	// The player has no ships, so it is only an observer of the simulation.
+	PlayerInfo player;
+	player.SetSystem(*system);
+	// Seed the random generator after creating the player, which seeds it with
+	// the current time, so that every run simulates exactly the same thing.
+	Random::Seed(seed);
+	
+	Engine engine(player);
+	size_t shipCount = 0;
+	for(const auto &it : fleets)
+		for(int i = 0; i < it.second; ++i)
+		{
+			list<shared_ptr<Ship>> placed;
+			it.first->Place(*system, placed);
+			for(const shared_ptr<Ship> &ship : placed)
+				engine.Place(ship);
+			shipCount += placed.size();
+		}
+	
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	// Count how often the object pools grow once the simulation is warmed up.
+	size_t warmAllocations = 0;
+	for(int i = 0; i < steps; ++i)
+	{
+		if(i == steps / 2)
+			warmAllocations = engine.Allocations();
+		engine.StepHeadless();
+	}
+	warmAllocations = engine.Allocations() - warmAllocations;
+	double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	
+	cout << "Benchmark \"" << name << "\": " << shipCount << " ships in " << system->Name()
+		<< ", " << steps << " steps." << endl;
+	char line[128];
+	snprintf(line, sizeof(line), "%-20s %10.3f s %10.1f steps/s", "total", elapsed,
+		elapsed > 0. ? steps / elapsed : 0.);
+	cout << line << endl;
+	for(int i = 0; i < Engine::PHASE_COUNT; ++i)
+	{
+		Engine::Phase phase = static_cast<Engine::Phase>(i);
+		double time = engine.PhaseTime(phase);
+		snprintf(line, sizeof(line), "%-20s %10.3f s %9.1f%%  %8.3f ms/step", Engine::PhaseName(phase),
+			time, elapsed > 0. ? 100. * time / elapsed : 0., 1000. * time / steps);
+		cout << line << endl;
+	}
+	cout << "Pool allocations: " << engine.Allocations() << " (" << warmAllocations
+		<< " in the second half of the run)" << endl;
+	cout << "Final state checksum: " << hex << engine.Checksum() << dec << endl;
+	return true;
+}
@@ -0,0 +1,53 @@
+/* Benchmark.h
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+class DataNode;
+class Fleet;
+class System;
+
+
+
+// Class representing a simulation benchmark: a system and a set of fleets that
+// are placed in it, which is then run headless (without a window or any
+// drawing) for a number of steps to measure how fast the Engine simulates it.
+class Benchmark {
+public:
+	void Load(const DataNode &node);
+	
+	const std::string &Name() const;
+	
+	// Run the benchmark for the given number of steps, or for the number of
+	// steps it defines if that is zero, and print the timing results. Returns
+	// false if the benchmark could not be run.
+	bool Run(int steps = 0) const;
+	
+	
+private:
+	std::string name;
+	const System *system = nullptr;
+	// Each fleet, and how many copies of it to place.
+	std::vector<std::pair<const Fleet *, int>> fleets;
+	int steps = 3600;
+	uint64_t seed = 0;
+};
+
+
+
+#endif
@@ -0,0 +1,76 @@
+/* BinaryIO.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "BinaryIO.h"
+
+#include "text/Utf8.h"
+
+using namespace std;
+
+
+
+// Add the lowest given number of bytes of the value to the end of the string.
+void BinaryIO::Append(string &out, uint64_t value, int bytes)
+{
+	for(int i = 0; i < bytes; ++i)
+		out += static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+
+
+// Add a string, preceded by its length.
+void BinaryIO::AppendString(string &out, const string &value)
+{
+	Append(out, value.size(), 4);
+	out += value;
+}
+
+
+
+// Read a value of the given number of bytes, starting at the given position,
+// and move the position past it. Returns false if there are not enough bytes
+// left.
+bool BinaryIO::Extract(const string &in, size_t &pos, uint64_t &value, int bytes)
+{
+	if(in.size() - pos < static_cast<size_t>(bytes))
+		return false;
+	
+	value = 0;
+	for(int i = 0; i < bytes; ++i)
+		value |= static_cast<uint64_t>(static_cast<unsigned char>(in[pos++])) << (8 * i);
+	return true;
+}
+
+
+
+bool BinaryIO::ExtractString(const string &in, size_t &pos, string &value)
+{
+	uint64_t size = 0;
+	if(!Extract(in, pos, size, 4) || in.size() - pos < size)
+		return false;
+	
+	value.assign(in, pos, size);
+	pos += size;
+	return true;
+}
+
+
+
+// Open a file for writing binary data.
+FILE *BinaryIO::Open(const string &path)
+{
+#if defined _WIN32
+	return _wfopen(Utf8::ToUTF16(path).c_str(), L"wb");
+#else
+	return fopen(path.c_str(), "wb");
+#endif
+}
@@ -0,0 +1,46 @@
+/* BinaryIO.h
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef BINARY_IO_H_
+#define BINARY_IO_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+
+
+// Functions for the game's binary file formats (replays and the data cache).
+// All numbers are stored little-endian, regardless of the platform, so the
+// files can be moved between computers.
+class BinaryIO {
+public:
+	// Add the lowest given number of bytes of the value to the end of the string.
+	static void Append(std::string &out, uint64_t value, int bytes);
+	// Add a string, preceded by its length.
+	static void AppendString(std::string &out, const std::string &value);
+	
+	// Read a value of the given number of bytes, starting at the given
+	// position, and move the position past it. Returns false if there are
+	// not enough bytes left.
+	static bool Extract(const std::string &in, size_t &pos, uint64_t &value, int bytes);
+	static bool ExtractString(const std::string &in, size_t &pos, std::string &value);
+	
+	// Open a file for writing binary data. Files::Open() writes in text mode on
+	// Windows, which would mangle the data.
+	static FILE *Open(const std::string &path);
+};
+
+
+
+#endif
@@ -139,6 +139,7 @@ private:
 	friend class OutfitEditor;
 	friend class ShipEditor;
 	friend class SystemEditor;
+	friend class SystemGenerator;
 	friend class TemplateEditor<Effect>;
 	friend class TemplateEditor<Outfit>;
 	friend class TemplateEditor<Ship>;
@@ -151,6 +151,8 @@ private:
 	double turn = 0.;
 	// Turret turn rates, reduced to 8 bits to save space.
 	signed char aim[32] = {};
+	
+	friend class Replay;
 };
 
 
@@ -147,31 +147,21 @@ namespace {
 		return false;
 	}
 	
-	// Converts the given vector of condition tokens (like "reputation: Republic",
-	// "random", or "4") into the integral values they have at runtime.
-	vector<int64_t> SubstituteValues(const vector<string> &side, const map<string, int64_t> &conditions, const map<string, int64_t> &created)
+	// Most expressions have only a few tokens and operators, so their values
+	// can be computed without allocating any memory.
+	const size_t LOCAL_DATA_SIZE = 16;
+	
+	// Get the value of the named condition. Temporary conditions take precedence.
+	int64_t ConditionValue(const string &name, const map<string, int64_t> &conditions, const map<string, int64_t> &created)
 	{
-		auto result = vector<int64_t>();
-		result.reserve(side.size());
-		for(const string &str : side)
+		if(!created.empty())
 		{
-			int64_t value = 0;
-			if(str == "random")
-				value = Random::Int(100);
-			else if(DataNode::IsNumber(str))
-				value = static_cast<int64_t>(DataNode::Value(str));
-			else
-			{
-				const auto temp = created.find(str);
-				const auto perm = conditions.find(str);
-				if(temp != created.end())
-					value = temp->second;
-				else if(perm != conditions.end())
-					value = perm->second;
-			}
-			result.emplace_back(value);
+			const auto temp = created.find(name);
+			if(temp != created.end())
+				return temp->second;
 		}
-		return result;
+		const auto perm = conditions.find(name);
+		return (perm != conditions.end() ? perm->second : 0);
 	}
 	
 	bool UsedAll(const vector<bool> &status)
@@ -478,6 +468,7 @@ void ConditionSet::TestApply(const Conditions &conditions, Conditions &created)
 ConditionSet::Expression::Expression(const vector<string> &left, const string &op, const vector<string> &right)
 	: op(op), fun(Op(op)), left(left), right(right)
 {
+	name = this->left.ToString();
 }
 
 
@@ -486,6 +477,7 @@ ConditionSet::Expression::Expression(const vector<string> &left, const string &o
 ConditionSet::Expression::Expression(const string &left, const string &op, const string &right)
 	: op(op), fun(Op(op)), left(left), right(right)
 {
+	name = this->left.ToString();
 }
 
 
@@ -520,9 +512,9 @@ bool ConditionSet::Expression::IsEmpty() const
 
 // Returns everything to the left of the main assignment or comparison operator.
 // In an assignment expression, this should be only a single token.
-string ConditionSet::Expression::Name() const
+const string &ConditionSet::Expression::Name() const
 {
-	return left.ToString();
+	return name;
 }
 
 
@@ -548,7 +540,7 @@ bool ConditionSet::Expression::Test(const Conditions &conditions, const Conditio
 // Assign the computed value to the desired condition.
 void ConditionSet::Expression::Apply(Conditions &conditions, Conditions &created) const
 {
-	int64_t &c = conditions[Name()];
+	int64_t &c = conditions[name];
 	int64_t value = right.Evaluate(conditions, created);
 	c = fun(c, value);
 }
@@ -558,7 +550,7 @@ void ConditionSet::Expression::Apply(Conditions &conditions, Conditions &created
 // Assign the computed value to the desired temporary condition.
 void ConditionSet::Expression::TestApply(const Conditions &conditions, Conditions &created) const
 {
-	int64_t &c = created[Name()];
+	int64_t &c = created[name];
 	int64_t value = right.Evaluate(conditions, created);
 	c = fun(c, value);
 }
@@ -573,6 +565,7 @@ ConditionSet::Expression::SubExpression::SubExpression(const vector<string> &sid
 	
 	ParseSide(side);
 	GenerateSequence();
+	ResolveOperands();
 }
 
 
@@ -582,6 +575,7 @@ ConditionSet::Expression::SubExpression::SubExpression(const vector<string> &sid
 ConditionSet::Expression::SubExpression::SubExpression(const string &side)
 {
 	tokens.emplace_back(side.empty() ? "'" : side);
+	ResolveOperands();
 }
 
 
@@ -648,19 +642,40 @@ int64_t ConditionSet::Expression::SubExpression::Evaluate(const Conditions &cond
 	if(tokens.empty())
 		return 0;
 	
-	// For SubExpressions with no Operations (i.e. simple conditions), tokens will consist
-	// of only the condition or numeric value to be returned as-is after substitution.
-	auto data = SubstituteValues(tokens, conditions, created);
+	// The numeric value of each token is followed by the result of each Operation.
+	const size_t size = tokens.size() + sequence.size();
+	int64_t localData[LOCAL_DATA_SIZE];
+	vector<int64_t> heapData;
+	int64_t *data = localData;
+	if(size > LOCAL_DATA_SIZE)
+	{
+		heapData.resize(size);
+		data = heapData.data();
+	}
+	
+	// Substitute the runtime values of "random" and any conditions. For
+	// SubExpressions with no Operations (i.e. simple conditions), tokens will
+	// consist of only the condition or numeric value to be returned as-is.
+	for(size_t i = 0; i < tokens.size(); ++i)
+	{
+		const Operand &operand = operands[i];
+		if(operand.type == Operand::Type::NUMBER)
+			data[i] = operand.value;
+		else if(operand.type == Operand::Type::RANDOM)
+			data[i] = Random::Int(100);
+		else
+			data[i] = ConditionValue(tokens[i], conditions, created);
+	}
 	
-	if(!sequence.empty())
+	// Each Operation adds to the end of the data.
+	size_t end = tokens.size();
+	for(const Operation &op : sequence)
 	{
-		// Each Operation adds to the end of the data vector.
-		data.reserve(operatorCount + data.size());
-		for(const Operation &op : sequence)
-			data.emplace_back(op.fun(data[op.a], data[op.b]));
+		data[end] = op.fun(data[op.a], data[op.b]);
+		++end;
 	}
 	
-	return data.back();
+	return data[end - 1];
 }
 
 
@@ -815,6 +830,34 @@ bool ConditionSet::Expression::SubExpression::AddOperation(vector<int> &data, si
 
 
 
+// Determine what kind of value each token represents. This must be done
+// after parsing, since parsing may discard the tokens.
+void ConditionSet::Expression::SubExpression::ResolveOperands()
+{
+	operands.clear();
+	operands.reserve(tokens.size());
+	for(const string &token : tokens)
+		operands.emplace_back(token);
+}
+
+
+
+// Constructor for an Operand, which parses the given token once.
+ConditionSet::Expression::SubExpression::Operand::Operand(const string &token)
+{
+	if(token == "random")
+		type = Type::RANDOM;
+	else if(DataNode::IsNumber(token))
+	{
+		type = Type::NUMBER;
+		value = static_cast<int64_t>(DataNode::Value(token));
+	}
+	else
+		type = Type::CONDITION;
+}
+
+
+
 // Constructor for an Operation, indicating the binary function and the
 // indices of its operands within the evaluation-time data vector.
 ConditionSet::Expression::SubExpression::Operation::Operation(const string &op, size_t &a, size_t &b)
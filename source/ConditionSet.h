@@ -82,7 +82,7 @@ private:
 		bool IsEmpty() const;
 		
 		// Returns the left side of this Expression.
-		std::string Name() const;
+		const std::string &Name() const;
 		// True if this Expression performs a comparison and false if it performs an assignment.
 		bool IsTestable() const;
 		
@@ -117,9 +117,24 @@ private:
 			void ParseSide(const std::vector<std::string> &side);
 			void GenerateSequence();
 			bool AddOperation(std::vector<int> &data, size_t &index, const size_t &opIndex);
+			// Determine what kind of value each token represents.
+			void ResolveOperands();
 			
 			
 		private:
+			// An Operand records, for the token at the same index, whether it is a
+			// number, the "random" keyword, or the name of a condition, so that
+			// the token never needs to be parsed again during evaluation.
+			class Operand {
+			public:
+				explicit Operand(const std::string &token);
+				
+				enum class Type : int {NUMBER, RANDOM, CONDITION};
+				Type type;
+				// The value of a number token.
+				int64_t value = 0;
+			};
+			
 			// An Operation has a pointer to its binary function, and the data indices for
 			// its operands. The result is always placed on the back of the data vector.
 			class Operation {
@@ -137,6 +152,7 @@ private:
 			std::vector<Operation> sequence;
 			// The tokens vector converts into a data vector of numeric values during evaluation.
 			std::vector<std::string> tokens;
+			std::vector<Operand> operands;
 			std::vector<std::string> operators;
 			// The number of true (non-parentheses) operators.
 			int operatorCount = 0;
@@ -146,6 +162,8 @@ private:
 	private:
 		// String representation of the Expression's binary function.
 		std::string op;
+		// The left side as a single string, i.e. the condition an assignment modifies.
+		std::string name;
 		// Pointer to a binary function that defines the assignment or
 		// comparison operation to be performed between SubExpressions.
 		int64_t (*fun)(int64_t, int64_t);
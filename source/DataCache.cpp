@@ -0,0 +1,316 @@
+/* DataCache.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "DataCache.h"
+
+#include "BinaryIO.h"
+#include "DataFile.h"
+#include "DataNode.h"
+#include "Files.h"
+
+#include <cstdio>
+#include <ctime>
+#include <unordered_map>
+
+using namespace std;
+
+namespace {
+	// Every cache file starts with this, followed by the format version. The
+	// version must be changed whenever the format changes.
+	const char MAGIC[4] = {'E', 'S', 'D', 'C'};
+	const uint32_t VERSION = 1;
+	
+	bool enabled = false;
+	
+	// Each source has its own cache, named after a hash of its path (FNV-1a).
+	string CachePath(const string &source)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for(char c : source)
+			hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+		
+		char name[32];
+		snprintf(name, sizeof(name), "%016llx.dat", static_cast<unsigned long long>(hash));
+		return Files::Config() + "cache/" + name;
+	}
+}
+
+
+
+// Each distinct token in a cache, and its numeric value if it has one. Even
+// data files that differ in every other way use many of the same tokens, so
+// each token is only stored, and parsed, once.
+class DataCache::Token {
+public:
+	string text;
+	DataNode::Number number;
+};
+
+
+
+// Class for building a cache one file at a time. Every distinct token is only
+// stored once, in a table at the start of the cache, and nodes refer to their
+// tokens by their index in that table.
+class DataCache::Writer {
+public:
+	explicit Writer(const vector<Entry> &manifest);
+	
+	void Add(const DataFile &file);
+	string Data() const;
+	
+	
+private:
+	void AddNode(const DataNode &node);
+	
+	
+private:
+	string header;
+	string nodes;
+	unordered_map<string, uint32_t> indices;
+	vector<const string *> strings;
+};
+
+
+
+DataCache::Writer::Writer(const vector<Entry> &manifest)
+	: header(MAGIC, sizeof(MAGIC))
+{
+	BinaryIO::Append(header, VERSION, 4);
+	BinaryIO::Append(header, manifest.size(), 4);
+	
+	// A file that changes again within the same second that it was loaded in
+	// would still have the same timestamp, so only trust timestamps that are
+	// older than this cache.
+	int64_t now = time(nullptr);
+	for(const Entry &entry : manifest)
+	{
+		BinaryIO::AppendString(header, entry.path);
+		BinaryIO::Append(header, entry.size, 8);
+		BinaryIO::Append(header, entry.timestamp < now ? entry.timestamp : -1, 8);
+	}
+}
+
+
+
+void DataCache::Writer::Add(const DataFile &file)
+{
+	AddNode(file.root);
+}
+
+
+
+string DataCache::Writer::Data() const
+{
+	string out = header;
+	BinaryIO::Append(out, strings.size(), 4);
+	for(const string *it : strings)
+		BinaryIO::AppendString(out, *it);
+	return out + nodes;
+}
+
+
+
+void DataCache::Writer::AddNode(const DataNode &node)
+{
+	BinaryIO::Append(nodes, node.lineNumber, 4);
+	BinaryIO::Append(nodes, node.tokens.size(), 4);
+	for(const string &token : node.tokens)
+	{
+		auto it = indices.find(token);
+		if(it == indices.end())
+		{
+			it = indices.emplace(token, strings.size()).first;
+			strings.push_back(&it->first);
+		}
+		BinaryIO::Append(nodes, it->second, 4);
+	}
+	
+	BinaryIO::Append(nodes, node.children.size(), 4);
+	for(const DataNode &child : node.children)
+		AddNode(child);
+}
+
+
+
+// Turn the use of the cache on or off.
+void DataCache::SetEnabled(bool enable)
+{
+	enabled = enable;
+}
+
+
+
+bool DataCache::IsEnabled()
+{
+	return enabled;
+}
+
+
+
+// Load each of the given data files from the given source, in order, and pass
+// them to the callback. If none of the files have changed, they are read from
+// the cache instead of being parsed; otherwise the cache is written again.
+void DataCache::Load(const string &source, const vector<string> &paths, const Callback &callback)
+{
+	vector<Entry> manifest = Manifest(paths);
+	const string cachePath = CachePath(source);
+	size_t count = Read(Files::Read(cachePath), manifest, callback);
+	if(count == paths.size())
+		return;
+	
+	// If the cache matched but part of it could not be read, it is damaged.
+	// Parse the remaining files, and rebuild the cache the next time.
+	if(count)
+	{
+		Files::LogError("Warning: the data cache for \"" + source + "\" is damaged.");
+		for(size_t i = count; i < paths.size(); ++i)
+			callback(paths[i], DataFile(paths[i]));
+		Files::Delete(cachePath);
+		return;
+	}
+	
+	Writer writer(manifest);
+	for(const string &path : paths)
+	{
+		DataFile file(path);
+		callback(path, file);
+		writer.Add(file);
+	}
+	
+	// Write to a temporary file first, so a partially written cache is never
+	// mistaken for a complete one.
+	if(!Files::Exists(Files::Config() + "cache"))
+		Files::CreateNewDirectory(Files::Config() + "cache");
+	const string temporaryPath = cachePath + "~";
+	FILE *file = BinaryIO::Open(temporaryPath);
+	if(!file)
+		return;
+	const string data = writer.Data();
+	bool success = (fwrite(data.data(), 1, data.size(), file) == data.size());
+	success &= !fclose(file);
+	if(success)
+		Files::Move(temporaryPath, cachePath);
+	else
+		Files::Delete(temporaryPath);
+}
+
+
+
+// Get the current state of each of the given files.
+vector<DataCache::Entry> DataCache::Manifest(const vector<string> &paths)
+{
+	vector<Entry> manifest;
+	manifest.reserve(paths.size());
+	for(const string &path : paths)
+	{
+		manifest.emplace_back();
+		manifest.back().path = path;
+		manifest.back().size = Files::Size(path);
+		manifest.back().timestamp = Files::Timestamp(path);
+	}
+	return manifest;
+}
+
+
+
+// Convert the given files, made from the given manifest, to the cache format.
+string DataCache::Write(const vector<Entry> &manifest, const vector<DataFile> &files)
+{
+	Writer writer(manifest);
+	for(const DataFile &file : files)
+		writer.Add(file);
+	return writer.Data();
+}
+
+
+
+// Read each file in the given cache and pass it to the callback. This returns
+// how many files were read, which is zero if the cache was not made from the
+// given manifest.
+size_t DataCache::Read(const string &data, const vector<Entry> &manifest, const Callback &callback)
+{
+	size_t pos = sizeof(MAGIC);
+	uint64_t version = 0;
+	uint64_t count = 0;
+	if(data.compare(0, sizeof(MAGIC), MAGIC, sizeof(MAGIC)) || !BinaryIO::Extract(data, pos, version, 4)
+			|| version != VERSION || !BinaryIO::Extract(data, pos, count, 4) || count != manifest.size())
+		return 0;
+	
+	string path;
+	for(const Entry &entry : manifest)
+	{
+		uint64_t size = 0;
+		uint64_t timestamp = 0;
+		if(!BinaryIO::ExtractString(data, pos, path) || !BinaryIO::Extract(data, pos, size, 8)
+				|| !BinaryIO::Extract(data, pos, timestamp, 8))
+			return 0;
+		if(path != entry.path || size != entry.size || static_cast<int64_t>(timestamp) != entry.timestamp)
+			return 0;
+	}
+	
+	// Every string needs at least four bytes for its length.
+	if(!BinaryIO::Extract(data, pos, count, 4) || count > (data.size() - pos) / 4)
+		return 0;
+	vector<Token> tokens(count);
+	for(Token &token : tokens)
+	{
+		if(!BinaryIO::ExtractString(data, pos, token.text))
+			return 0;
+		token.number.isNumber = !token.text.empty() && DataNode::ParseNumber(token.text.c_str(), token.number.value);
+	}
+	
+	size_t read = 0;
+	for(const Entry &entry : manifest)
+	{
+		DataFile file;
+		if(!ReadNode(data, pos, tokens, file.root))
+			break;
+		callback(entry.path, file);
+		++read;
+	}
+	return read;
+}
+
+
+
+bool DataCache::ReadNode(const string &data, size_t &pos, const vector<Token> &tokens, DataNode &node)
+{
+	uint64_t lineNumber = 0;
+	uint64_t count = 0;
+	if(!BinaryIO::Extract(data, pos, lineNumber, 4) || !BinaryIO::Extract(data, pos, count, 4)
+			|| count > (data.size() - pos) / 4)
+		return false;
+	
+	node.lineNumber = lineNumber;
+	node.tokens.reserve(count);
+	node.numbers.reserve(count);
+	for(uint64_t i = 0; i < count; ++i)
+	{
+		uint64_t index = 0;
+		BinaryIO::Extract(data, pos, index, 4);
+		if(index >= tokens.size())
+			return false;
+		node.tokens.push_back(tokens[index].text);
+		node.numbers.push_back(tokens[index].number);
+	}
+	
+	// Every child needs at least twelve bytes for its line number and counts.
+	if(!BinaryIO::Extract(data, pos, count, 4) || count > (data.size() - pos) / 12)
+		return false;
+	for(uint64_t i = 0; i < count; ++i)
+	{
+		node.children.emplace_back(&node);
+		if(!ReadNode(data, pos, tokens, node.children.back()))
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,80 @@
+/* DataCache.h
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef DATA_CACHE_H_
+#define DATA_CACHE_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+class DataFile;
+class DataNode;
+
+
+
+// Class for storing the already tokenized data files of a "source" folder (the
+// game's resources or a plugin) in a single binary file, so that the next time
+// the game starts they can be loaded without parsing any text. Each cache also
+// records the path, size, and modification time of every file it was made from;
+// if any of those do not match the files that are on disk now, the cache is
+// ignored, the text files are parsed as usual, and the cache is written again.
+// Building the nodes takes most of the time either way, so reading a cache is
+// only faster than parsing on slow file systems, where it saves opening every
+// data file. Caching is therefore off unless it is turned on with the "--cache"
+// command line option.
+class DataCache {
+public:
+	// The state of a data file at the time it was loaded.
+	class Entry {
+	public:
+		std::string path;
+		uint64_t size = 0;
+		int64_t timestamp = 0;
+	};
+	
+	// A function that is given each loaded data file and its path.
+	using Callback = std::function<void(const std::string &path, const DataFile &file)>;
+	
+	
+public:
+	// Turn the use of the cache on or off.
+	static void SetEnabled(bool enabled);
+	static bool IsEnabled();
+	
+	// Load each of the given data files from the given source, in order, and
+	// pass them to the callback. If none of the files have changed, they are
+	// read from the cache instead of being parsed; otherwise the cache is
+	// written again.
+	static void Load(const std::string &source, const std::vector<std::string> &paths, const Callback &callback);
+	
+	// Get the current state of each of the given files.
+	static std::vector<Entry> Manifest(const std::vector<std::string> &paths);
+	// Convert the given files, made from the given manifest, to the cache format.
+	static std::string Write(const std::vector<Entry> &manifest, const std::vector<DataFile> &files);
+	// Read each file in the given cache and pass it to the callback. This
+	// returns how many files were read, which is zero if the cache was not
+	// made from the given manifest.
+	static size_t Read(const std::string &data, const std::vector<Entry> &manifest, const Callback &callback);
+	
+	
+private:
+	class Token;
+	class Writer;
+	
+	static bool ReadNode(const std::string &data, size_t &pos, const std::vector<Token> &tokens, DataNode &node);
+};
+
+
+
+#endif
@@ -13,10 +13,48 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "DataFile.h"
 
 #include "Files.h"
-#include "text/Utf8.h"
+#include "Profiler.h"
+
+#include <cstdint>
+#include <cstring>
 
 using namespace std;
 
+namespace {
+	// Find the first instance of either of the given characters, starting at
+	// the given position. The text must contain one of them after that point.
+	size_t FindEither(const string &data, size_t pos, char a, char b)
+	{
+		// Quoted tokens are often long, so check eight bytes at a time for a
+		// byte that is equal to either character before checking byte by byte.
+		const uint64_t ONES = 0x0101010101010101ull;
+		const uint64_t HIGHS = 0x8080808080808080ull;
+		const uint64_t maskA = ONES * static_cast<unsigned char>(a);
+		const uint64_t maskB = ONES * static_cast<unsigned char>(b);
+		for( ; pos + sizeof(uint64_t) <= data.length(); pos += sizeof(uint64_t))
+		{
+			uint64_t word;
+			memcpy(&word, data.data() + pos, sizeof(word));
+			// A byte of (word ^ mask) is zero where the word matches the character.
+			uint64_t matchA = word ^ maskA;
+			uint64_t matchB = word ^ maskB;
+			if(((matchA - ONES) & ~matchA & HIGHS) || ((matchB - ONES) & ~matchB & HIGHS))
+				break;
+		}
+		while(data[pos] != a && data[pos] != b)
+			++pos;
+		return pos;
+	}
+	
+	// Skip the rest of the current line, and return the line break.
+	char SkipLine(const string &data, size_t &pos)
+	{
+		const char *text = data.data();
+		pos = static_cast<const char *>(memchr(text + pos, '\n', data.length() - pos)) - text + 1;
+		return '\n';
+	}
+}
+
 
 
 // Constructor, taking a file path (in UTF-8).
@@ -38,6 +76,7 @@ DataFile::DataFile(istream &in)
 // Load from a file path (in UTF-8).
 void DataFile::Load(const string &path)
 {
+	PROFILE_SCOPE("DataFile::Load");
 	string data = Files::Read(path);
 	if(data.empty())
 		return;
@@ -96,6 +135,13 @@ list<DataNode>::const_iterator DataFile::end() const
 // Parse the given text.
 void DataFile::LoadData(const string &data)
 {
+	PROFILE_SCOPE("DataFile::LoadData");
+	// Every character with a special meaning (whitespace, quotes, comments, and
+	// line breaks) is ASCII, and no byte of a multi-byte UTF-8 character is, so
+	// the text can be parsed one byte at a time without decoding it. Any byte
+	// above 127 is simply part of a token.
+	const char *text = data.data();
+	
 	// Keep track of the current stack of indentation levels and the most recent
 	// node at each level - that is, the node that will be the "parent" of any
 	// new node added at the next deeper indentation level.
@@ -110,7 +156,7 @@ void DataFile::LoadData(const string &data)
 	{
 		++lineNumber;
 		size_t tokenPos = pos;
-		char32_t c = Utf8::DecodeCodePoint(data, pos);
+		unsigned char c = text[pos++];
 		
 		// Find the first non-white character in this line.
 		bool isSpaces = false;
@@ -136,13 +182,12 @@ void DataFile::LoadData(const string &data)
 			
 			++white;
 			tokenPos = pos;
-			c = Utf8::DecodeCodePoint(data, pos);
+			c = text[pos++];
 		}
 		
 		// If the line is a comment, skip to the end of the line.
 		if(c == '#')
-			while(c != '\n')
-				c = Utf8::DecodeCodePoint(data, pos);
+			c = SkipLine(data, pos);
 		// Skip empty lines (including comment lines).
 		if(c == '\n')
 			continue;
@@ -170,22 +215,23 @@ void DataFile::LoadData(const string &data)
 		{
 			// Check if this token begins with a quotation mark. If so, it will
 			// include everything up to the next instance of that mark.
-			char32_t endQuote = c;
+			char endQuote = c;
 			bool isQuoted = (endQuote == '"' || endQuote == '`');
+			size_t endPos;
 			if(isQuoted)
 			{
 				tokenPos = pos;
-				c = Utf8::DecodeCodePoint(data, pos);
+				endPos = FindEither(data, pos, endQuote, '\n');
 			}
-			
-			size_t endPos = tokenPos;
-			
-			// Find the end of this token.
-			while(c != '\n' && (isQuoted ? (c != endQuote) : (c > ' ')))
+			else
 			{
+				// Find the end of this token.
 				endPos = pos;
-				c = Utf8::DecodeCodePoint(data, pos);
+				while(static_cast<unsigned char>(text[endPos]) > ' ')
+					++endPos;
 			}
+			c = text[endPos];
+			pos = endPos + 1;
 			
 			// It ought to be legal to construct a string from an empty iterator
 			// range, but it appears that some libraries do not handle that case
@@ -193,7 +239,7 @@ void DataFile::LoadData(const string &data)
 			if(tokenPos == endPos)
 				node.tokens.emplace_back();
 			else
-				node.tokens.emplace_back(data, tokenPos, endPos - tokenPos);
+				node.tokens.emplace_back(text + tokenPos, endPos - tokenPos);
 			// This is not a fatal error, but it may indicate a format mistake:
 			if(isQuoted && c == '\n')
 				node.PrintTrace("Closing quotation mark is missing:");
@@ -205,24 +251,22 @@ void DataFile::LoadData(const string &data)
 				if(isQuoted)
 				{
 					tokenPos = pos;
-					c = Utf8::DecodeCodePoint(data, pos);
+					c = text[pos++];
 				}
 				while(c != '\n' && c <= ' ' && c != '#')
 				{
 					tokenPos = pos;
-					c = Utf8::DecodeCodePoint(data, pos);
+					c = text[pos++];
 				}
 				
 				// If a comment is encountered outside of a token, skip the rest
 				// of this line of the file.
 				if(c == '#')
-				{
-					while(c != '\n')
-						c = Utf8::DecodeCodePoint(data, pos);
-				}
+					c = SkipLine(data, pos);
 			}
 		}
 		// Now that we've reached the end of the line, we know no more tokens will be added to the node.
 		node.tokens.shrink_to_fit();
+		node.CacheNumbers();
 	}
 }
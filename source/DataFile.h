@@ -49,6 +49,9 @@ private:
 private:
 	// This is the container for all DataNodes in this file.
 	DataNode root;
+	
+	// Allow DataCache to store and restore the nodes of a file.
+	friend class DataCache;
 };
 
 
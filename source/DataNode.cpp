@@ -13,10 +13,12 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "DataNode.h"
 
 #include "Files.h"
+#include "Logger.h"
 
 #include <algorithm>
 #include <cctype>
 #include <cmath>
+#include <cstdint>
 
 using namespace std;
 
@@ -36,7 +38,7 @@ DataNode::DataNode(const DataNode *parent) noexcept(false)
 
 // Copy constructor.
 DataNode::DataNode(const DataNode &other)
-	: children(other.children), tokens(other.tokens), lineNumber(other.lineNumber)
+	: children(other.children), tokens(other.tokens), numbers(other.numbers), lineNumber(other.lineNumber)
 {
 	Reparent();
 }
@@ -48,6 +50,7 @@ DataNode &DataNode::operator=(const DataNode &other)
 {
 	children = other.children;
 	tokens = other.tokens;
+	numbers = other.numbers;
 	lineNumber = other.lineNumber;
 	Reparent();
 	return *this;
@@ -56,7 +59,8 @@ DataNode &DataNode::operator=(const DataNode &other)
 
 
 DataNode::DataNode(DataNode &&other) noexcept
-	: children(std::move(other.children)), tokens(std::move(other.tokens)), lineNumber(std::move(other.lineNumber))
+	: children(std::move(other.children)), tokens(std::move(other.tokens)),
+		numbers(std::move(other.numbers)), lineNumber(std::move(other.lineNumber))
 {
 	Reparent();
 }
@@ -67,6 +71,7 @@ DataNode &DataNode::operator=(DataNode &&other) noexcept
 {
 	children.swap(other.children);
 	tokens.swap(other.tokens);
+	numbers.swap(other.numbers);
 	lineNumber = std::move(other.lineNumber);
 	Reparent();
 	return *this;
@@ -102,15 +107,18 @@ const string &DataNode::Token(int index) const
 // Convert the token with the given index to a numerical value.
 double DataNode::Value(int index) const
 {
+	// Nodes loaded from a file already know which of their tokens are numbers.
+	if(static_cast<size_t>(index) < numbers.size() && numbers[index].isNumber)
+		return numbers[index].value;
+	
+	double value = 0.;
 	// Check for empty strings and out-of-bounds indices.
 	if(static_cast<size_t>(index) >= tokens.size() || tokens[index].empty())
 		PrintTrace("Requested token index (" + to_string(index) + ") is out of bounds:");
-	else if(!IsNumber(tokens[index]))
+	else if(!ParseNumber(tokens[index].c_str(), value))
 		PrintTrace("Cannot convert value \"" + tokens[index] + "\" to a number:");
-	else
-		return Value(tokens[index]);
 	
-	return 0.;
+	return value;
 }
 
 
@@ -118,51 +126,10 @@ double DataNode::Value(int index) const
 // Static helper function for any class which needs to parse string -> number.
 double DataNode::Value(const string &token)
 {
-	// Allowed format: "[+-]?[0-9]*[.]?[0-9]*([eE][+-]?[0-9]*)?".
-	if(!IsNumber(token))
-	{
+	double value = 0.;
+	if(!ParseNumber(token.c_str(), value))
 		Files::LogError("Cannot convert value \"" + token + "\" to a number.");
-		return 0.;
-	}
-	const char *it = token.c_str();
-	
-	// Check for leading sign.
-	double sign = (*it == '-') ? -1. : 1.;
-	it += (*it == '-' || *it == '+');
-	
-	// Digits before the decimal point.
-	int64_t value = 0;
-	while(*it >= '0' && *it <= '9')
-		value = (value * 10) + (*it++ - '0');
-	
-	// Digits after the decimal point (if any).
-	int64_t power = 0;
-	if(*it == '.')
-	{
-		++it;
-		while(*it >= '0' && *it <= '9')
-		{
-			value = (value * 10) + (*it++ - '0');
-			--power;
-		}
-	}
-	
-	// Exponent.
-	if(*it == 'e' || *it == 'E')
-	{
-		++it;
-		int64_t sign = (*it == '-') ? -1 : 1;
-		it += (*it == '-' || *it == '+');
-		
-		int64_t exponent = 0;
-		while(*it >= '0' && *it <= '9')
-			exponent = (exponent * 10) + (*it++ - '0');
-		
-		power += sign * exponent;
-	}
-	
-	// Compose the return value.
-	return copysign(value * pow(10., power), sign);
+	return value;
 }
 
 
@@ -171,6 +138,9 @@ double DataNode::Value(const string &token)
 // class is able to parse.
 bool DataNode::IsNumber(int index) const
 {
+	if(static_cast<size_t>(index) < numbers.size())
+		return numbers[index].isNumber;
+	
 	// Make sure this token exists and is not empty.
 	if(static_cast<size_t>(index) >= tokens.size() || tokens[index].empty())
 		return false;
@@ -182,38 +152,8 @@ bool DataNode::IsNumber(int index) const
 
 bool DataNode::IsNumber(const string &token)
 {
-	bool hasDecimalPoint = false;
-	bool hasExponent = false;
-	bool isLeading = true;
-	for(const char *it = token.c_str(); *it; ++it)
-	{
-		// If this is the start of the number or the exponent, it is allowed to
-		// be a '-' or '+' sign.
-		if(isLeading)
-		{
-			isLeading = false;
-			if(*it == '-' || *it == '+')
-				continue;
-		}
-		// If this is a decimal, it may or may not be allowed.
-		if(*it == '.')
-		{
-			if(hasDecimalPoint || hasExponent)
-				return false;
-			hasDecimalPoint = true;
-		}
-		else if(*it == 'e' || *it == 'E')
-		{
-			if(hasExponent)
-				return false;
-			hasExponent = true;
-			// At the start of an exponent, a '-' or '+' is allowed.
-			isLeading = true;
-		}
-		else if(*it < '0' || *it > '9')
-			return false;
-	}
-	return true;
+	double value;
+	return ParseNumber(token.c_str(), value);
 }
 
 
@@ -245,50 +185,138 @@ list<DataNode>::const_iterator DataNode::end() const noexcept
 // Print a message followed by a "trace" of this node and its parents.
 int DataNode::PrintTrace(const string &message) const
 {
+	string text;
 	if(!message.empty())
 	{
 		// Put an empty line in the log between each error message.
 		Files::LogError("");
-		Files::LogError(message);
+		text = message + '\n';
 	}
+	int indent = AppendTrace(text);
+	if(text.empty())
+		return indent;
+	text.pop_back();
+	
+	// The whole trace is a single entry in the log, which points to the file
+	// and line that this node came from.
+	const DataNode *root = this;
+	while(root->parent)
+		root = root->parent;
+	string location;
+	if(root->tokens.size() >= 2 && root->tokens[0] == "file")
+		location = root->tokens[1] + (parent ? ":" + to_string(lineNumber) : "");
 	
-	// Recursively print all the parents of this node, so that the user can
+	Logger::Log(text, Logger::SeverityOf(message), location);
+	
+	// Tell the caller what indentation level we're at now.
+	return indent;
+}
+
+
+
+// Adjust the parent pointers when a copy is made of a DataNode.
+void DataNode::Reparent() noexcept
+{
+	for(DataNode &child : children)
+	{
+		child.parent = this;
+		child.Reparent();
+	}
+}
+
+
+
+// Parse every token once, so that Value() and IsNumber() do not have to.
+void DataNode::CacheNumbers()
+{
+	numbers.resize(tokens.size());
+	for(size_t i = 0; i < tokens.size(); ++i)
+		numbers[i].isNumber = !tokens[i].empty() && ParseNumber(tokens[i].c_str(), numbers[i].value);
+}
+
+
+
+// Parse the given token if it is in the number format described by IsNumber().
+// Returns false, and leaves the value unchanged, if it is not.
+bool DataNode::ParseNumber(const char *it, double &result) noexcept
+{
+	// Allowed format: "[+-]?[0-9]*[.]?[0-9]*([eE][+-]?[0-9]*)?".
+	// Check for leading sign.
+	double sign = (*it == '-') ? -1. : 1.;
+	it += (*it == '-' || *it == '+');
+	
+	// Digits before the decimal point. Overly long numbers wrap around rather
+	// than overflowing, just as they always have.
+	uint64_t value = 0;
+	while(*it >= '0' && *it <= '9')
+		value = (value * 10) + (*it++ - '0');
+	
+	// Digits after the decimal point (if any).
+	int64_t power = 0;
+	if(*it == '.')
+	{
+		++it;
+		while(*it >= '0' && *it <= '9')
+		{
+			value = (value * 10) + (*it++ - '0');
+			--power;
+		}
+	}
+	
+	// Exponent.
+	if(*it == 'e' || *it == 'E')
+	{
+		++it;
+		int64_t sign = (*it == '-') ? -1 : 1;
+		it += (*it == '-' || *it == '+');
+		
+		uint64_t exponent = 0;
+		while(*it >= '0' && *it <= '9')
+			exponent = (exponent * 10) + (*it++ - '0');
+		
+		power += sign * static_cast<int64_t>(exponent);
+	}
+	
+	// Anything left over means this token is not a number.
+	if(*it)
+		return false;
+	
+	// Compose the return value.
+	result = copysign(static_cast<int64_t>(value) * pow(10., power), sign);
+	return true;
+}
+
+
+
+// Add a "trace" of this node and its parents to the given text, one line per
+// node, and return the indentation level of this node.
+int DataNode::AppendTrace(string &text) const
+{
+	// Recursively add all the parents of this node, so that the user can
 	// trace it back to the right point in the file.
 	size_t indent = 0;
 	if(parent)
-		indent = parent->PrintTrace() + 2;
+		indent = parent->AppendTrace(text) + 2;
 	if(tokens.empty())
 		return indent;
 	
 	// Convert this node back to tokenized text, with quotes used as necessary.
-	string line = !parent ? "" : "L" + to_string(lineNumber) + ": ";
-	line.append(string(indent, ' '));
+	if(parent)
+		text += "L" + to_string(lineNumber) + ": ";
+	text.append(string(indent, ' '));
 	for(const string &token : tokens)
 	{
 		if(&token != &tokens.front())
-			line += ' ';
+			text += ' ';
 		bool hasSpace = any_of(token.begin(), token.end(), [](char c) { return isspace(c); });
 		bool hasQuote = any_of(token.begin(), token.end(), [](char c) { return (c == '"'); });
 		if(hasSpace)
-			line += hasQuote ? '`' : '"';
-		line += token;
+			text += hasQuote ? '`' : '"';
+		text += token;
 		if(hasSpace)
-			line += hasQuote ? '`' : '"';
+			text += hasQuote ? '`' : '"';
 	}
-	Files::LogError(line);
+	text += '\n';
 	
-	// Tell the caller what indentation level we're at now.
 	return indent;
 }
-
-
-
-// Adjust the parent pointers when a copy is made of a DataNode.
-void DataNode::Reparent() noexcept
-{
-	for(DataNode &child : children)
-	{
-		child.parent = this;
-		child.Reparent();
-	}
-}
@@ -65,6 +65,23 @@ public:
 private:
 	// Adjust the parent pointers when a copy is made of a DataNode.
 	void Reparent() noexcept;
+	// Add a trace of this node and its parents to the given text, and return
+	// the indentation level of this node.
+	int AppendTrace(std::string &text) const;
+	// Parse every token once, so that Value() and IsNumber() do not have to.
+	void CacheNumbers();
+	// Parse the given token if it is in the number format described by
+	// IsNumber(). Returns false, and leaves the value unchanged, if it is not.
+	static bool ParseNumber(const char *it, double &result) noexcept;
+	
+	
+private:
+	// The parsed value of a token, if it is a number.
+	class Number {
+	public:
+		double value = 0.;
+		bool isNumber = false;
+	};
 	
 	
 private:
@@ -72,12 +89,16 @@ private:
 	std::list<DataNode> children;
 	// These are the tokens found in this particular line of the data file.
 	std::vector<std::string> tokens;
+	// The numeric value of each token, filled in when the node is loaded. Nodes
+	// that were not created by a DataFile may not have this cache.
+	std::vector<Number> numbers;
 	// The parent pointer is used only for printing stack traces.
 	const DataNode *parent = nullptr;
 	// The line number in the given file that produced this node.
 	size_t lineNumber = 0;
 	
-	// Allow DataFile to modify the internal structure of DataNodes.
+	// Allow DataFile and DataCache to modify the internal structure of DataNodes.
+	friend class DataCache;
 	friend class DataFile;
 };
 
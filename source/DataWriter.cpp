@@ -15,8 +15,16 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "DataNode.h"
 #include "Files.h"
 
+#include <charconv>
+#include <cstdio>
+
 using namespace std;
 
+namespace {
+	// Output is composed in memory until it reaches this size.
+	const size_t BUFFER_SIZE = 1 << 20;
+}
+
 
 
 // This string constant is just used for remembering what string needs to be
@@ -29,15 +37,31 @@ const string DataWriter::space = " ";
 DataWriter::DataWriter(const string &path)
 	: path(path), before(&indent)
 {
-	out.precision(8);
 }
 
 
 
-// Destructor, which saves the file all in one block.
+DataWriter::DataWriter()
+	: before(&indent)
+{
+}
+
+
+
+// Destructor, which saves the file all in one block (unless it was so large
+// that parts of it have already been written).
 DataWriter::~DataWriter()
 {
-	Files::Write(path, out.str());
+	if(!path.empty())
+		Flush(true);
+}
+
+
+
+// Get everything that has been written so far.
+string DataWriter::SaveToString() const
+{
+	return out;
 }
 
 
@@ -47,7 +71,7 @@ void DataWriter::Write(const DataNode &node)
 {
 	// Write all this node's tokens.
 	for(int i = 0; i < node.Size(); ++i)
-		WriteToken(node.Token(i).c_str());
+		WriteToken(node.Token(i));
 	Write();
 	
 	// If this node has any children, call this function recursively on them.
@@ -67,8 +91,20 @@ void DataWriter::Write(const DataNode &node)
 // Begin a new line of the file.
 void DataWriter::Write()
 {
-	out << '\n';
+	out += '\n';
 	before = &indent;
+	Flush();
+}
+
+
+
+// Write lines that are already in this format, e.g. what another writer's
+// SaveToString() returned.
+void DataWriter::WriteLines(const string &lines)
+{
+	out += lines;
+	before = &indent;
+	Flush();
 }
 
 
@@ -92,7 +128,10 @@ void DataWriter::EndChild()
 // Write a comment line, at the current indentation level.
 void DataWriter::WriteComment(const string &str)
 {
-	out << indent << "# " << str << '\n';
+	out += indent;
+	out += "# ";
+	out += str;
+	out += '\n';
 }
 
 
@@ -103,20 +142,21 @@ void DataWriter::WriteToken(const char *a)
 	// Figure out what kind of quotation marks need to be used for this string.
 	bool hasSpace = !*a;
 	bool hasQuote = false;
-	for(const char *it = a; *it; ++it)
+	const char *it = a;
+	for( ; *it; ++it)
 	{
 		hasSpace |= (*it <= ' ' && *it >= 0);
 		hasQuote |= (*it == '"');
 	}
 	
 	// Write the token, enclosed in quotes if necessary.
-	out << *before;
-	if(hasSpace && hasQuote)
-		out << '`' << a << '`';
-	else if(hasSpace)
-		out << '"' << a << '"';
-	else
-		out << a;
+	out += *before;
+	char quote = (hasSpace && hasQuote) ? '`' : hasSpace ? '"' : '\0';
+	if(quote)
+		out += quote;
+	out.append(a, it - a);
+	if(quote)
+		out += quote;
 	
 	// The next token written will not be the first one on this line, so it only
 	// needs to have a single space before it.
@@ -130,3 +170,59 @@ void DataWriter::WriteToken(const string &a)
 {
 	WriteToken(a.c_str());
 }
+
+
+
+// Append a number in the same format as an ostream with a precision of 8.
+void DataWriter::WriteNumber(int64_t value)
+{
+	char buffer[24];
+	out.append(buffer, to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+}
+
+
+
+void DataWriter::WriteNumber(uint64_t value)
+{
+	char buffer[24];
+	out.append(buffer, to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+}
+
+
+
+void DataWriter::WriteNumber(double value)
+{
+	// Not every standard library supports to_chars() for floating point, and
+	// this must match the "%g" format that ostreams use anyway.
+	char buffer[32];
+	int length = snprintf(buffer, sizeof(buffer), "%.8g", value);
+	out.append(buffer, length);
+}
+
+
+
+// If the output is very large, write what has been composed so far. Output
+// that is composed in memory is never written.
+void DataWriter::Flush(bool force)
+{
+	if(path.empty() || (!force && out.size() < BUFFER_SIZE))
+		return;
+	
+	// Output that fits in memory is written in a single block. Larger output is
+	// written in chunks to a temporary file, which only replaces the old file
+	// once the last chunk is written, so a crash never leaves it truncated.
+	if(force && !file)
+		Files::Write(path, out);
+	else
+	{
+		if(!file)
+			file = File(path + "~", true);
+		Files::Write(file, out);
+		if(force)
+		{
+			file = File();
+			Files::Move(path + "~", path);
+		}
+	}
+	out.clear();
+}
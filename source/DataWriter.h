@@ -13,10 +13,13 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #ifndef DATA_WRITER_H_
 #define DATA_WRITER_H_
 
+#include "File.h"
+
 #include <algorithm>
+#include <cstdint>
 #include <map>
-#include <sstream>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 class DataNode;
@@ -32,6 +35,9 @@ class DataWriter {
 public:
 	// Constructor, specifying the file to write.
 	explicit DataWriter(const std::string &path);
+	// Constructor for composing data in memory only, to be retrieved with
+	// SaveToString() instead of being written to a file.
+	DataWriter();
 	DataWriter(const DataWriter &) = delete;
 	DataWriter(DataWriter &&) = delete;
 	DataWriter &operator=(const DataWriter &) = delete;
@@ -40,6 +46,9 @@ public:
 	// it possible to write the whole file in a single chunk.
 	~DataWriter();
 	
+	// Get everything that has been written so far.
+	std::string SaveToString() const;
+	
 	// The Write() function can take any number of arguments. Each argument is
 	// converted to a token. Arguments may be strings or numeric values.
 	template <class A, class ...B>
@@ -56,6 +65,11 @@ public:
 	// Finish writing a block of child nodes and decrease the indentation.
 	void EndChild();
 	
+	// Write lines that are already in this format, e.g. what another writer's
+	// SaveToString() returned. They are written as they are, without adding any
+	// indentation, and must end with a line break.
+	void WriteLines(const std::string &lines);
+	
 	// Write a comment. It will be at the current indentation level, and will
 	// have "# " inserted before it.
 	void WriteComment(const std::string &str);
@@ -68,6 +82,15 @@ public:
 	void WriteToken(const A &a);
 	
 	
+private:
+	// Append a number in the same format as an ostream with a precision of 8.
+	void WriteNumber(int64_t value);
+	void WriteNumber(uint64_t value);
+	void WriteNumber(double value);
+	// If the output is very large, write what has been composed so far.
+	void Flush(bool force = false);
+	
+	
 private:
 	// Save path (in UTF-8).
 	std::string path;
@@ -80,7 +103,10 @@ private:
 	// "indent" for the first token in a line and "space" for subsequent tokens.
 	const std::string *before;
 	// Compose the output in memory before writing it to file.
-	std::ostringstream out;
+	std::string out;
+	// Very large outputs are written in several chunks to this temporary file,
+	// which is moved into place once the output is complete.
+	File file;
 };
 
 
@@ -103,7 +129,19 @@ void DataWriter::WriteToken(const A &a)
 	static_assert(std::is_arithmetic<A>::value,
 		"DataWriter cannot output anything but strings and arithmetic types.");
 	
-	out << *before << a;
+	out += *before;
+	// Booleans and characters are written the same way an ostream would.
+	if constexpr(std::is_same<A, bool>::value)
+		out += (a ? '1' : '0');
+	else if constexpr(std::is_same<A, char>::value || std::is_same<A, signed char>::value
+			|| std::is_same<A, unsigned char>::value)
+		out += static_cast<char>(a);
+	else if constexpr(std::is_floating_point<A>::value)
+		WriteNumber(static_cast<double>(a));
+	else if constexpr(std::is_signed<A>::value)
+		WriteNumber(static_cast<int64_t>(a));
+	else
+		WriteNumber(static_cast<uint64_t>(a));
 	before = &space;
 }
 
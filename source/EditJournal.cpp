@@ -0,0 +1,196 @@
+/* EditJournal.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "EditJournal.h"
+
+#include <algorithm>
+
+using namespace std;
+
+
+
+// Record a change made by the given owner to the given object. If merging is
+// requested, and the last edit was of the same field and could still be
+// continued (e.g. the user is still typing in the same text box), the two are
+// combined into one edit.
+void EditJournal::Record(Owner *owner, const void *object, unique_ptr<Change> change, bool merge)
+{
+	change->Update();
+	// Anything that was undone can no longer be redone.
+	if(position < edits.size())
+	{
+		edits.erase(edits.begin() + position, edits.end());
+		isOpen = false;
+	}
+	
+	if(isOpen && (merge || isGrouping))
+	{
+		for(auto it = edits.rbegin(); it != edits.rend() && it->group == lastGroup; ++it)
+			if(it->object == object && it->change->Merge(*change))
+				return;
+	}
+	if(!isOpen || !isGrouping)
+		++lastGroup;
+	
+	edits.push_back(Edit{owner, object, lastGroup, std::move(change)});
+	position = edits.size();
+	isOpen = merge || isGrouping;
+}
+
+
+
+// Stop merging changes into the last edit.
+void EditJournal::Seal()
+{
+	if(!isGrouping)
+		isOpen = false;
+}
+
+
+
+// Every change recorded between these calls is undone or redone at once, and
+// repeated changes to the same field are merged.
+void EditJournal::BeginGroup()
+{
+	isGrouping = false;
+	Seal();
+	isGrouping = true;
+}
+
+
+
+void EditJournal::EndGroup()
+{
+	isGrouping = false;
+	Seal();
+}
+
+
+
+bool EditJournal::CanUndo() const
+{
+	return position;
+}
+
+
+
+bool EditJournal::CanRedo() const
+{
+	return position < edits.size();
+}
+
+
+
+void EditJournal::Undo()
+{
+	if(!CanUndo())
+		return;
+	
+	isGrouping = false;
+	isOpen = false;
+	const size_t last = position;
+	size_t group = edits[position - 1].group;
+	while(position && edits[position - 1].group == group)
+	{
+		Edit &edit = edits[--position];
+		edit.change->Undo();
+		edit.owner->Changed(edit.object);
+	}
+	EndChanges(position, last);
+}
+
+
+
+void EditJournal::Redo()
+{
+	if(!CanRedo())
+		return;
+	
+	isGrouping = false;
+	isOpen = false;
+	const size_t first = position;
+	size_t group = edits[position].group;
+	while(position < edits.size() && edits[position].group == group)
+	{
+		Edit &edit = edits[position++];
+		edit.change->Redo();
+		edit.owner->Changed(edit.object);
+	}
+	EndChanges(first, position);
+}
+
+
+
+// Forget every edit of the given object (e.g. because it was deleted), or made
+// by the given owner.
+void EditJournal::Forget(const void *object)
+{
+	size_t before = count_if(edits.begin(), edits.begin() + position,
+		[object](const Edit &edit) { return edit.object == object; });
+	edits.erase(remove_if(edits.begin(), edits.end(),
+		[object](const Edit &edit) { return edit.object == object; }), edits.end());
+	position -= before;
+	isOpen = false;
+}
+
+
+
+void EditJournal::Forget(const Owner *owner)
+{
+	size_t before = count_if(edits.begin(), edits.begin() + position,
+		[owner](const Edit &edit) { return edit.owner == owner; });
+	edits.erase(remove_if(edits.begin(), edits.end(),
+		[owner](const Edit &edit) { return edit.owner == owner; }), edits.end());
+	position -= before;
+	isOpen = false;
+}
+
+
+
+void EditJournal::Clear()
+{
+	edits.clear();
+	position = 0;
+	isOpen = false;
+	isGrouping = false;
+}
+
+
+
+// How many edits are recorded, and how much memory they use, in bytes.
+size_t EditJournal::Size() const
+{
+	return edits.size();
+}
+
+
+
+size_t EditJournal::Memory() const
+{
+	size_t memory = edits.capacity() * sizeof(Edit);
+	for(const Edit &edit : edits)
+		memory += edit.change->Size();
+	return memory;
+}
+
+
+
+// Tell each owner of the given edits that all of them have been applied.
+void EditJournal::EndChanges(size_t first, size_t last) const
+{
+	vector<Owner *> owners;
+	for(size_t i = first; i < last; ++i)
+		if(find(owners.begin(), owners.end(), edits[i].owner) == owners.end())
+			owners.push_back(edits[i].owner);
+	for(Owner *owner : owners)
+		owner->EndChanges();
+}
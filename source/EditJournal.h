@@ -0,0 +1,231 @@
+/* EditJournal.h
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef EDIT_JOURNAL_H_
+#define EDIT_JOURNAL_H_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+
+// Class recording every edit made to a game object in the editor, so that edits
+// can be undone and redone. Each edit only stores the field that was changed and
+// its old and new values, not a copy of the whole object. Edits that belong
+// together (e.g. every step of dragging a system across the map) are grouped,
+// and undone or redone at once. Recording a new edit discards any edits that
+// were undone and not redone.
+class EditJournal {
+public:
+	// Anything that edits objects, and must be told when one of its edits is
+	// undone or redone (e.g. to mark the object as unsaved).
+	class Owner {
+	public:
+		virtual ~Owner() = default;
+		virtual void Changed(const void *object) = 0;
+		// Called once every edit of a group has been undone or redone, so that
+		// anything that depends on all of them (e.g. the map) is updated once.
+		virtual void EndChanges() {}
+	};
+	
+	// A single change to a field of an object.
+	class Change {
+	public:
+		virtual ~Change() = default;
+		
+		// Check whether the field's value is different from its old value.
+		virtual bool IsChanged() const = 0;
+		// Remember the current value of the field as its new value.
+		virtual void Update() = 0;
+		virtual void Undo() = 0;
+		virtual void Redo() = 0;
+		// If the given change is of the same field, take its new value.
+		virtual bool Merge(const Change &other) = 0;
+		// How much memory this change uses, in bytes.
+		virtual size_t Size() const = 0;
+	};
+	
+	template <class V>
+	class FieldChange : public Change {
+	public:
+		FieldChange(V &field, V oldValue) : field(&field), oldValue(std::move(oldValue)), newValue(field) {}
+		
+		virtual bool IsChanged() const override { return !(*field == oldValue); }
+		virtual void Update() override { newValue = *field; }
+		virtual void Undo() override { *field = oldValue; }
+		virtual void Redo() override { *field = newValue; }
+		virtual bool Merge(const Change &other) override;
+		virtual size_t Size() const override { return sizeof(*this); }
+	
+	private:
+		V *field;
+		V oldValue;
+		V newValue;
+	};
+	
+	// A change to a field of an element of a container (e.g. the distance of a
+	// stellar object in a system). Adding or removing elements moves the others
+	// in memory, so the element is found again by its index, and the field by
+	// the given function, whenever the change is undone or redone.
+	template <class C, class V>
+	class ElementChange : public Change {
+	public:
+		using Getter = std::function<V &(typename C::value_type &)>;
+		
+		ElementChange(C &container, size_t index, Getter get)
+			: container(&container), index(index), get(std::move(get)), oldValue(*Field()), newValue(oldValue) {}
+		
+		virtual bool IsChanged() const override { return Field() && !(*Field() == oldValue); }
+		virtual void Update() override { if(V *field = Field()) newValue = *field; }
+		virtual void Undo() override { if(V *field = Field()) *field = oldValue; }
+		virtual void Redo() override { if(V *field = Field()) *field = newValue; }
+		virtual bool Merge(const Change &other) override;
+		virtual size_t Size() const override { return sizeof(*this); }
+	
+	private:
+		// The field, unless its element no longer exists.
+		V *Field() const { return index < container->size() ? &get((*container)[index]) : nullptr; }
+	
+	private:
+		C *container;
+		size_t index;
+		Getter get;
+		V oldValue;
+		V newValue;
+	};
+	
+	
+public:
+	// Remember the current value of a field, so that a change to it can be
+	// recorded once it has been made.
+	template <class V>
+	static std::unique_ptr<Change> Snapshot(V &field);
+	// Remember the current value of the field that the given function returns
+	// of an element of a container. Adding or removing elements of a container
+	// should be recorded as a change of the whole container, so that the indices
+	// of the elements are the same again once it is undone.
+	template <class C, class F>
+	static std::unique_ptr<Change> Snapshot(C &container, size_t index, F get);
+	
+	// Record a change made by the given owner to the given object. If merging
+	// is requested, and the last edit was of the same field and could still be
+	// continued (e.g. the user is still typing in the same text box), the two
+	// are combined into one edit.
+	void Record(Owner *owner, const void *object, std::unique_ptr<Change> change, bool merge = false);
+	template <class V>
+	void Record(Owner *owner, const void *object, V &field, V oldValue, bool merge = false);
+	// Stop merging changes into the last edit.
+	void Seal();
+	// Every change recorded between these calls is undone or redone at once,
+	// and repeated changes to the same field are merged.
+	void BeginGroup();
+	void EndGroup();
+	
+	bool CanUndo() const;
+	bool CanRedo() const;
+	void Undo();
+	void Redo();
+	
+	// Forget every edit of the given object (e.g. because it was deleted), or
+	// made by the given owner.
+	void Forget(const void *object);
+	void Forget(const Owner *owner);
+	void Clear();
+	
+	// How many edits are recorded, and how much memory they use, in bytes.
+	size_t Size() const;
+	size_t Memory() const;
+	
+	
+private:
+	class Edit {
+	public:
+		Owner *owner;
+		const void *object;
+		size_t group;
+		std::unique_ptr<Change> change;
+	};
+	
+	
+private:
+	// Tell each owner of the given edits that all of them have been applied.
+	void EndChanges(size_t first, size_t last) const;
+	
+	
+private:
+	std::vector<Edit> edits;
+	// How many of the edits are currently applied. The rest have been undone.
+	size_t position = 0;
+	size_t lastGroup = 0;
+	// Whether new changes may still be merged into the last group.
+	bool isOpen = false;
+	bool isGrouping = false;
+};
+
+
+
+template <class V>
+bool EditJournal::FieldChange<V>::Merge(const Change &other)
+{
+	const auto *same = dynamic_cast<const FieldChange<V> *>(&other);
+	if(!same || same->field != field)
+		return false;
+	
+	newValue = same->newValue;
+	return true;
+}
+
+
+
+template <class C, class V>
+bool EditJournal::ElementChange<C, V>::Merge(const Change &other)
+{
+	const auto *same = dynamic_cast<const ElementChange<C, V> *>(&other);
+	if(!same || same->container != container || same->index != index || same->Field() != Field())
+		return false;
+	
+	newValue = same->newValue;
+	return true;
+}
+
+
+
+template <class V>
+std::unique_ptr<EditJournal::Change> EditJournal::Snapshot(V &field)
+{
+	return std::unique_ptr<Change>(new FieldChange<V>(field, field));
+}
+
+
+
+template <class C, class F>
+std::unique_ptr<EditJournal::Change> EditJournal::Snapshot(C &container, size_t index, F get)
+{
+	using V = typename std::remove_reference<decltype(get(container[index]))>::type;
+	return std::unique_ptr<Change>(new ElementChange<C, V>(container, index, std::move(get)));
+}
+
+
+
+template <class V>
+void EditJournal::Record(Owner *owner, const void *object, V &field, V oldValue, bool merge)
+{
+	Record(owner, object, std::unique_ptr<Change>(new FieldChange<V>(field, std::move(oldValue))), merge);
+}
+
+
+
+#endif
@@ -0,0 +1,246 @@
+/* EditLog.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "EditLog.h"
+
+#include "Files.h"
+#include "Logger.h"
+
+#include <cstdint>
+#include <map>
+#include <utility>
+
+using namespace std;
+
+namespace {
+	// Every log starts with this, so that an unrelated file is never replayed.
+	const string MAGIC = "ESEDITS1";
+	// Each record starts with the size of its contents, and their checksum.
+	const size_t RECORD_HEADER = 8;
+	
+	// A checksum of the contents of a record, to detect records that were only
+	// partially written before a crash (FNV-1a).
+	uint32_t Checksum(const char *data, size_t size)
+	{
+		uint32_t hash = 2166136261u;
+		for(size_t i = 0; i < size; ++i)
+		{
+			hash ^= static_cast<unsigned char>(data[i]);
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+	
+	// The log is always little-endian, whatever the platform.
+	void WriteUInt32(string &out, uint32_t value)
+	{
+		for(int i = 0; i < 4; ++i)
+			out += static_cast<char>((value >> (8 * i)) & 0xFF);
+	}
+	
+	uint32_t ReadUInt32(const char *data)
+	{
+		uint32_t value = 0;
+		for(int i = 0; i < 4; ++i)
+			value |= static_cast<uint32_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+		return value;
+	}
+}
+
+
+
+EditLog::~EditLog()
+{
+	Close();
+}
+
+
+
+// Read the log at the given path. Only the last record of each object is
+// returned, in the order in which the objects were first logged.
+vector<EditLog::Record> EditLog::Read(const string &path)
+{
+	vector<Record> records;
+	if(!Files::Exists(path))
+		return records;
+	
+	const string data = Files::Read(path);
+	if(data.compare(0, MAGIC.size(), MAGIC))
+	{
+		Logger::Log("Ignoring \"" + path + "\", which is not an edit log.", Logger::Severity::WARNING);
+		return records;
+	}
+	
+	map<pair<string, string>, size_t> index;
+	size_t pos = MAGIC.size();
+	while(data.size() - pos >= RECORD_HEADER)
+	{
+		const size_t size = ReadUInt32(data.data() + pos);
+		const uint32_t checksum = ReadUInt32(data.data() + pos + 4);
+		pos += RECORD_HEADER;
+		// Anything after an incomplete record was never written successfully.
+		if(data.size() - pos < size || Checksum(data.data() + pos, size) != checksum)
+		{
+			Logger::Log("The end of the edit log \"" + path + "\" is incomplete.", Logger::Severity::WARNING);
+			break;
+		}
+		
+		// The contents are the key, name and definition, separated by null characters.
+		const size_t keyEnd = data.find('\0', pos);
+		const size_t nameEnd = data.find('\0', keyEnd + 1);
+		const size_t end = pos + size;
+		if(keyEnd >= end || nameEnd >= end)
+		{
+			pos = end;
+			continue;
+		}
+		
+		Record record;
+		record.key.assign(data, pos, keyEnd - pos);
+		record.name.assign(data, keyEnd + 1, nameEnd - keyEnd - 1);
+		record.definition.assign(data, nameEnd + 1, end - nameEnd - 1);
+		pos = end;
+		
+		auto it = index.emplace(make_pair(record.key, record.name), records.size());
+		if(it.second)
+			records.push_back(std::move(record));
+		else
+			records[it.first->second] = std::move(record);
+	}
+	return records;
+}
+
+
+
+// Start logging to the given file, or stop logging if the path is empty.
+// Anything that was not flushed yet is discarded. New records are added after
+// any that are already in the file, so once those have been read, call
+// Rewrite() before adding any more.
+void EditLog::Open(const string &path)
+{
+	Close();
+	this->path = path;
+	batch.clear();
+}
+
+
+
+// Stop logging, and delete the log (e.g. because the edits were discarded).
+void EditLog::Discard()
+{
+	Close();
+	if(!path.empty() && Files::Exists(path))
+		Files::Delete(path);
+	path.clear();
+	batch.clear();
+}
+
+
+
+const string &EditLog::Path() const
+{
+	return path;
+}
+
+
+
+// Add the current definition of an object to the next batch.
+void EditLog::Append(const string &key, const string &name, const string &definition)
+{
+	if(path.empty())
+		return;
+	
+	const size_t start = batch.size();
+	batch.append(RECORD_HEADER, '\0');
+	batch += key;
+	batch += '\0';
+	batch += name;
+	batch += '\0';
+	batch += definition;
+	
+	const size_t size = batch.size() - start - RECORD_HEADER;
+	string header;
+	WriteUInt32(header, size);
+	WriteUInt32(header, Checksum(batch.data() + start + RECORD_HEADER, size));
+	batch.replace(start, RECORD_HEADER, header);
+}
+
+
+
+// Write the batch to the end of the log, and wait for it to be stored.
+void EditLog::Flush()
+{
+	if(path.empty() || batch.empty())
+		return;
+	
+	if(!file)
+	{
+		const bool isNew = Files::Size(path) < MAGIC.size();
+		file = Files::Append(path);
+		if(!file)
+		{
+			Logger::Log("Unable to write the edit log \"" + path + "\".", Logger::Severity::WARNING);
+			batch.clear();
+			return;
+		}
+		if(isNew)
+			Files::Write(file, MAGIC);
+	}
+	Files::Write(file, batch);
+	Files::Sync(file);
+	batch.clear();
+}
+
+
+
+// Replace the whole log with just the batch, dropping any records of objects
+// that have been saved since. If the batch is empty, the log is deleted.
+void EditLog::Rewrite()
+{
+	if(path.empty())
+		return;
+	
+	Close();
+	if(batch.empty())
+	{
+		if(Files::Exists(path))
+			Files::Delete(path);
+		return;
+	}
+	
+	// Replace the old log only once the new one is stored, so that a crash
+	// while it is being written loses nothing.
+	const string temporary = path + "~";
+	if(Files::Exists(temporary))
+		Files::Delete(temporary);
+	FILE *out = Files::Append(temporary);
+	if(!out)
+	{
+		Logger::Log("Unable to write the edit log \"" + path + "\".", Logger::Severity::WARNING);
+		return;
+	}
+	Files::Write(out, MAGIC);
+	Files::Write(out, batch);
+	Files::Sync(out);
+	fclose(out);
+	Files::Move(temporary, path);
+	batch.clear();
+}
+
+
+
+void EditLog::Close()
+{
+	if(file)
+		fclose(file);
+	file = nullptr;
+}
@@ -0,0 +1,82 @@
+/* EditLog.h
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef EDIT_LOG_H_
+#define EDIT_LOG_H_
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+
+
+// Class that keeps a log of every unsaved object in the editor on disk, so that
+// the edits can be recovered if the editor crashes before they are saved. Each
+// record holds the definition of one object, as it would be saved to the plugin.
+// Records are only ever added to the end of the log, in batches, and each batch
+// is stored on disk before the next one is written. If the editor crashes in the
+// middle of writing a batch, only that incomplete record is lost.
+class EditLog {
+public:
+	class Record {
+	public:
+		// The kind of object (e.g. "system"), and its name.
+		std::string key;
+		std::string name;
+		std::string definition;
+	};
+	
+	
+public:
+	EditLog() noexcept = default;
+	EditLog(const EditLog &) = delete;
+	EditLog &operator=(const EditLog &) = delete;
+	~EditLog();
+	
+	// Read the log at the given path. Only the last record of each object is
+	// returned, in the order in which the objects were first logged.
+	static std::vector<Record> Read(const std::string &path);
+	
+	// Start logging to the given file, or stop logging if the path is empty.
+	// Anything that was not flushed yet is discarded. New records are added
+	// after any that are already in the file, so once those have been read,
+	// call Rewrite() before adding any more.
+	void Open(const std::string &path);
+	// Stop logging, and delete the log (e.g. because the edits were discarded).
+	void Discard();
+	const std::string &Path() const;
+	
+	// Add the current definition of an object to the next batch.
+	void Append(const std::string &key, const std::string &name, const std::string &definition);
+	// Write the batch to the end of the log, and wait for it to be stored.
+	void Flush();
+	// Replace the whole log with just the batch, dropping any records of
+	// objects that have been saved since. If the batch is empty, the log is
+	// deleted.
+	void Rewrite();
+	
+	
+private:
+	void Close();
+	
+	
+private:
+	std::string path;
+	FILE *file = nullptr;
+	// The records that have not been written yet.
+	std::string batch;
+};
+
+
+
+#endif
@@ -28,6 +28,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Government.h"
 #include "Hazard.h"
 #include "ImageSet.h"
+#include "Logger.h"
 #include "MainEditorPanel.h"
 #include "MainPanel.h"
 #include "MapEditorPanel.h"
@@ -36,6 +37,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Music.h"
 #include "Planet.h"
 #include "PlayerInfo.h"
+#include "Profiler.h"
 #include "Ship.h"
 #include "Sound.h"
 #include "SpriteSet.h"
@@ -44,12 +46,67 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "UI.h"
 #include "Visual.h"
 
+#include <SDL2/SDL.h>
+
 #include <cassert>
 #include <cstdint>
 #include <map>
+#include <sstream>
 
 using namespace std;
 
+namespace {
+	// The total time spent in one profiled scope, for a given chain of parents.
+	class ProfileEntry {
+	public:
+		const char *name;
+		int depth;
+		int64_t time;
+		int count;
+	};
+
+	// Loads the given definition of an object on top of the object as it is now,
+	// or, if the object is being recovered, on top of its base definition. The
+	// definition of an object that was not saved when the editor last closed
+	// only lists how it differs from the base game, just like the plugin itself.
+	template <class T, class F>
+	T *LoadDefinition(TemplateEditor<T> &editor, const Set<T> &objects, const Set<T> &base, const string &name, bool recover, F load)
+	{
+		T *object = const_cast<T *>(objects.Get(name));
+		if(recover)
+			*object = base.Has(name) ? *base.Get(name) : T();
+		load(*object);
+		editor.Changed(object);
+		return object;
+	}
+
+	// Calls the given function with the given editor and the object with the
+	// given name, unless there is no such object.
+	template <class T, class F>
+	void VisitObject(TemplateEditor<T> &editor, const Set<T> &objects, const string &name, F &f)
+	{
+		if(const T *object = objects.Find(name))
+			f(editor, object);
+	}
+
+	// The definition of the given object as it was last saved, if it was.
+	template <class T>
+	const string *FindSaved(const TemplateEditor<T> &editor, const string &name)
+	{
+		auto it = editor.Saved().find(name);
+		return it != editor.Saved().end() ? &it->second : nullptr;
+	}
+
+	template <class T>
+	void IndexAll(const TemplateEditor<T> &editor, const Set<T> &objects, ReferenceIndex &index, SearchIndex &search)
+	{
+		// Objects that are referred to but never defined have no name.
+		for(const auto &it : objects)
+			if(!GetName(it.second).empty())
+				editor.Index(index, search, it.first, it.second);
+	}
+}
+
 
 
 Editor::Editor(PlayerInfo &player, UI &menu, UI &ui) noexcept
@@ -60,6 +117,7 @@ Editor::Editor(PlayerInfo &player, UI &menu, UI &ui) noexcept
 	systemEditor(*this, showSystemMenu)
 {
 	StyleColorsDarkGray();
+	IndexObjects();
 }
 
 
@@ -95,20 +153,10 @@ void Editor::SaveAll()
 // Writes the plugin to a file.
 void Editor::WriteAll()
 {
+	PROFILE_SCOPE("Editor::WriteAll");
 	if(!HasPlugin())
 		return;
 
-	const auto &effects = effectEditor.Changes();
-	const auto &fleets = fleetEditor.Changes();
-	const auto &hazards = hazardEditor.Changes();
-	const auto &governments = governmentEditor.Changes();
-	const auto &outfits = outfitEditor.Changes();
-	const auto &outfitters = outfitterEditor.Changes();
-	const auto &planets = planetEditor.Changes();
-	const auto &ships = shipEditor.Changes();
-	const auto &shipyards = shipyardEditor.Changes();
-	const auto &systems = systemEditor.Changes();
-
 	// Save every change made to this plugin.
 	for(auto &&file : pluginPaths)
 	{
@@ -118,96 +166,27 @@ void Editor::WriteAll()
 		{
 			const string &type = pair.first;
 			const string &toSearch = pair.second;
+			const string *definition = nullptr;
 			if(type == "planet")
-			{
-				auto it = find_if(planets.begin(), planets.end(),
-						[&toSearch](const Planet &p) { return p.TrueName() == toSearch; });
-				if(it != planets.end())
-					planetEditor.WriteToFile(writer, &*it);
-				else
-					continue;
-			}
+				definition = FindSaved(planetEditor, toSearch);
 			else if(type == "ship")
-			{
-				auto it = find_if(ships.begin(), ships.end(),
-						[&toSearch](const Ship &s) { return s.TrueName() == toSearch; });
-				if(it != ships.end())
-					shipEditor.WriteToFile(writer, &*it);
-				else
-					continue;
-			}
+				definition = FindSaved(shipEditor, toSearch);
 			else if(type == "system")
-			{
-				auto it = find_if(systems.begin(), systems.end(),
-						[&toSearch](const System &sys) { return sys.Name() == toSearch; });
-				if(it != systems.end())
-					systemEditor.WriteToFile(writer, &*it);
-				else
-					continue;
-			}
+				definition = FindSaved(systemEditor, toSearch);
 			else if(type == "outfit")
-			{
-				auto it = find_if(outfits.begin(), outfits.end(),
-						[&toSearch](const Outfit &o) { return o.Name() == toSearch; });
-				if(it != outfits.end())
-					outfitEditor.WriteToFile(writer, &*it);
-				else
-					continue;
-			}
+				definition = FindSaved(outfitEditor, toSearch);
 			else if(type == "hazard")
-			{
-				auto it = find_if(hazards.begin(), hazards.end(),
-						[&toSearch](const Hazard &h) { return h.Name() == toSearch; });
-				if(it != hazards.end())
-					hazardEditor.WriteToFile(writer, &*it);
-				else
-					continue;
-			}
+				definition = FindSaved(hazardEditor, toSearch);
 			else if(type == "government")
-			{
-				auto it = find_if(governments.begin(), governments.end(),
-						[&toSearch](const Government &g) { return g.TrueName() == toSearch; });
-				if(it != governments.end())
-					governmentEditor.WriteToFile(writer, &*it);
-				else
-					continue;
-			}
+				definition = FindSaved(governmentEditor, toSearch);
 			else if(type == "fleet")
-			{
-				auto it = find_if(fleets.begin(), fleets.end(),
-						[&toSearch](const Fleet &f) { return f.Name() == toSearch; });
-				if(it != fleets.end())
-					fleetEditor.WriteToFile(writer, &*it);
-				else
-					continue;
-			}
+				definition = FindSaved(fleetEditor, toSearch);
 			else if(type == "outfitter")
-			{
-				auto it = find_if(outfitters.begin(), outfitters.end(),
-						[&toSearch](const Sale<Outfit> &o) { return o.Name() == toSearch; });
-				if(it != outfitters.end())
-					outfitterEditor.WriteToFile(writer, &*it);
-				else
-					continue;
-			}
+				definition = FindSaved(outfitterEditor, toSearch);
 			else if(type == "shipyard")
-			{
-				auto it = find_if(shipyards.begin(), shipyards.end(),
-						[&toSearch](const Sale<Ship> &s) { return s.Name() == toSearch; });
-				if(it != shipyards.end())
-					shipyardEditor.WriteToFile(writer, &*it);
-				else
-					continue;
-			}
+				definition = FindSaved(shipyardEditor, toSearch);
 			else if(type == "effect")
-			{
-				auto it = find_if(effects.begin(), effects.end(),
-						[&toSearch](const Effect &e) { return e.Name() == toSearch; });
-				if(it != effects.end())
-					effectEditor.WriteToFile(writer, &*it);
-				else
-					continue;
-			}
+				definition = FindSaved(effectEditor, toSearch);
 			else
 			{
 				// If we are here then we encountered an object to save that we don't support yet.
@@ -215,12 +194,20 @@ void Editor::WriteAll()
 				auto it= unimplementedNodes.find(pair);
 				assert(it != unimplementedNodes.end());
 				writer.Write(it->second);
+				writer.Write();
+				continue;
 			}
 
+			if(!definition)
+				continue;
+			writer.WriteLines(*definition);
 			// Add an empty newline between nodes.
 			writer.Write();
 		}
 	}
+
+	// Only the changes that are still unsaved need to be recovered now.
+	LogChanges(true);
 }
 
 
@@ -264,6 +251,14 @@ PlayerInfo &Editor::Player()
 
 
 
+// The edits made in every editor, so they can be undone.
+EditJournal &Editor::Journal()
+{
+	return journal;
+}
+
+
+
 UI &Editor::GetUI()
 {
 	return ui;
@@ -280,13 +275,67 @@ UI &Editor::GetMenu()
 
 void Editor::RenameObject(const std::string &type, const std::string &oldName, const std::string &newName)
 {
-	for(auto &&file : pluginPaths)
-		for(auto &&object : file.second)
+	auto it = pluginFiles.find(make_pair(type, oldName));
+	if(it != pluginFiles.end())
+	{
+		const string file = it->second;
+		for(auto &&object : pluginPaths[file])
 			if(object.first == type && object.second == oldName)
 			{
 				object.second = newName;
 				break;
 			}
+		pluginFiles.erase(it);
+		pluginFiles.emplace(make_pair(type, newName), file);
+	}
+
+	// Everything that refers to the object now has to be saved with its new name.
+	UpdateIndexes();
+	search.Remove(make_pair(type, oldName));
+	for(const ReferenceIndex::Key &user : references.Rename(make_pair(type, oldName), newName))
+		Visit(user, [](auto &editor, const auto *object) { editor.Changed(object); });
+}
+
+
+
+// Loads the given definition on top of the object it defines, the way a plugin
+// that changes the object would, and marks it as unsaved. If it is restoring
+// the object, the object is first reset to the base game's version.
+bool Editor::Apply(const DataNode &node, bool restore)
+{
+	if(node.Size() < 2)
+		return false;
+	const string &key = node.Token(0);
+	// A ship variant is named after its last token.
+	const string &name = key == keyFor<Ship>() && node.Size() >= 3 ? node.Token(2) : node.Token(1);
+	return LoadObject(node, key, name, restore);
+}
+
+
+
+// Renames the given object, and everything that refers to it. Like in the
+// editor's windows, only the objects the current plugin defines can be renamed.
+bool Editor::Rename(const string &type, const string &oldName, const string &newName)
+{
+	if(!pluginFiles.count(make_pair(type, oldName)))
+		return false;
+
+	// Objects that are only referred to still take up their name.
+	bool isTaken = false;
+	Visit(make_pair(type, newName), [&isTaken](auto &, const auto *) { isTaken = true; });
+	if(isTaken)
+		return false;
+
+	bool isRenamed = false;
+	Visit(make_pair(type, oldName), [&newName, &isRenamed](auto &editor, const auto *object)
+		{
+			if(GetName(*object).empty())
+				return;
+			editor.Select(object);
+			editor.Rename(newName);
+			isRenamed = true;
+		});
+	return isRenamed;
 }
 
 
@@ -314,6 +363,42 @@ void Editor::RenderMain()
 		systemEditor.AlwaysRender();
 	if(showPlanetMenu)
 		planetEditor.Render();
+	if(showProfiler)
+		RenderProfiler();
+	if(showLog)
+		RenderLog();
+	if(showUsages)
+		RenderUsages();
+	if(showSearch)
+		RenderSearch();
+
+	// Each edit made with a widget lasts until the user stops using it.
+	if(!ImGui::IsAnyItemActive())
+		journal.Seal();
+	// Waiting for the log to be stored on disk is slow, so only do it once a second.
+	const auto now = chrono::steady_clock::now();
+	if(now - lastLog >= chrono::seconds(1))
+	{
+		LogChanges();
+		UpdateIndexes();
+		lastLog = now;
+	}
+	// Text boxes have their own undo, so only use the shortcuts outside of them.
+	const ImGuiIO &io = ImGui::GetIO();
+	if(io.KeyCtrl && !io.WantTextInput)
+	{
+		if(ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Z)))
+		{
+			if(io.KeyShift)
+				journal.Redo();
+			else
+				journal.Undo();
+		}
+		else if(ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Y)))
+			journal.Redo();
+		else if(ImGui::IsKeyPressed(SDL_SCANCODE_P))
+			showSearch = focusSearch = true;
+	}
 
 	bool newPluginDialog = false;
 	bool openPluginDialog = false;
@@ -334,6 +419,14 @@ void Editor::RenderMain()
 				ShowConfirmationDialog();
 			ImGui::EndMenu();
 		}
+		if(ImGui::BeginMenu("Edit"))
+		{
+			if(ImGui::MenuItem("Undo", "Ctrl+Z", false, journal.CanUndo()))
+				journal.Undo();
+			if(ImGui::MenuItem("Redo", "Ctrl+Y", false, journal.CanRedo()))
+				journal.Redo();
+			ImGui::EndMenu();
+		}
 		if(ImGui::BeginMenu("Editors"))
 		{
 			ImGui::MenuItem("Effect Editor", nullptr, &showEffectMenu);
@@ -361,6 +454,11 @@ void Editor::RenderMain()
 				menu.Push(new MainEditorPanel(player, &systemEditor));
 			if(ImGui::MenuItem("Reload Plugin Resources", nullptr, false, HasPlugin()))
 				ReloadPluginResources();
+			ImGui::MenuItem("Profiler", nullptr, &showProfiler);
+			ImGui::MenuItem("Log", nullptr, &showLog);
+			ImGui::MenuItem("Find Usages", nullptr, &showUsages);
+			if(ImGui::MenuItem("Search", "Ctrl+P"))
+				showSearch = focusSearch = true;
 			ImGui::EndMenu();
 		}
 
@@ -382,71 +480,61 @@ void Editor::RenderMain()
 		{
 			if(!dirtyEffects.empty() && ImGui::BeginMenu("Effects"))
 			{
-				for(auto &&e : dirtyEffects)
-					ImGui::MenuItem(e.second.c_str(), nullptr, false, false);
+				ImGui::ClippedList(dirtyEffects, [](const auto &e) { ImGui::MenuItem(e.second.c_str(), nullptr, false, false); });
 				ImGui::EndMenu();
 			}
 
 			if(!dirtyFleets.empty() && ImGui::BeginMenu("Fleets"))
 			{
-				for(auto &&f : dirtyFleets)
-					ImGui::MenuItem(f.second.c_str(), nullptr, false, false);
+				ImGui::ClippedList(dirtyFleets, [](const auto &f) { ImGui::MenuItem(f.second.c_str(), nullptr, false, false); });
 				ImGui::EndMenu();
 			}
 
 			if(!dirtyHazards.empty() && ImGui::BeginMenu("Hazards"))
 			{
-				for(auto &&h : dirtyHazards)
-					ImGui::MenuItem(h.second.c_str(), nullptr, false, false);
+				ImGui::ClippedList(dirtyHazards, [](const auto &h) { ImGui::MenuItem(h.second.c_str(), nullptr, false, false); });
 				ImGui::EndMenu();
 			}
 
 			if(!dirtyGovernments.empty() && ImGui::BeginMenu("Governments"))
 			{
-				for(auto &&g : dirtyGovernments)
-					ImGui::MenuItem(g.second.c_str(), nullptr, false, false);
+				ImGui::ClippedList(dirtyGovernments, [](const auto &g) { ImGui::MenuItem(g.second.c_str(), nullptr, false, false); });
 				ImGui::EndMenu();
 			}
 
 			if(!dirtyOutfits.empty() && ImGui::BeginMenu("Outfits"))
 			{
-				for(auto &&o : dirtyOutfits)
-					ImGui::MenuItem(o.second.c_str(), nullptr, false, false);
+				ImGui::ClippedList(dirtyOutfits, [](const auto &o) { ImGui::MenuItem(o.second.c_str(), nullptr, false, false); });
 				ImGui::EndMenu();
 			}
 
 			if(!dirtyOutfitters.empty() && ImGui::BeginMenu("Outfitters"))
 			{
-				for(auto &&o : dirtyOutfitters)
-					ImGui::MenuItem(o.second.c_str(), nullptr, false, false);
+				ImGui::ClippedList(dirtyOutfitters, [](const auto &o) { ImGui::MenuItem(o.second.c_str(), nullptr, false, false); });
 				ImGui::EndMenu();
 			}
 
 			if(!dirtyPlanets.empty() && ImGui::BeginMenu("Planets"))
 			{
-				for(auto &&p : dirtyPlanets)
-					ImGui::MenuItem(p.second.c_str(), nullptr, false, false);
+				ImGui::ClippedList(dirtyPlanets, [](const auto &p) { ImGui::MenuItem(p.second.c_str(), nullptr, false, false); });
 				ImGui::EndMenu();
 			}
 
 			if(!dirtyShips.empty() && ImGui::BeginMenu("Ships"))
 			{
-				for(auto &&s : dirtyShips)
-					ImGui::MenuItem(s.second.c_str(), nullptr, false, false);
+				ImGui::ClippedList(dirtyShips, [](const auto &s) { ImGui::MenuItem(s.second.c_str(), nullptr, false, false); });
 				ImGui::EndMenu();
 			}
 
 			if(!dirtyShipyards.empty() && ImGui::BeginMenu("Shipyards"))
 			{
-				for(auto &&s : dirtyShipyards)
-					ImGui::MenuItem(s.second.c_str(), nullptr, false, false);
+				ImGui::ClippedList(dirtyShipyards, [](const auto &s) { ImGui::MenuItem(s.second.c_str(), nullptr, false, false); });
 				ImGui::EndMenu();
 			}
 
 			if(!dirtySystems.empty() && ImGui::BeginMenu("Systems"))
 			{
-				for(auto &&sys : dirtySystems)
-					ImGui::MenuItem(sys.second.c_str(), nullptr, false, false);
+				ImGui::ClippedList(dirtySystems, [](const auto &sys) { ImGui::MenuItem(sys.second.c_str(), nullptr, false, false); });
 				ImGui::EndMenu();
 			}
 
@@ -553,6 +641,8 @@ void Editor::RenderMain()
 		ImGui::SameLine();
 		if(ImGui::Button("Yes"))
 		{
+			// The unsaved changes are discarded, so they should not be recovered either.
+			editLog.Discard();
 			menu.Quit();
 			showConfirmationDialog = false;
 			ImGui::CloseCurrentPopup();
@@ -579,6 +669,290 @@ void Editor::RenderMain()
 
 
 
+// Show how much time the profiled scopes took over the recorded events.
+void Editor::RenderProfiler()
+{
+	if(!ImGui::Begin("Profiler", &showProfiler))
+	{
+		ImGui::End();
+		return;
+	}
+	if(!Profiler::IsAvailable())
+	{
+		ImGui::Text("The profiler was disabled when building the editor.");
+		ImGui::End();
+		return;
+	}
+
+	bool record = Profiler::IsEnabled();
+	if(ImGui::Checkbox("Record", &record))
+		Profiler::SetEnabled(record);
+	ImGui::SameLine();
+	if(ImGui::Button("Clear"))
+		Profiler::Clear();
+	ImGui::SameLine();
+	static string tracePath;
+	if(ImGui::Button("Export Trace"))
+	{
+		tracePath = Files::Config() + "trace.json";
+		Profiler::WriteTrace(tracePath);
+	}
+	if(!tracePath.empty())
+		ImGui::Text("Trace written to \"%s\".", tracePath.c_str());
+
+	// Collecting the events is too slow to do every frame, so only refresh
+	// the totals a few times per second.
+	static double lastUpdate = -1.;
+	static vector<pair<int, vector<ProfileEntry>>> threads;
+	static vector<int64_t> spans;
+	if(lastUpdate < 0. || ImGui::GetTime() - lastUpdate > .5)
+	{
+		lastUpdate = ImGui::GetTime();
+		threads.clear();
+		spans.clear();
+		for(const Profiler::ThreadEvents &thread : Profiler::Events())
+		{
+			if(thread.events.empty())
+				continue;
+
+			// Key each scope by the names of its parents, so that the same
+			// function called from different places is listed separately.
+			map<string, ProfileEntry> totals;
+			vector<pair<int64_t, string>> parents;
+			int64_t end = 0;
+			for(const Profiler::Event &event : thread.events)
+			{
+				while(!parents.empty() && parents.back().first <= event.start)
+					parents.pop_back();
+				string key = (parents.empty() ? "" : parents.back().second + '\n') + event.name;
+				auto it = totals.emplace(key, ProfileEntry{event.name, static_cast<int>(parents.size()), 0, 0}).first;
+				it->second.time += event.duration;
+				++it->second.count;
+				parents.emplace_back(event.start + event.duration, key);
+				end = max(end, event.start + event.duration);
+			}
+
+			threads.emplace_back(thread.thread, vector<ProfileEntry>());
+			for(const auto &it : totals)
+				threads.back().second.push_back(it.second);
+			spans.push_back(end - thread.events.front().start);
+		}
+	}
+
+	for(size_t i = 0; i < threads.size(); ++i)
+	{
+		double span = max<int64_t>(1, spans[i]);
+		string label = "Thread " + to_string(threads[i].first) + " (" + to_string(spans[i] / 1000000) + " ms recorded)";
+		if(!ImGui::TreeNodeEx(label.c_str(), ImGuiTreeNodeFlags_DefaultOpen))
+			continue;
+
+		for(const ProfileEntry &entry : threads[i].second)
+		{
+			float indent = entry.depth * ImGui::GetStyle().IndentSpacing;
+			if(indent)
+				ImGui::Indent(indent);
+			string text = string(entry.name) + ": " + to_string(entry.time / 1000) + " us, "
+				+ to_string(entry.count) + (entry.count == 1 ? " call" : " calls");
+			ImGui::ProgressBar(entry.time / span, ImVec2(-1.f, 0.f), text.c_str());
+			if(indent)
+				ImGui::Unindent(indent);
+		}
+		ImGui::TreePop();
+	}
+
+	ImGui::End();
+}
+
+
+
+// Show the messages that have been logged, filtered by severity and text.
+void Editor::RenderLog()
+{
+	if(!ImGui::Begin("Log", &showLog))
+	{
+		ImGui::End();
+		return;
+	}
+
+	static bool showErrors = true;
+	static bool showWarnings = true;
+	static bool showInfo = false;
+	static ImGuiTextFilter filter;
+	bool changed = ImGui::Checkbox("Errors", &showErrors);
+	ImGui::SameLine();
+	changed |= ImGui::Checkbox("Warnings", &showWarnings);
+	ImGui::SameLine();
+	changed |= ImGui::Checkbox("Info", &showInfo);
+	ImGui::SameLine();
+	changed |= filter.Draw("Filter");
+	ImGui::Separator();
+
+	// Only copy and filter the messages again if something new was logged.
+	static uint64_t count = 0;
+	static vector<Logger::Entry> entries;
+	static vector<int> visible;
+	if(changed || Logger::Count() != count)
+	{
+		count = Logger::Count();
+		entries = Logger::Recent();
+		visible.clear();
+		for(size_t i = 0; i < entries.size(); ++i)
+		{
+			const Logger::Entry &entry = entries[i];
+			bool show = (entry.severity == Logger::Severity::SEVERE) ? showErrors
+				: (entry.severity == Logger::Severity::WARNING) ? showWarnings : showInfo;
+			if(show && (filter.PassFilter(entry.message.c_str()) || filter.PassFilter(entry.location.c_str())))
+				visible.push_back(i);
+		}
+	}
+
+	// Each message only takes up one line, with the rest of it in a tooltip,
+	// so that only the visible lines need to be drawn.
+	ImGui::BeginChild("##messages", ImVec2(0.f, 0.f), false, ImGuiWindowFlags_HorizontalScrollbar);
+	bool atBottom = ImGui::GetScrollY() >= ImGui::GetScrollMaxY();
+	ImGuiListClipper clipper;
+	clipper.Begin(visible.size());
+	while(clipper.Step())
+		for(int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+		{
+			const Logger::Entry &entry = entries[visible[i]];
+			ImVec4 color = ImGui::GetStyleColorVec4(ImGuiCol_Text);
+			if(entry.severity == Logger::Severity::SEVERE)
+				color = ImVec4(1.f, .4f, .4f, 1.f);
+			else if(entry.severity == Logger::Severity::WARNING)
+				color = ImVec4(1.f, .8f, .3f, 1.f);
+
+			size_t end = entry.message.find('\n');
+			ImGui::PushStyleColor(ImGuiCol_Text, color);
+			ImGui::TextUnformatted(entry.message.c_str(), entry.message.c_str() + min(end, entry.message.size()));
+			ImGui::PopStyleColor();
+			if(end != string::npos && ImGui::IsItemHovered())
+				ImGui::SetTooltip("%s", entry.message.c_str());
+			if(!entry.location.empty())
+			{
+				ImGui::SameLine();
+				ImGui::TextDisabled("(%s)", entry.location.c_str());
+			}
+		}
+	// Keep showing the newest messages unless the user has scrolled up.
+	if(atBottom)
+		ImGui::SetScrollHereY(1.f);
+	ImGui::EndChild();
+
+	ImGui::End();
+}
+
+
+
+// Show every object that refers to the given one, and where it is defined.
+void Editor::RenderUsages()
+{
+	if(!ImGui::Begin("Find Usages", &showUsages))
+	{
+		ImGui::End();
+		return;
+	}
+
+	static const char *TYPES[] = {"effect", "fleet", "government", "hazard", "outfit", "outfitter",
+		"planet", "ship", "shipyard", "system"};
+	if(usagesOf.first.empty())
+		usagesOf.first = keyFor<Outfit>();
+	if(ImGui::BeginCombo("type", usagesOf.first.c_str()))
+	{
+		for(const char *type : TYPES)
+			if(ImGui::Selectable(type, usagesOf.first == type))
+				usagesOf.first = type;
+		ImGui::EndCombo();
+	}
+	ImGui::InputText("name", &usagesOf.second);
+
+	auto it = pluginFiles.find(usagesOf);
+	if(it != pluginFiles.end())
+		ImGui::Text("defined in: %s", it->second.c_str());
+	ImGui::Separator();
+
+	UpdateIndexes();
+	const auto &users = references.Users(usagesOf);
+	ImGui::Text("%zu usages", users.size());
+	ImGui::BeginChild("##usages");
+	ImGui::ClippedList(users, [this](const ReferenceIndex::Key &user)
+			{
+				const string label = user.first + " \"" + user.second + "\"";
+				if(ImGui::Selectable(label.c_str()))
+					Visit(user, [](auto &editor, const auto *object)
+							{
+								editor.Select(object);
+								editor.Show();
+							});
+				auto file = pluginFiles.find(user);
+				if(file != pluginFiles.end() && ImGui::IsItemHovered())
+					ImGui::SetTooltip("%s", file->second.c_str());
+			});
+	ImGui::EndChild();
+
+	ImGui::End();
+}
+
+
+
+// Search for objects of any kind by name, and optionally by their attributes.
+void Editor::RenderSearch()
+{
+	if(!ImGui::Begin("Search", &showSearch))
+	{
+		ImGui::End();
+		return;
+	}
+
+	if(focusSearch)
+	{
+		ImGui::SetKeyboardFocusHere();
+		focusSearch = false;
+	}
+	ImGui::InputText("##query", &searchQuery);
+	ImGui::SameLine();
+	ImGui::Checkbox("attributes", &searchAttributes);
+
+	// Objects that are still being indexed show up as soon as they are indexed.
+	UpdateIndexes();
+	static const size_t RESULTS_PER_TYPE = 50;
+	const vector<SearchIndex::Result> results = search.Find(searchQuery, searchAttributes, RESULTS_PER_TYPE);
+	if(search.IsIndexing())
+		ImGui::TextDisabled("indexing... (%zu objects so far)", search.Size());
+	ImGui::Separator();
+
+	ImGui::BeginChild("##results");
+	const string *type = nullptr;
+	for(const SearchIndex::Result &result : results)
+	{
+		if(!type || *type != result.key.first)
+		{
+			type = &result.key.first;
+			ImGui::TextDisabled("%s", type->c_str());
+		}
+		ImGui::PushID(&result);
+		ImGui::Indent();
+		if(ImGui::Selectable(result.key.second.c_str()))
+			Visit(result.key, [](auto &editor, const auto *object)
+					{
+						editor.Select(object);
+						editor.Show();
+					});
+		ImGui::Unindent();
+		if(!result.match.empty())
+		{
+			ImGui::SameLine();
+			ImGui::TextDisabled("(%s)", result.match.c_str());
+		}
+		ImGui::PopID();
+	}
+	ImGui::EndChild();
+
+	ImGui::End();
+}
+
+
+
 void Editor::ShowConfirmationDialog()
 {
 	if(HasUnsavedChanges())
@@ -595,6 +969,8 @@ void Editor::ReloadPluginResources()
 	if(!HasPlugin())
 		return;
 
+	// The images may have been changed outside of the editor.
+	Files::RefreshManifest(currentPlugin);
 	string directoryPath = currentPlugin + "images/";
 	size_t start = directoryPath.size();
 
@@ -630,7 +1006,28 @@ void Editor::ReloadPluginResources()
 
 void AddNode(Editor &editor, const std::string &file, const std::string &key, const std::string &name)
 {
-	editor.pluginPaths[editor.currentPlugin + "data/" + file].emplace_back(std::make_pair(key, name));
+	const string path = editor.currentPlugin + "data/" + file;
+	editor.pluginPaths[path].emplace_back(std::make_pair(key, name));
+	editor.pluginFiles.emplace(std::make_pair(key, name), path);
+}
+
+
+
+EditJournal &JournalFor(Editor &editor)
+{
+	return editor.Journal();
+}
+
+
+
+// Restores the object that the given saved definition defines to the way it
+// was saved.
+void RestoreDefinition(Editor &editor, const std::string &definition)
+{
+	istringstream in(definition);
+	const DataFile data(in);
+	if(data.begin() != data.end())
+		editor.Apply(*data.begin(), true);
 }
 
 
@@ -642,7 +1039,10 @@ void Editor::NewPlugin(const string &plugin)
 	auto plugins = Files::ListDirectories(pluginsPath);
 	for(const auto &existing : plugins)
 		if(existing == plugin)
-			return OpenPlugin(plugin);
+		{
+			OpenPlugin(plugin);
+			return;
+		}
 
 	Files::CreateNewDirectory(pluginsPath + plugin);
 	Files::CreateNewDirectory(pluginsPath + plugin + "/data");
@@ -651,16 +1051,23 @@ void Editor::NewPlugin(const string &plugin)
 
 
 
-void Editor::OpenPlugin(const string &plugin)
+// Opens the given plugin, and returns false if there is no such plugin.
+bool Editor::OpenPlugin(const string &plugin, bool recover)
 {
 	const string path = Files::Config() + "plugins/" + plugin + "/";
 	if(!Files::Exists(path))
-		return;
+		return false;
+	// The plugin may have been changed since the game started.
+	Files::RefreshManifest(path);
+	// Anything that changed in the previous plugin can still be recovered later.
+	LogChanges();
 
 	currentPlugin = path;
 	currentPluginName = plugin;
 	pluginPaths.clear();
+	pluginFiles.clear();
 	unimplementedNodes.clear();
+	references.Clear();
 
 	effectEditor.Clear();
 	fleetEditor.Clear();
@@ -707,6 +1114,7 @@ void Editor::OpenPlugin(const string &plugin)
 				{
 					shipEditor.WriteToPlugin(GameData::Ships().Get(node.Token(2)), false);
 					pluginPaths[file].emplace_back(key, node.Token(2));
+					pluginFiles.emplace(make_pair(key, node.Token(2)), file);
 					continue;
 				}
 				else
@@ -731,24 +1139,222 @@ void Editor::OpenPlugin(const string &plugin)
 			else
 				unimplementedNodes.emplace(std::make_pair(key, value), node);
 
-			bool alreadyExists = false;
-			for(const auto &file : pluginPaths)
-			{
-				for(const auto &pair : file.second)
-					if(key != "phrase" && pair.first == key && pair.second == value)
-					{
-						alreadyExists = true;
-						break;
-					}
-				if(alreadyExists)
-					break;
-			}
-			if(alreadyExists)
+			if(key != "phrase" && pluginFiles.count(make_pair(key, value)))
 				node.PrintTrace("Duplicate node found. This is only partially supported by the game (and by this editor) so it is recommended to avoid duplicating nodes.");
 			else
+			{
 				pluginPaths[file].emplace_back(key, value);
+				pluginFiles.emplace(make_pair(key, value), file);
+			}
 		}
 	}
+
+	// The log is kept next to the plugin, rather than in it, so that it is
+	// never distributed with it. If nothing is recovered, the log is left alone
+	// for the next time the plugin is opened in the editor, and nothing is
+	// logged at all.
+	if(recover)
+	{
+		editLog.Open(Files::Config() + "plugins/" + plugin + ".edits");
+		RecoverChanges();
+	}
+	else
+		editLog.Open("");
+	IndexObjects();
+	return true;
+}
+
+
+
+// Logs every unsaved change to the crash recovery log. Normally only the objects
+// that changed since the last call are added to the end of it, but once the
+// plugin has been written the log is replaced by just the remaining changes.
+void Editor::LogChanges(bool rewrite)
+{
+	if(!HasPlugin() || editLog.Path().empty())
+		return;
+
+	effectEditor.Log(editLog, rewrite);
+	fleetEditor.Log(editLog, rewrite);
+	hazardEditor.Log(editLog, rewrite);
+	governmentEditor.Log(editLog, rewrite);
+	outfitEditor.Log(editLog, rewrite);
+	outfitterEditor.Log(editLog, rewrite);
+	shipEditor.Log(editLog, rewrite);
+	shipyardEditor.Log(editLog, rewrite);
+	planetEditor.Log(editLog, rewrite);
+	systemEditor.Log(editLog, rewrite);
+	if(rewrite)
+		editLog.Rewrite();
+	else
+		editLog.Flush();
+}
+
+
+
+// Loads the given definition of an object on top of it, or on top of its base
+// definition if it is being recovered. Returns false if objects of the given
+// type can't be edited.
+bool Editor::LoadObject(const DataNode &node, const string &key, const string &name, bool recover)
+{
+	if(key == "effect")
+		LoadDefinition(effectEditor, GameData::Effects(), GameData::baseEffects, name, recover,
+				[&node](Effect &effect) { effect.Load(node); });
+	else if(key == "fleet")
+		LoadDefinition(fleetEditor, GameData::Fleets(), GameData::baseFleets, name, recover,
+				[&node](Fleet &fleet) { fleet.Load(node); });
+	else if(key == "hazard")
+		LoadDefinition(hazardEditor, GameData::Hazards(), GameData::baseHazards, name, recover,
+				[&node](Hazard &hazard) { hazard.Load(node); });
+	else if(key == "government")
+		LoadDefinition(governmentEditor, GameData::Governments(), GameData::baseGovernments, name, recover,
+				[&node](Government &government) { government.Load(node); });
+	else if(key == "outfit")
+		LoadDefinition(outfitEditor, GameData::Outfits(), GameData::baseOutfits, name, recover,
+				[&node](Outfit &outfit) { outfit.Load(node); });
+	else if(key == "outfitter")
+		LoadDefinition(outfitterEditor, GameData::Outfitters(), GameData::baseOutfitSales, name, recover,
+				[&node](Sale<Outfit> &outfitter) { outfitter.Load(node, GameData::Outfits()); });
+	else if(key == "ship")
+		LoadDefinition(shipEditor, GameData::Ships(), GameData::baseShips, name, recover,
+				[&node](Ship &ship)
+				{
+					ship.Load(node);
+					ship.FinishLoading(true, &GameData::Ships(), &GameData::Effects());
+				});
+	else if(key == "shipyard")
+		LoadDefinition(shipyardEditor, GameData::Shipyards(), GameData::baseShipSales, name, recover,
+				[&node](Sale<Ship> &shipyard) { shipyard.Load(node, GameData::Ships()); });
+	else if(key == "planet")
+		LoadDefinition(planetEditor, GameData::Planets(), GameData::basePlanets, name, recover,
+				[&node](Planet &planet) { planet.Load(node); });
+	else if(key == "system")
+		LoadDefinition(systemEditor, GameData::Systems(), GameData::baseSystems, name, recover,
+				[&node](System &system)
+				{
+					system.Load(node, const_cast<Set<Planet> &>(GameData::Planets()), true);
+				});
+	else
+		return false;
+	return true;
+}
+
+
+
+// Restores every change that was logged but never saved the last time the
+// current plugin was open, e.g. because the editor crashed.
+void Editor::RecoverChanges()
+{
+	PROFILE_SCOPE("Editor::RecoverChanges");
+	const vector<EditLog::Record> records = EditLog::Read(editLog.Path());
+	int recovered = 0;
+	bool hasSystems = false;
+	for(const EditLog::Record &record : records)
+	{
+		// Objects that were saved or reset are logged without a definition.
+		if(record.definition.empty())
+			continue;
+		istringstream in(record.definition);
+		const DataFile data(in);
+		if(data.begin() == data.end())
+			continue;
+
+		const DataNode &node = *data.begin();
+		if(!LoadObject(node, record.key, record.name, true))
+			continue;
+		hasSystems |= record.key == keyFor<System>();
+		++recovered;
+	}
+	// The neighbors of the recovered systems may have changed.
+	if(hasSystems)
+		GameData::UpdateSystems();
+
+	if(recovered)
+		Logger::Log("Recovered " + to_string(recovered) + " unsaved objects of \"" + currentPluginName + "\".",
+				Logger::Severity::INFO);
+	// Drop everything from the log that is no longer needed, including anything
+	// that was only partially written.
+	LogChanges(true);
+}
+
+
+
+// Finds every object that each object of the game refers to, and starts
+// indexing every object for searching in the background.
+void Editor::IndexObjects()
+{
+	PROFILE_SCOPE("Editor::IndexObjects");
+	references.Clear();
+	search.Clear();
+	IndexAll(effectEditor, GameData::Effects(), references, search);
+	IndexAll(fleetEditor, GameData::Fleets(), references, search);
+	IndexAll(hazardEditor, GameData::Hazards(), references, search);
+	IndexAll(governmentEditor, GameData::Governments(), references, search);
+	IndexAll(outfitEditor, GameData::Outfits(), references, search);
+	IndexAll(outfitterEditor, GameData::Outfitters(), references, search);
+	IndexAll(shipEditor, GameData::Ships(), references, search);
+	IndexAll(shipyardEditor, GameData::Shipyards(), references, search);
+	IndexAll(planetEditor, GameData::Planets(), references, search);
+	IndexAll(systemEditor, GameData::Systems(), references, search);
+}
+
+
+
+// Updates the indexes with the objects that changed since they were last
+// updated, and warns about any deleted object that is still in use.
+void Editor::UpdateIndexes()
+{
+	vector<ReferenceIndex::Key> deleted;
+	effectEditor.UpdateIndex(references, search, deleted);
+	fleetEditor.UpdateIndex(references, search, deleted);
+	hazardEditor.UpdateIndex(references, search, deleted);
+	governmentEditor.UpdateIndex(references, search, deleted);
+	outfitEditor.UpdateIndex(references, search, deleted);
+	outfitterEditor.UpdateIndex(references, search, deleted);
+	shipEditor.UpdateIndex(references, search, deleted);
+	shipyardEditor.UpdateIndex(references, search, deleted);
+	planetEditor.UpdateIndex(references, search, deleted);
+	systemEditor.UpdateIndex(references, search, deleted);
+
+	for(const ReferenceIndex::Key &key : deleted)
+	{
+		const auto &users = references.Users(key);
+		if(users.empty())
+			continue;
+		string message = "The deleted " + key.first + " \"" + key.second + "\" is still used by:";
+		for(const ReferenceIndex::Key &user : users)
+			message += "\n\t" + user.first + " \"" + user.second + "\"";
+		Logger::Log(message, Logger::Severity::WARNING);
+	}
+}
+
+
+
+template <typename F>
+void Editor::Visit(const ReferenceIndex::Key &key, F &&f)
+{
+	const string &type = key.first;
+	const string &name = key.second;
+	if(type == keyFor<Effect>())
+		VisitObject(effectEditor, GameData::Effects(), name, f);
+	else if(type == keyFor<Fleet>())
+		VisitObject(fleetEditor, GameData::Fleets(), name, f);
+	else if(type == keyFor<Hazard>())
+		VisitObject(hazardEditor, GameData::Hazards(), name, f);
+	else if(type == keyFor<Government>())
+		VisitObject(governmentEditor, GameData::Governments(), name, f);
+	else if(type == keyFor<Outfit>())
+		VisitObject(outfitEditor, GameData::Outfits(), name, f);
+	else if(type == keyFor<Sale<Outfit>>())
+		VisitObject(outfitterEditor, GameData::Outfitters(), name, f);
+	else if(type == keyFor<Ship>())
+		VisitObject(shipEditor, GameData::Ships(), name, f);
+	else if(type == keyFor<Sale<Ship>>())
+		VisitObject(shipyardEditor, GameData::Shipyards(), name, f);
+	else if(type == keyFor<Planet>())
+		VisitObject(planetEditor, GameData::Planets(), name, f);
+	else if(type == keyFor<System>())
+		VisitObject(systemEditor, GameData::Systems(), name, f);
 }
 
 
@@ -13,6 +13,8 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #ifndef EDITOR_H_
 #define EDITOR_H_
 
+#include "EditJournal.h"
+#include "EditLog.h"
 #include "EffectEditor.h"
 #include "FleetEditor.h"
 #include "HazardEditor.h"
@@ -20,10 +22,13 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "OutfitEditor.h"
 #include "OutfitterEditor.h"
 #include "PlanetEditor.h"
+#include "ReferenceIndex.h"
+#include "SearchIndex.h"
 #include "ShipEditor.h"
 #include "ShipyardEditor.h"
 #include "SystemEditor.h"
 
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <set>
@@ -32,6 +37,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include <vector>
 
 class Body;
+class DataNode;
 class Engine;
 class PlayerInfo;
 class Sprite;
@@ -75,13 +81,48 @@ public:
 	PlayerInfo &Player();
 	UI &GetUI();
 	UI &GetMenu();
+	// The edits made in every editor, so they can be undone.
+	EditJournal &Journal();
 
 	void RenameObject(const std::string &type, const std::string &oldName, const std::string &newName);
 
+	// Opens the given plugin, and returns false if there is no such plugin.
+	// Unless recovering is turned off (e.g. for a batch script), any unsaved
+	// changes from the last time the plugin was open are recovered, and new
+	// changes are logged so that they can be recovered after a crash.
+	bool OpenPlugin(const std::string &plugin, bool recover = true);
+	// Loads the given definition on top of the object it defines, the way a
+	// plugin that changes the object would, and marks it as unsaved. If it is
+	// restoring the object, the object is first reset to the base game's
+	// version, so that it ends up the way the definition describes. This
+	// doesn't update the neighbors of the systems.
+	bool Apply(const DataNode &node, bool restore = false);
+	// Renames the given object, if the current plugin defines it, and updates
+	// everything that refers to it.
+	bool Rename(const std::string &type, const std::string &oldName, const std::string &newName);
+
 
 private:
 	void NewPlugin(const std::string &plugin);
-	void OpenPlugin(const std::string &plugin);
+	// Logs every unsaved change to the crash recovery log, or restores those that
+	// were logged when the plugin was last open.
+	void LogChanges(bool rewrite = false);
+	void RecoverChanges();
+	// Loads the given definition of an object on top of it, or on top of its
+	// base definition if it is being recovered.
+	bool LoadObject(const DataNode &node, const std::string &key, const std::string &name, bool recover);
+	// Indexes every object, or only the objects that changed since.
+	void IndexObjects();
+	void UpdateIndexes();
+	// Calls the given function with the editor for the given object, and the
+	// object itself, if it exists.
+	template <typename F>
+	void Visit(const ReferenceIndex::Key &key, F &&f);
+
+	void RenderProfiler();
+	void RenderLog();
+	void RenderUsages();
+	void RenderSearch();
 
 	void StyleColorsYellow();
 	void StyleColorsDarkGray();
@@ -92,6 +133,8 @@ private:
 	UI &menu;
 	UI &ui;
 
+	// The journal must outlive the editors that record edits in it.
+	EditJournal journal;
 	EffectEditor effectEditor;
 	FleetEditor fleetEditor;
 	HazardEditor hazardEditor;
@@ -105,6 +148,10 @@ private:
 
 	std::string currentPlugin;
 	std::string currentPluginName;
+	// Every unsaved change is logged, in batches, so that it can be recovered
+	// if the editor crashes.
+	EditLog editLog;
+	std::chrono::steady_clock::time_point lastLog;
 
 	bool showConfirmationDialog = false;
 	bool showEffectMenu = false;
@@ -117,8 +164,22 @@ private:
 	bool showShipyardMenu = false;
 	bool showSystemMenu = false;
 	bool showPlanetMenu = false;
+	bool showProfiler = false;
+	bool showLog = false;
+	bool showUsages = false;
+	bool showSearch = false;
+	bool focusSearch = false;
 
 	std::unordered_map<std::string, std::vector<std::pair<std::string, std::string>>> pluginPaths;
+	// The file of the plugin that defines each object.
+	std::unordered_map<std::pair<std::string, std::string>, std::string, HashPairOfStrings> pluginFiles;
+	// Which objects refer to which others.
+	ReferenceIndex references;
+	ReferenceIndex::Key usagesOf;
+	// Every object, by its name and attributes.
+	SearchIndex search;
+	std::string searchQuery;
+	bool searchAttributes = false;
 	std::unordered_map<std::pair<std::string, std::string>, DataNode, HashPairOfStrings> unimplementedNodes;
 
 	friend void AddNode(Editor &editor, const std::string &file, const std::string &key, const std::string &name);
@@ -53,6 +53,19 @@ EffectEditor::EffectEditor(Editor &editor, bool &show) noexcept
 
 
 
+// Renames the current object, and updates everything that refers to it.
+void EffectEditor::Rename(const string &name)
+{
+	DeleteFromChanges();
+	editor.RenameObject(keyFor<Effect>(), object->name, name);
+	GameData::Effects().Rename(object->name, name);
+	object->name = name;
+	WriteToPlugin(object, false);
+	SetDirty();
+}
+
+
+
 void EffectEditor::Render()
 {
 	if(IsDirty())
@@ -90,14 +103,7 @@ void EffectEditor::Render()
 			if(ImGui::MenuItem("Reset", nullptr, false, object && IsDirty()))
 			{
 				SetClean();
-				bool found = false;
-				for(auto &&change : Changes())
-					if(change.Name() == object->Name())
-					{
-						*object = change;
-						found = true;
-						break;
-					}
+				bool found = RestoreSaved();
 
 				if(!found && GameData::baseEffects.Has(object->name))
 					*object = *GameData::baseEffects.Get(object->name);
@@ -111,10 +117,7 @@ void EffectEditor::Render()
 			}
 			if(ImGui::MenuItem("Delete", nullptr, false, alreadyDefined))
 			{
-				if(find_if(Changes().begin(), Changes().end(), [this](const Effect &effect)
-							{
-								return effect.name == object->name;
-							}) != Changes().end())
+				if(IsSaved())
 				{
 					SetDirty("[deleted]");
 					DeleteFromChanges();
@@ -142,15 +145,7 @@ void EffectEditor::Render()
 				object = newEffect;
 				SetDirty();
 			});
-	ImGui::BeginSimpleRenameModal("Rename Effect", [this](const string &name)
-			{
-				DeleteFromChanges();
-				editor.RenameObject(keyFor<Effect>(), object->name, name);
-				GameData::Effects().Rename(object->name, name);
-				object->name = name;
-				WriteToPlugin(object, false);
-				SetDirty();
-			});
+	ImGui::BeginSimpleRenameModal("Rename Effect", [this](const string &name) { Rename(name); });
 	ImGui::BeginSimpleCloneModal("Clone Effect", [this](const string &name)
 			{
 				auto *clone = const_cast<Effect *>(GameData::Effects().Get(name));
@@ -179,22 +174,22 @@ void EffectEditor::RenderEffect()
 	RenderElement(object, "sprite");
 
 	string soundName = object->sound ? object->sound->Name() : "";
-	if(ImGui::InputCombo("sound", &soundName, &object->sound, Audio::GetSounds()))
+	if(ImGui::InputCombo("sound", &soundName, Track(object->sound), Audio::GetSounds()))
 		SetDirty();
 
-	if(ImGui::InputInt("lifetime", &object->lifetime))
+	if(ImGui::InputInt("lifetime", Track(object->lifetime)))
 		SetDirty();
-	if(ImGui::InputInt("random lifetime", &object->randomLifetime))
+	if(ImGui::InputInt("random lifetime", Track(object->randomLifetime)))
 		SetDirty();
-	if(ImGui::InputDoubleEx("velocity scale", &object->velocityScale))
+	if(ImGui::InputDoubleEx("velocity scale", Track(object->velocityScale)))
 		SetDirty();
-	if(ImGui::InputDoubleEx("random velocity", &object->randomVelocity))
+	if(ImGui::InputDoubleEx("random velocity", Track(object->randomVelocity)))
 		SetDirty();
-	if(ImGui::InputDoubleEx("random angle", &object->randomAngle))
+	if(ImGui::InputDoubleEx("random angle", Track(object->randomAngle)))
 		SetDirty();
-	if(ImGui::InputDoubleEx("random spin", &object->randomSpin))
+	if(ImGui::InputDoubleEx("random spin", Track(object->randomSpin)))
 		SetDirty();
-	if(ImGui::InputDoubleEx("random frame rate", &object->randomFrameRate))
+	if(ImGui::InputDoubleEx("random frame rate", Track(object->randomFrameRate)))
 		SetDirty();
 }
 
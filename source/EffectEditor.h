@@ -31,7 +31,9 @@ public:
 	EffectEditor(Editor &editor, bool &show) noexcept;
 
 	void Render();
-	void WriteToFile(DataWriter &writer, const Effect *effect);
+	// Renames the current object, and updates everything that refers to it.
+	virtual void Rename(const std::string &name) override;
+	virtual void WriteToFile(DataWriter &writer, const Effect *effect) override;
 
 private:
 	void RenderPlanetMenu();
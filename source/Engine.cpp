@@ -42,8 +42,10 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "PointerShader.h"
 #include "Politics.h"
 #include "Preferences.h"
+#include "Profiler.h"
 #include "Projectile.h"
 #include "Random.h"
+#include "Replay.h"
 #include "RingShader.h"
 #include "Screen.h"
 #include "Ship.h"
@@ -59,7 +61,9 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "text/WrappedText.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstring>
 #include <string>
 
 using namespace std;
@@ -105,6 +109,18 @@ namespace {
 			objects.erase(out, objects.end());
 	}
 	
+	template <class Type>
+	void Prune(Pool<Type> &objects)
+	{
+		objects.RemoveIf([](const Type &object) { return object.ShouldBeRemoved(); });
+	}
+	
+	template <class Type>
+	void Prune(Pool<shared_ptr<Type>> &objects)
+	{
+		objects.RemoveIf([](const shared_ptr<Type> &object) { return object->ShouldBeRemoved(); });
+	}
+	
 	template <class Type>
 	void Prune(list<shared_ptr<Type>> &objects)
 	{
@@ -117,13 +133,6 @@ namespace {
 		}
 	}
 	
-	template <class Type>
-	void Append(vector<Type> &objects, vector<Type> &added)
-	{
-		objects.insert(objects.end(), make_move_iterator(added.begin()), make_move_iterator(added.end()));
-		added.clear();
-	}
-	
 	bool CanSendHail(const shared_ptr<const Ship> &ship, const PlayerInfo &player)
 	{
 		const System *playerSystem = player.GetSystem();
@@ -261,6 +270,22 @@ Engine::~Engine()
 
 void Engine::Place()
 {
+	// Each time the player takes off, start a new recording if asked to.
+	if(!Replay::RecordPath().empty())
+	{
+		uint64_t newSeed = (static_cast<uint64_t>(Random::Int()) << 32) | Random::Int();
+		recorder.reset(new Replay);
+		if(recorder->StartRecording(Replay::RecordPath(), player, newSeed))
+		{
+			// Both the placement of the ships and the simulation itself must
+			// start from the recorded seed.
+			Random::Seed(newSeed);
+			SeedSimulation(newSeed);
+		}
+		else
+			recorder.reset();
+	}
+	
 	ships.clear();
 	ai.ClearOrders();
 	
@@ -888,6 +913,99 @@ void Engine::Go()
 
 
 
+// Run one step of calculations on the calling thread, without generating
+// anything to draw. This is used to benchmark the simulation itself.
+void Engine::StepHeadless(const Command &command)
+{
+	isHeadless = true;
+	activeCommands = command;
+	
+	// Let the AI respond to the events of the previous step. There is no
+	// MainPanel to handle them for the player.
+	events.swap(eventQueue);
+	eventQueue.clear();
+	ai.UpdateEvents(events);
+	events.clear();
+	
+	++step;
+	CalculateStep();
+}
+
+
+
+// Seed the random generator used by the simulation, starting with the next
+// step of calculations.
+void Engine::SeedSimulation(uint64_t seed)
+{
+	hasSeed = true;
+	this->seed = seed;
+}
+
+
+
+// Compute a checksum of the state of every ship, to check whether two
+// simulations ended up in exactly the same state.
+uint64_t Engine::Checksum() const
+{
+	// FNV-1a hash of the exact bit patterns of each value.
+	uint64_t hash = 14695981039346656037ull;
+	auto Add = [&hash](double value)
+	{
+		uint64_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		for(int i = 0; i < 8; ++i)
+		{
+			hash ^= (bits >> (8 * i)) & 0xFF;
+			hash *= 1099511628211ull;
+		}
+	};
+	for(const shared_ptr<Ship> &ship : ships)
+	{
+		Add(ship->Position().X());
+		Add(ship->Position().Y());
+		Add(ship->Velocity().X());
+		Add(ship->Velocity().Y());
+		Add(ship->Facing().Degrees());
+		Add(ship->Shields());
+		Add(ship->Hull());
+	}
+	Add(projectiles.size());
+	return hash;
+}
+
+
+
+size_t Engine::Allocations() const
+{
+	return projectiles.Allocations() + visuals.Allocations() + flotsam.Allocations();
+}
+
+
+
+// Get the name of a phase of the calculation step.
+const char *Engine::PhaseName(Phase phase)
+{
+	static const char *NAMES[PHASE_COUNT] = {
+		"AI",
+		"move ships",
+		"move objects",
+		"spawn",
+		"collisions",
+		"fill draw lists"
+	};
+	return (phase >= 0 && phase < PHASE_COUNT) ? NAMES[phase] : "";
+}
+
+
+
+// Get the total time (in seconds) spent in the given phase of the calculation step.
+double Engine::PhaseTime(Phase phase) const
+{
+	return (phase >= 0 && phase < PHASE_COUNT) ? phaseTime[phase] : 0.;
+}
+
+
+
 // Pass the list of game events to MainPanel for handling by the player, and any
 // UI element generation.
 list<ShipEvent> &Engine::Events()
@@ -1308,7 +1426,25 @@ void Engine::ThreadEntryPoint()
 
 void Engine::CalculateStep()
 {
+	PROFILE_SCOPE("Engine::CalculateStep");
 	FrameTimer loadTimer;
+	// Track how long each phase of this step takes.
+	chrono::steady_clock::time_point phaseStart = chrono::steady_clock::now();
+	auto EndPhase = [this, &phaseStart](Phase phase)
+	{
+		chrono::steady_clock::time_point now = chrono::steady_clock::now();
+		phaseTime[phase] += chrono::duration<double>(now - phaseStart).count();
+		phaseStart = now;
+	};
+	
+	// The simulation's random numbers come from the thread it runs on.
+	if(hasSeed)
+	{
+		Random::Seed(seed);
+		hasSeed = false;
+	}
+	if(recorder)
+		recorder->Record(activeCommands);
 	
 	// Clear the list of objects to draw.
 	draw[calcTickTock].Clear(step, zoom);
@@ -1323,6 +1459,7 @@ void Engine::CalculateStep()
 	
 	// Clear the active players commands, they are all processed at this point.
 	activeCommands.Clear();
+	EndPhase(AI_STEP);
 	
 	// Perform actions for all the game objects. In general this is ordered from
 	// bottom to top of the draw stack, but in some cases one object type must
@@ -1367,6 +1504,7 @@ void Engine::CalculateStep()
 		EnterSystem();
 	}
 	Prune(ships);
+	EndPhase(MOVE_SHIPS);
 	
 	// Move the asteroids. This must be done before collision detection. Minables
 	// may create visuals or flotsam.
@@ -1392,6 +1530,7 @@ void Engine::CalculateStep()
 	for(Visual &visual : visuals)
 		visual.Move();
 	Prune(visuals);
+	EndPhase(MOVE_OBJECTS);
 	
 	// Perform various minor actions.
 	SpawnFleets();
@@ -1406,9 +1545,10 @@ void Engine::CalculateStep()
 	// detection) but they should not be moved, which is why we put off adding
 	// them to the lists until now.
 	ships.splice(ships.end(), newShips);
-	Append(projectiles, newProjectiles);
-	flotsam.splice(flotsam.end(), newFlotsam);
-	Append(visuals, newVisuals);
+	projectiles.Append(newProjectiles);
+	flotsam.Append(newFlotsam);
+	visuals.Append(newVisuals);
+	EndPhase(SPAWN);
 	
 	// Decrement the count of how long it's been since a ship last asked for help.
 	if(grudgeTime)
@@ -1427,6 +1567,8 @@ void Engine::CalculateStep()
 	// Damage ships from any active weather events.
 	for(Weather &weather : activeWeather)
 		DoWeather(weather);
+	// The explosions and hits from collisions and weather should be drawn this step.
+	visuals.Append(newVisuals);
 	
 	// Check for flotsam collection (collisions with ships).
 	for(const shared_ptr<Flotsam> &it : flotsam)
@@ -1436,6 +1578,29 @@ void Engine::CalculateStep()
 	for(const shared_ptr<Ship> &it : ships)
 		DoScanning(it);
 	
+	EndPhase(COLLISIONS);
+	
+	// A headless simulation has nothing to draw.
+	if(!isHeadless)
+		FillDrawLists(flagship, playerSystem);
+	EndPhase(FILL_DRAW_LISTS);
+	
+	// Keep track of how much of the CPU time we are using.
+	loadSum += loadTimer.Time();
+	if(++loadCount == 60)
+	{
+		load = loadSum;
+		loadSum = 0.;
+		loadCount = 0;
+	}
+}
+
+
+
+// Fill in the draw lists and radar for this step.
+void Engine::FillDrawLists(const Ship *flagship, const System *playerSystem)
+{
+	PROFILE_SCOPE("Engine::FillDrawLists");
 	// Draw the objects. Start by figuring out where the view should be centered:
 	Point newCenter = center;
 	Point newCenterVelocity;
@@ -1519,15 +1684,6 @@ void Engine::CalculateStep()
 	// Draw the visuals.
 	for(const Visual &visual : visuals)
 		batchDraw[calcTickTock].AddVisual(visual);
-	
-	// Keep track of how much of the CPU time we are using.
-	loadSum += loadTimer.Time();
-	if(++loadCount == 60)
-	{
-		load = loadSum;
-		loadSum = 0.;
-		loadCount = 0;
-	}
 }
 
 
@@ -1536,6 +1692,7 @@ void Engine::CalculateStep()
 // boarding events, fire weapons, and launch fighters.
 void Engine::MoveShip(const shared_ptr<Ship> &ship)
 {
+	PROFILE_SCOPE("Engine::MoveShip");
 	const Ship *flagship = player.Flagship();
 	
 	bool isJump = ship->IsUsingJumpDrive();
@@ -1615,6 +1772,7 @@ void Engine::MoveShip(const shared_ptr<Ship> &ship)
 // Populate the ship collision detection set for projectile & flotsam computations.
 void Engine::FillCollisionSets()
 {
+	PROFILE_SCOPE("Engine::FillCollisionSets");
 	shipCollisions.Clear(step);
 	for(const shared_ptr<Ship> &it : ships)
 		if(it->GetSystem() == player.GetSystem() && it->Zoom() == 1.)
@@ -1933,11 +2091,12 @@ void Engine::HandleMouseClicks()
 
 
 
-// Perform collision detection. Note that unlike the preceding functions, this
-// one adds any visuals that are created directly to the main visuals list. If
-// this is multi-threaded in the future, that will need to change.
+// Perform collision detection. Any visuals that are created are added to the
+// list of new visuals, which is added to the main visuals list once all the
+// collisions have been handled.
 void Engine::DoCollisions(Projectile &projectile)
 {
+	PROFILE_SCOPE("Engine::DoCollisions");
 	// The asteroids can collide with projectiles, the same as any other
 	// object. If the asteroid turns out to be closer than the ship, it
 	// shields the ship (unless the projectile has a blast radius).
@@ -2006,7 +2165,7 @@ void Engine::DoCollisions(Projectile &projectile)
 	{
 		// Create the explosion the given distance along the projectile's
 		// motion path for this step.
-		projectile.Explode(visuals, closestHit, hitVelocity);
+		projectile.Explode(newVisuals, closestHit, hitVelocity);
 		
 		// If this projectile has a blast radius, find all ships within its
 		// radius. Otherwise, only one is damaged.
@@ -2023,7 +2182,7 @@ void Engine::DoCollisions(Projectile &projectile)
 				if(isSafe && projectile.Target() != ship && !gov->IsEnemy(ship->GetGovernment()))
 					continue;
 				
-				int eventType = ship->TakeDamage(visuals, projectile.GetWeapon(), 1.,
+				int eventType = ship->TakeDamage(newVisuals, projectile.GetWeapon(), 1.,
 					projectile.DistanceTraveled(), projectile.Position(), projectile.GetGovernment(), ship != hit.get());
 				if(eventType)
 					eventQueue.emplace_back(gov, ship->shared_from_this(), eventType);
@@ -2031,7 +2190,7 @@ void Engine::DoCollisions(Projectile &projectile)
 		}
 		else if(hit)
 		{
-			int eventType = hit->TakeDamage(visuals, projectile.GetWeapon(), 1.,
+			int eventType = hit->TakeDamage(newVisuals, projectile.GetWeapon(), 1.,
 				projectile.DistanceTraveled(), projectile.Position(), projectile.GetGovernment());
 			if(eventType)
 				eventQueue.emplace_back(gov, hit, eventType);
@@ -2046,7 +2205,7 @@ void Engine::DoCollisions(Projectile &projectile)
 		// a chance to shoot it down.
 		for(Ship *ship : hasAntiMissile)
 			if(ship == projectile.Target() || gov->IsEnemy(ship->GetGovernment()))
-				if(ship->FireAntiMissile(projectile, visuals))
+				if(ship->FireAntiMissile(projectile, newVisuals))
 				{
 					projectile.Kill();
 					break;
@@ -2057,8 +2216,8 @@ void Engine::DoCollisions(Projectile &projectile)
 
 
 // Determine whether any active weather events have impacted the ships within
-// the system. As with DoCollisions, this function adds visuals directly to
-// the main visuals list.
+// the system. As with DoCollisions, any visuals that are created are added to
+// the list of new visuals.
 void Engine::DoWeather(Weather &weather)
 {
 	weather.CalculateStrength();
@@ -2074,7 +2233,7 @@ void Engine::DoWeather(Weather &weather)
 		{
 			Ship *hit = reinterpret_cast<Ship *>(body);
 			double distanceTraveled = hit->Position().Length() - hit->GetMask().Radius();
-			hit->TakeDamage(visuals, *hazard, multiplier, distanceTraveled, Point(), nullptr, hazard->BlastRadius() > 0.);
+			hit->TakeDamage(newVisuals, *hazard, multiplier, distanceTraveled, Point(), nullptr, hazard->BlastRadius() > 0.);
 		}
 	}
 }
@@ -22,10 +22,12 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "EscortDisplay.h"
 #include "Information.h"
 #include "Point.h"
+#include "Pool.h"
 #include "Radar.h"
 #include "Rectangle.h"
 
 #include <condition_variable>
+#include <cstdint>
 #include <list>
 #include <map>
 #include <memory>
@@ -42,9 +44,11 @@ class Outfit;
 class PlanetLabel;
 class PlayerInfo;
 class Projectile;
+class Replay;
 class Ship;
 class ShipEvent;
 class Sprite;
+class System;
 class Visual;
 class Weather;
 
@@ -75,6 +79,33 @@ public:
 	void Step(bool isActive);
 	// Begin the next step of calculations.
 	void Go();
+	// Run one step of calculations on the calling thread, without generating
+	// anything to draw, giving the player's flagship the given commands. This
+	// is used to benchmark or replay the simulation itself.
+	void StepHeadless(const Command &command = Command());
+	// Seed the random generator used by the simulation, starting with the
+	// next step of calculations.
+	void SeedSimulation(uint64_t seed);
+	// Compute a checksum of the state of every ship, to check whether two
+	// simulations ended up in exactly the same state.
+	uint64_t Checksum() const;
+	// How many times the storage of projectiles, visuals and flotsam has had to
+	// grow. Once the simulation has warmed up, this should stop increasing.
+	size_t Allocations() const;
+	
+	// The phases of each calculation step, which are timed separately.
+	enum Phase : int {
+		AI_STEP,
+		MOVE_SHIPS,
+		MOVE_OBJECTS,
+		SPAWN,
+		COLLISIONS,
+		FILL_DRAW_LISTS,
+		PHASE_COUNT
+	};
+	// Get the name of a phase, and the total time (in seconds) spent in it.
+	static const char *PhaseName(Phase phase);
+	double PhaseTime(Phase phase) const;
 	
 	// Get any special events that happened in this step.
 	// MainPanel::Step will clear this list.
@@ -114,6 +145,7 @@ private:
 	void DoCollection(Flotsam &flotsam);
 	void DoScanning(const std::shared_ptr<Ship> &ship);
 	
+	void FillDrawLists(const Ship *flagship, const System *playerSystem);
 	void FillRadar();
 	
 	void AddSprites(const Ship &ship);
@@ -149,16 +181,16 @@ private:
 	PlayerInfo &player;
 	
 	std::list<std::shared_ptr<Ship>> ships;
-	std::vector<Projectile> projectiles;
+	Pool<Projectile> projectiles;
 	std::vector<Weather> activeWeather;
-	std::list<std::shared_ptr<Flotsam>> flotsam;
-	std::vector<Visual> visuals;
+	Pool<std::shared_ptr<Flotsam>> flotsam;
+	Pool<Visual> visuals;
 	AsteroidField asteroids;
 	
 	// New objects created within the latest step:
 	std::list<std::shared_ptr<Ship>> newShips;
 	std::vector<Projectile> newProjectiles;
-	std::list<std::shared_ptr<Flotsam>> newFlotsam;
+	std::vector<std::shared_ptr<Flotsam>> newFlotsam;
 	std::vector<Visual> newVisuals;
 	
 	// Track which ships currently have anti-missiles ready to fire.
@@ -238,6 +270,16 @@ private:
 	double load = 0.;
 	int loadCount = 0;
 	double loadSum = 0.;
+	
+	// Total time spent in each phase of the calculation step.
+	double phaseTime[PHASE_COUNT] = {};
+	// A headless engine only simulates, and never fills in the draw lists.
+	bool isHeadless = false;
+	// The seed to give the random generator at the start of the next step.
+	bool hasSeed = false;
+	uint64_t seed = 0;
+	// The recording of the player's current flight, if any.
+	std::unique_ptr<Replay> recorder;
 
 	friend class Editor;
 };
@@ -13,6 +13,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Files.h"
 
 #include "File.h"
+#include "Logger.h"
 
 #include <SDL2/SDL.h>
 
@@ -21,17 +22,25 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #define STRICT
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
+#include <io.h>
 #endif
 
 #include <sys/stat.h>
 #include <dirent.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <condition_variable>
 #include <cstdlib>
 #include <fstream>
-#include <iostream>
+#include <map>
 #include <mutex>
 #include <stdexcept>
+#include <unordered_map>
+
+#ifndef ES_NO_THREADS
+#include <thread>
+#endif // ES_NO_THREADS
 
 using namespace std;
 
@@ -45,8 +54,23 @@ namespace {
 	string savePath;
 	string testPath;
 	
-	mutex errorMutex;
-	File errorLog;
+	// A regular file or a directory, as it was when its parent was listed.
+	class Entry {
+	public:
+		// The paths of directories end in a '/'.
+		string path;
+		bool isDirectory = false;
+		uint64_t size = 0;
+		time_t timestamp = 0;
+	};
+	
+	// The contents of every directory that BuildManifest() has walked, in the
+	// order the file system listed them, and each of those entries by its path
+	// (without any trailing '/'). Anything the game itself writes to, moves, or
+	// deletes is forgotten, so that it is looked up again the next time.
+	mutex manifestMutex;
+	map<string, vector<Entry>> manifestListings;
+	unordered_map<string, Entry> manifestEntries;
 	
 	// Convert windows-style directory separators ('\\') to standard '/'.
 #if defined _WIN32
@@ -57,6 +81,142 @@ namespace {
 				c = '/';
 	}
 #endif
+	
+	// Get the path that the manifest knows the given file or directory by.
+	string Key(const string &path)
+	{
+		return (!path.empty() && path.back() == '/') ? path.substr(0, path.length() - 1) : path;
+	}
+	
+	// Get the directory (ending in '/') that contains the given path.
+	string Parent(const string &key)
+	{
+		return key.substr(0, key.rfind('/') + 1);
+	}
+	
+	// Get every regular file and directory in the given directory from the
+	// file system. Dotfiles (including "." and "..") are skipped.
+	vector<Entry> ReadEntries(const string &directory)
+	{
+		vector<Entry> entries;
+#if defined _WIN32
+		WIN32_FIND_DATAW ffd;
+		HANDLE hFind = FindFirstFileW(Utf8::ToUTF16(directory + '*').c_str(), &ffd);
+		if(hFind == INVALID_HANDLE_VALUE)
+			return entries;
+		
+		do {
+			if(!ffd.cFileName || ffd.cFileName[0] == '.')
+				continue;
+			
+			entries.emplace_back();
+			Entry &entry = entries.back();
+			entry.path = directory + Utf8::ToUTF8(ffd.cFileName);
+			entry.isDirectory = (ffd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY);
+			if(entry.isDirectory)
+				entry.path += '/';
+			entry.size = (static_cast<uint64_t>(ffd.nFileSizeHigh) << 32) | ffd.nFileSizeLow;
+			// File times are given in 100 ns intervals since the year 1601.
+			uint64_t time = (static_cast<uint64_t>(ffd.ftLastWriteTime.dwHighDateTime) << 32)
+				| ffd.ftLastWriteTime.dwLowDateTime;
+			entry.timestamp = static_cast<time_t>((time - 116444736000000000ull) / 10000000ull);
+		} while(FindNextFileW(hFind, &ffd));
+		
+		FindClose(hFind);
+#else
+		DIR *dir = opendir(directory.c_str());
+		if(!dir)
+			return entries;
+		
+		while(true)
+		{
+			dirent *ent = readdir(dir);
+			if(!ent)
+				break;
+			// Skip dotfiles (including "." and "..").
+			if(ent->d_name[0] == '.')
+				continue;
+			
+			string name = directory + ent->d_name;
+			// Don't assume that this operating system's implementation of dirent
+			// includes the t_type field; in particular, on Windows it will not.
+			struct stat buf;
+			if(stat(name.c_str(), &buf))
+				continue;
+			bool isRegularFile = S_ISREG(buf.st_mode);
+			bool isDirectory = S_ISDIR(buf.st_mode);
+			if(!isRegularFile && !isDirectory)
+				continue;
+			
+			entries.emplace_back();
+			Entry &entry = entries.back();
+			entry.path = std::move(name);
+			entry.isDirectory = isDirectory;
+			if(isDirectory)
+				entry.path += '/';
+			entry.size = buf.st_size;
+			entry.timestamp = buf.st_mtime;
+		}
+		
+		closedir(dir);
+#endif
+		return entries;
+	}
+	
+	// Get the contents of the given directory, from the manifest if possible.
+	vector<Entry> Entries(const string &directory)
+	{
+		{
+			lock_guard<mutex> lock(manifestMutex);
+			auto it = manifestListings.find(directory);
+			if(it != manifestListings.end())
+				return it->second;
+		}
+		return ReadEntries(directory);
+	}
+	
+	// Look up the given path in the manifest. This returns 1 if it exists, 0 if
+	// it is known not to exist, and -1 if the manifest does not know about it.
+	int FindEntry(const string &path, Entry &entry)
+	{
+		string key = Key(path);
+		lock_guard<mutex> lock(manifestMutex);
+		auto it = manifestEntries.find(key);
+		if(it != manifestEntries.end())
+		{
+			entry = it->second;
+			return 1;
+		}
+		return manifestListings.count(Parent(key)) ? 0 : -1;
+	}
+	
+	// Forget what the manifest knows about the given path, because the game is
+	// about to change it.
+	void Forget(const string &path)
+	{
+		string key = Key(path);
+		lock_guard<mutex> lock(manifestMutex);
+		manifestEntries.erase(key);
+		manifestListings.erase(key + '/');
+		manifestListings.erase(Parent(key));
+	}
+	
+	// Forget what the manifest knows about the given directory (which ends in
+	// a '/') and everything in it.
+	void ForgetDirectory(const string &directory)
+	{
+		lock_guard<mutex> lock(manifestMutex);
+		for(auto it = manifestListings.lower_bound(directory);
+				it != manifestListings.end() && !it->first.compare(0, directory.length(), directory); )
+			it = manifestListings.erase(it);
+		for(auto it = manifestEntries.begin(); it != manifestEntries.end(); )
+		{
+			if(!it->first.compare(0, directory.length(), directory))
+				it = manifestEntries.erase(it);
+			else
+				++it;
+		}
+	}
 }
 
 
@@ -224,49 +384,9 @@ vector<string> Files::List(string directory)
 		directory += '/';
 	
 	vector<string> list;
-	
-#if defined _WIN32
-	WIN32_FIND_DATAW ffd;
-	HANDLE hFind = FindFirstFileW(Utf8::ToUTF16(directory + '*').c_str(), &ffd);
-	if(!hFind)
-		return list;
-	
-	do {
-		if(!ffd.cFileName || ffd.cFileName[0] == '.')
-			continue;
-		
-		if(!(ffd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
-			list.push_back(directory + Utf8::ToUTF8(ffd.cFileName));
-	} while(FindNextFileW(hFind, &ffd));
-	
-	FindClose(hFind);
-#else
-	DIR *dir = opendir(directory.c_str());
-	if(!dir)
-		return list;
-	
-	while(true)
-	{
-		dirent *ent = readdir(dir);
-		if(!ent)
-			break;
-		// Skip dotfiles (including "." and "..").
-		if(ent->d_name[0] == '.')
-			continue;
-		
-		string name = directory + ent->d_name;
-		// Don't assume that this operating system's implementation of dirent
-		// includes the t_type field; in particular, on Windows it will not.
-		struct stat buf;
-		stat(name.c_str(), &buf);
-		bool isRegularFile = S_ISREG(buf.st_mode);
-		
-		if(isRegularFile)
-			list.push_back(name);
-	}
-	
-	closedir(dir);
-#endif
+	for(const Entry &entry : Entries(directory))
+		if(!entry.isDirectory)
+			list.push_back(entry.path);
 	return list;
 }
 
@@ -279,53 +399,9 @@ vector<string> Files::ListDirectories(string directory)
 		directory += '/';
 	
 	vector<string> list;
-
-#if defined _WIN32
-	WIN32_FIND_DATAW ffd;
-	HANDLE hFind = FindFirstFileW(Utf8::ToUTF16(directory + '*').c_str(), &ffd);
-	if(!hFind)
-		return list;
-	
-	do {
-		if(!ffd.cFileName || ffd.cFileName[0] == '.')
-			continue;
-		
-		if(ffd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
-			list.push_back(directory + Utf8::ToUTF8(ffd.cFileName) + '/');
-	} while(FindNextFileW(hFind, &ffd));
-	
-	FindClose(hFind);
-#else
-	DIR *dir = opendir(directory.c_str());
-	if(!dir)
-		return list;
-	
-	while(true)
-	{
-		dirent *ent = readdir(dir);
-		if(!ent)
-			break;
-		// Skip dotfiles (including "." and "..").
-		if(ent->d_name[0] == '.')
-			continue;
-		
-		string name = directory + ent->d_name;
-		// Don't assume that this operating system's implementation of dirent
-		// includes the t_type field; in particular, on Windows it will not.
-		struct stat buf;
-		stat(name.c_str(), &buf);
-		bool isDirectory = S_ISDIR(buf.st_mode);
-		
-		if(isDirectory)
-		{
-			if(name.back() != '/')
-				name += '/';
-			list.push_back(name);
-		}
-	}
-	
-	closedir(dir);
-#endif
+	for(const Entry &entry : Entries(directory))
+		if(entry.isDirectory)
+			list.push_back(entry.path);
 	return list;
 }
 
@@ -345,59 +421,108 @@ void Files::RecursiveList(string directory, vector<string> *list)
 	if(directory.empty() || directory.back() != '/')
 		directory += '/';
 	
-#if defined _WIN32
-	WIN32_FIND_DATAW ffd;
-	HANDLE hFind = FindFirstFileW(Utf8::ToUTF16(directory + '*').c_str(), &ffd);
-	if(hFind == INVALID_HANDLE_VALUE)
-		return;
-	
-	do {
-		if(!ffd.cFileName || ffd.cFileName[0] == '.')
-			continue;
-		
-		if(!(ffd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
-			list->push_back(directory + Utf8::ToUTF8(ffd.cFileName));
+	for(const Entry &entry : Entries(directory))
+	{
+		if(!entry.isDirectory)
+			list->push_back(entry.path);
 		else
-			RecursiveList(directory + Utf8::ToUTF8(ffd.cFileName) + '/', list);
-	} while(FindNextFileW(hFind, &ffd));
+			RecursiveList(entry.path, list);
+	}
+}
+
+
+
+// Walk the given directories and remember every file and directory in them.
+// Until they are refreshed, questions about their contents (List(), Exists(),
+// Timestamp(), and so on) are answered without touching the file system. The
+// directories are walked in parallel, which helps most on slow file systems.
+void Files::BuildManifest(const vector<string> &directories)
+{
+	vector<string> pending;
+	for(string directory : directories)
+	{
+		if(directory.empty() || directory.back() != '/')
+			directory += '/';
+		ForgetDirectory(directory);
+		pending.push_back(directory);
+	}
+	
+	mutex pendingMutex;
+	condition_variable pendingCondition;
+	int busy = 0;
+	auto Walk = [&]() -> void
+	{
+		unique_lock<mutex> lock(pendingMutex);
+		while(true)
+		{
+			// Wait until there is a directory to list, or until nothing is left
+			// to list and no other thread can find anything more.
+			pendingCondition.wait(lock, [&]() -> bool { return !pending.empty() || !busy; });
+			if(pending.empty())
+				break;
+			
+			string directory = std::move(pending.back());
+			pending.pop_back();
+			++busy;
+			lock.unlock();
+			
+			vector<Entry> entries = ReadEntries(directory);
+			
+			lock.lock();
+			for(const Entry &entry : entries)
+				if(entry.isDirectory)
+					pending.push_back(entry.path);
+			{
+				lock_guard<mutex> manifestLock(manifestMutex);
+				for(const Entry &entry : entries)
+					manifestEntries[Key(entry.path)] = entry;
+				manifestListings[directory] = std::move(entries);
+			}
+			--busy;
+			pendingCondition.notify_all();
+		}
+	};
 	
-	FindClose(hFind);
+#ifndef ES_NO_THREADS
+	vector<thread> threads;
+	unsigned threadCount = max(1u, min(thread::hardware_concurrency(), 8u));
+	for(unsigned i = 1; i < threadCount; ++i)
+		threads.emplace_back(Walk);
+	Walk();
+	for(thread &it : threads)
+		it.join();
 #else
-	DIR *dir = opendir(directory.c_str());
-	if(!dir)
+	Walk();
+#endif // ES_NO_THREADS
+}
+
+
+
+// Walk the given directory again, because its contents may have been changed
+// by something other than the game.
+void Files::RefreshManifest(const string &directory)
+{
+	if(directory.empty())
 		return;
 	
-	while(true)
+	bool isKnown = false;
 	{
-		dirent *ent = readdir(dir);
-		if(!ent)
-			break;
-		// Skip dotfiles (including "." and "..").
-		if(ent->d_name[0] == '.')
-			continue;
-		
-		string name = directory + ent->d_name;
-		// Don't assume that this operating system's implementation of dirent
-		// includes the t_type field; in particular, on Windows it will not.
-		struct stat buf;
-		stat(name.c_str(), &buf);
-		bool isRegularFile = S_ISREG(buf.st_mode);
-		bool isDirectory = S_ISDIR(buf.st_mode);
-		
-		if(isRegularFile)
-			list->push_back(name);
-		else if(isDirectory)
-			RecursiveList(name + '/', list);
+		lock_guard<mutex> lock(manifestMutex);
+		isKnown = manifestListings.count(directory.back() == '/' ? directory : directory + '/');
 	}
-	
-	closedir(dir);
-#endif
+	if(isKnown)
+		BuildManifest({directory});
 }
 
 
 
 bool Files::Exists(const string &filePath)
 {
+	Entry entry;
+	int known = FindEntry(filePath, entry);
+	if(known >= 0)
+		return known;
+	
 #if defined _WIN32
 	struct _stat buf;
 	return !_wstat(Utf8::ToUTF16(filePath).c_str(), &buf);
@@ -411,6 +536,10 @@ bool Files::Exists(const string &filePath)
 
 time_t Files::Timestamp(const string &filePath)
 {
+	Entry entry;
+	if(FindEntry(filePath, entry) > 0)
+		return entry.timestamp;
+	
 #if defined _WIN32
 	struct _stat buf;
 	_wstat(Utf8::ToUTF16(filePath).c_str(), &buf);
@@ -423,8 +552,31 @@ time_t Files::Timestamp(const string &filePath)
 
 
 
+// Get the size of the given file in bytes, or 0 if it does not exist.
+uint64_t Files::Size(const string &filePath)
+{
+	Entry entry;
+	int known = FindEntry(filePath, entry);
+	if(known >= 0)
+		return entry.size;
+	
+#if defined _WIN32
+	struct _stat buf;
+	if(_wstat(Utf8::ToUTF16(filePath).c_str(), &buf))
+		return 0;
+#else
+	struct stat buf;
+	if(stat(filePath.c_str(), &buf))
+		return 0;
+#endif
+	return buf.st_size;
+}
+
+
+
 void Files::Copy(const string &from, const string &to)
 {
+	Forget(to);
 #if defined _WIN32
 	CopyFileW(Utf8::ToUTF16(from).c_str(), Utf8::ToUTF16(to).c_str(), false);
 #else
@@ -436,6 +588,8 @@ void Files::Copy(const string &from, const string &to)
 
 void Files::Move(const string &from, const string &to)
 {
+	Forget(from);
+	Forget(to);
 #if defined _WIN32
 	MoveFileExW(Utf8::ToUTF16(from).c_str(), Utf8::ToUTF16(to).c_str(), MOVEFILE_REPLACE_EXISTING);
 #else
@@ -447,6 +601,7 @@ void Files::Move(const string &from, const string &to)
 
 void Files::Delete(const string &filePath)
 {
+	Forget(filePath);
 #if defined _WIN32
 	DeleteFileW(Utf8::ToUTF16(filePath).c_str());
 #else
@@ -468,6 +623,7 @@ string Files::Name(const string &path)
 
 void Files::CreateNewDirectory(const string &path)
 {
+	Forget(path);
 #if defined _WIN32
 	if(!CreateDirectoryW(Utf8::ToUTF16(path).c_str(), nullptr))
 		LogError("Failed to create directory at '" + path + "'.");
@@ -480,6 +636,8 @@ void Files::CreateNewDirectory(const string &path)
 
 FILE *Files::Open(const string &path, bool write)
 {
+	if(write)
+		Forget(path);
 #if defined _WIN32
 	return _wfopen(Utf8::ToUTF16(path).c_str(), write ? L"w" : L"rb");
 #else
@@ -489,6 +647,19 @@ FILE *Files::Open(const string &path, bool write)
 
 
 
+// Open a file to add data to the end of it, creating it if necessary.
+FILE *Files::Append(const string &path)
+{
+	Forget(path);
+#if defined _WIN32
+	return _wfopen(Utf8::ToUTF16(path).c_str(), L"ab");
+#else
+	return fopen(path.c_str(), "ab");
+#endif
+}
+
+
+
 string Files::Read(const string &path)
 {
 	File file(path);
@@ -541,21 +712,23 @@ void Files::Write(FILE *file, const string &data)
 
 
 
-void Files::LogError(const string &message)
+// Wait until everything written to the given file is stored on disk.
+void Files::Sync(FILE *file)
 {
-	lock_guard<mutex> lock(errorMutex);
-	cerr << message << endl;
-	if(!errorLog)
-	{
-		errorLog = File(config + "errors.txt", true);
-		if(!errorLog)
-		{
-			cerr << "Unable to create \"errors.txt\" " << (config.empty() ? "in current directory" : "in \"" + config + "\"") << endl;
-			return;
-		}
-	}
+	if(!file)
+		return;
 	
-	Write(errorLog, message);
-	fwrite("\n", 1, 1, errorLog);
-	fflush(errorLog);
+	fflush(file);
+#if defined _WIN32
+	_commit(_fileno(file));
+#else
+	fsync(fileno(file));
+#endif
+}
+
+
+
+void Files::LogError(const string &message)
+{
+	Logger::Log(message, Logger::SeverityOf(message));
 }
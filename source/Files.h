@@ -13,6 +13,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #ifndef FILES_H_
 #define FILES_H_
 
+#include <cstdint>
 #include <cstdio>
 #include <ctime>
 #include <string>
@@ -48,8 +49,19 @@ public:
 	static std::vector<std::string> RecursiveList(const std::string &directory);
 	static void RecursiveList(std::string directory, std::vector<std::string> *list);
 	
+	// Walk the given directories and remember every file and directory in them.
+	// Until they are refreshed, questions about their contents (List(), Exists(),
+	// Timestamp(), and so on) are answered without touching the file system.
+	// Anything the game itself writes to is looked up again automatically.
+	static void BuildManifest(const std::vector<std::string> &directories);
+	// Walk the given directory again if it is in the manifest, because its
+	// contents may have been changed by something other than the game.
+	static void RefreshManifest(const std::string &directory);
+	
 	static bool Exists(const std::string &filePath);
 	static std::time_t Timestamp(const std::string &filePath);
+	// Get the size of the given file in bytes, or 0 if it does not exist.
+	static uint64_t Size(const std::string &filePath);
 	static void Copy(const std::string &from, const std::string &to);
 	static void Move(const std::string &from, const std::string &to);
 	static void Delete(const std::string &filePath);
@@ -60,10 +72,14 @@ public:
 	// File IO.
 	static void CreateNewDirectory(const std::string &path);
 	static FILE *Open(const std::string &path, bool write = false);
+	// Open a file to add data to the end of it, creating it if necessary.
+	static FILE *Append(const std::string &path);
 	static std::string Read(const std::string &path);
 	static std::string Read(FILE *file);
 	static void Write(const std::string &path, const std::string &data);
 	static void Write(FILE *file, const std::string &data);
+	// Wait until everything written to the given file is stored on disk.
+	static void Sync(FILE *file);
 	
 	static void LogError(const std::string &message);
 };
@@ -90,6 +90,19 @@ FleetEditor::FleetEditor(Editor &editor, bool &show) noexcept
 
 
 
+// Renames the current object, and updates everything that refers to it.
+void FleetEditor::Rename(const string &name)
+{
+	DeleteFromChanges();
+	editor.RenameObject(keyFor<Fleet>(), object->fleetName, name);
+	GameData::Fleets().Rename(object->fleetName, name);
+	object->fleetName = name;
+	WriteToPlugin(object, false);
+	SetDirty();
+}
+
+
+
 void FleetEditor::Render()
 {
 	if(IsDirty())
@@ -127,14 +140,7 @@ void FleetEditor::Render()
 			if(ImGui::MenuItem("Reset", nullptr, false, object && IsDirty()))
 			{
 				SetClean();
-				bool found = false;
-				for(auto &&change : Changes())
-					if(change.Name() == object->Name())
-					{
-						*object = change;
-						found = true;
-						break;
-					}
+				bool found = RestoreSaved();
 
 				if(!found && GameData::baseFleets.Has(object->fleetName))
 					*object = *GameData::baseFleets.Get(object->fleetName);
@@ -148,10 +154,7 @@ void FleetEditor::Render()
 			}
 			if(ImGui::MenuItem("Delete", nullptr, false, alreadyDefined))
 			{
-				if(find_if(Changes().begin(), Changes().end(), [this](const Fleet &fleet)
-							{
-								return fleet.fleetName == object->fleetName;
-							}) != Changes().end())
+				if(IsSaved())
 				{
 					SetDirty("[deleted]");
 					DeleteFromChanges();
@@ -179,15 +182,7 @@ void FleetEditor::Render()
 				object = newFleet;
 				SetDirty();
 			});
-	ImGui::BeginSimpleRenameModal("Rename Fleet", [this](const string &name)
-			{
-				DeleteFromChanges();
-				editor.RenameObject(keyFor<Fleet>(), object->fleetName, name);
-				GameData::Fleets().Rename(object->fleetName, name);
-				object->fleetName = name;
-				WriteToPlugin(object, false);
-				SetDirty();
-			});
+	ImGui::BeginSimpleRenameModal("Rename Fleet", [this](const string &name) { Rename(name); });
 	ImGui::BeginSimpleCloneModal("Clone Fleet", [this](const string &name)
 			{
 				auto *clone = const_cast<Fleet *>(GameData::Fleets().Get(name));
@@ -277,7 +272,7 @@ void FleetEditor::RenderFleet()
 		ImGui::EndCombo();
 	}
 
-	if(ImGui::InputInt("cargo", &object->cargo))
+	if(ImGui::InputInt("cargo", Track(object->cargo)))
 		SetDirty();
 	if(ImGui::TreeNode("commodities"))
 	{
@@ -346,7 +341,7 @@ void FleetEditor::RenderFleet()
 	}
 	if(ImGui::TreeNode("personality"))
 	{
-		if(ImGui::InputDoubleEx("confusion", &object->personality.confusionMultiplier))
+		if(ImGui::InputDoubleEx("confusion", Track(object->personality.confusionMultiplier)))
 			SetDirty();
 		bool flag = object->personality.flags & Personality::PACIFIST;
 		if(ImGui::Checkbox("pacifist", &flag))
@@ -868,3 +863,16 @@ void FleetEditor::WriteToFile(DataWriter &writer, const Fleet *fleet)
 	}
 	writer.EndChild();
 }
+
+
+
+// Lists every object the given fleet refers to.
+void FleetEditor::References(const Fleet &fleet, vector<ReferenceIndex::Key> &references) const
+{
+	AddReference(references, fleet.government);
+	for(const auto &variant : fleet.variants)
+		for(const Ship *ship : variant.ships)
+			AddReference(references, ship);
+	for(const auto *outfitter : fleet.outfitters)
+		AddReference(references, outfitter);
+}
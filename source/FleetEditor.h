@@ -31,7 +31,10 @@ public:
 	FleetEditor(Editor &editor, bool &show) noexcept;
 
 	void Render();
-	void WriteToFile(DataWriter &writer, const Fleet *fleet);
+	// Renames the current object, and updates everything that refers to it.
+	virtual void Rename(const std::string &name) override;
+	virtual void WriteToFile(DataWriter &writer, const Fleet *fleet) override;
+	virtual void References(const Fleet &fleet, std::vector<ReferenceIndex::Key> &references) const override;
 
 private:
 	void RenderFleet();
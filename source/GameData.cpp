@@ -14,9 +14,11 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "Audio.h"
 #include "BatchShader.h"
+#include "Benchmark.h"
 #include "Color.h"
 #include "Command.h"
 #include "Conversation.h"
+#include "DataCache.h"
 #include "DataFile.h"
 #include "DataNode.h"
 #include "DataWriter.h"
@@ -33,8 +35,11 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "ImageSet.h"
 #include "Interface.h"
 #include "LineShader.h"
+#include "Logger.h"
+#include "MapBatch.h"
 #include "Minable.h"
 #include "Mission.h"
+#include "MissionIndex.h"
 #include "Music.h"
 #include "News.h"
 #include "Outfit.h"
@@ -69,6 +74,7 @@ class Sprite;
 using namespace std;
 
 namespace {
+	Set<Benchmark> benchmarks;
 	Set<Color> colors;
 	Set<Conversation> conversations;
 	Set<Effect> effects;
@@ -103,6 +109,11 @@ namespace {
 	Set<System> defaultSystems;
 	Set<Planet> defaultPlanets;
 	
+	// Missions are indexed by where they can be offered. The index is rebuilt
+	// the next time it is needed after any mission is (re)loaded.
+	MissionIndex missionIndex;
+	bool missionIndexIsStale = true;
+	
 	Politics politics;
 	vector<StartConditions> startConditions;
 
@@ -202,7 +213,10 @@ bool GameData::BeginLoad(const char * const *argv)
 			continue;
 		}
 	}
-	Files::Init(argv);
+	// Walk every directory that game data may be loaded from just once, rather
+	// than once for each kind of file that is loaded from it.
+	Files::BuildManifest({Files::Data(), Files::Images(), Files::Sounds(),
+		Files::Resources() + "plugins/", Files::Config() + "plugins/"});
 	
 	// Initialize the list of "source" folders based on any active plugins.
 	LoadSources();
@@ -302,19 +316,36 @@ void GameData::LoadData(const string *ignore, bool debugMode)
 		// is, things in folders near the start of the path have the ability to
 		// override things in folders later in the path.
 		vector<string> dataFiles = Files::RecursiveList(source + "data/");
-		for(const string &path : dataFiles)
-			LoadFile(path,
-					debugMode,
-					effects,
-					fleets,
-					hazards,
-					governments,
-					outfits,
-					outfitSales,
-					ships,
-					shipSales,
-					systems,
-					planets);
+		// Only text files contain game data; anything else may be an image.
+		dataFiles.erase(remove_if(dataFiles.begin(), dataFiles.end(),
+				[](const string &path) -> bool
+				{
+					return path.length() < 4 || path.compare(path.length() - 4, 4, ".txt");
+				}),
+			dataFiles.end());
+		auto load = [&](const string &path, const DataFile &data)
+			{
+				LoadFile(path,
+						data,
+						debugMode,
+						effects,
+						fleets,
+						hazards,
+						governments,
+						outfits,
+						outfitSales,
+						ships,
+						shipSales,
+						systems,
+						planets);
+			};
+		// Reading the cache is no faster than parsing the text unless the file
+		// system is slow, so it is only used if it was asked for.
+		if(DataCache::IsEnabled())
+			DataCache::Load(source, dataFiles, load);
+		else
+			for(const string &path : dataFiles)
+				load(path, DataFile(path));
 	}
 	
 	// Now that all data is loaded, update the neighbor lists and other
@@ -721,7 +752,11 @@ void GameData::Change(const DataNode &node, bool initialLoad)
 	else if(node.Token(0) == "galaxy" && node.Size() >= 2 && initialLoad)
 		galaxies.Get(node.Token(1))->Load(node);
 	else if(node.Token(0) == "government" && node.Size() >= 2)
+	{
 		governments.Get(node.Token(1))->Load(node);
+		if(initialLoad)
+			politics.UpdateHostility();
+	}
 	else if(node.Token(0) == "outfitter" && node.Size() >= 2)
 		outfitSales.Get(node.Token(1))->Load(node, ::outfits);
 	else if(node.Token(0) == "planet" && node.Size() >= 2)
@@ -782,6 +817,14 @@ void GameData::UpdateSystem(System *system)
 
 
 
+// Update only the systems affected by the given batch of map edits.
+void GameData::UpdateSystems(MapBatch &batch)
+{
+	batch.Commit(systems, neighborDistances);
+}
+
+
+
 void GameData::AddJumpRange(double neighborDistance)
 {
 	neighborDistances.insert(neighborDistance);
@@ -808,6 +851,13 @@ void GameData::DestroyPersons(vector<string> &names)
 
 
 
+const Set<Benchmark> &GameData::Benchmarks()
+{
+	return benchmarks;
+}
+
+
+
 const Set<Color> &GameData::Colors()
 {
 	return colors;
@@ -887,6 +937,20 @@ const Set<Mission> &GameData::Missions()
 
 
 
+// Get the missions that might be offered when landing on the given planet, in
+// the same order as Missions(). Each must still be checked with CanOffer().
+vector<const Mission *> GameData::MissionsOfferedAt(const Planet *planet)
+{
+	if(missionIndexIsStale)
+	{
+		missionIndex.Build(missions);
+		missionIndexIsStale = false;
+	}
+	return missionIndex.Candidates(planet);
+}
+
+
+
 const Set<News> &GameData::SpaceportNews()
 {
 	return news;
@@ -1160,6 +1224,7 @@ void GameData::LoadSources()
 
 void GameData::LoadFile(
 		const string &path,
+		const DataFile &data,
 		bool debugMode,
 		Set<Effect> &effects,
 		Set<Fleet> &fleets,
@@ -1172,14 +1237,9 @@ void GameData::LoadFile(
 		Set<System> &systems,
 		Set<Planet> &planets)
 {
-	// This is an ordinary file. Check to see if it is an image.
-	if(path.length() < 4 || path.compare(path.length() - 4, 4, ".txt"))
-		return;
-	
 	const bool initialLoad = &effects == &::effects;
-	DataFile data(path);
 	if(debugMode)
-		Files::LogError("Parsing: " + path);
+		Logger::Log("Parsing: " + path, Logger::Severity::INFO);
 	
 	for(const DataNode &node : data)
 	{
@@ -1206,7 +1266,10 @@ void GameData::LoadFile(
 		else if(key == "minable" && node.Size() >= 2 && initialLoad)
 			minables.Get(node.Token(1))->Load(node);
 		else if(key == "mission" && node.Size() >= 2 && initialLoad)
+		{
 			missions.Get(node.Token(1))->Load(node);
+			missionIndexIsStale = true;
+		}
 		else if(key == "outfit" && node.Size() >= 2)
 			outfits.Get(node.Token(1))->Load(node);
 		else if(key == "outfitter" && node.Size() >= 2)
@@ -1244,6 +1307,8 @@ void GameData::LoadFile(
 		}
 		else if(key == "system" && node.Size() >= 2)
 			systems.Get(node.Token(1))->Load(node, ::planets, initialLoad);
+		else if(key == "benchmark" && node.Size() >= 2 && initialLoad)
+			benchmarks.Get(node.Token(1))->Load(node);
 		else if((key == "test") && node.Size() >= 2 && initialLoad)
 			tests.Get(node.Token(1))->Load(node);
 		else if((key == "test-data") && node.Size() >= 2 && initialLoad)
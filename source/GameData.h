@@ -24,8 +24,10 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include <string>
 #include <vector>
 
+class Benchmark;
 class Color;
 class Conversation;
+class DataFile;
 class DataNode;
 class DataWriter;
 class Date;
@@ -37,6 +39,7 @@ class Government;
 class Hazard;
 class ImageSet;
 class Interface;
+class MapBatch;
 class Minable;
 class Mission;
 class News;
@@ -63,6 +66,7 @@ class TestData;
 // universe.
 class GameData {
 public:
+	// Begin loading the game data. Files::Init() must already have been called.
 	static bool BeginLoad(const char * const *argv);
 	static void LoadData(const std::string *ignore = nullptr, bool debugMode = false);
 	// Check for objects that are referred to but never defined.
@@ -94,6 +98,8 @@ public:
 	// This must be done any time that a change creates or moves a system.
 	static void UpdateSystems(bool initialLoad = false);
 	static void UpdateSystem(System *system);
+	// Update only the systems affected by the given batch of map edits.
+	static void UpdateSystems(MapBatch &batch);
 	static void AddJumpRange(double neighborDistance);
 	
 	// Re-activate any special persons that were created previously but that are
@@ -102,6 +108,7 @@ public:
 	// Mark all persons in the given list as dead.
 	static void DestroyPersons(std::vector<std::string> &names);
 	
+	static const Set<Benchmark> &Benchmarks();
 	static const Set<Color> &Colors();
 	static const Set<Conversation> &Conversations();
 	static const Set<Effect> &Effects();
@@ -113,6 +120,9 @@ public:
 	static const Set<Interface> &Interfaces();
 	static const Set<Minable> &Minables();
 	static const Set<Mission> &Missions();
+	// Get the missions that might be offered when landing on the given planet,
+	// in the same order as Missions(). Each must still be checked with CanOffer().
+	static std::vector<const Mission *> MissionsOfferedAt(const Planet *planet);
 	static const Set<News> &SpaceportNews();
 	static const Set<Outfit> &Outfits();
 	static const Set<Sale<Outfit>> &Outfitters();
@@ -163,6 +173,7 @@ private:
 	static void LoadSources();
 	static void LoadFile(
 			const std::string &path,
+			const DataFile &data,
 			bool debugMode,
 			Set<Effect> &effects,
 			Set<Fleet> &fleets,
@@ -267,6 +267,13 @@ void GameWindow::Quit()
 
 
 
+bool GameWindow::HasContext()
+{
+	return context;
+}
+
+
+
 void GameWindow::Step()
 {
 	SDL_GL_SwapWindow(mainWindow);
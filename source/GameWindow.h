@@ -23,6 +23,9 @@ public:
 	static std::string SDLVersions();
 	static bool Init();
 	static void Quit();
+	// Check if a window and OpenGL context exist. Without one (e.g. when
+	// running a headless benchmark) nothing can be uploaded to the GPU.
+	static bool HasContext();
 	
 	// Paint the next frame in the main window.
 	static void Step();
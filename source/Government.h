@@ -138,8 +138,12 @@ private:
 	const Fleet *raidFleet = nullptr;
 	double crewAttack = 1.;
 	double crewDefense = 2.;
+	
+	// The slot this government occupies in the Politics hostility cache.
+	mutable size_t politicsIndex = 0;
 
 	friend class GovernmentEditor;
+	friend class Politics;
 };
 
 
@@ -32,6 +32,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Minable.h"
 #include "Planet.h"
 #include "PlayerInfo.h"
+#include "Politics.h"
 #include "Ship.h"
 #include "ShipEvent.h"
 #include "Sound.h"
@@ -54,6 +55,19 @@ GovernmentEditor::GovernmentEditor(Editor &editor, bool &show) noexcept
 
 
 
+// Renames the current object, and updates everything that refers to it.
+void GovernmentEditor::Rename(const string &name)
+{
+	DeleteFromChanges();
+	editor.RenameObject(keyFor<Government>(), object->TrueName(), name);
+	GameData::Governments().Rename(object->TrueName(), name);
+	object->name = name;
+	WriteToPlugin(object, false);
+	SetDirty();
+}
+
+
+
 void GovernmentEditor::Render()
 {
 	if(IsDirty())
@@ -91,14 +105,7 @@ void GovernmentEditor::Render()
 			if(ImGui::MenuItem("Reset", nullptr, false, object && IsDirty()))
 			{
 				SetClean();
-				bool found = false;
-				for(auto &&change : Changes())
-					if(change.TrueName() == object->TrueName())
-					{
-						*object = change;
-						found = true;
-						break;
-					}
+				bool found = RestoreSaved();
 
 				if(!found && GameData::baseGovernments.Has(object->TrueName()))
 					*object = *GameData::baseGovernments.Get(object->TrueName());
@@ -109,13 +116,11 @@ void GovernmentEditor::Render()
 					GameData::Governments().Erase(object->TrueName());
 					object = nullptr;
 				}
+				GameData::GetPolitics().UpdateHostility();
 			}
 			if(ImGui::MenuItem("Delete", nullptr, false, alreadyDefined))
 			{
-				if(find_if(Changes().begin(), Changes().end(), [this](const Government &gov)
-							{
-								return gov.TrueName() == object->TrueName();
-							}) != Changes().end())
+				if(IsSaved())
 				{
 					SetDirty("[deleted]");
 					DeleteFromChanges();
@@ -124,6 +129,7 @@ void GovernmentEditor::Render()
 					SetClean();
 				GameData::Governments().Erase(object->TrueName());
 				object = nullptr;
+				GameData::GetPolitics().UpdateHostility();
 			}
 			ImGui::EndMenu();
 		}
@@ -141,17 +147,10 @@ void GovernmentEditor::Render()
 				auto *newGov = const_cast<Government *>(GameData::Governments().Get(name));
 				newGov->name = name;
 				object = newGov;
+				GameData::GetPolitics().UpdateHostility();
 				SetDirty();
 			});
-	ImGui::BeginSimpleRenameModal("Rename Government", [this](const string &name)
-			{
-				DeleteFromChanges();
-				editor.RenameObject(keyFor<Government>(), object->TrueName(), name);
-				GameData::Governments().Rename(object->TrueName(), name);
-				object->name = name;
-				WriteToPlugin(object, false);
-				SetDirty();
-			});
+	ImGui::BeginSimpleRenameModal("Rename Government", [this](const string &name) { Rename(name); });
 	ImGui::BeginSimpleCloneModal("Clone Government", [this](const string &name)
 			{
 				auto *clone = const_cast<Government *>(GameData::Governments().Get(name));
@@ -159,6 +158,7 @@ void GovernmentEditor::Render()
 				object = clone;
 
 				object->name = name;
+				GameData::GetPolitics().UpdateHostility();
 				SetDirty();
 			});
 
@@ -176,9 +176,9 @@ void GovernmentEditor::Render()
 
 void GovernmentEditor::RenderGovernment()
 {
-	if(ImGui::InputText("display name", &object->displayName))
+	if(ImGui::InputText("display name", Track(object->displayName)))
 		SetDirty();
-	if(ImGui::InputSwizzle("swizzle", &object->swizzle))
+	if(ImGui::InputSwizzle("swizzle", Track(object->swizzle)))
 		SetDirty();
 	float color[3] = {};
 	color[0] = object->color.Get()[0];
@@ -189,7 +189,7 @@ void GovernmentEditor::RenderGovernment()
 		object->color = Color(color[0], color[1], color[2]);
 		SetDirty();
 	}
-	if(ImGui::InputDoubleEx("player reputation", &object->initialPlayerReputation))
+	if(ImGui::InputDoubleEx("player reputation", Track(object->initialPlayerReputation)))
 		SetDirty();
 	if(ImGui::InputDoubleEx("crew attack", &object->crewAttack))
 	{
@@ -204,6 +204,7 @@ void GovernmentEditor::RenderGovernment()
 
 	if(ImGui::TreeNode("attitude towards"))
 	{
+		bool attitudesChanged = false;
 		auto toRemove = object->attitudeToward.end();
 		const Government *toAdd = nullptr;
 		int index = 0;
@@ -220,6 +221,7 @@ void GovernmentEditor::RenderGovernment()
 					{
 						toAdd = &gov.second;
 						toRemove = it;
+						attitudesChanged = true;
 						SetDirty();
 					}
 					if(selected)
@@ -233,6 +235,7 @@ void GovernmentEditor::RenderGovernment()
 			{
 				if(!it->second)
 					toRemove = it;
+				attitudesChanged = true;
 				SetDirty();
 			}
 			ImGui::PopID();
@@ -244,6 +247,8 @@ void GovernmentEditor::RenderGovernment()
 			if(toAdd)
 				object->attitudeToward[toAdd] = value;
 		}
+		if(attitudesChanged)
+			GameData::GetPolitics().UpdateHostility();
 
 		ImGui::Spacing();
 		if(ImGui::BeginCombo("add government", ""))
@@ -265,24 +270,24 @@ void GovernmentEditor::RenderGovernment()
 
 	if(ImGui::TreeNode("penalty for"))
 	{
-		if(ImGui::InputDoubleEx("assist", &object->penaltyFor[ShipEvent::ASSIST]))
+		if(ImGui::InputDoubleEx("assist", Track(object->penaltyFor[ShipEvent::ASSIST])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("disable", &object->penaltyFor[ShipEvent::DISABLE]))
+		if(ImGui::InputDoubleEx("disable", Track(object->penaltyFor[ShipEvent::DISABLE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("board", &object->penaltyFor[ShipEvent::BOARD]))
+		if(ImGui::InputDoubleEx("board", Track(object->penaltyFor[ShipEvent::BOARD])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("capture", &object->penaltyFor[ShipEvent::CAPTURE]))
+		if(ImGui::InputDoubleEx("capture", Track(object->penaltyFor[ShipEvent::CAPTURE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("destroy", &object->penaltyFor[ShipEvent::DESTROY]))
+		if(ImGui::InputDoubleEx("destroy", Track(object->penaltyFor[ShipEvent::DESTROY])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("atrocity", &object->penaltyFor[ShipEvent::ATROCITY]))
+		if(ImGui::InputDoubleEx("atrocity", Track(object->penaltyFor[ShipEvent::ATROCITY])))
 			SetDirty();
 		ImGui::TreePop();
 	}
 
-	if(ImGui::InputDoubleEx("bribe", &object->bribe))
+	if(ImGui::InputDoubleEx("bribe", Track(object->bribe)))
 		SetDirty();
-	if(ImGui::InputDoubleEx("fine", &object->fine))
+	if(ImGui::InputDoubleEx("fine", Track(object->fine)))
 		SetDirty();
 	string deathSentenceName = object->deathSentence ? object->deathSentence->Name() : "";
 	static Conversation *deathSentence;
@@ -292,7 +297,7 @@ void GovernmentEditor::RenderGovernment()
 		SetDirty();
 	}
 	string friendlyHail = object->friendlyHail ? object->friendlyHail->Name() : "";
-	if(ImGui::InputCombo("friendly hail", &friendlyHail, &object->friendlyHail, GameData::Phrases()))
+	if(ImGui::InputCombo("friendly hail", &friendlyHail, Track(object->friendlyHail), GameData::Phrases()))
 		SetDirty();
 	string friendlyDisabledHail = object->friendlyDisabledHail ? object->friendlyDisabledHail->Name() : "";
 	if(ImGui::InputCombo("friendly disabled hail", &friendlyDisabledHail, &object->friendlyDisabledHail, GameData::Phrases()))
@@ -302,7 +307,7 @@ void GovernmentEditor::RenderGovernment()
 		SetDirty();
 	}
 	string hostileHail = object->hostileHail ? object->hostileHail->Name() : "";
-	if(ImGui::InputCombo("hostile hail", &hostileHail, &object->hostileHail, GameData::Phrases()))
+	if(ImGui::InputCombo("hostile hail", &hostileHail, Track(object->hostileHail), GameData::Phrases()))
 		SetDirty();
 	string hostileDisabledHail = object->hostileDisabledHail? object->hostileDisabledHail->Name() : "";
 	if(ImGui::InputCombo("hostile disabled hail", &hostileDisabledHail, &object->hostileDisabledHail, GameData::Phrases()))
@@ -312,10 +317,10 @@ void GovernmentEditor::RenderGovernment()
 		SetDirty();
 	}
 
-	if(ImGui::InputText("language", &object->language))
+	if(ImGui::InputText("language", Track(object->language)))
 		SetDirty();
 	string raidName = object->raidFleet ? object->raidFleet->Name() : "";
-	if(ImGui::InputCombo("raid fleet", &raidName, &object->raidFleet, GameData::Fleets()))
+	if(ImGui::InputCombo("raid fleet", &raidName, Track(object->raidFleet), GameData::Fleets()))
 		SetDirty();
 
 	static string enforcements;
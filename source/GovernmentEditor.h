@@ -31,7 +31,9 @@ public:
 	GovernmentEditor(Editor &editor, bool &show) noexcept;
 
 	void Render();
-	void WriteToFile(DataWriter &writer, const Government *government);
+	// Renames the current object, and updates everything that refers to it.
+	virtual void Rename(const std::string &name) override;
+	virtual void WriteToFile(DataWriter &writer, const Government *government) override;
 
 private:
 	void RenderGovernment();
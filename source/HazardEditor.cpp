@@ -53,6 +53,19 @@ HazardEditor::HazardEditor(Editor &editor, bool &show) noexcept
 
 
 
+// Renames the current object, and updates everything that refers to it.
+void HazardEditor::Rename(const string &name)
+{
+	DeleteFromChanges();
+	editor.RenameObject(keyFor<Hazard>(), object->name, name);
+	GameData::Hazards().Rename(object->name, name);
+	object->name = name;
+	WriteToPlugin(object, false);
+	SetDirty();
+}
+
+
+
 void HazardEditor::Render()
 {
 	if(IsDirty())
@@ -90,14 +103,7 @@ void HazardEditor::Render()
 			if(ImGui::MenuItem("Reset", nullptr, false, object && IsDirty()))
 			{
 				SetClean();
-				bool found = false;
-				for(auto &&change : Changes())
-					if(change.Name() == object->Name())
-					{
-						*object = change;
-						found = true;
-						break;
-					}
+				bool found = RestoreSaved();
 
 				if(!found && GameData::baseHazards.Has(object->name))
 					*object = *GameData::baseHazards.Get(object->name);
@@ -111,10 +117,7 @@ void HazardEditor::Render()
 			}
 			if(ImGui::MenuItem("Delete", nullptr, false, alreadyDefined))
 			{
-				if(find_if(Changes().begin(), Changes().end(), [this](const Hazard &hazard)
-							{
-								return hazard.name == object->name;
-							}) != Changes().end())
+				if(IsSaved())
 				{
 					SetDirty("[deleted]");
 					DeleteFromChanges();
@@ -142,15 +145,7 @@ void HazardEditor::Render()
 				object = newHazard;
 				SetDirty();
 			});
-	ImGui::BeginSimpleRenameModal("Rename Hazard", [this](const string &name)
-			{
-				DeleteFromChanges();
-				editor.RenameObject(keyFor<Hazard>(), object->name, name);
-				GameData::Hazards().Rename(object->name, name);
-				object->name = name;
-				WriteToPlugin(object, false);
-				SetDirty();
-			});
+	ImGui::BeginSimpleRenameModal("Rename Hazard", [this](const string &name) { Rename(name); });
 	ImGui::BeginSimpleCloneModal("Clone Hazard", [this](const string &name)
 			{
 				auto *clone = const_cast<Hazard *>(GameData::Hazards().Get(name));
@@ -272,38 +267,38 @@ void HazardEditor::RenderHazard()
 
 	if(ImGui::TreeNode("weapon"))
 	{
-		if(ImGui::InputDoubleEx("shield damage", &object->damage[Weapon::SHIELD_DAMAGE]))
+		if(ImGui::InputDoubleEx("shield damage", Track(object->damage[Weapon::SHIELD_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("hull damage", &object->damage[Weapon::HULL_DAMAGE]))
+		if(ImGui::InputDoubleEx("hull damage", Track(object->damage[Weapon::HULL_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("fuel damage", &object->damage[Weapon::FUEL_DAMAGE]))
+		if(ImGui::InputDoubleEx("fuel damage", Track(object->damage[Weapon::FUEL_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("heat damage", &object->damage[Weapon::HEAT_DAMAGE]))
+		if(ImGui::InputDoubleEx("heat damage", Track(object->damage[Weapon::HEAT_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("energy damage", &object->damage[Weapon::ENERGY_DAMAGE]))
+		if(ImGui::InputDoubleEx("energy damage", Track(object->damage[Weapon::ENERGY_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("ion damage", &object->damage[Weapon::ION_DAMAGE]))
+		if(ImGui::InputDoubleEx("ion damage", Track(object->damage[Weapon::ION_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("disruption damage", &object->damage[Weapon::DISRUPTION_DAMAGE]))
+		if(ImGui::InputDoubleEx("disruption damage", Track(object->damage[Weapon::DISRUPTION_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("slowing damage", &object->damage[Weapon::SLOWING_DAMAGE]))
+		if(ImGui::InputDoubleEx("slowing damage", Track(object->damage[Weapon::SLOWING_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("relative shield damage", &object->damage[Weapon::RELATIVE_SHIELD_DAMAGE]))
+		if(ImGui::InputDoubleEx("relative shield damage", Track(object->damage[Weapon::RELATIVE_SHIELD_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("relative hull damage", &object->damage[Weapon::RELATIVE_HULL_DAMAGE]))
+		if(ImGui::InputDoubleEx("relative hull damage", Track(object->damage[Weapon::RELATIVE_HULL_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("relative hull damage", &object->damage[Weapon::RELATIVE_FUEL_DAMAGE]))
+		if(ImGui::InputDoubleEx("relative hull damage", Track(object->damage[Weapon::RELATIVE_FUEL_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("relative heat damage", &object->damage[Weapon::RELATIVE_HEAT_DAMAGE]))
+		if(ImGui::InputDoubleEx("relative heat damage", Track(object->damage[Weapon::RELATIVE_HEAT_DAMAGE])))
 			SetDirty();
 		if(ImGui::InputDoubleEx("piecing", &object->piercing))
 		{
 			object->piercing = max(0., object->piercing);
 			SetDirty();
 		}
-		if(ImGui::InputDoubleEx("hit force", &object->damage[Weapon::HIT_FORCE]))
+		if(ImGui::InputDoubleEx("hit force", Track(object->damage[Weapon::HIT_FORCE])))
 			SetDirty();
-		if(ImGui::Checkbox("gravitational", &object->isGravitational))
+		if(ImGui::Checkbox("gravitational", Track(object->isGravitational)))
 			SetDirty();
 		if(ImGui::InputDoubleEx("blast radius", &object->blastRadius))
 		{
@@ -510,3 +505,12 @@ void HazardEditor::WriteToFile(DataWriter &writer, const Hazard *hazard)
 		writer.EndChild();
 	writer.EndChild();
 }
+
+
+
+// Lists every object the given hazard refers to.
+void HazardEditor::References(const Hazard &hazard, vector<ReferenceIndex::Key> &references) const
+{
+	for(const auto &it : hazard.environmentalEffects)
+		AddReference(references, it.first);
+}
@@ -31,7 +31,10 @@ public:
 	HazardEditor(Editor &editor, bool &show) noexcept;
 
 	void Render();
-	void WriteToFile(DataWriter &writer, const Hazard *hazard);
+	// Renames the current object, and updates everything that refers to it.
+	virtual void Rename(const std::string &name) override;
+	virtual void WriteToFile(DataWriter &writer, const Hazard *hazard) override;
+	virtual void References(const Hazard &hazard, std::vector<ReferenceIndex::Key> &references) const override;
 
 private:
 	void RenderHazard();
@@ -14,6 +14,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "Files.h"
 #include "Mask.h"
+#include "Profiler.h"
 #include "Sprite.h"
 
 #include <algorithm>
@@ -214,6 +215,7 @@ void ImageSet::ValidateFrames() noexcept(false)
 // worker threads. This also generates collision masks if needed.
 void ImageSet::Load() noexcept(false)
 {
+	PROFILE_SCOPE("ImageSet::Load");
 	assert(framePaths[0].empty() && "should call ValidateFrames before calling Load");
 	
 	// Determine how many frames there will be, total. The image buffers will
@@ -269,6 +271,7 @@ void ImageSet::Load() noexcept(false)
 // the paths are saved in case the sprite needs to be loaded again.
 void ImageSet::Upload(Sprite *sprite)
 {
+	PROFILE_SCOPE("ImageSet::Upload");
 	// Load the frames. This will clear the buffers and the mask vector.
 	sprite->AddFrames(buffer[0], false);
 	sprite->AddFrames(buffer[1], true);
@@ -32,6 +32,8 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "PlayerInfo.h"
 #include "Preferences.h"
 #include "Rectangle.h"
+#include "SaveIndex.h"
+#include "SaveQueue.h"
 #include "ShipyardPanel.h"
 #include "StarField.h"
 #include "StartConditionsPanel.h"
@@ -118,6 +120,14 @@ void LoadPanel::Draw()
 	GameData::Background().Draw(Point(), Point());
 	const Font &font = FontSet::Get(14);
 	
+	// If the selected save's header was not known yet, check if it has been
+	// read in the meantime, but only once any headers have been.
+	if(!loadedInfo.IsLoaded() && !selectedFile.empty() && infoGeneration != SaveIndex::Generation())
+	{
+		infoGeneration = SaveIndex::Generation();
+		SaveIndex::Get(Files::Saves() + selectedFile, loadedInfo);
+	}
+	
 	Information info;
 	if(loadedInfo.IsLoaded())
 	{
@@ -303,7 +313,7 @@ bool LoadPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command, boo
 			}
 			selectedFile = it->first;
 		}
-		loadedInfo.Load(Files::Saves() + selectedFile);
+		UpdateInfo();
 	}
 	else if(key == SDLK_LEFT)
 		sideHasFocus = true;
@@ -357,8 +367,7 @@ bool LoadPanel::Click(int x, int y, int clicks)
 	else
 		return false;
 	
-	if(!selectedFile.empty())
-		loadedInfo.Load(Files::Saves() + selectedFile);
+	UpdateInfo();
 	
 	return true;
 }
@@ -407,6 +416,8 @@ bool LoadPanel::Scroll(double dx, double dy)
 void LoadPanel::UpdateLists()
 {
 	files.clear();
+	// Make sure every save has been written before listing them.
+	SaveQueue::Wait();
 	
 	vector<string> fileList = Files::List(Files::Saves());
 	for(const string &path : fileList)
@@ -429,6 +440,15 @@ void LoadPanel::UpdateLists()
 			}
 		);
 	
+	// Read the headers of any saves that have changed since they were last
+	// listed, in the order they are shown, so that browsing through them does
+	// not have to parse each one.
+	vector<string> paths;
+	for(const auto &it : files)
+		for(const auto &fit : it.second)
+			paths.push_back(Files::Saves() + fit.first);
+	SaveIndex::Update(paths);
+	
 	if(!files.empty())
 	{
 		if(selectedPilot.empty())
@@ -439,7 +459,7 @@ void LoadPanel::UpdateLists()
 			if(it != files.end())
 			{
 				selectedFile = it->second.front().first;
-				loadedInfo.Load(Files::Saves() + selectedFile);
+				UpdateInfo();
 			}
 		}
 	}
@@ -447,6 +467,22 @@ void LoadPanel::UpdateLists()
 
 
 
+// Show the header of the selected save, if it has already been read. Otherwise,
+// have it read in the background before any other saves.
+void LoadPanel::UpdateInfo()
+{
+	loadedInfo.Clear();
+	if(selectedFile.empty())
+		return;
+	
+	string path = Files::Saves() + selectedFile;
+	infoGeneration = SaveIndex::Generation();
+	if(!SaveIndex::Get(path, loadedInfo))
+		SaveIndex::Update({path}, true);
+}
+
+
+
 // Snapshot name callback.
 void LoadPanel::SnapshotCallback(const string &name)
 {
@@ -476,13 +512,14 @@ void LoadPanel::SnapshotCallback(const string &name)
 // This name is the one to be used, even if it already exists.
 void LoadPanel::WriteSnapshot(const string &sourceFile, const string &snapshotName)
 {
-	// Copy the autosave to a new, named file.
+	// Copy the autosave to a new, named file, once it has been written.
+	SaveQueue::Wait();
 	Files::Copy(sourceFile, snapshotName);
 	if(Files::Exists(snapshotName))
 	{
 		UpdateLists();
 		selectedFile = Files::Name(snapshotName);
-		loadedInfo.Load(Files::Saves() + selectedFile);
+		UpdateInfo();
 
 #ifdef __EMSCRIPTEN__
 		// sync from persisted state into memory and then
@@ -506,7 +543,7 @@ void LoadPanel::LoadCallback()
 	gamePanels.Reset();
 	gamePanels.CanSave(true);
 	
-	player.Load(loadedInfo.Path());
+	player.Load(Files::Saves() + selectedFile);
 	
 	GetUI()->Pop(this);
 	GetUI()->Pop(GetUI()->Root().get());
@@ -564,7 +601,7 @@ void LoadPanel::DeleteSave()
 	{
 		selectedFile = it->second.front().first;
 		selectedPilot = pilot;
-		loadedInfo.Load(Files::Saves() + selectedFile);
+		UpdateInfo();
 		sideHasFocus = false;
 	}
 }
@@ -18,6 +18,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Point.h"
 #include "SavedGame.h"
 
+#include <cstddef>
 #include <ctime>
 #include <map>
 #include <string>
@@ -50,6 +51,8 @@ protected:
 	
 private:
 	void UpdateLists();
+	// Show the header of the selected save.
+	void UpdateInfo();
 	
 	// Snapshot name callback.
 	void SnapshotCallback(const std::string &name);
@@ -64,6 +67,8 @@ private:
 private:
 	PlayerInfo &player;
 	SavedGame loadedInfo;
+	// The generation of the save index when the selected header was last looked for.
+	size_t infoGeneration = 0;
 	UI &gamePanels;
 	
 	std::map<std::string, std::vector<std::pair<std::string, std::time_t>>> files;
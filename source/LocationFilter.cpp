@@ -266,6 +266,37 @@ bool LocationFilter::IsEmpty() const
 
 
 
+// Get the planets, systems, or governments that a planet must belong to in
+// order to match this filter. Empty sets mean no restriction.
+const set<const Planet *> &LocationFilter::Planets() const
+{
+	return planets;
+}
+
+
+
+const set<const System *> &LocationFilter::Systems() const
+{
+	return systems;
+}
+
+
+
+const set<const Government *> &LocationFilter::Governments() const
+{
+	return governments;
+}
+
+
+
+// A planet must have at least one attribute from each of these sets.
+const list<set<string>> &LocationFilter::Attributes() const
+{
+	return attributes;
+}
+
+
+
 // Check if all of this filter's named content is invalid (e.g. its known members only
 // match to content that is currently unavailable). If at least one valid parameter
 // from every restriction is valid, then this filter is valid.
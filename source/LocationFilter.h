@@ -47,6 +47,14 @@ public:
 	bool IsEmpty() const;
 	bool IsValid() const;
 	
+	// Get the planets, systems, or governments that a planet must belong to
+	// in order to match this filter. Empty sets mean no restriction.
+	const std::set<const Planet *> &Planets() const;
+	const std::set<const System *> &Systems() const;
+	const std::set<const Government *> &Governments() const;
+	// A planet must have at least one attribute from each of these sets.
+	const std::list<std::set<std::string>> &Attributes() const;
+	
 	// If the player is in the given system, does this filter match?
 	bool Matches(const Planet *planet, const System *origin = nullptr) const;
 	bool Matches(const System *system, const System *origin = nullptr) const;
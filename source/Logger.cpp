@@ -0,0 +1,261 @@
+/* Logger.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "Logger.h"
+
+#include "File.h"
+#include "Files.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <mutex>
+
+#ifndef ES_NO_THREADS
+#include <condition_variable>
+#include <thread>
+#endif // ES_NO_THREADS
+
+using namespace std;
+
+namespace {
+	// How many messages to keep in memory for the editor.
+	const size_t RECENT_SIZE = 10000;
+	
+	class Node {
+	public:
+		Logger::Entry entry;
+		Node *next = nullptr;
+	};
+	
+	// Messages that have been logged but not yet written, as a stack: each new
+	// message is pushed onto the front, and the writer takes the whole stack
+	// at once and reverses it, so no thread ever has to wait to log something.
+	atomic<Node *> pending(nullptr);
+	
+	// Only one thread may write at a time, or the batches could be reordered.
+	mutex writeMutex;
+	File errorLog;
+	
+	mutex recentMutex;
+	deque<Logger::Entry> recent;
+	uint64_t count = 0;
+
+#ifndef ES_NO_THREADS
+	mutex wakeMutex;
+	condition_variable wakeCondition;
+	bool isStopping = false;
+	thread writer;
+	terminate_handler previousHandler = nullptr;
+#endif // ES_NO_THREADS
+	atomic<bool> isRunning(false);
+	
+	// Write every message that is still pending. The caller must hold the lock
+	// on the writeMutex.
+	void WritePending()
+	{
+		Node *node = pending.exchange(nullptr, memory_order_acquire);
+		if(!node)
+			return;
+		
+		// Reverse the stack so the messages are in the order they were logged.
+		Node *first = nullptr;
+		while(node)
+		{
+			Node *next = node->next;
+			node->next = first;
+			first = node;
+			node = next;
+		}
+		
+		string text;
+		vector<Logger::Entry> entries;
+		while(first)
+		{
+			text += first->entry.message;
+			text += '\n';
+			entries.push_back(std::move(first->entry));
+			Node *next = first->next;
+			delete first;
+			first = next;
+		}
+		
+		cerr << text;
+		cerr.flush();
+		if(!errorLog)
+		{
+			const string &config = Files::Config();
+			errorLog = File(config + "errors.txt", true);
+			if(!errorLog)
+				cerr << "Unable to create \"errors.txt\" " << (config.empty() ? "in current directory" : "in \"" + config + "\"") << endl;
+		}
+		if(errorLog)
+		{
+			Files::Write(errorLog, text);
+			fflush(errorLog);
+		}
+		
+		lock_guard<mutex> lock(recentMutex);
+		for(Logger::Entry &entry : entries)
+		{
+			// Blank lines only separate messages in the files.
+			if(entry.message.empty())
+				continue;
+			recent.push_back(std::move(entry));
+			if(recent.size() > RECENT_SIZE)
+				recent.pop_front();
+			++count;
+		}
+	}
+
+#ifndef ES_NO_THREADS
+	void WriterLoop()
+	{
+		unique_lock<mutex> lock(wakeMutex);
+		while(!isStopping)
+		{
+			// A message that is logged just before this starts waiting does not
+			// wake it up, so never wait long.
+			wakeCondition.wait_for(lock, chrono::milliseconds(100),
+				[]() -> bool { return isStopping || pending.load(memory_order_relaxed); });
+			lock.unlock();
+			{
+				lock_guard<mutex> writeLock(writeMutex);
+				WritePending();
+			}
+			lock.lock();
+		}
+	}
+	
+	// Write everything that is queued before the program is terminated.
+	[[noreturn]] void TerminateHandler()
+	{
+		// If this thread was already writing when it failed, give up on the
+		// rest rather than waiting for itself.
+		unique_lock<mutex> lock(writeMutex, try_to_lock);
+		if(lock.owns_lock())
+			WritePending();
+		if(previousHandler)
+			previousHandler();
+		abort();
+	}
+#endif // ES_NO_THREADS
+
+	// Make sure the writer stops, and writes everything, when the program exits.
+	class WriterGuard {
+	public:
+		~WriterGuard() { Logger::StopWriter(); }
+	};
+	WriterGuard guard;
+}
+
+
+
+// Add a message to the log.
+void Logger::Log(const string &message, Severity severity, const string &location)
+{
+	Node *node = new Node;
+	node->entry.severity = severity;
+	node->entry.message = message;
+	node->entry.location = location;
+	// Once the node is pushed, the writer may take it at any time, so remember
+	// what it was pushed onto instead of looking at it again.
+	Node *head = pending.load(memory_order_relaxed);
+	do {
+		node->next = head;
+	} while(!pending.compare_exchange_weak(head, node, memory_order_release, memory_order_relaxed));
+	
+	if(!isRunning)
+		Flush();
+#ifndef ES_NO_THREADS
+	// Only the first message of each batch needs to wake up the writer.
+	else if(!head)
+		wakeCondition.notify_one();
+#endif // ES_NO_THREADS
+}
+
+
+
+// Guess how serious a message is from how it is worded: messages that start
+// with "Warning" are warnings, and anything else is an error.
+Logger::Severity Logger::SeverityOf(const string &message)
+{
+	return message.compare(0, 7, "Warning") ? Severity::SEVERE : Severity::WARNING;
+}
+
+
+
+// Block until every message logged so far has been written.
+void Logger::Flush()
+{
+	lock_guard<mutex> lock(writeMutex);
+	WritePending();
+}
+
+
+
+// Start or stop writing messages from a background thread. Any messages that
+// are still queued are written when it stops, or if the program is terminated
+// by an uncaught exception.
+void Logger::StartWriter()
+{
+#ifndef ES_NO_THREADS
+	if(isRunning)
+		return;
+	
+	isStopping = false;
+	writer = thread(WriterLoop);
+	previousHandler = set_terminate(TerminateHandler);
+	isRunning = true;
+#endif // ES_NO_THREADS
+}
+
+
+
+void Logger::StopWriter()
+{
+#ifndef ES_NO_THREADS
+	if(!isRunning)
+		return;
+	
+	{
+		lock_guard<mutex> lock(wakeMutex);
+		isStopping = true;
+	}
+	wakeCondition.notify_one();
+	writer.join();
+	set_terminate(previousHandler);
+	isRunning = false;
+#endif // ES_NO_THREADS
+	Flush();
+}
+
+
+
+// Get the most recently logged messages, oldest first.
+vector<Logger::Entry> Logger::Recent()
+{
+	lock_guard<mutex> lock(recentMutex);
+	return vector<Entry>(recent.begin(), recent.end());
+}
+
+
+
+// Get how many messages have been logged in total, so that a viewer can tell
+// whether anything new has been logged.
+uint64_t Logger::Count()
+{
+	lock_guard<mutex> lock(recentMutex);
+	return count;
+}
@@ -0,0 +1,74 @@
+/* Logger.h
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef LOGGER_H_
+#define LOGGER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+
+// Class for recording errors and warnings. Every message is written to the
+// console and to "errors.txt" in the config directory, and the most recent ones
+// are also kept in memory so that they can be browsed in the editor. Until the
+// writer thread is started, each message is written (and flushed) right away by
+// the thread that logged it. Once it is running, logging a message only adds it
+// to a lock-free queue, and the writer thread writes whatever has accumulated
+// in a single batch, with a single flush.
+class Logger {
+public:
+	// How serious a message is. (Windows defines ERROR as a macro, so that
+	// name cannot be used here.)
+	enum class Severity : int {
+		INFO,
+		WARNING,
+		SEVERE
+	};
+	
+	class Entry {
+	public:
+		Severity severity = Severity::SEVERE;
+		std::string message;
+		// Where the problem is, e.g. the data file and line that caused it.
+		// This is empty if the message is not about any particular place.
+		std::string location;
+	};
+	
+	
+public:
+	// Add a message to the log.
+	static void Log(const std::string &message, Severity severity = Severity::SEVERE,
+		const std::string &location = "");
+	// Guess how serious a message is from how it is worded: messages that
+	// start with "Warning" are warnings, and anything else is an error.
+	static Severity SeverityOf(const std::string &message);
+	// Block until every message logged so far has been written.
+	static void Flush();
+	
+	// Start or stop writing messages from a background thread. Any messages
+	// that are still queued are written when it stops, or if the program is
+	// terminated by an uncaught exception.
+	static void StartWriter();
+	static void StopWriter();
+	
+	// Get the most recently logged messages, oldest first.
+	static std::vector<Entry> Recent();
+	// Get how many messages have been logged in total, so that a viewer can
+	// tell whether anything new has been logged.
+	static uint64_t Count();
+};
+
+
+
+#endif
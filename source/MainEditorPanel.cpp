@@ -57,10 +57,18 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include <algorithm>
 #include <cctype>
 #include <cmath>
+#include <cstdlib>
 #include <limits>
 
 using namespace std;
 
+namespace {
+	// The number of steps to simulate for each frame that is drawn, when fast-forwarding.
+	const int FAST_FORWARD_STEPS = 3;
+	// How many steps it takes for a day to pass, while the stellar objects are orbiting.
+	const int STEPS_PER_DAY = 10;
+}
+
 
 
 MainEditorPanel::MainEditorPanel(PlayerInfo &player, SystemEditor *systemEditor)
@@ -94,6 +102,14 @@ void MainEditorPanel::Step()
 		else if(zoom > zoomTarget)
 			zoom = max(zoomTarget, zoom * (1. / (1. + zoomRatio)));
 	}
+
+	// Only the last of the steps simulated while fast-forwarding gets drawn.
+	for(int i = isFastForward ? FAST_FORWARD_STEPS : 1; i; --i)
+	{
+		preview.Step();
+		if(isOrbiting && !(preview.Steps() % STEPS_PER_DAY))
+			preview.SetDate(preview.GetDate() + 1);
+	}
 }
 
 
@@ -102,8 +118,8 @@ void MainEditorPanel::Draw()
 {
 	glClear(GL_COLOR_BUFFER_BIT);
 	GameData::Background().Draw(center, Point(), zoom);
-	draw.Clear(step, zoom);
-	batchDraw.Clear(step, zoom);
+	draw.Clear(preview.Steps(), zoom);
+	batchDraw.Clear(preview.Steps(), zoom);
 	draw.SetCenter(center);
 	batchDraw.SetCenter(center);
 
@@ -117,13 +133,7 @@ void MainEditorPanel::Draw()
 				draw.Add(object);
 		}
 
-	asteroids.Step(newVisuals, newFlotsam, step);
-	asteroids.Draw(draw, center, zoom);
-	for(const auto &visual : newVisuals)
-		batchDraw.AddVisual(visual);
-	for(const auto &floatsam : newFlotsam)
-		draw.Add(*floatsam);
-	++step;
+	preview.Draw(draw, batchDraw, center, zoom);
 
 	if(currentObject)
 	{
@@ -143,6 +153,19 @@ void MainEditorPanel::Draw()
 
 	draw.Draw();
 	batchDraw.Draw();
+
+	// Show which date the stellar objects are at, if it isn't today.
+	const int days = preview.GetDate() - preview.Today();
+	string status = preview.GetDate().ToString();
+	if(days)
+		status += " (" + Format::Number(abs(days)) + (abs(days) == 1 ? " day " : " days ")
+			+ (days > 0 ? "ahead)" : "ago)");
+	if(isOrbiting)
+		status += ", orbiting";
+	if(isFastForward)
+		status += ", fast-forward";
+	FontSet::Get(14).Draw(status, Point(Screen::Left() + 10., Screen::Bottom() - 24.),
+		*GameData::Colors().Get("medium"));
 }
 
 
@@ -161,6 +184,14 @@ const System *MainEditorPanel::Selected() const
 
 
 
+// The date whose stellar positions are being shown.
+const Date &MainEditorPanel::GetDate() const
+{
+	return preview.GetDate();
+}
+
+
+
 bool MainEditorPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command, bool isNewPress)
 {
 	if(command.Has(Command::MAP) || key == 'd' || key == SDLK_ESCAPE
@@ -170,6 +201,21 @@ bool MainEditorPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &comman
 		Preferences::ZoomViewIn();
 	else if(key == SDLK_MINUS || key == SDLK_KP_MINUS)
 		Preferences::ZoomViewOut();
+	else if(command.Has(Command::FASTFORWARD) && isNewPress)
+		isFastForward = !isFastForward;
+	else if(key == SDLK_SPACE && isNewPress)
+		isOrbiting = !isOrbiting;
+	// Move the stellar objects a day (or a month, with shift) back or forward.
+	else if(key == '[' || key == ']')
+	{
+		const int days = (mod & KMOD_SHIFT) ? 30 : 1;
+		preview.SetDate(preview.GetDate() + (key == '[' ? -days : days));
+	}
+	else if(key == 't')
+	{
+		isOrbiting = false;
+		preview.SetDate(preview.Today());
+	}
 	else
 		return false;
 
@@ -200,6 +246,8 @@ bool MainEditorPanel::Click(int x, int y, int clicks)
 
 bool MainEditorPanel::Drag(double dx, double dy)
 {
+	if(moveStellars && currentObject && !isDragging)
+		systemEditor->BeginEdit();
 	isDragging = true;
 	if(moveStellars && currentObject)
 		systemEditor->UpdateStellarPosition(*currentObject, Point(dx, dy) / zoom, currentSystem);
@@ -228,6 +276,7 @@ bool MainEditorPanel::Release(int x, int y)
 	// only if we didn't move the systems.
 	if(isDragging)
 	{
+		systemEditor->EndEdit();
 		isDragging = false;
 		moveStellars = false;
 		return true;
@@ -251,13 +300,5 @@ void MainEditorPanel::Select(const System *system)
 void MainEditorPanel::UpdateCache()
 {
 	GameData::SetHaze(currentSystem->Haze(), true);
-	asteroids.Clear();
-	for(const System::Asteroid &a : currentSystem->Asteroids())
-	{
-		// Check whether this is a minable or an ordinary asteroid.
-		if(a.Type())
-			asteroids.Add(a.Type(), a.Count(), a.Energy(), currentSystem->AsteroidBelt());
-		else
-			asteroids.Add(a.Name(), a.Count(), a.Energy());
-	}
+	preview.Load(*currentSystem, player.GetDate());
 }
@@ -16,11 +16,11 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "Panel.h"
 
-#include "AsteroidField.h"
 #include "BatchDrawList.h"
 #include "DrawList.h"
 #include "Color.h"
 #include "Point.h"
+#include "SystemPreview.h"
 
 #include <map>
 #include <string>
@@ -48,6 +48,8 @@ public:
 	virtual bool AllowFastForward() const override;
 
 	const System *Selected() const;
+	// The date whose stellar positions are being shown.
+	const Date &GetDate() const;
 
 
 protected:
@@ -68,12 +70,9 @@ protected:
 	// The (non-null) system which is currently selected.
 	const System *currentSystem;
 	const StellarObject *currentObject = nullptr;
-	AsteroidField asteroids;
-	std::list<std::shared_ptr<Flotsam>> newFlotsam;
-	std::vector<Visual> newVisuals;
+	SystemPreview preview;
 
 	Point center;
-	int step = 0;
 	double zoom = 1.;
 
 	void UpdateCache();
@@ -82,6 +81,10 @@ protected:
 private:
 	bool isDragging = false;
 	bool moveStellars = false;
+	// Fast-forward runs several steps of the simulation for each frame drawn.
+	bool isFastForward = false;
+	// Whether the stellar objects are moving along their orbits.
+	bool isOrbiting = false;
 	DrawList draw;
 	BatchDrawList batchDraw;
 
@@ -0,0 +1,131 @@
+/* MapBatch.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "MapBatch.h"
+
+#include "Point.h"
+#include "System.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	using Cell = pair<int, int>;
+	
+	Cell CellOf(const Point &position, double size)
+	{
+		return Cell(floor(position.X() / size), floor(position.Y() / size));
+	}
+	
+	// Check whether a system that sees everything within the given distance
+	// might see one of the given positions, which are sorted into cells of that size.
+	bool IsNear(const Point &position, double distance, const map<Cell, vector<Point>> &cells)
+	{
+		const Cell cell = CellOf(position, distance);
+		for(int x = cell.first - 1; x <= cell.first + 1; ++x)
+			for(int y = cell.second - 1; y <= cell.second + 1; ++y)
+			{
+				auto it = cells.find(Cell(x, y));
+				if(it != cells.end())
+					for(const Point &other : it->second)
+						if(position.Distance(other) <= distance)
+							return true;
+			}
+		return false;
+	}
+}
+
+
+
+// Remember a system that was moved, linked, unlinked or deleted.
+void MapBatch::Touch(const System *system)
+{
+	touched.insert(system);
+}
+
+
+
+bool MapBatch::IsEmpty() const
+{
+	return touched.empty();
+}
+
+
+
+void MapBatch::Clear()
+{
+	touched.clear();
+}
+
+
+
+// Update the neighbors of every system affected by the changes, and forget
+// them. This returns the number of systems that were updated.
+size_t MapBatch::Commit(Set<System> &systems, const set<double> &neighborDistances)
+{
+	if(touched.empty())
+		return 0;
+	
+	// Systems with their own jump range may see farther than any ship can jump.
+	double distance = System::DEFAULT_NEIGHBOR_DISTANCE;
+	if(!neighborDistances.empty())
+		distance = max(distance, *neighborDistances.rbegin());
+	for(const auto &it : systems)
+		distance = max(distance, it.second.JumpRange());
+	
+	// Only the positions of the systems that still exist can be seen. Deleted
+	// systems have no name.
+	map<Cell, vector<Point>> cells;
+	for(const System *system : touched)
+		if(!system->Name().empty())
+			cells[CellOf(system->Position(), distance)].push_back(system->Position());
+	
+	vector<System *> affected;
+	for(auto &it : systems)
+	{
+		System &system = it.second;
+		if(it.first.empty() || system.Name().empty())
+			continue;
+		
+		bool isAffected = touched.count(&system) || IsNear(system.Position(), distance, cells);
+		// A system that could see one of the changed systems before might not
+		// be able to see it anymore.
+		for(auto jt = neighborDistances.begin(); !isAffected && jt != neighborDistances.end(); ++jt)
+			for(const System *neighbor : system.JumpNeighbors(*jt))
+				if(touched.count(neighbor))
+				{
+					isAffected = true;
+					break;
+				}
+		if(!isAffected)
+			for(const System *neighbor : system.VisibleNeighbors())
+				if(touched.count(neighbor))
+				{
+					isAffected = true;
+					break;
+				}
+		if(isAffected)
+			affected.push_back(&system);
+	}
+	
+	// The neighbors of each system are found from the positions and links of the
+	// others, which no longer change, so the order doesn't matter.
+	for(System *system : affected)
+		system->UpdateSystem(systems, neighborDistances);
+	touched.clear();
+	return affected.size();
+}
@@ -0,0 +1,49 @@
+/* MapBatch.h
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef MAP_BATCH_H_
+#define MAP_BATCH_H_
+
+#include "Set.h"
+
+#include <cstddef>
+#include <set>
+#include <unordered_set>
+
+class System;
+
+
+
+// Class collecting the systems changed by a batch of map edits (e.g. moving,
+// linking or deleting a whole region of the map), so that the neighbors of the
+// systems they affect are updated once, after every edit has been made. Only
+// the systems that were changed, that are now close enough to see one of them,
+// or that could see one of them before, have their neighbors updated.
+class MapBatch {
+public:
+	// Remember a system that was moved, linked, unlinked or deleted.
+	void Touch(const System *system);
+	bool IsEmpty() const;
+	void Clear();
+	
+	// Update the neighbors of every system affected by the changes, and forget
+	// them. This returns the number of systems that were updated.
+	size_t Commit(Set<System> &systems, const std::set<double> &neighborDistances);
+	
+	
+private:
+	std::unordered_set<const System *> touched;
+};
+
+
+
+#endif
@@ -55,6 +55,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include <cctype>
 #include <cmath>
 #include <limits>
+#include <string>
 
 using namespace std;
 
@@ -147,6 +148,13 @@ const System *MapEditorPanel::Selected() const
 
 
 
+const vector<const System *> &MapEditorPanel::Selection() const
+{
+	return selectedSystems;
+}
+
+
+
 bool MapEditorPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command, bool isNewPress)
 {
 	const Interface *mapInterface = GameData::Interfaces().Get("map");
@@ -159,6 +167,27 @@ bool MapEditorPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command
 			this, &MapEditorPanel::Find, "Search for:"));
 		return true;
 	}
+	else if(key == SDLK_DELETE || (key == SDLK_BACKSPACE && (mod & (KMOD_CTRL | KMOD_GUI))))
+	{
+		// Deleting systems can't be undone, so ask first.
+		const vector<const System *> systems = systemEditor->Deletable(selectedSystems);
+		if(systems.size() == 1)
+			GetUI()->Push(new Dialog(this, &MapEditorPanel::DeleteSelection,
+				"Delete the system \"" + systems.front()->Name() + "\"? This can't be undone."));
+		else if(!systems.empty())
+			GetUI()->Push(new Dialog(this, &MapEditorPanel::DeleteSelection,
+				"Delete the " + to_string(systems.size()) + " selected systems that this plugin defines?"
+				" This can't be undone."));
+	}
+	else if(key == 'c' && (mod & (KMOD_CTRL | KMOD_GUI)))
+		systemEditor->Copy(selectedSystems);
+	else if(key == 'v' && (mod & (KMOD_CTRL | KMOD_GUI)))
+	{
+		// The copied systems are pasted under the mouse, and become the selection.
+		vector<const System *> pasted = systemEditor->Paste(UI::GetMouse() / Zoom() - center);
+		if(!pasted.empty())
+			selectedSystems = std::move(pasted);
+	}
 	else if(key == SDLK_PLUS || key == SDLK_KP_PLUS || key == SDLK_EQUALS)
 		player.SetMapZoom(min(static_cast<int>(mapInterface->GetValue("max zoom")), player.MapZoom() + 1));
 	else if(key == SDLK_MINUS || key == SDLK_KP_MINUS)
@@ -204,7 +233,11 @@ bool MapEditorPanel::RClick(int x, int y)
 	for(const auto &it : GameData::Systems())
 		if(it.second.IsValid() && click.Distance(it.second.Position()) < 10.)
 		{
-			systemEditor->ToggleLink(&it.second);
+			// Every selected system is linked to (or unlinked from) the clicked one.
+			if(selectedSystems.size() > 1)
+				systemEditor->ToggleLinks(selectedSystems, &it.second);
+			else
+				systemEditor->ToggleLink(&it.second);
 			return true;
 		}
 
@@ -217,6 +250,9 @@ bool MapEditorPanel::RClick(int x, int y)
 
 bool MapEditorPanel::Drag(double dx, double dy)
 {
+	// The neighbors of the moved systems are only updated once they are dropped.
+	if(moveSystems && !isDragging)
+		systemEditor->BeginBatch();
 	isDragging = true;
 	if(moveSystems)
 	{
@@ -256,6 +292,8 @@ bool MapEditorPanel::Scroll(double dx, double dy)
 
 bool MapEditorPanel::Release(int x, int y)
 {
+	if(isDragging && moveSystems)
+		systemEditor->EndBatch();
 	isDragging = false;
 	moveSystems = false;
 
@@ -330,6 +368,14 @@ void MapEditorPanel::Select(const System *system)
 
 
 
+void MapEditorPanel::DeleteSelection()
+{
+	systemEditor->Delete(selectedSystems);
+	Select(nullptr);
+}
+
+
+
 void MapEditorPanel::Find(const string &name)
 {
 	int bestIndex = 9999;
@@ -44,6 +44,7 @@ public:
 	virtual bool AllowFastForward() const override;
 
 	const System *Selected() const;
+	const std::vector<const System *> &Selection() const;
 
 
 protected:
@@ -92,6 +93,9 @@ protected:
 
 
 private:
+	// Delete the selected systems that the plugin defines.
+	void DeleteSelection();
+
 	void DrawWormholes();
 	void DrawLinks();
 	// Draw systems in accordance to the set commodity color scheme.
@@ -517,6 +517,22 @@ bool Mission::IsAtLocation(Location location) const
 
 
 
+// The planet this mission must be offered on (if any), and the filter that
+// planet must match.
+const Planet *Mission::Source() const
+{
+	return source;
+}
+
+
+
+const LocationFilter &Mission::SourceFilter() const
+{
+	return sourceFilter;
+}
+
+
+
 // Information about what you are doing.
 const Planet *Mission::Destination() const
 {
@@ -82,6 +82,10 @@ public:
 	// Find out where this mission is offered.
 	enum Location {SPACEPORT, LANDING, JOB, ASSISTING, BOARDING};
 	bool IsAtLocation(Location location) const;
+	// The planet this mission must be offered on (if any), and the filter
+	// that planet must match.
+	const Planet *Source() const;
+	const LocationFilter &SourceFilter() const;
 	
 	// Information about what you are doing.
 	const Planet *Destination() const;
@@ -0,0 +1,103 @@
+/* MissionIndex.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "MissionIndex.h"
+
+#include "LocationFilter.h"
+#include "Mission.h"
+#include "Planet.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+	template <class Key>
+	void Insert(const map<Key, vector<size_t>> &buckets, const Key &key, vector<size_t> &result)
+	{
+		auto it = buckets.find(key);
+		if(it != buckets.end())
+			result.insert(result.end(), it->second.begin(), it->second.end());
+	}
+}
+
+
+
+// Rebuild the index from the given missions. Missions that are offered when
+// boarding or assisting a ship are not included.
+void MissionIndex::Build(const Set<Mission> &missions)
+{
+	this->missions.clear();
+	byPlanet.clear();
+	bySystem.clear();
+	byGovernment.clear();
+	byAttribute.clear();
+	unrestricted.clear();
+	
+	for(const auto &it : missions)
+	{
+		const Mission &mission = it.second;
+		if(mission.IsAtLocation(Mission::BOARDING) || mission.IsAtLocation(Mission::ASSISTING))
+			continue;
+		
+		const size_t index = this->missions.size();
+		this->missions.push_back(&mission);
+		
+		// A mission only needs to be filed under one restriction, so pick the
+		// one that is likely to match the fewest planets.
+		const LocationFilter &filter = mission.SourceFilter();
+		if(mission.Source())
+			byPlanet[mission.Source()].push_back(index);
+		else if(!filter.Planets().empty())
+			for(const Planet *planet : filter.Planets())
+				byPlanet[planet].push_back(index);
+		else if(!filter.Systems().empty())
+			for(const System *system : filter.Systems())
+				bySystem[system].push_back(index);
+		else if(!filter.Governments().empty())
+			for(const Government *government : filter.Governments())
+				byGovernment[government].push_back(index);
+		else if(!filter.Attributes().empty())
+			for(const string &attribute : filter.Attributes().front())
+				byAttribute[attribute].push_back(index);
+		else
+			unrestricted.push_back(index);
+	}
+}
+
+
+
+// Get every mission that might be offered on the given planet, in the same
+// order as they appear in the set that was indexed.
+vector<const Mission *> MissionIndex::Candidates(const Planet *planet) const
+{
+	vector<const Mission *> result;
+	// No mission can be offered when the player is not on a planet.
+	if(!planet)
+		return result;
+	
+	vector<size_t> indices = unrestricted;
+	Insert(byPlanet, planet, indices);
+	Insert(bySystem, planet->GetSystem(), indices);
+	Insert(byGovernment, planet->GetGovernment(), indices);
+	for(const string &attribute : planet->Attributes())
+		Insert(byAttribute, attribute, indices);
+	
+	// A mission may be filed under more than one of this planet's attributes.
+	sort(indices.begin(), indices.end());
+	indices.erase(unique(indices.begin(), indices.end()), indices.end());
+	
+	result.reserve(indices.size());
+	for(size_t index : indices)
+		result.push_back(missions[index]);
+	return result;
+}
@@ -0,0 +1,61 @@
+/* MissionIndex.h
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef MISSION_INDEX_H_
+#define MISSION_INDEX_H_
+
+#include "Set.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+class Government;
+class Mission;
+class Planet;
+class System;
+
+
+
+// Class for quickly finding the missions that might be offered when landing on
+// a given planet. Each mission is filed under the most specific thing its
+// source planet must be (a particular planet, or a planet in one of a set of
+// systems, owned by one of a set of governments, or having one of a set of
+// attributes). Missions whose source filter has none of these restrictions are
+// candidates everywhere. A candidate must still be checked with CanOffer(), but
+// a mission that is not a candidate could never be offered on that planet.
+class MissionIndex {
+public:
+	// Rebuild the index from the given missions. Missions that are offered
+	// when boarding or assisting a ship are not included.
+	void Build(const Set<Mission> &missions);
+	
+	// Get every mission that might be offered on the given planet, in the
+	// same order as they appear in the set that was indexed.
+	std::vector<const Mission *> Candidates(const Planet *planet) const;
+	
+	
+private:
+	// The indexed missions. The buckets below refer to them by their position
+	// in this list, which is also the order the missions must be offered in.
+	std::vector<const Mission *> missions;
+	
+	std::map<const Planet *, std::vector<size_t>> byPlanet;
+	std::map<const System *, std::vector<size_t>> bySystem;
+	std::map<const Government *, std::vector<size_t>> byGovernment;
+	std::map<std::string, std::vector<size_t>> byAttribute;
+	std::vector<size_t> unrestricted;
+};
+
+
+
+#endif
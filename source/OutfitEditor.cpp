@@ -55,6 +55,19 @@ OutfitEditor::OutfitEditor(Editor &editor, bool &show) noexcept
 
 
 
+// Renames the current object, and updates everything that refers to it.
+void OutfitEditor::Rename(const string &name)
+{
+	DeleteFromChanges();
+	editor.RenameObject(keyFor<Outfit>(), object->name, name);
+	GameData::Outfits().Rename(object->name, name);
+	object->name = name;
+	WriteToPlugin(object, false);
+	SetDirty();
+}
+
+
+
 void OutfitEditor::Render()
 {
 	if(IsDirty())
@@ -92,14 +105,7 @@ void OutfitEditor::Render()
 			if(ImGui::MenuItem("Reset", nullptr, false, object && IsDirty()))
 			{
 				SetClean();
-				bool found = false;
-				for(auto &&change : Changes())
-					if(change.Name() == object->Name())
-					{
-						*object = change;
-						found = true;
-						break;
-					}
+				bool found = RestoreSaved();
 				if(!found && GameData::baseOutfits.Has(object->name))
 					*object = *GameData::baseOutfits.Get(object->name);
 				else if(!found)
@@ -112,10 +118,7 @@ void OutfitEditor::Render()
 			}
 			if(ImGui::MenuItem("Delete", nullptr, false, alreadyDefined))
 			{
-				if(find_if(Changes().begin(), Changes().end(), [this](const Outfit &outfit)
-							{
-								return outfit.name == object->name;
-							}) != Changes().end())
+				if(IsSaved())
 				{
 					SetDirty("[deleted]");
 					DeleteFromChanges();
@@ -168,15 +171,7 @@ void OutfitEditor::Render()
 				object = newOutfit;
 				SetDirty();
 			});
-	ImGui::BeginSimpleRenameModal("Rename Outfit", [this](const string &name)
-			{
-				DeleteFromChanges();
-				editor.RenameObject(keyFor<Outfit>(), object->name, name);
-				GameData::Outfits().Rename(object->name, name);
-				object->name = name;
-				WriteToPlugin(object, false);
-				SetDirty();
-			});
+	ImGui::BeginSimpleRenameModal("Rename Outfit", [this](const string &name) { Rename(name); });
 	ImGui::BeginSimpleCloneModal("Clone Outfit", [this](const string &name)
 			{
 				auto *clone = const_cast<Outfit *>(GameData::Outfits().Get(name));
@@ -220,11 +215,11 @@ void OutfitEditor::RenderOutfit()
 		}
 		ImGui::EndCombo();
 	}
-	if(ImGui::InputText("plural", &object->pluralName))
+	if(ImGui::InputText("plural", Track(object->pluralName)))
 		SetDirty();
-	if(ImGui::InputInt64Ex("cost", &object->cost))
+	if(ImGui::InputInt64Ex("cost", Track(object->cost)))
 		SetDirty();
-	if(ImGui::InputDoubleEx("mass", &object->mass))
+	if(ImGui::InputDoubleEx("mass", Track(object->mass)))
 		SetDirty();
 
 	str.clear();
@@ -247,7 +242,7 @@ void OutfitEditor::RenderOutfit()
 		SetDirty();
 	}
 
-	if(ImGui::InputTextMultiline("description", &object->description, ImVec2(), ImGuiInputTextFlags_EnterReturnsTrue))
+	if(ImGui::InputTextMultiline("description", Track(object->description), ImVec2(), ImGuiInputTextFlags_EnterReturnsTrue))
 		SetDirty();
 
 	int index = 0;
@@ -352,19 +347,19 @@ void OutfitEditor::RenderOutfit()
 	if(ImGui::TreeNode("weapon"))
 	{
 		bool isClustered = false;
-		if(ImGui::Checkbox("stream", &object->isStreamed))
+		if(ImGui::Checkbox("stream", Track(object->isStreamed)))
 			SetDirty();
 		if(ImGui::Checkbox("cluster", &isClustered))
 			SetDirty();
-		if(ImGui::Checkbox("safe", &object->isSafe))
+		if(ImGui::Checkbox("safe", Track(object->isSafe)))
 			SetDirty();
-		if(ImGui::Checkbox("phasing", &object->isPhasing))
+		if(ImGui::Checkbox("phasing", Track(object->isPhasing)))
 			SetDirty();
-		if(ImGui::Checkbox("no damage scaling", &object->isDamageScaled))
+		if(ImGui::Checkbox("no damage scaling", Track(object->isDamageScaled)))
 			SetDirty();
-		if(ImGui::Checkbox("parallel", &object->isParallel))
+		if(ImGui::Checkbox("parallel", Track(object->isParallel)))
 			SetDirty();
-		if(ImGui::Checkbox("gravitational", &object->isGravitational))
+		if(ImGui::Checkbox("gravitational", Track(object->isGravitational)))
 			SetDirty();
 		RenderElement(&object->sprite, "sprite");
 		RenderElement(&object->hardpointSprite, "hardpoint sprite");
@@ -389,7 +384,7 @@ void OutfitEditor::RenderOutfit()
 					SetDirty();
 				}
 			ImGui::SameLine();
-			if(ImGui::InputInt("##usage", &object->ammo.second))
+			if(ImGui::InputInt("##usage", Track(object->ammo.second)))
 				SetDirty();
 			ImGui::TreePop();
 		}
@@ -496,7 +491,7 @@ void OutfitEditor::RenderOutfit()
 			object->burstCount = max(1, object->burstCount);
 			SetDirty();
 		}
-		if(ImGui::InputInt("homing", &object->homing))
+		if(ImGui::InputInt("homing", Track(object->homing)))
 			SetDirty();
 		if(ImGui::InputInt("missile strength", &object->missileStrength))
 		{
@@ -508,13 +503,13 @@ void OutfitEditor::RenderOutfit()
 			object->antiMissile = max(0, object->antiMissile);
 			SetDirty();
 		}
-		if(ImGui::InputDoubleEx("velocity", &object->velocity))
+		if(ImGui::InputDoubleEx("velocity", Track(object->velocity)))
 			SetDirty();
-		if(ImGui::InputDoubleEx("random velocity", &object->randomVelocity))
+		if(ImGui::InputDoubleEx("random velocity", Track(object->randomVelocity)))
 			SetDirty();
-		if(ImGui::InputDoubleEx("acceleration", &object->acceleration))
+		if(ImGui::InputDoubleEx("acceleration", Track(object->acceleration)))
 			SetDirty();
-		if(ImGui::InputDoubleEx("drag", &object->drag))
+		if(ImGui::InputDoubleEx("drag", Track(object->drag)))
 			SetDirty();
 		double hardpointOffset[2] = {object->hardpointOffset.X(), -object->hardpointOffset.Y()};
 		if(ImGui::InputDouble2Ex("hardpoint offset", hardpointOffset))
@@ -522,11 +517,11 @@ void OutfitEditor::RenderOutfit()
 			object->hardpointOffset.Set(hardpointOffset[0], -hardpointOffset[1]);
 			SetDirty();
 		}
-		if(ImGui::InputDoubleEx("turn", &object->turn))
+		if(ImGui::InputDoubleEx("turn", Track(object->turn)))
 			SetDirty();
-		if(ImGui::InputDoubleEx("inaccuracy", &object->inaccuracy))
+		if(ImGui::InputDoubleEx("inaccuracy", Track(object->inaccuracy)))
 			SetDirty();
-		if(ImGui::InputDoubleEx("turret turn", &object->turretTurn))
+		if(ImGui::InputDoubleEx("turret turn", Track(object->turretTurn)))
 			SetDirty();
 		if(ImGui::InputDoubleEx("tracking", &object->tracking))
 		{
@@ -548,33 +543,33 @@ void OutfitEditor::RenderOutfit()
 			object->radarTracking = max(0., min(1., object->radarTracking));
 			SetDirty();
 		}
-		if(ImGui::InputDoubleEx("firing energy", &object->firingEnergy))
+		if(ImGui::InputDoubleEx("firing energy", Track(object->firingEnergy)))
 			SetDirty();
-		if(ImGui::InputDoubleEx("firing force", &object->firingForce))
+		if(ImGui::InputDoubleEx("firing force", Track(object->firingForce)))
 			SetDirty();
-		if(ImGui::InputDoubleEx("firing fuel", &object->firingFuel))
+		if(ImGui::InputDoubleEx("firing fuel", Track(object->firingFuel)))
 			SetDirty();
-		if(ImGui::InputDoubleEx("firing heat", &object->firingHeat))
+		if(ImGui::InputDoubleEx("firing heat", Track(object->firingHeat)))
 			SetDirty();
-		if(ImGui::InputDoubleEx("firing hull", &object->firingHull))
+		if(ImGui::InputDoubleEx("firing hull", Track(object->firingHull)))
 			SetDirty();
-		if(ImGui::InputDoubleEx("firing shields", &object->firingShields))
+		if(ImGui::InputDoubleEx("firing shields", Track(object->firingShields)))
 			SetDirty();
-		if(ImGui::InputDoubleEx("firing ion", &object->firingIon))
+		if(ImGui::InputDoubleEx("firing ion", Track(object->firingIon)))
 			SetDirty();
-		if(ImGui::InputDoubleEx("firing slowing", &object->firingSlowing))
+		if(ImGui::InputDoubleEx("firing slowing", Track(object->firingSlowing)))
 			SetDirty();
-		if(ImGui::InputDoubleEx("firing disruption", &object->firingDisruption))
+		if(ImGui::InputDoubleEx("firing disruption", Track(object->firingDisruption)))
 			SetDirty();
-		if(ImGui::InputDoubleEx("relative firing energy", &object->relativeFiringEnergy))
+		if(ImGui::InputDoubleEx("relative firing energy", Track(object->relativeFiringEnergy)))
 			SetDirty();
-		if(ImGui::InputDoubleEx("relative firing heat", &object->relativeFiringHeat))
+		if(ImGui::InputDoubleEx("relative firing heat", Track(object->relativeFiringHeat)))
 			SetDirty();
-		if(ImGui::InputDoubleEx("relative firing fuel", &object->relativeFiringFuel))
+		if(ImGui::InputDoubleEx("relative firing fuel", Track(object->relativeFiringFuel)))
 			SetDirty();
-		if(ImGui::InputDoubleEx("relative firing hull", &object->relativeFiringHull))
+		if(ImGui::InputDoubleEx("relative firing hull", Track(object->relativeFiringHull)))
 			SetDirty();
-		if(ImGui::InputDoubleEx("relative firing shields", &object->relativeFiringShields))
+		if(ImGui::InputDoubleEx("relative firing shields", Track(object->relativeFiringShields)))
 			SetDirty();
 		if(ImGui::InputDoubleEx("split range", &object->splitRange))
 		{
@@ -591,33 +586,33 @@ void OutfitEditor::RenderOutfit()
 			object->blastRadius = max(0., object->blastRadius);
 			SetDirty();
 		}
-		if(ImGui::InputDoubleEx("shield damage", &object->damage[Weapon::SHIELD_DAMAGE]))
+		if(ImGui::InputDoubleEx("shield damage", Track(object->damage[Weapon::SHIELD_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("hull damage", &object->damage[Weapon::HULL_DAMAGE]))
+		if(ImGui::InputDoubleEx("hull damage", Track(object->damage[Weapon::HULL_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("fuel damage", &object->damage[Weapon::FUEL_DAMAGE]))
+		if(ImGui::InputDoubleEx("fuel damage", Track(object->damage[Weapon::FUEL_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("heat damage", &object->damage[Weapon::HEAT_DAMAGE]))
+		if(ImGui::InputDoubleEx("heat damage", Track(object->damage[Weapon::HEAT_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("energy damage", &object->damage[Weapon::ENERGY_DAMAGE]))
+		if(ImGui::InputDoubleEx("energy damage", Track(object->damage[Weapon::ENERGY_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("ion damage", &object->damage[Weapon::ION_DAMAGE]))
+		if(ImGui::InputDoubleEx("ion damage", Track(object->damage[Weapon::ION_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("disruption damage", &object->damage[Weapon::DISRUPTION_DAMAGE]))
+		if(ImGui::InputDoubleEx("disruption damage", Track(object->damage[Weapon::DISRUPTION_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("slowing damage", &object->damage[Weapon::SLOWING_DAMAGE]))
+		if(ImGui::InputDoubleEx("slowing damage", Track(object->damage[Weapon::SLOWING_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("relatile shield damage", &object->damage[Weapon::RELATIVE_SHIELD_DAMAGE]))
+		if(ImGui::InputDoubleEx("relatile shield damage", Track(object->damage[Weapon::RELATIVE_SHIELD_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("relative hull damage", &object->damage[Weapon::RELATIVE_HULL_DAMAGE]))
+		if(ImGui::InputDoubleEx("relative hull damage", Track(object->damage[Weapon::RELATIVE_HULL_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("relative fuel damage", &object->damage[Weapon::RELATIVE_FUEL_DAMAGE]))
+		if(ImGui::InputDoubleEx("relative fuel damage", Track(object->damage[Weapon::RELATIVE_FUEL_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("relative heat damage", &object->damage[Weapon::RELATIVE_HEAT_DAMAGE]))
+		if(ImGui::InputDoubleEx("relative heat damage", Track(object->damage[Weapon::RELATIVE_HEAT_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("relative energy damage", &object->damage[Weapon::RELATIVE_ENERGY_DAMAGE]))
+		if(ImGui::InputDoubleEx("relative energy damage", Track(object->damage[Weapon::RELATIVE_ENERGY_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("hit force", &object->damage[Weapon::HIT_FORCE]))
+		if(ImGui::InputDoubleEx("hit force", Track(object->damage[Weapon::HIT_FORCE])))
 			SetDirty();
 		if(ImGui::InputDoubleEx("piecing", &object->piercing))
 		{
@@ -1283,3 +1278,38 @@ void OutfitEditor::WriteToFile(DataWriter &writer, const Outfit *outfit)
 		}
 	writer.EndChild();
 }
+
+
+
+// Lists every object the given outfit refers to.
+void OutfitEditor::References(const Outfit &outfit, vector<ReferenceIndex::Key> &references) const
+{
+	AddReference(references, outfit.ammo.first);
+	for(const auto &submunition : outfit.submunitions)
+		AddReference(references, submunition.weapon);
+	for(const auto *effects : {&outfit.afterburnerEffects, &outfit.jumpEffects, &outfit.fireEffects,
+			&outfit.liveEffects, &outfit.hitEffects, &outfit.targetEffects, &outfit.dieEffects})
+		for(const auto &it : *effects)
+			AddReference(references, it.first);
+}
+
+
+
+// Lists the category and attributes of the given outfit, including the kinds of
+// damage it does.
+void OutfitEditor::SearchTerms(const Outfit &outfit, vector<string> &terms) const
+{
+	static const char *DAMAGE_NAMES[Weapon::DAMAGE_TYPES] = {"hit force", "shield damage", "hull damage",
+		"fuel damage", "heat damage", "energy damage", "ion damage", "disruption damage", "slowing damage",
+		"discharge damage", "corrosion damage", "leak damage", "burn damage", "relative shield damage",
+		"relative hull damage", "relative fuel damage", "relative heat damage", "relative energy damage"};
+
+	if(!outfit.category.empty())
+		terms.push_back(outfit.category);
+	for(const auto &it : outfit.attributes)
+		if(it.second)
+			terms.emplace_back(it.first);
+	for(int i = 0; i < Weapon::DAMAGE_TYPES; ++i)
+		if(outfit.damage[i])
+			terms.emplace_back(DAMAGE_NAMES[i]);
+}
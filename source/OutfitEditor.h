@@ -31,7 +31,11 @@ public:
 	OutfitEditor(Editor &editor, bool &show) noexcept;
 
 	void Render();
-	void WriteToFile(DataWriter &writer, const Outfit *outfit);
+	// Renames the current object, and updates everything that refers to it.
+	virtual void Rename(const std::string &name) override;
+	virtual void WriteToFile(DataWriter &writer, const Outfit *outfit) override;
+	virtual void References(const Outfit &outfit, std::vector<ReferenceIndex::Key> &references) const override;
+	virtual void SearchTerms(const Outfit &outfit, std::vector<std::string> &terms) const override;
 
 private:
 	void RenderOutfitMenu();
@@ -54,6 +54,19 @@ OutfitterEditor::OutfitterEditor(Editor &editor, bool &show) noexcept
 
 
 
+// Renames the current object, and updates everything that refers to it.
+void OutfitterEditor::Rename(const string &name)
+{
+	DeleteFromChanges();
+	editor.RenameObject(keyFor<Sale<Outfit>>(), object->name, name);
+	GameData::Outfitters().Rename(object->name, name);
+	object->name = name;
+	WriteToPlugin(object, false);
+	SetDirty();
+}
+
+
+
 void OutfitterEditor::Render()
 {
 	if(IsDirty())
@@ -91,14 +104,7 @@ void OutfitterEditor::Render()
 			if(ImGui::MenuItem("Reset", nullptr, false, object && IsDirty()))
 			{
 				SetClean();
-				bool found = false;
-				for(auto &&change : Changes())
-					if(change.Name() == object->Name())
-					{
-						*object = change;
-						found = true;
-						break;
-					}
+				bool found = RestoreSaved();
 
 				if(!found && GameData::baseOutfitSales.Has(object->name))
 					*object = *GameData::baseOutfitSales.Get(object->name);
@@ -112,10 +118,7 @@ void OutfitterEditor::Render()
 			}
 			if(ImGui::MenuItem("Delete", nullptr, false, alreadyDefined))
 			{
-				if(find_if(Changes().begin(), Changes().end(), [this](const Sale<Outfit> &outfitter)
-							{
-								return outfitter.name == object->name;
-							}) != Changes().end())
+				if(IsSaved())
 				{
 					SetDirty("[deleted]");
 					DeleteFromChanges();
@@ -143,15 +146,7 @@ void OutfitterEditor::Render()
 				object = newOutfitter;
 				SetDirty();
 			});
-	ImGui::BeginSimpleRenameModal("Rename Outfitter", [this](const string &name)
-			{
-				DeleteFromChanges();
-				editor.RenameObject(keyFor<Sale<Outfit>>(), object->name, name);
-				GameData::Outfitters().Rename(object->name, name);
-				object->name = name;
-				WriteToPlugin(object, false);
-				SetDirty();
-			});
+	ImGui::BeginSimpleRenameModal("Rename Outfitter", [this](const string &name) { Rename(name); });
 	ImGui::BeginSimpleCloneModal("Clone Outfitter", [this](const string &name)
 			{
 				auto *clone = const_cast<Sale<Outfit> *>(GameData::Outfitters().Get(name));
@@ -177,30 +172,28 @@ void OutfitterEditor::Render()
 void OutfitterEditor::RenderOutfitter()
 {
 	ImGui::Text("outfitter: %s", object->name.c_str());
-	int index = 0;
 	const Outfit *toAdd = nullptr;
 	const Outfit *toRemove = nullptr;
-	for(auto it = object->begin(); it != object->end(); ++it)
-	{
-		ImGui::PushID(index++);
-		string name = (*it)->Name();
-		Outfit *change = nullptr;
-		if(ImGui::InputCombo("outfit", &name, &change, GameData::Outfits()))
-		{
-			if(name.empty())
-			{
-				toRemove = *it;
-				SetDirty();
-			}
-			else
+	// Large outfitters have hundreds of outfits, so only render the visible ones.
+	ImGui::ClippedList(*object, [this, &toAdd, &toRemove](const Outfit *outfit)
 			{
-				toAdd = change;
-				toRemove = *it;
-				SetDirty();
-			}
-		}
-		ImGui::PopID();
-	}
+				string name = outfit->Name();
+				Outfit *change = nullptr;
+				if(ImGui::InputCombo("outfit", &name, &change, GameData::Outfits()))
+				{
+					if(name.empty())
+					{
+						toRemove = outfit;
+						SetDirty();
+					}
+					else
+					{
+						toAdd = change;
+						toRemove = outfit;
+						SetDirty();
+					}
+				}
+			});
 	if(toAdd)
 		object->insert(toAdd);
 	if(toRemove)
@@ -242,3 +235,12 @@ void OutfitterEditor::WriteToFile(DataWriter &writer, const Sale<Outfit> *outfit
 			});
 	writer.EndChild();
 }
+
+
+
+// Lists every object the given outfitter refers to.
+void OutfitterEditor::References(const Sale<Outfit> &outfitter, vector<ReferenceIndex::Key> &references) const
+{
+	for(const Outfit *outfit : outfitter)
+		AddReference(references, outfit);
+}
@@ -32,7 +32,10 @@ public:
 	OutfitterEditor(Editor &editor, bool &show) noexcept;
 
 	void Render();
-	void WriteToFile(DataWriter &writer, const Sale<Outfit> *outfitter);
+	// Renames the current object, and updates everything that refers to it.
+	virtual void Rename(const std::string &name) override;
+	virtual void WriteToFile(DataWriter &writer, const Sale<Outfit> *outfitter) override;
+	virtual void References(const Sale<Outfit> &outfitter, std::vector<ReferenceIndex::Key> &references) const override;
 
 private:
 	void RenderOutfitter();
@@ -53,6 +53,19 @@ PlanetEditor::PlanetEditor(Editor &editor, bool &show) noexcept
 
 
 
+// Renames the current object, and updates everything that refers to it.
+void PlanetEditor::Rename(const string &name)
+{
+	DeleteFromChanges();
+	editor.RenameObject(keyFor<Planet>(), object->name, name);
+	GameData::Planets().Rename(object->name, name);
+	object->name = name;
+	WriteToPlugin(object, false);
+	SetDirty();
+}
+
+
+
 void PlanetEditor::Render()
 {
 	if(IsDirty())
@@ -90,14 +103,7 @@ void PlanetEditor::Render()
 			if(ImGui::MenuItem("Reset", nullptr, false, object && IsDirty()))
 			{
 				SetClean();
-				bool found = false;
-				for(auto &&change : Changes())
-					if(change.TrueName() == object->TrueName())
-					{
-						*object = change;
-						found = true;
-						break;
-					}
+				bool found = RestoreSaved();
 
 				if(!found && GameData::basePlanets.Has(object->name))
 					*object = *GameData::basePlanets.Get(object->TrueName());
@@ -111,10 +117,7 @@ void PlanetEditor::Render()
 			}
 			if(ImGui::MenuItem("Delete", nullptr, false, alreadyDefined))
 			{
-				if(find_if(Changes().begin(), Changes().end(), [this](const Planet &planet)
-							{
-								return planet.name == object->name;
-							}) != Changes().end())
+				if(IsSaved())
 				{
 					SetDirty("[deleted]");
 					DeleteFromChanges();
@@ -143,15 +146,7 @@ void PlanetEditor::Render()
 				object = newPlanet;
 				SetDirty();
 			});
-	ImGui::BeginSimpleRenameModal("Rename Planet", [this](const string &name)
-			{
-				DeleteFromChanges();
-				editor.RenameObject(keyFor<Planet>(), object->name, name);
-				GameData::Planets().Rename(object->name, name);
-				object->name = name;
-				WriteToPlugin(object, false);
-				SetDirty();
-			});
+	ImGui::BeginSimpleRenameModal("Rename Planet", [this](const string &name) { Rename(name); });
 	ImGui::BeginSimpleCloneModal("Clone Planet", [this](const string &name)
 			{
 				auto *clone = const_cast<Planet *>(GameData::Planets().Get(name));
@@ -230,36 +225,33 @@ void PlanetEditor::RenderPlanet()
 
 	if(ImGui::TreeNode("shipyards"))
 	{
-		index = 0;
 		const Sale<Ship> *toAdd = nullptr;
 		const Sale<Ship> *toRemove = nullptr;
-		for(auto it = object->shipSales.begin(); it != object->shipSales.end(); ++it)
-		{
-			ImGui::PushID(index++);
-			if(ImGui::BeginCombo("shipyard", (*it)->name.c_str()))
-			{
-				for(const auto &item : GameData::Shipyards())
+		ImGui::ClippedList(object->shipSales, [this, &toAdd, &toRemove](const Sale<Ship> *shipyard)
 				{
-					const bool selected = &item.second == *it;
-					if(ImGui::Selectable(item.first.c_str(), selected))
+					if(ImGui::BeginCombo("shipyard", shipyard->name.c_str()))
 					{
-						toAdd = &item.second;
-						toRemove = *it;
-						SetDirty();
-					}
-					if(selected)
-						ImGui::SetItemDefaultFocus();
-				}
+						for(const auto &item : GameData::Shipyards())
+						{
+							const bool selected = &item.second == shipyard;
+							if(ImGui::Selectable(item.first.c_str(), selected))
+							{
+								toAdd = &item.second;
+								toRemove = shipyard;
+								SetDirty();
+							}
+							if(selected)
+								ImGui::SetItemDefaultFocus();
+						}
 
-				if(ImGui::Selectable("[remove]"))
-				{
-					toRemove = *it;
-					SetDirty();
-				}
-				ImGui::EndCombo();
-			}
-			ImGui::PopID();
-		}
+						if(ImGui::Selectable("[remove]"))
+						{
+							toRemove = shipyard;
+							SetDirty();
+						}
+						ImGui::EndCombo();
+					}
+				});
 		if(toAdd)
 			object->shipSales.insert(toAdd);
 		if(toRemove)
@@ -278,36 +270,33 @@ void PlanetEditor::RenderPlanet()
 	}
 	if(ImGui::TreeNode("outfitters"))
 	{
-		index = 0;
 		const Sale<Outfit> *toAdd = nullptr;
 		const Sale<Outfit> *toRemove = nullptr;
-		for(auto it = object->outfitSales.begin(); it != object->outfitSales.end(); ++it)
-		{
-			ImGui::PushID(index++);
-			if(ImGui::BeginCombo("outfitter", (*it)->name.c_str()))
-			{
-				for(const auto &item : GameData::Outfitters())
+		ImGui::ClippedList(object->outfitSales, [this, &toAdd, &toRemove](const Sale<Outfit> *outfitter)
 				{
-					const bool selected = &item.second == *it;
-					if(ImGui::Selectable(item.first.c_str(), selected))
+					if(ImGui::BeginCombo("outfitter", outfitter->name.c_str()))
 					{
-						toAdd = &item.second;
-						toRemove = *it;
-						SetDirty();
-					}
-					if(selected)
-						ImGui::SetItemDefaultFocus();
-				}
+						for(const auto &item : GameData::Outfitters())
+						{
+							const bool selected = &item.second == outfitter;
+							if(ImGui::Selectable(item.first.c_str(), selected))
+							{
+								toAdd = &item.second;
+								toRemove = outfitter;
+								SetDirty();
+							}
+							if(selected)
+								ImGui::SetItemDefaultFocus();
+						}
 
-				if(ImGui::Selectable("[remove]"))
-				{
-					toRemove = *it;
-					SetDirty();
-				}
-				ImGui::EndCombo();
-			}
-			ImGui::PopID();
-		}
+						if(ImGui::Selectable("[remove]"))
+						{
+							toRemove = outfitter;
+							SetDirty();
+						}
+						ImGui::EndCombo();
+					}
+				});
 		if(toAdd)
 			object->outfitSales.insert(toAdd);
 		if(toRemove)
@@ -327,9 +316,9 @@ void PlanetEditor::RenderPlanet()
 
 	if(ImGui::TreeNode("tribute"))
 	{
-		if(ImGui::InputInt("tribute", &object->tribute))
+		if(ImGui::InputInt("tribute", Track(object->tribute)))
 			SetDirty();
-		if(ImGui::InputInt("threshold", &object->defenseThreshold))
+		if(ImGui::InputInt("threshold", Track(object->defenseThreshold)))
 			SetDirty();
 
 		if(ImGui::TreeNode("fleets"))
@@ -422,10 +411,10 @@ void PlanetEditor::RenderPlanet()
 		landscapeName.clear();
 		SetDirty();
 	}
-	if(ImGui::InputText("music", &object->music, ImGuiInputTextFlags_EnterReturnsTrue))
+	if(ImGui::InputText("music", Track(object->music), ImGuiInputTextFlags_EnterReturnsTrue))
 		SetDirty();
 
-	if(ImGui::InputTextMultiline("description", &object->description, ImVec2(), ImGuiInputTextFlags_EnterReturnsTrue))
+	if(ImGui::InputTextMultiline("description", Track(object->description), ImVec2(), ImGuiInputTextFlags_EnterReturnsTrue))
 		SetDirty();
 	if(ImGui::InputTextMultiline("spaceport", &object->spaceport, ImVec2(), ImGuiInputTextFlags_EnterReturnsTrue))
 	{
@@ -464,11 +453,11 @@ void PlanetEditor::RenderPlanet()
 		}
 	}
 
-	if(ImGui::InputDoubleEx("required reputation", &object->requiredReputation))
+	if(ImGui::InputDoubleEx("required reputation", Track(object->requiredReputation)))
 		SetDirty();
-	if(ImGui::InputDoubleEx("bribe", &object->bribe))
+	if(ImGui::InputDoubleEx("bribe", Track(object->bribe)))
 		SetDirty();
-	if(ImGui::InputDoubleEx("security", &object->security))
+	if(ImGui::InputDoubleEx("security", Track(object->security)))
 		SetDirty();
 	object->customSecurity = object->security != .25;
 
@@ -605,3 +594,17 @@ void PlanetEditor::WriteToFile(DataWriter &writer, const Planet *planet)
 
 	writer.EndChild();
 }
+
+
+
+// Lists every object the given planet refers to.
+void PlanetEditor::References(const Planet &planet, vector<ReferenceIndex::Key> &references) const
+{
+	AddReference(references, planet.government);
+	for(const auto *shipyard : planet.shipSales)
+		AddReference(references, shipyard);
+	for(const auto *outfitter : planet.outfitSales)
+		AddReference(references, outfitter);
+	for(const Fleet *fleet : planet.defenseFleets)
+		AddReference(references, fleet);
+}
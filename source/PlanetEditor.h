@@ -31,7 +31,10 @@ public:
 	PlanetEditor(Editor &editor, bool &show) noexcept;
 
 	void Render();
-	void WriteToFile(DataWriter &writer, const Planet *planet);
+	// Renames the current object, and updates everything that refers to it.
+	virtual void Rename(const std::string &name) override;
+	virtual void WriteToFile(DataWriter &writer, const Planet *planet) override;
+	virtual void References(const Planet &planet, std::vector<ReferenceIndex::Key> &references) const override;
 
 private:
 	void RenderPlanetMenu();
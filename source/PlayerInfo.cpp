@@ -30,6 +30,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Politics.h"
 #include "Preferences.h"
 #include "Random.h"
+#include "SaveQueue.h"
 #include "SavedGame.h"
 #include "Ship.h"
 #include "ShipEvent.h"
@@ -121,8 +122,10 @@ void PlayerInfo::New(const StartConditions &start)
 // Load player information from a saved game file.
 void PlayerInfo::Load(const string &path)
 {
-	// Make sure any previously loaded data is cleared.
+	// Make sure any previously loaded data is cleared, and that the file is
+	// not still being written.
 	Clear();
+	SaveQueue::Wait();
 	
 	filePath = path;
 	fullFilePath = path;
@@ -345,26 +348,11 @@ void PlayerInfo::Save() const
 	// Remember that this was the most recently saved player.
 	Files::Write(Files::Config() + "recent.txt", filePath + '\n');
 	
-	if(filePath.rfind(".txt") == filePath.length() - 4)
-	{
-		// Only update the backups if this save will have a newer date.
-		SavedGame saved(filePath);
-		if(saved.GetDate() != date.ToString())
-		{
-			string root = filePath.substr(0, filePath.length() - 4);
-			string files[4] = {
-				root + "~~previous-3.txt",
-				root + "~~previous-2.txt",
-				root + "~~previous-1.txt",
-				filePath
-			};
-			for(int i = 0; i < 3; ++i)
-				if(Files::Exists(files[i + 1]))
-					Files::Move(files[i + 1], files[i]);
-		}
-	}
-		
-	Save(filePath);
+	// Only the serialization is done here. Updating the backups and writing
+	// the file happen in the background.
+	DataWriter out;
+	Save(out);
+	SaveQueue::Write(filePath, out.SaveToString(), date.ToString());
 
 #ifdef __EMSCRIPTEN__
 	EM_ASM(
@@ -2638,22 +2626,22 @@ void PlayerInfo::CreateMissions()
 	// Check for available missions.
 	bool skipJobs = planet && !planet->IsInhabited();
 	bool hasPriorityMissions = false;
-	for(const auto &it : GameData::Missions())
+	// Only missions that could possibly be offered on this planet need to be
+	// checked, and they are checked in the same order as GameData::Missions().
+	for(const Mission *mission : GameData::MissionsOfferedAt(planet))
 	{
-		if(it.second.IsAtLocation(Mission::BOARDING) || it.second.IsAtLocation(Mission::ASSISTING))
-			continue;
-		if(skipJobs && it.second.IsAtLocation(Mission::JOB))
+		if(skipJobs && mission->IsAtLocation(Mission::JOB))
 			continue;
 		
-		if(it.second.CanOffer(*this))
+		if(mission->CanOffer(*this))
 		{
 			list<Mission> &missions =
-				it.second.IsAtLocation(Mission::JOB) ? availableJobs : availableMissions;
+				mission->IsAtLocation(Mission::JOB) ? availableJobs : availableMissions;
 			
-			missions.push_back(it.second.Instantiate(*this));
+			missions.push_back(mission->Instantiate(*this));
 			if(missions.back().HasFailed(*this))
 				missions.pop_back();
-			else if(!it.second.IsAtLocation(Mission::JOB))
+			else if(!mission->IsAtLocation(Mission::JOB))
 				hasPriorityMissions |= missions.back().HasPriority();
 		}
 	}
@@ -2799,7 +2787,9 @@ void PlayerInfo::Autosave() const
 		return;
 	
 	string path = filePath.substr(0, filePath.length() - 4) + "~autosave.txt";
-	Save(path);
+	DataWriter out;
+	Save(out);
+	SaveQueue::Write(path, out.SaveToString());
 }
 
 
@@ -2807,8 +2797,13 @@ void PlayerInfo::Autosave() const
 void PlayerInfo::Save(const string &path) const
 {
 	DataWriter out(path);
-	
-	
+	Save(out);
+}
+
+
+
+void PlayerInfo::Save(DataWriter &out) const
+{
 	// Basic player information and persistent UI settings:
 	
 	// Pilot information:
@@ -31,6 +31,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include <utility>
 #include <vector>
 
+class DataWriter;
 class Government;
 class Outfit;
 class Planet;
@@ -285,6 +286,8 @@ private:
 	void StepMissions(UI *ui);
 	void Autosave() const;
 	void Save(const std::string &path) const;
+	// Write everything that is saved about this player.
+	void Save(DataWriter &out) const;
 	
 	// Check for and apply any punitive actions from planetary security.
 	void Fine(UI *ui);
@@ -383,6 +386,7 @@ private:
 	friend class Editor;
 	friend class SystemEditor;
 	friend class ShipEditor;
+	friend class Replay;
 };
 
 
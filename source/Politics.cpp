@@ -42,11 +42,48 @@ void Politics::Reset()
 	// were already checked for when you first landed).
 	for(const auto &it : GameData::Governments())
 		fined.insert(&it.second);
+	
+	UpdateHostility();
+}
+
+
+
+// Rebuild the cached hostility between every pair of governments.
+void Politics::UpdateHostility()
+{
+	indexed.clear();
+	for(const auto &it : GameData::Governments())
+	{
+		it.second.politicsIndex = indexed.size();
+		indexed.push_back(&it.second);
+	}
+	
+	const size_t count = indexed.size();
+	hostility.assign(count * count, false);
+	for(size_t i = 0; i < count; ++i)
+		for(size_t j = 0; j < count; ++j)
+			hostility[i * count + j] = CalculateIsEnemy(indexed[i], indexed[j]);
 }
 
 
 
 bool Politics::IsEnemy(const Government *first, const Government *second) const
+{
+	// Copies of a government share its index, so make sure the index really
+	// refers to this government before trusting the cache.
+	const size_t count = indexed.size();
+	const size_t i = first->politicsIndex;
+	const size_t j = second->politicsIndex;
+	if(i < count && j < count && indexed[i] == first && indexed[j] == second)
+		return hostility[i * count + j];
+	
+	return CalculateIsEnemy(first, second);
+}
+
+
+
+// Check if the two governments are enemies, without using the cache.
+bool Politics::CalculateIsEnemy(const Government *first, const Government *second) const
 {
 	if(first == second)
 		return false;
@@ -73,6 +110,27 @@ bool Politics::IsEnemy(const Government *first, const Government *second) const
 
 
 
+// Refresh the cached hostility between the player and the given government, or
+// between the player and every government if none is given.
+void Politics::UpdatePlayerHostility(const Government *gov)
+{
+	const Government *player = GameData::PlayerGovernment();
+	const size_t count = indexed.size();
+	const size_t p = player ? player->politicsIndex : count;
+	if(p >= count || indexed[p] != player)
+		return;
+	
+	for(size_t i = 0; i < count; ++i)
+		if(!gov || indexed[i] == gov)
+		{
+			bool isEnemy = CalculateIsEnemy(player, indexed[i]);
+			hostility[p * count + i] = isEnemy;
+			hostility[i * count + p] = isEnemy;
+		}
+}
+
+
+
 // Commit the given "offense" against the given government (which may not
 // actually consider it to be an offense). This may result in temporary
 // hostilities (if the even type is PROVOKE), or a permanent change to your
@@ -112,6 +170,7 @@ void Politics::Offend(const Government *gov, int eventType, int count)
 			reputationWith[other] -= penalty;
 		}
 	}
+	UpdatePlayerHostility();
 }
 
 
@@ -122,6 +181,7 @@ void Politics::Bribe(const Government *gov)
 	bribed.insert(gov);
 	provoked.erase(gov);
 	fined.insert(gov);
+	UpdatePlayerHostility(gov);
 }
 
 
@@ -311,6 +371,7 @@ double Politics::Reputation(const Government *gov) const
 void Politics::AddReputation(const Government *gov, double value)
 {
 	reputationWith[gov] += value;
+	UpdatePlayerHostility(gov);
 }
 
 
@@ -318,6 +379,7 @@ void Politics::AddReputation(const Government *gov, double value)
 void Politics::SetReputation(const Government *gov, double value)
 {
 	reputationWith[gov] = value;
+	UpdatePlayerHostility(gov);
 }
 
 
@@ -329,4 +391,5 @@ void Politics::ResetDaily()
 	bribed.clear();
 	bribedPlanets.clear();
 	fined.clear();
+	UpdatePlayerHostility();
 }
@@ -16,6 +16,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 class Government;
 class Planet;
@@ -33,6 +34,10 @@ public:
 	// Reset to the initial political state defined in the game data.
 	void Reset();
 	
+	// Rebuild the cached hostility between every pair of governments. This
+	// must be done whenever any government's attitudes toward others change.
+	void UpdateHostility();
+	
 	bool IsEnemy(const Government *first, const Government *second) const;
 	
 	// Commit the given "offense" against the given government (which may not
@@ -66,6 +71,14 @@ public:
 	void ResetDaily();
 	
 	
+private:
+	// Check if the two governments are enemies, without using the cache.
+	bool CalculateIsEnemy(const Government *first, const Government *second) const;
+	// Refresh the cached hostility between the player and the given government,
+	// or between the player and every government if none is given.
+	void UpdatePlayerHostility(const Government *gov = nullptr);
+	
+	
 private:
 	// attitude[target][other] stores how much an action toward the given target
 	// government will affect your reputation with the given other government.
@@ -78,6 +91,13 @@ private:
 	std::map<const Planet *, bool> bribedPlanets;
 	std::set<const Planet *> dominatedPlanets;
 	std::set<const Government *> fined;
+	
+	// The governments that have a slot in the hostility cache, and a bit matrix
+	// of which of them are currently enemies. Only the player's row and column
+	// depend on reputation, bribes and provocation, so those are refreshed
+	// whenever any of them change.
+	std::vector<const Government *> indexed;
+	std::vector<bool> hostility;
 };
 
 
@@ -0,0 +1,128 @@
+/* Pool.h
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef POOL_H_
+#define POOL_H_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+
+
+// Template for storing many short-lived objects of the same type (e.g. the
+// projectiles in flight), so that stepping through all of them runs over one
+// contiguous block of memory. An object is removed by moving the last object
+// into its place, so the others never have to be shifted, but the order of the
+// objects is not kept. The storage of removed objects is reused, so once a pool
+// has held as many objects as it will ever need at once, adding more no longer
+// allocates any memory.
+template <class Type>
+class Pool {
+public:
+	// Add an object to the pool.
+	void Add(Type object);
+	// Move every object of the given list into the pool, and clear the list.
+	void Append(std::vector<Type> &added);
+	// Remove every object for which the given function returns true.
+	template <class F>
+	void RemoveIf(F &&shouldRemove);
+	// Remove every object, but keep the memory they used.
+	void clear() noexcept { objects.clear(); }
+	std::size_t size() const noexcept { return objects.size(); }
+	bool empty() const noexcept { return objects.empty(); }
+	
+	// How many times the pool has had to allocate memory.
+	std::size_t Allocations() const noexcept { return allocations; }
+	
+	typename std::vector<Type>::iterator begin() noexcept { return objects.begin(); }
+	typename std::vector<Type>::const_iterator begin() const noexcept { return objects.begin(); }
+	typename std::vector<Type>::iterator end() noexcept { return objects.end(); }
+	typename std::vector<Type>::const_iterator end() const noexcept { return objects.end(); }
+	
+	
+private:
+	// Remove the object at the given index, by moving the last one into its place.
+	void RemoveAt(std::size_t index);
+	// Make room for at least the given number of objects.
+	void Reserve(std::size_t count);
+	
+	
+private:
+	std::vector<Type> objects;
+	std::size_t allocations = 0;
+};
+
+
+
+template <class Type>
+void Pool<Type>::Add(Type object)
+{
+	if(objects.size() == objects.capacity())
+		++allocations;
+	objects.push_back(std::move(object));
+}
+
+
+
+template <class Type>
+void Pool<Type>::Append(std::vector<Type> &added)
+{
+	Reserve(objects.size() + added.size());
+	for(Type &object : added)
+		Add(std::move(object));
+	added.clear();
+}
+
+
+
+template <class Type>
+template <class F>
+void Pool<Type>::RemoveIf(F &&shouldRemove)
+{
+	// The object that is moved into the place of a removed one must be checked
+	// too, so only move on once the object at this index is kept.
+	for(std::size_t i = 0; i < objects.size(); )
+	{
+		if(shouldRemove(objects[i]))
+			RemoveAt(i);
+		else
+			++i;
+	}
+}
+
+
+
+template <class Type>
+void Pool<Type>::RemoveAt(std::size_t index)
+{
+	const std::size_t last = objects.size() - 1;
+	if(index != last)
+		objects[index] = std::move(objects[last]);
+	objects.pop_back();
+}
+
+
+
+template <class Type>
+void Pool<Type>::Reserve(std::size_t count)
+{
+	if(count <= objects.capacity())
+		return;
+	
+	++allocations;
+	objects.reserve(count);
+}
+
+
+
+#endif
@@ -0,0 +1,206 @@
+/* Profiler.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "Profiler.h"
+
+#include "Files.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+
+using namespace std;
+
+namespace {
+	// Each thread remembers this many of its most recent events.
+	const size_t RING_SIZE = 1 << 15;
+	
+	class ThreadLog {
+	public:
+		explicit ThreadLog(int thread) : thread(thread), events(RING_SIZE) {}
+		
+		int thread;
+		// This is only ever contended while the events are being read.
+		mutex lock;
+		vector<Profiler::Event> events;
+		// The index the next event will be written to, and how many of the
+		// entries hold valid events.
+		size_t next = 0;
+		size_t count = 0;
+	};
+	
+	atomic<bool> enabled(false);
+	const chrono::steady_clock::time_point epoch = chrono::steady_clock::now();
+	
+	mutex logsMutex;
+	vector<unique_ptr<ThreadLog>> logs;
+	
+	// Only trivial types can be thread_local on every platform, so each thread
+	// just keeps a pointer to its log. The logs themselves are never freed.
+	thread_local ThreadLog *threadLog = nullptr;
+	thread_local int threadDepth = 0;
+	
+	int64_t Now()
+	{
+		return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - epoch).count();
+	}
+	
+	ThreadLog &GetThreadLog()
+	{
+		if(!threadLog)
+		{
+			lock_guard<mutex> lock(logsMutex);
+			logs.emplace_back(new ThreadLog(logs.size()));
+			threadLog = logs.back().get();
+		}
+		return *threadLog;
+	}
+	
+	// Write a time given in nanoseconds as (fractional) microseconds.
+	void AppendMicroseconds(string &out, int64_t nanoseconds)
+	{
+		char buffer[32];
+		snprintf(buffer, sizeof(buffer), "%.3f", nanoseconds * .001);
+		out += buffer;
+	}
+}
+
+
+
+Profiler::Scope::Scope(const char *name)
+	: name(name), start(enabled ? Now() : -1)
+{
+	if(start >= 0)
+		++threadDepth;
+}
+
+
+
+Profiler::Scope::~Scope()
+{
+	if(start < 0)
+		return;
+	
+	--threadDepth;
+	int64_t end = Now();
+	ThreadLog &log = GetThreadLog();
+	lock_guard<mutex> lock(log.lock);
+	log.events[log.next] = Event{name, start, end - start, threadDepth};
+	log.next = (log.next + 1) % RING_SIZE;
+	log.count = min(log.count + 1, RING_SIZE);
+}
+
+
+
+// Turn the recording of events on or off.
+void Profiler::SetEnabled(bool enable)
+{
+	enabled = enable && IsAvailable();
+}
+
+
+
+bool Profiler::IsEnabled()
+{
+	return enabled;
+}
+
+
+
+// Check if profiling was compiled in at all.
+bool Profiler::IsAvailable()
+{
+#ifndef ES_NO_PROFILER
+	return true;
+#else
+	return false;
+#endif // ES_NO_PROFILER
+}
+
+
+
+// Discard every recorded event.
+void Profiler::Clear()
+{
+	lock_guard<mutex> lock(logsMutex);
+	for(const unique_ptr<ThreadLog> &log : logs)
+	{
+		lock_guard<mutex> logLock(log->lock);
+		log->next = 0;
+		log->count = 0;
+	}
+}
+
+
+
+// Get a copy of the events that are still in each thread's ring buffer.
+vector<Profiler::ThreadEvents> Profiler::Events()
+{
+	vector<ThreadEvents> result;
+	lock_guard<mutex> lock(logsMutex);
+	for(const unique_ptr<ThreadLog> &log : logs)
+	{
+		result.emplace_back();
+		ThreadEvents &thread = result.back();
+		thread.thread = log->thread;
+		
+		lock_guard<mutex> logLock(log->lock);
+		thread.events.reserve(log->count);
+		size_t first = (log->next + RING_SIZE - log->count) % RING_SIZE;
+		for(size_t i = 0; i < log->count; ++i)
+			thread.events.push_back(log->events[(first + i) % RING_SIZE]);
+	}
+	
+	// Events are recorded when they end, so a scope comes after everything
+	// nested inside of it. Sort them by when they started instead.
+	for(ThreadEvents &thread : result)
+		stable_sort(thread.events.begin(), thread.events.end(),
+			[](const Event &a, const Event &b) noexcept -> bool
+			{
+				return a.start < b.start || (a.start == b.start && a.depth < b.depth);
+			});
+	return result;
+}
+
+
+
+// Write the recorded events to the given file as Chrome trace JSON.
+void Profiler::WriteTrace(const string &path)
+{
+	string out = "{\"traceEvents\":[";
+	bool isFirst = true;
+	for(const ThreadEvents &thread : Events())
+		for(const Event &event : thread.events)
+		{
+			out += isFirst ? "\n" : ",\n";
+			isFirst = false;
+			
+			out += "{\"name\":\"";
+			for(const char *it = event.name; *it; ++it)
+			{
+				if(*it == '"' || *it == '\\')
+					out += '\\';
+				out += *it;
+			}
+			out += "\",\"ph\":\"X\",\"pid\":0,\"tid\":" + to_string(thread.thread) + ",\"ts\":";
+			AppendMicroseconds(out, event.start);
+			out += ",\"dur\":";
+			AppendMicroseconds(out, event.duration);
+			out += "}";
+		}
+	out += "\n],\"displayTimeUnit\":\"ms\"}\n";
+	
+	Files::Write(path, out);
+}
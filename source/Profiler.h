@@ -0,0 +1,96 @@
+/* Profiler.h
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+
+// Class for measuring how long scopes of code take to run. Each scope that is
+// marked with PROFILE_SCOPE() records an event (its name, start time, duration,
+// and how deeply it is nested) into a ring buffer owned by the calling thread.
+// Each buffer is guarded by its own mutex. Other threads only take it while the
+// events are cleared or copied out, so a scope only has to wait for the lock
+// while Clear(), Events(), or WriteTrace() is reading that thread's buffer. The
+// most recent events can be inspected, or written out in the Chrome "trace
+// event" format so they can be viewed in chrome://tracing or similar tools.
+// Recording is off by default; building with ES_NO_PROFILER removes every
+// scope from the code entirely.
+class Profiler {
+public:
+	class Event {
+	public:
+		// The name must be a string literal (or otherwise outlive the profiler).
+		const char *name;
+		// Start and duration of the scope, in nanoseconds.
+		int64_t start;
+		int64_t duration;
+		// How many other scopes this one is nested inside of.
+		int depth;
+	};
+	
+	class ThreadEvents {
+	public:
+		// The order in which this thread first recorded an event.
+		int thread;
+		// The events in the order they started.
+		std::vector<Event> events;
+	};
+	
+	// Object that records an event covering its lifetime.
+	class Scope {
+	public:
+		explicit Scope(const char *name);
+		~Scope();
+		
+		Scope(const Scope &) = delete;
+		Scope &operator=(const Scope &) = delete;
+		
+	private:
+		const char *name;
+		int64_t start;
+	};
+	
+	
+public:
+	// Turn the recording of events on or off.
+	static void SetEnabled(bool enabled);
+	static bool IsEnabled();
+	// Check if profiling was compiled in at all.
+	static bool IsAvailable();
+	
+	// Discard every recorded event.
+	static void Clear();
+	// Get a copy of the events that are still in each thread's ring buffer.
+	static std::vector<ThreadEvents> Events();
+	// Write the recorded events to the given file as Chrome trace JSON.
+	static void WriteTrace(const std::string &path);
+};
+
+
+
+#ifndef ES_NO_PROFILER
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+// Record how long the rest of the enclosing scope takes to run.
+#define PROFILE_SCOPE(name) Profiler::Scope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name)
+#endif // ES_NO_PROFILER
+
+
+
+#endif
@@ -0,0 +1,143 @@
+/* ReferenceIndex.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "ReferenceIndex.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+	const set<ReferenceIndex::Key> NO_USERS;
+	const vector<ReferenceIndex::Key> NO_REFERENCES;
+}
+
+
+
+// Replace everything the given object refers to.
+void ReferenceIndex::Set(const Key &object, vector<Key> newReferences)
+{
+	sort(newReferences.begin(), newReferences.end());
+	newReferences.erase(unique(newReferences.begin(), newReferences.end()), newReferences.end());
+	
+	Remove(object);
+	if(newReferences.empty())
+		return;
+	
+	for(const Key &reference : newReferences)
+		users[reference].insert(object);
+	references[object] = std::move(newReferences);
+}
+
+
+
+// Forget everything the given object refers to. Anything that refers to it is
+// still remembered.
+void ReferenceIndex::Remove(const Key &object)
+{
+	auto it = references.find(object);
+	if(it == references.end())
+		return;
+	
+	for(const Key &reference : it->second)
+	{
+		auto jt = users.find(reference);
+		if(jt == users.end())
+			continue;
+		jt->second.erase(object);
+		if(jt->second.empty())
+			users.erase(jt);
+	}
+	references.erase(it);
+}
+
+
+
+// Rename an object, both where it refers to other objects and where other
+// objects refer to it. This returns every object that refers to it, since those
+// now need to be saved with the new name.
+set<ReferenceIndex::Key> ReferenceIndex::Rename(const Key &object, const string &newName)
+{
+	const Key renamed(object.first, newName);
+	if(renamed == object)
+		return Users(object);
+	
+	// Only the objects that refer to this one need to be updated, rather than
+	// everything in the index.
+	set<Key> objectUsers;
+	auto it = users.find(object);
+	if(it != users.end())
+	{
+		objectUsers = std::move(it->second);
+		users.erase(it);
+		for(const Key &user : objectUsers)
+		{
+			vector<Key> &list = references[user];
+			replace(list.begin(), list.end(), object, renamed);
+			sort(list.begin(), list.end());
+		}
+		users[renamed].insert(objectUsers.begin(), objectUsers.end());
+	}
+	
+	auto jt = references.find(object);
+	if(jt != references.end())
+	{
+		vector<Key> list = std::move(jt->second);
+		references.erase(jt);
+		for(const Key &reference : list)
+		{
+			std::set<Key> &referenceUsers = users[reference];
+			referenceUsers.erase(object);
+			referenceUsers.insert(renamed);
+		}
+		references[renamed] = std::move(list);
+	}
+	
+	// An object that refers to itself is now listed under its new name.
+	if(objectUsers.erase(object))
+		objectUsers.insert(renamed);
+	return objectUsers;
+}
+
+
+
+void ReferenceIndex::Clear()
+{
+	references.clear();
+	users.clear();
+}
+
+
+
+// Get every object that refers to the given object.
+const set<ReferenceIndex::Key> &ReferenceIndex::Users(const Key &object) const
+{
+	auto it = users.find(object);
+	return it == users.end() ? NO_USERS : it->second;
+}
+
+
+
+// Get every object the given object refers to.
+const vector<ReferenceIndex::Key> &ReferenceIndex::References(const Key &object) const
+{
+	auto it = references.find(object);
+	return it == references.end() ? NO_REFERENCES : it->second;
+}
+
+
+
+// The number of objects that refer to anything.
+size_t ReferenceIndex::Size() const
+{
+	return references.size();
+}
@@ -0,0 +1,61 @@
+/* ReferenceIndex.h
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef REFERENCE_INDEX_H_
+#define REFERENCE_INDEX_H_
+
+#include <cstddef>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+
+// Class keeping track of which game objects refer to which others (e.g. the
+// fleets that use a ship, or the outfitters that sell an outfit), in both
+// directions. Objects are identified by their kind (e.g. "ship") and name, so
+// that this works for objects that are no longer, or not yet, defined.
+class ReferenceIndex {
+public:
+	using Key = std::pair<std::string, std::string>;
+	
+	
+public:
+	// Replace everything the given object refers to.
+	void Set(const Key &object, std::vector<Key> references);
+	// Forget everything the given object refers to. Anything that refers to it
+	// is still remembered.
+	void Remove(const Key &object);
+	// Rename an object, both where it refers to other objects and where other
+	// objects refer to it. This returns every object that refers to it, since
+	// those now need to be saved with the new name.
+	std::set<Key> Rename(const Key &object, const std::string &newName);
+	void Clear();
+	
+	// Get every object that refers to the given object.
+	const std::set<Key> &Users(const Key &object) const;
+	// Get every object the given object refers to.
+	const std::vector<Key> &References(const Key &object) const;
+	// The number of objects that refer to anything.
+	size_t Size() const;
+	
+	
+private:
+	std::map<Key, std::vector<Key>> references;
+	std::map<Key, std::set<Key>> users;
+};
+
+
+
+#endif
@@ -0,0 +1,364 @@
+/* RegionGenerator.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "RegionGenerator.h"
+
+#include "Angle.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <random>
+#include <tuple>
+
+#ifndef ES_NO_THREADS
+#include <thread>
+#endif // ES_NO_THREADS
+
+using namespace std;
+
+namespace {
+	// The number of places around a system where another one is tried, before
+	// giving up on placing any more next to it.
+	constexpr int CANDIDATES = 30;
+	// The number of places where the first system is tried.
+	constexpr int FIRST_CANDIDATES = 1000;
+	// The largest grid that points are placed in.
+	constexpr double MAX_CELLS = 1 << 24;
+	
+	class Edge {
+	public:
+		Edge(const vector<Point> &points, size_t first, size_t second)
+			: length(points[first].Distance(points[second])), first(first), second(second) {}
+		
+		bool operator<(const Edge &other) const
+		{
+			return tie(length, first, second) < tie(other.length, other.first, other.second);
+		}
+		
+		double length;
+		size_t first;
+		size_t second;
+	};
+	
+	// The groups of points that are linked to each other.
+	class Components {
+	public:
+		explicit Components(size_t size)
+			: parent(size), count(size)
+		{
+			for(size_t i = 0; i < size; ++i)
+				parent[i] = i;
+		}
+		
+		size_t Find(size_t i)
+		{
+			while(parent[i] != i)
+				i = parent[i] = parent[parent[i]];
+			return i;
+		}
+		
+		// Join the groups of the given points, and return false if they already
+		// were in the same one.
+		bool Join(size_t first, size_t second)
+		{
+			first = Find(first);
+			second = Find(second);
+			if(first == second)
+				return false;
+			parent[second] = first;
+			--count;
+			return true;
+		}
+		
+		size_t Count() const { return count; }
+	
+	private:
+		vector<size_t> parent;
+		size_t count;
+	};
+	
+	// Check whether the segments from a to b and from c to d cross, not counting
+	// an end they share.
+	bool Crosses(const Point &a, const Point &b, const Point &c, const Point &d)
+	{
+		if(a == c || a == d || b == c || b == d)
+			return false;
+		auto side = [](const Point &from, const Point &to, const Point &point)
+		{
+			return (to - from).Cross(point - from);
+		};
+		return (side(a, b, c) > 0.) != (side(a, b, d) > 0.)
+			&& (side(c, d, a) > 0.) != (side(c, d, b) > 0.);
+	}
+}
+
+
+
+// Generate a region with the given settings, choosing the contents of its
+// systems from the given palette.
+void RegionGenerator::Generate(const Settings &settings, const SystemGenerator::Palette &palette)
+{
+	const vector<Point> points = Place(settings.polygon, settings.count, settings.spacing, settings.seed);
+	links = Link(points, settings.linkDistance, settings.links);
+	
+	systems.clear();
+	systems.resize(points.size());
+	for(size_t i = 0; i < points.size(); ++i)
+	{
+		System &system = systems[i];
+		system.name = settings.prefix + " " + to_string(i + 1);
+		system.position = points[i];
+		system.attributes.insert("uninhabited");
+		system.isDefined = true;
+		system.hasPosition = true;
+	}
+	
+	// Each system has its own seed, so it doesn't matter which thread randomizes it.
+	atomic<size_t> next(0);
+	auto Randomize = [&]() -> void
+	{
+		for(size_t i = next++; i < systems.size(); i = next++)
+		{
+			seed_seq sequence{static_cast<uint32_t>(settings.seed), static_cast<uint32_t>(i)};
+			uint32_t seed;
+			sequence.generate(&seed, &seed + 1);
+			SystemGenerator(palette, seed).Randomize(systems[i]);
+		}
+	};
+
+#ifndef ES_NO_THREADS
+	vector<thread> threads;
+	unsigned threadCount = max(1u, min(thread::hardware_concurrency(), 8u));
+	for(unsigned i = 1; i < threadCount; ++i)
+		threads.emplace_back(Randomize);
+	Randomize();
+	for(thread &it : threads)
+		it.join();
+#else
+	Randomize();
+#endif // ES_NO_THREADS
+}
+
+
+
+const vector<System> &RegionGenerator::Systems() const
+{
+	return systems;
+}
+
+
+
+// The links between the systems, as pairs of indices into Systems().
+const vector<pair<size_t, size_t>> &RegionGenerator::Links() const
+{
+	return links;
+}
+
+
+
+// Place up to the given number of points within the polygon, no closer to
+// each other than the given spacing. This is Bridson's algorithm: new points
+// are tried around the ones placed so far, until there is no room left around
+// any of them, so the region fills up outward from a random first point.
+vector<Point> RegionGenerator::Place(const vector<Point> &polygon, int count, double spacing, uint_fast32_t seed)
+{
+	vector<Point> points;
+	if(polygon.size() < 3 || count <= 0 || spacing <= 0.)
+		return points;
+	
+	Point low = polygon.front();
+	Point high = polygon.front();
+	for(const Point &corner : polygon)
+	{
+		low = Point(min(low.X(), corner.X()), min(low.Y(), corner.Y()));
+		high = Point(max(high.X(), corner.X()), max(high.Y(), corner.Y()));
+	}
+	if(high.X() <= low.X() || high.Y() <= low.Y())
+		return points;
+	
+	// Each cell of the grid is small enough to hold only one point.
+	const double cellSize = spacing / sqrt(2.);
+	const int width = ceil((high.X() - low.X()) / cellSize) + 1;
+	const int height = ceil((high.Y() - low.Y()) / cellSize) + 1;
+	if(static_cast<double>(width) * height > MAX_CELLS)
+		return points;
+	vector<int> grid(width * height, -1);
+	auto cellOf = [&](const Point &point)
+	{
+		return make_pair(static_cast<int>((point.X() - low.X()) / cellSize),
+			static_cast<int>((point.Y() - low.Y()) / cellSize));
+	};
+	auto isCrowded = [&](const Point &point)
+	{
+		const auto cell = cellOf(point);
+		for(int x = max(0, cell.first - 2); x <= min(width - 1, cell.first + 2); ++x)
+			for(int y = max(0, cell.second - 2); y <= min(height - 1, cell.second + 2); ++y)
+			{
+				const int other = grid[y * width + x];
+				if(other >= 0 && points[other].Distance(point) < spacing)
+					return true;
+			}
+		return false;
+	};
+	auto add = [&](const Point &point)
+	{
+		const auto cell = cellOf(point);
+		grid[cell.second * width + cell.first] = points.size();
+		points.push_back(point);
+	};
+	
+	mt19937 gen(seed);
+	uniform_real_distribution<> randX(low.X(), high.X());
+	uniform_real_distribution<> randY(low.Y(), high.Y());
+	for(int i = 0; i < FIRST_CANDIDATES && points.empty(); ++i)
+	{
+		const Point point(randX(gen), randY(gen));
+		if(Contains(polygon, point))
+			add(point);
+	}
+	
+	// The candidates are spread evenly over the ring between one and two
+	// spacings away from a point.
+	uniform_real_distribution<> randAngle(0., 360.);
+	uniform_real_distribution<> randArea(spacing * spacing, 4. * spacing * spacing);
+	vector<size_t> active(points.size(), 0);
+	while(!active.empty() && points.size() < static_cast<size_t>(count))
+	{
+		const size_t index = uniform_int_distribution<size_t>(0, active.size() - 1)(gen);
+		const Point origin = points[active[index]];
+		bool isPlaced = false;
+		for(int i = 0; i < CANDIDATES && !isPlaced; ++i)
+		{
+			const Point point = origin + sqrt(randArea(gen)) * Angle(randAngle(gen)).Unit();
+			if(Contains(polygon, point) && !isCrowded(point))
+			{
+				active.push_back(points.size());
+				add(point);
+				isPlaced = true;
+			}
+		}
+		if(!isPlaced)
+		{
+			active[index] = active.back();
+			active.pop_back();
+		}
+	}
+	return points;
+}
+
+
+
+// Link each point to its nearest neighbors, such that every point can be
+// reached from every other and no two links cross.
+vector<pair<size_t, size_t>> RegionGenerator::Link(const vector<Point> &points, double linkDistance, int links)
+{
+	vector<pair<size_t, size_t>> result;
+	if(points.size() < 2)
+		return result;
+	
+	// Find every pair of points within the link distance of each other.
+	vector<Edge> candidates;
+	if(linkDistance > 0.)
+	{
+		map<pair<int, int>, vector<size_t>> cells;
+		auto cellOf = [linkDistance](const Point &point)
+		{
+			return make_pair(static_cast<int>(floor(point.X() / linkDistance)),
+				static_cast<int>(floor(point.Y() / linkDistance)));
+		};
+		for(size_t i = 0; i < points.size(); ++i)
+			cells[cellOf(points[i])].push_back(i);
+		for(size_t i = 0; i < points.size(); ++i)
+		{
+			const auto cell = cellOf(points[i]);
+			for(int x = cell.first - 1; x <= cell.first + 1; ++x)
+				for(int y = cell.second - 1; y <= cell.second + 1; ++y)
+				{
+					auto it = cells.find(make_pair(x, y));
+					if(it != cells.end())
+						for(size_t j : it->second)
+							if(j > i && points[i].Distance(points[j]) <= linkDistance)
+								candidates.emplace_back(points, i, j);
+				}
+		}
+		sort(candidates.begin(), candidates.end());
+	}
+	
+	// The shortest links that connect all the points form a tree (with no
+	// crossing links). If the points are too far apart for that, longer links
+	// are considered too.
+	Components components(points.size());
+	vector<int> count(points.size());
+	vector<bool> isLinked(candidates.size());
+	auto link = [&](const Edge &edge)
+	{
+		result.emplace_back(edge.first, edge.second);
+		++count[edge.first];
+		++count[edge.second];
+	};
+	for(size_t i = 0; i < candidates.size(); ++i)
+		if(components.Join(candidates[i].first, candidates[i].second))
+		{
+			link(candidates[i]);
+			isLinked[i] = true;
+		}
+	if(components.Count() > 1)
+	{
+		vector<Edge> longer;
+		for(size_t i = 0; i < points.size(); ++i)
+			for(size_t j = i + 1; j < points.size(); ++j)
+				if(components.Find(i) != components.Find(j))
+					longer.emplace_back(points, i, j);
+		sort(longer.begin(), longer.end());
+		for(const Edge &edge : longer)
+			if(components.Join(edge.first, edge.second))
+				link(edge);
+	}
+	
+	// Then each point gets its nearest neighbors, as long as neither of them
+	// has enough links already and the link doesn't cross another one.
+	for(size_t i = 0; i < candidates.size(); ++i)
+	{
+		const Edge &edge = candidates[i];
+		if(isLinked[i] || count[edge.first] >= links || count[edge.second] >= links)
+			continue;
+		const Point &from = points[edge.first];
+		const Point &to = points[edge.second];
+		auto crosses = [&](const pair<size_t, size_t> &other)
+		{
+			return Crosses(from, to, points[other.first], points[other.second]);
+		};
+		if(none_of(result.begin(), result.end(), crosses))
+			link(edge);
+	}
+	return result;
+}
+
+
+
+// Check whether the given point is within the polygon, by counting how many of
+// its sides a ray from the point crosses.
+bool RegionGenerator::Contains(const vector<Point> &polygon, const Point &point)
+{
+	bool isInside = false;
+	for(size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++)
+	{
+		const Point &a = polygon[i];
+		const Point &b = polygon[j];
+		if((a.Y() > point.Y()) != (b.Y() > point.Y())
+				&& point.X() < (b.X() - a.X()) * (point.Y() - a.Y()) / (b.Y() - a.Y()) + a.X())
+			isInside = !isInside;
+	}
+	return isInside;
+}
@@ -0,0 +1,83 @@
+/* RegionGenerator.h
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef REGION_GENERATOR_H_
+#define REGION_GENERATOR_H_
+
+#include "Point.h"
+#include "System.h"
+#include "SystemGenerator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+
+// Class that lays out a new region of the map. The systems are placed at random
+// within a polygon, but never closer to each other than a given spacing, and
+// linked to their nearest neighbors so that each one can be reached from every
+// other. Then each system is filled with random stellar objects, asteroids,
+// minables and hazards. The systems are randomized in parallel, but each one
+// has its own seed, so the same settings always give the same region.
+// The systems that are generated are not part of the game data yet.
+class RegionGenerator {
+public:
+	class Settings {
+	public:
+		// The corners of the region, in order.
+		std::vector<Point> polygon;
+		// The number of systems to place, if there is enough room for them.
+		int count = 100;
+		// The minimum distance between two systems.
+		double spacing = 50.;
+		// Systems are linked to others within this distance, unless a longer
+		// link is needed to reach the rest of the region.
+		double linkDistance = 100.;
+		// The number of links a system gets, unless more are needed to reach
+		// the rest of the region.
+		int links = 3;
+		uint_fast32_t seed = 0;
+		// The systems are named after this, followed by their number.
+		std::string prefix = "Generated";
+	};
+	
+	
+public:
+	// Generate a region with the given settings, choosing the contents of its
+	// systems from the given palette.
+	void Generate(const Settings &settings, const SystemGenerator::Palette &palette);
+	
+	const std::vector<System> &Systems() const;
+	// The links between the systems, as pairs of indices into Systems().
+	const std::vector<std::pair<size_t, size_t>> &Links() const;
+	
+	// Place up to the given number of points within the polygon, no closer to
+	// each other than the given spacing (Poisson-disk sampling).
+	static std::vector<Point> Place(const std::vector<Point> &polygon, int count, double spacing, uint_fast32_t seed);
+	// Link each point to its nearest neighbors, such that every point can be
+	// reached from every other and no two links cross.
+	static std::vector<std::pair<size_t, size_t>> Link(const std::vector<Point> &points, double linkDistance, int links);
+	// Check whether the given point is within the polygon.
+	static bool Contains(const std::vector<Point> &polygon, const Point &point);
+	
+	
+private:
+	std::vector<System> systems;
+	std::vector<std::pair<size_t, size_t>> links;
+};
+
+
+
+#endif
@@ -0,0 +1,240 @@
+/* Replay.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "Replay.h"
+
+#include "BinaryIO.h"
+#include "Engine.h"
+#include "Files.h"
+#include "PlayerInfo.h"
+#include "Random.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+namespace {
+	// Every replay file starts with this, followed by the format version.
+	const char MAGIC[4] = {'E', 'S', 'R', 'P'};
+	const uint32_t VERSION = 1;
+	
+	string recordPath;
+	
+	// Doubles are stored as their bit pattern, so they are restored exactly.
+	uint64_t ToBits(double value)
+	{
+		uint64_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+	
+	double FromBits(uint64_t bits)
+	{
+		double value;
+		memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+}
+
+
+
+Replay::~Replay()
+{
+	if(file)
+	{
+		FlushRun();
+		fclose(file);
+	}
+}
+
+
+
+// Get or set where the game should record the player's flights (each time the
+// player takes off, the recording starts over). Empty if not recording.
+const string &Replay::RecordPath()
+{
+	return recordPath;
+}
+
+
+
+void Replay::SetRecordPath(const string &path)
+{
+	recordPath = path;
+}
+
+
+
+// Begin recording to the given file, starting from the given player's current
+// state. Returns false if the file could not be written.
+bool Replay::StartRecording(const string &path, const PlayerInfo &player, uint64_t seed)
+{
+	// The snapshot is an ordinary saved game, written out next to the replay.
+	string snapshotPath = path + "~snapshot.txt";
+	player.Save(snapshotPath);
+	string snapshot = Files::Read(snapshotPath);
+	Files::Delete(snapshotPath);
+	
+	file = BinaryIO::Open(path);
+	if(!file)
+	{
+		Files::LogError("Unable to write replay file \"" + path + "\".");
+		return false;
+	}
+	
+	string header(MAGIC, sizeof(MAGIC));
+	BinaryIO::Append(header, VERSION, 4);
+	BinaryIO::Append(header, seed, 8);
+	BinaryIO::Append(header, snapshot.size(), 8);
+	header += snapshot;
+	fwrite(header.data(), 1, header.size(), file);
+	return true;
+}
+
+
+
+// Record the player's commands for the next step.
+void Replay::Record(const Command &command)
+{
+	if(!file)
+		return;
+	
+	if(runLength && (command.state != lastCommand.state || ToBits(command.turn) != ToBits(lastCommand.turn)
+			|| runLength == UINT32_MAX))
+		FlushRun();
+	lastCommand = command;
+	++runLength;
+}
+
+
+
+// Load a recording. Returns false if it is not a valid replay file.
+bool Replay::Load(const string &path)
+{
+	string data = Files::Read(path);
+	commands.clear();
+	
+	size_t pos = sizeof(MAGIC);
+	uint64_t version = 0;
+	uint64_t size = 0;
+	if(data.compare(0, sizeof(MAGIC), MAGIC, sizeof(MAGIC)) || !BinaryIO::Extract(data, pos, version, 4)
+			|| version != VERSION || !BinaryIO::Extract(data, pos, seed, 8) || !BinaryIO::Extract(data, pos, size, 8)
+			|| data.size() - pos < size)
+	{
+		Files::LogError("\"" + path + "\" is not a valid replay file.");
+		return false;
+	}
+	snapshot = data.substr(pos, size);
+	pos += size;
+	
+	while(pos < data.size())
+	{
+		uint64_t count = 0;
+		uint64_t state = 0;
+		uint64_t turn = 0;
+		if(!BinaryIO::Extract(data, pos, count, 4) || !BinaryIO::Extract(data, pos, state, 8)
+				|| !BinaryIO::Extract(data, pos, turn, 8))
+		{
+			Files::LogError("Replay file \"" + path + "\" is truncated.");
+			return false;
+		}
+		Command command;
+		command.state = state;
+		command.turn = FromBits(turn);
+		commands.emplace_back(command, count);
+	}
+	return true;
+}
+
+
+
+// Simulate the loaded recording without a window and print the timing
+// statistics. Returns false if the replay could not be run.
+bool Replay::Run() const
+{
+	// Restore the player from the snapshot, then take off just like the
+	// recorded flight did.
+	string snapshotPath = Files::Config() + "replay~snapshot.txt";
+	Files::Write(snapshotPath, snapshot);
+	PlayerInfo player;
+	player.Load(snapshotPath);
+	Files::Delete(snapshotPath);
+	if(!player.IsLoaded() || !player.GetSystem() || !player.TakeOff(nullptr))
+	{
+		Files::LogError("The replay's saved game could not be loaded.");
+		return false;
+	}
+	
+	// Both the placement of the ships and the simulation itself must start
+	// from the recorded seed.
+	Engine engine(player);
+	Random::Seed(seed);
+	engine.Place();
+	engine.SeedSimulation(seed);
+	
+	vector<double> stepTimes;
+	for(const auto &it : commands)
+		for(uint32_t i = 0; i < it.second; ++i)
+		{
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			engine.StepHeadless(it.first);
+			stepTimes.push_back(chrono::duration<double>(chrono::steady_clock::now() - start).count());
+		}
+	if(stepTimes.empty())
+	{
+		Files::LogError("The replay does not contain any steps.");
+		return false;
+	}
+	
+	double total = 0.;
+	for(double time : stepTimes)
+		total += time;
+	sort(stepTimes.begin(), stepTimes.end());
+	auto Percentile = [&stepTimes](double fraction) -> double
+	{
+		return 1000. * stepTimes[min(stepTimes.size() - 1, static_cast<size_t>(fraction * stepTimes.size()))];
+	};
+	
+	cout << "Replayed " << stepTimes.size() << " steps in " << total << " s ("
+		<< stepTimes.size() / total << " steps/s)." << endl;
+	cout << "Step time (ms): min " << Percentile(0.) << ", median " << Percentile(.5)
+		<< ", 95% " << Percentile(.95) << ", 99% " << Percentile(.99)
+		<< ", max " << Percentile(1.) << ", mean " << 1000. * total / stepTimes.size() << endl;
+	for(int i = 0; i < Engine::PHASE_COUNT; ++i)
+	{
+		Engine::Phase phase = static_cast<Engine::Phase>(i);
+		cout << "  " << Engine::PhaseName(phase) << ": " << 1000. * engine.PhaseTime(phase) / stepTimes.size()
+			<< " ms/step" << endl;
+	}
+	// Identical replays must end in an identical state.
+	cout << "Final state checksum: " << hex << engine.Checksum() << dec << endl;
+	return true;
+}
+
+
+
+// Write the run of identical commands that is currently being recorded.
+void Replay::FlushRun()
+{
+	if(!runLength)
+		return;
+	
+	string out;
+	BinaryIO::Append(out, runLength, 4);
+	BinaryIO::Append(out, lastCommand.state, 8);
+	BinaryIO::Append(out, ToBits(lastCommand.turn), 8);
+	fwrite(out.data(), 1, out.size(), file);
+	runLength = 0;
+}
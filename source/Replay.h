@@ -0,0 +1,79 @@
+/* Replay.h
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include "Command.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+class PlayerInfo;
+
+
+
+// Class for recording the player's flight so that it can be simulated again
+// later, headless and without any real-time input. A recording stores a
+// snapshot of the player (as a saved game), the random seed the simulation was
+// started with, and the player's commands for every step of the simulation, in
+// a compact binary file. Every replay of the same file simulates exactly the
+// same thing, so it can be used to compare the performance of the Engine.
+// Only the commands given to the flagship are recorded, so anything done in
+// another panel (e.g. boarding or hailing) is not part of the replay.
+class Replay {
+public:
+	Replay() = default;
+	Replay(const Replay &) = delete;
+	Replay &operator=(const Replay &) = delete;
+	~Replay();
+	
+	// Get or set where the game should record the player's flights (each time
+	// the player takes off, the recording starts over). Empty if not recording.
+	static const std::string &RecordPath();
+	static void SetRecordPath(const std::string &path);
+	
+	// Begin recording to the given file, starting from the given player's
+	// current state. Returns false if the file could not be written.
+	bool StartRecording(const std::string &path, const PlayerInfo &player, uint64_t seed);
+	// Record the player's commands for the next step.
+	void Record(const Command &command);
+	
+	// Load a recording. Returns false if it is not a valid replay file.
+	bool Load(const std::string &path);
+	// Simulate the loaded recording without a window and print the timing
+	// statistics. Returns false if the replay could not be run.
+	bool Run() const;
+	
+	
+private:
+	// Write the run of identical commands that is currently being recorded.
+	void FlushRun();
+	
+	
+private:
+	FILE *file = nullptr;
+	Command lastCommand;
+	uint32_t runLength = 0;
+	
+	std::string snapshot;
+	uint64_t seed = 0;
+	// Each command, and how many steps in a row it was given for.
+	std::vector<std::pair<Command, uint32_t>> commands;
+};
+
+
+
+#endif
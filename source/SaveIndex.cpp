@@ -0,0 +1,242 @@
+/* SaveIndex.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "SaveIndex.h"
+
+#include "DataFile.h"
+#include "DataNode.h"
+#include "DataWriter.h"
+#include "Files.h"
+#include "SavedGame.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <map>
+#include <mutex>
+#ifndef ES_NO_THREADS
+#include <condition_variable>
+#include <thread>
+#endif // ES_NO_THREADS
+#include <utility>
+
+using namespace std;
+
+namespace {
+	class Entry {
+	public:
+		int64_t timestamp = -1;
+		uint64_t size = 0;
+		SavedGame header;
+	};
+	
+	mutex indexMutex;
+	map<string, Entry> entries;
+	deque<string> queue;
+	// The index file is only read once, the first time any header is needed.
+	bool isLoaded = false;
+	// Whether the index file is out of date.
+	bool isChanged = false;
+	// Incremented whenever any headers are added to the index.
+	atomic<size_t> generation(0);
+#ifndef ES_NO_THREADS
+	condition_variable idle;
+	// The reading thread only runs while there are headers in the queue.
+	thread worker;
+	bool isReading = false;
+#endif // ES_NO_THREADS
+
+	string IndexPath()
+	{
+		return Files::Config() + "cache/saves.txt";
+	}
+	
+	bool IsCurrent(const string &path, const Entry &entry)
+	{
+		return entry.timestamp == Files::Timestamp(path) && entry.size == Files::Size(path);
+	}
+	
+	// Read the index that was written the last time the game ran. The given
+	// lock must be held, and is released while the file is being read.
+	void LoadIndex(unique_lock<mutex> &lock)
+	{
+		if(isLoaded)
+			return;
+		isLoaded = true;
+		
+		lock.unlock();
+		map<string, Entry> loaded;
+		DataFile file(IndexPath());
+		for(const DataNode &node : file)
+			if(node.Token(0) == "save" && node.Size() >= 4)
+			{
+				Entry &entry = loaded[node.Token(1)];
+				entry.timestamp = node.Value(2);
+				entry.size = node.Value(3);
+				entry.header.LoadHeader(node);
+			}
+		lock.lock();
+		
+		// Any headers that were read in the meantime are newer.
+		for(auto &it : loaded)
+			entries.emplace(it.first, std::move(it.second));
+		++generation;
+	}
+	
+	void WriteIndex(const map<string, Entry> &index)
+	{
+		// A save that is changed again within the same second it was read in
+		// would still have the same timestamp, so only trust timestamps that
+		// are older than this index.
+		int64_t now = time(nullptr);
+		DataWriter out;
+		for(const auto &it : index)
+		{
+			// Leave out any saves that have been deleted.
+			if(!it.second.header.IsLoaded() || !Files::Exists(it.first))
+				continue;
+			
+			out.Write("save", it.first, it.second.timestamp < now ? it.second.timestamp : -1, it.second.size);
+			out.BeginChild();
+			{
+				it.second.header.SaveHeader(out);
+			}
+			out.EndChild();
+		}
+		
+		const string directory = Files::Config() + "cache";
+		if(!Files::Exists(directory))
+			Files::CreateNewDirectory(directory);
+		// Replace the old index only once the new one is complete.
+		const string temporary = IndexPath() + "~";
+		Files::Write(temporary, out.SaveToString());
+		Files::Move(temporary, IndexPath());
+	}
+	
+	void ReadQueue()
+	{
+		unique_lock<mutex> lock(indexMutex);
+		LoadIndex(lock);
+		while(true)
+		{
+			while(!queue.empty())
+			{
+				string path = std::move(queue.front());
+				queue.pop_front();
+				auto it = entries.find(path);
+				Entry entry = (it == entries.end() ? Entry() : it->second);
+				
+				lock.unlock();
+				bool isCurrent = IsCurrent(path, entry);
+				if(!isCurrent)
+				{
+					entry.size = Files::Size(path);
+					entry.timestamp = Files::Timestamp(path);
+					entry.header.Load(path);
+				}
+				lock.lock();
+				
+				if(!isCurrent)
+				{
+					entries[path] = std::move(entry);
+					isChanged = true;
+					++generation;
+				}
+			}
+			if(!isChanged)
+				break;
+			
+			// More headers may be queued while the index is being written.
+			isChanged = false;
+			map<string, Entry> index = entries;
+			lock.unlock();
+			WriteIndex(index);
+			lock.lock();
+		}
+#ifndef ES_NO_THREADS
+		isReading = false;
+		idle.notify_all();
+#endif // ES_NO_THREADS
+	}
+}
+
+
+
+// Get the header of the given saved game, if it has been read since the file
+// last changed. Otherwise, this returns false.
+bool SaveIndex::Get(const string &path, SavedGame &header)
+{
+	Entry entry;
+	{
+		lock_guard<mutex> lock(indexMutex);
+		auto it = entries.find(path);
+		if(it == entries.end())
+			return false;
+		entry = it->second;
+	}
+	if(!IsCurrent(path, entry) || !entry.header.IsLoaded())
+		return false;
+	
+	header = std::move(entry.header);
+	return true;
+}
+
+
+
+// This changes whenever any headers are read, so that anything waiting for a
+// header only has to look for it again once it does.
+size_t SaveIndex::Generation()
+{
+	return generation;
+}
+
+
+
+// Read the headers of any of the given saved games that are not known yet, in
+// the background. If the headers are needed right away, they are read before
+// any that were queued earlier.
+void SaveIndex::Update(const vector<string> &paths, bool isUrgent)
+{
+#ifndef ES_NO_THREADS
+	lock_guard<mutex> lock(indexMutex);
+	queue.insert(isUrgent ? queue.begin() : queue.end(), paths.begin(), paths.end());
+	if(!isReading)
+	{
+		// The previous thread has already finished reading.
+		if(worker.joinable())
+			worker.join();
+		isReading = true;
+		worker = thread(ReadQueue);
+	}
+#else
+	{
+		lock_guard<mutex> lock(indexMutex);
+		queue.insert(isUrgent ? queue.begin() : queue.end(), paths.begin(), paths.end());
+	}
+	ReadQueue();
+#endif // ES_NO_THREADS
+}
+
+
+
+// Block until every queued header has been read.
+void SaveIndex::Wait()
+{
+#ifndef ES_NO_THREADS
+	unique_lock<mutex> lock(indexMutex);
+	idle.wait(lock, []() noexcept -> bool { return !isReading; });
+	if(worker.joinable())
+		worker.join();
+#endif // ES_NO_THREADS
+}
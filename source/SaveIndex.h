@@ -0,0 +1,49 @@
+/* SaveIndex.h
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef SAVE_INDEX_H_
+#define SAVE_INDEX_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class SavedGame;
+
+
+
+// Class for remembering the headers of saved games (the pilot, date, location,
+// credits, and flagship that the load panel shows), so that browsing through
+// saves does not mean parsing each one of them. Headers are read on a background
+// thread, and are stored in "cache/saves.txt" in the config directory along with
+// the size and modification time of each save, so a save is only read again once
+// it has changed. Every path out of main() must call Wait(), so that the index
+// is written before the program exits.
+class SaveIndex {
+public:
+	// Get the header of the given saved game, if it has been read since the
+	// file last changed. Otherwise, this returns false.
+	static bool Get(const std::string &path, SavedGame &header);
+	// This changes whenever any headers are read, so that anything waiting for
+	// a header only has to look for it again once it does.
+	static size_t Generation();
+	// Read the headers of any of the given saved games that are not known yet,
+	// in the background. If the headers are needed right away, they are read
+	// before any that were queued earlier.
+	static void Update(const std::vector<std::string> &paths, bool isUrgent = false);
+	// Block until every queued header has been read.
+	static void Wait();
+};
+
+
+
+#endif
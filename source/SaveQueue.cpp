@@ -0,0 +1,126 @@
+/* SaveQueue.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "SaveQueue.h"
+
+#include "Files.h"
+#include "SavedGame.h"
+
+#include <deque>
+#ifndef ES_NO_THREADS
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif // ES_NO_THREADS
+#include <utility>
+
+using namespace std;
+
+namespace {
+	class Save {
+	public:
+		string path;
+		string data;
+		string date;
+	};
+	
+#ifndef ES_NO_THREADS
+	mutex queueMutex;
+	condition_variable idle;
+	deque<Save> queue;
+	// The writing thread only runs while there are saves in the queue.
+	thread worker;
+	bool isWriting = false;
+#endif // ES_NO_THREADS
+	
+	void WriteSave(const Save &save)
+	{
+		const string &path = save.path;
+		if(!save.date.empty() && path.rfind(".txt") == path.length() - 4)
+		{
+			// Only update the backups if this save will have a newer date.
+			// Reading the date does not require parsing the whole file.
+			if(SavedGame::ReadDate(path) != save.date)
+			{
+				string root = path.substr(0, path.length() - 4);
+				string files[4] = {
+					root + "~~previous-3.txt",
+					root + "~~previous-2.txt",
+					root + "~~previous-1.txt",
+					path
+				};
+				for(int i = 0; i < 3; ++i)
+					if(Files::Exists(files[i + 1]))
+						Files::Move(files[i + 1], files[i]);
+			}
+		}
+		
+		// Replace the old file only once the new one is complete.
+		string temporary = path + "~saving";
+		Files::Write(temporary, save.data);
+		Files::Move(temporary, path);
+	}
+	
+#ifndef ES_NO_THREADS
+	void WriteQueue()
+	{
+		unique_lock<mutex> lock(queueMutex);
+		while(!queue.empty())
+		{
+			Save save = std::move(queue.front());
+			queue.pop_front();
+			
+			lock.unlock();
+			WriteSave(save);
+			lock.lock();
+		}
+		isWriting = false;
+		idle.notify_all();
+	}
+#endif // ES_NO_THREADS
+}
+
+
+
+// Queue the given data to be written to the given path. If a date is given,
+// the existing file is first moved into the backups (the "~~previous" files),
+// unless it has that same date.
+void SaveQueue::Write(const string &path, string data, const string &date)
+{
+#ifndef ES_NO_THREADS
+	lock_guard<mutex> lock(queueMutex);
+	queue.push_back(Save{path, std::move(data), date});
+	if(!isWriting)
+	{
+		// The previous thread has already finished writing.
+		if(worker.joinable())
+			worker.join();
+		isWriting = true;
+		worker = thread(WriteQueue);
+	}
+#else
+	WriteSave(Save{path, std::move(data), date});
+#endif // ES_NO_THREADS
+}
+
+
+
+// Block until every queued save has been written.
+void SaveQueue::Wait()
+{
+#ifndef ES_NO_THREADS
+	unique_lock<mutex> lock(queueMutex);
+	idle.wait(lock, []() noexcept -> bool { return !isWriting; });
+	if(worker.joinable())
+		worker.join();
+#endif // ES_NO_THREADS
+}
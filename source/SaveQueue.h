@@ -0,0 +1,39 @@
+/* SaveQueue.h
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef SAVE_QUEUE_H_
+#define SAVE_QUEUE_H_
+
+#include <string>
+
+
+
+// Class for writing saved games on a background thread, so that saving does not
+// interrupt the game. Saves are written in the order they were queued. Each one
+// is first written to a temporary file which then replaces the old save, so a
+// crash while saving never leaves a partially written save behind. Anything
+// that reads or copies saved games must call Wait() first, and so must every
+// path out of main(), so that queued saves are written before the program
+// exits.
+class SaveQueue {
+public:
+	// Queue the given data to be written to the given path. If a date is
+	// given, the existing file is first moved into the backups (the
+	// "~~previous" files), unless it has that same date.
+	static void Write(const std::string &path, std::string data, const std::string &date = "");
+	// Block until every queued save has been written.
+	static void Wait();
+};
+
+
+
+#endif
@@ -14,12 +14,22 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "DataFile.h"
 #include "DataNode.h"
+#include "DataWriter.h"
 #include "Date.h"
+#include "File.h"
 #include "text/Format.h"
 #include "SpriteSet.h"
 
+#include <sstream>
+
 using namespace std;
 
+namespace {
+	// The date is near the start of every saved game, so only this much of a
+	// file needs to be read to find it.
+	const size_t HEADER_SIZE = 4096;
+}
+
 
 
 SavedGame::SavedGame(const string &path)
@@ -29,10 +39,41 @@ SavedGame::SavedGame(const string &path)
 
 
 
+// Read just the date from the beginning of the given saved game, without parsing
+// the rest of the file. Returns an empty string if there is none.
+string SavedGame::ReadDate(const string &path)
+{
+	File file(path);
+	if(!file)
+		return string();
+	
+	string header(HEADER_SIZE, '\0');
+	header.resize(fread(&header[0], 1, header.size(), file));
+	// Only parse complete lines. If the whole file was read, its last line
+	// is complete even if it does not end in a newline.
+	if(header.size() == HEADER_SIZE)
+		header.resize(header.rfind('\n') + 1);
+	
+	istringstream in(header);
+	DataFile data(in);
+	for(const DataNode &node : data)
+		if(node.Token(0) == "date" && node.Size() >= 4)
+			return Date(node.Value(1), node.Value(2), node.Value(3)).ToString();
+	return string();
+}
+
+
+
 void SavedGame::Load(const string &path)
+{
+	Load(DataFile(path), path);
+}
+
+
+
+void SavedGame::Load(const DataFile &file, const string &path)
 {
 	Clear();
-	DataFile file(path);
 	if(file.begin() != file.end())
 		this->path = path;
 	
@@ -57,14 +98,14 @@ void SavedGame::Load(const string &path)
 					break;
 				}
 		}
-		else if(node.Token(0) == "ship" && !shipSprite)
+		else if(node.Token(0) == "ship" && shipSprite.empty())
 		{
 			for(const DataNode &child : node)
 			{
 				if(child.Token(0) == "name" && child.Size() >= 2)
 					shipName = child.Token(1);
 				else if(child.Token(0) == "sprite" && child.Size() >= 2)
-					shipSprite = SpriteSet::Get(child.Token(1));
+					shipSprite = child.Token(1);
 			}
 		}
 	}
@@ -72,6 +113,60 @@ void SavedGame::Load(const string &path)
 
 
 
+// Read or write only the information that the load panel shows, so that it can
+// be cached without keeping the whole saved game around. The header is stored
+// as the children of a node whose second token is the path of the saved game.
+void SavedGame::LoadHeader(const DataNode &node)
+{
+	Clear();
+	if(node.Size() < 2)
+		return;
+	
+	path = node.Token(1);
+	for(const DataNode &child : node)
+	{
+		const string &key = child.Token(0);
+		if(child.Size() < 2)
+			continue;
+		if(key == "pilot")
+			name = child.Token(1);
+		else if(key == "credits")
+			credits = child.Token(1);
+		else if(key == "date")
+			date = child.Token(1);
+		else if(key == "system")
+			system = child.Token(1);
+		else if(key == "planet")
+			planet = child.Token(1);
+		else if(key == "playtime")
+			playTime = child.Token(1);
+		else if(key == "ship")
+			shipName = child.Token(1);
+		else if(key == "sprite")
+			shipSprite = child.Token(1);
+	}
+}
+
+
+
+void SavedGame::SaveHeader(DataWriter &out) const
+{
+	out.Write("pilot", name);
+	out.Write("credits", credits);
+	out.Write("date", date);
+	if(!system.empty())
+		out.Write("system", system);
+	if(!planet.empty())
+		out.Write("planet", planet);
+	out.Write("playtime", playTime);
+	if(!shipName.empty())
+		out.Write("ship", shipName);
+	if(!shipSprite.empty())
+		out.Write("sprite", shipSprite);
+}
+
+
+
 const string &SavedGame::Path() const
 {
 	return path;
@@ -98,7 +193,7 @@ void SavedGame::Clear()
 	planet.clear();
 	playTime = "0s";
 	
-	shipSprite = nullptr;
+	shipSprite.clear();
 	shipName.clear();
 }
 
@@ -148,7 +243,7 @@ const string &SavedGame::GetPlayTime() const
 
 const Sprite *SavedGame::ShipSprite() const
 {
-	return shipSprite;
+	return shipSprite.empty() ? nullptr : SpriteSet::Get(shipSprite);
 }
 
 
@@ -15,6 +15,9 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include <string>
 
+class DataFile;
+class DataNode;
+class DataWriter;
 class Sprite;
 
 
@@ -29,7 +32,18 @@ public:
 	SavedGame() = default;
 	explicit SavedGame(const std::string &path);
 	
+	// Read just the date from the beginning of the given saved game, without
+	// parsing the rest of the file. Returns an empty string if there is none.
+	static std::string ReadDate(const std::string &path);
+	
 	void Load(const std::string &path);
+	void Load(const DataFile &file, const std::string &path);
+	// Read or write only the information that the load panel shows, so that
+	// it can be cached without keeping the whole saved game around. The
+	// header is stored as the children of a node whose second token is the
+	// path of the saved game.
+	void LoadHeader(const DataNode &node);
+	void SaveHeader(DataWriter &out) const;
 	const std::string &Path() const;
 	bool IsLoaded() const;
 	void Clear();
@@ -57,7 +71,9 @@ private:
 	std::string planet;
 	std::string playTime;
 	
-	const Sprite *shipSprite = nullptr;
+	// The sprite is only looked up when it is needed, so that saved games can
+	// be read on any thread.
+	std::string shipSprite;
 	std::string shipName;
 };
 
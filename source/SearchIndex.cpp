@@ -0,0 +1,412 @@
+/* SearchIndex.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "SearchIndex.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+
+using namespace std;
+
+namespace {
+	// The number of changes to index before letting any searches run.
+	const size_t BATCH_SIZE = 256;
+	// Removed objects are only dropped from the index once there are this many.
+	const size_t MIN_REMOVED = 1024;
+	
+	// How well each kind of match ranks. Shorter names rank higher within each
+	// kind, by up to one less than the difference between two kinds.
+	const int EXACT_NAME = 1000;
+	const int NAME_PREFIX = 800;
+	const int NAME_WORD = 600;
+	const int NAME_SUBSTRING = 400;
+	const int EXACT_ATTRIBUTE = 300;
+	const int ATTRIBUTE_PREFIX = 250;
+	const int ATTRIBUTE_SUBSTRING = 200;
+	const int MAX_LENGTH_PENALTY = 49;
+	
+	string Lower(const string &text)
+	{
+		string lower = text;
+		for(char &c : lower)
+			c = tolower(static_cast<unsigned char>(c));
+		return lower;
+	}
+	
+	// Get every distinct trigram in the given text, in sorted order.
+	void Trigrams(const string &text, vector<uint32_t> &codes)
+	{
+		for(size_t i = 2; i < text.size(); ++i)
+			codes.push_back(static_cast<uint32_t>(static_cast<unsigned char>(text[i - 2])) << 16
+				| static_cast<uint32_t>(static_cast<unsigned char>(text[i - 1])) << 8
+				| static_cast<uint32_t>(static_cast<unsigned char>(text[i])));
+		sort(codes.begin(), codes.end());
+		codes.erase(unique(codes.begin(), codes.end()), codes.end());
+	}
+	
+	// Get the objects that contain every one of the given trigrams.
+	vector<uint32_t> Intersect(const unordered_map<uint32_t, vector<uint32_t>> &trigrams, const vector<uint32_t> &codes)
+	{
+		vector<const vector<uint32_t> *> lists;
+		for(uint32_t code : codes)
+		{
+			auto it = trigrams.find(code);
+			if(it == trigrams.end())
+				return {};
+			lists.push_back(&it->second);
+		}
+		// Starting with the shortest list keeps every intersection small.
+		sort(lists.begin(), lists.end(),
+			[](const vector<uint32_t> *a, const vector<uint32_t> *b) { return a->size() < b->size(); });
+		
+		vector<uint32_t> result = *lists.front();
+		vector<uint32_t> next;
+		for(size_t i = 1; i < lists.size() && !result.empty(); ++i)
+		{
+			next.clear();
+			set_intersection(result.begin(), result.end(), lists[i]->begin(), lists[i]->end(), back_inserter(next));
+			result.swap(next);
+		}
+		return result;
+	}
+	
+	int NameScore(const string &name, const string &query)
+	{
+		size_t pos = name.find(query);
+		if(pos == string::npos)
+			return 0;
+		
+		int score = NAME_SUBSTRING;
+		if(name.size() == query.size())
+			score = EXACT_NAME;
+		else if(!pos)
+			score = NAME_PREFIX;
+		else
+			for( ; pos != string::npos; pos = name.find(query, pos + 1))
+				if(!isalnum(static_cast<unsigned char>(name[pos - 1])))
+				{
+					score = NAME_WORD;
+					break;
+				}
+		return score - static_cast<int>(min<size_t>(name.size(), MAX_LENGTH_PENALTY));
+	}
+	
+	int AttributeScore(const string &attribute, const string &query)
+	{
+		size_t pos = attribute.find(query);
+		if(pos == string::npos)
+			return 0;
+		if(attribute.size() == query.size())
+			return EXACT_ATTRIBUTE;
+		return pos ? ATTRIBUTE_SUBSTRING : ATTRIBUTE_PREFIX;
+	}
+}
+
+
+
+SearchIndex::~SearchIndex()
+{
+	{
+		lock_guard<mutex> lock(indexMutex);
+		queue.clear();
+	}
+	Wait();
+}
+
+
+
+// Replace the attributes of the given object (its name is always searched).
+void SearchIndex::Add(const Key &object, vector<string> attributes)
+{
+	Queue(Change{object, std::move(attributes), false});
+}
+
+
+
+void SearchIndex::Remove(const Key &object)
+{
+	Queue(Change{object, {}, true});
+}
+
+
+
+void SearchIndex::Clear()
+{
+	lock_guard<mutex> lock(indexMutex);
+	queue.clear();
+	++generation;
+	documents.clear();
+	ids.clear();
+	removed = 0;
+	nameTrigrams.clear();
+	attributeTrigrams.clear();
+}
+
+
+
+// Block until every object that was added has been indexed.
+void SearchIndex::Wait()
+{
+#ifndef ES_NO_THREADS
+	unique_lock<mutex> lock(indexMutex);
+	idle.wait(lock, [this]() noexcept -> bool { return !isIndexing; });
+	if(worker.joinable())
+		worker.join();
+#endif // ES_NO_THREADS
+}
+
+
+
+// Find the objects whose name (or attributes) contain the query, ignoring case.
+// At most the given number of the best matches of each kind of object are
+// returned, with the kinds that have the best matches first.
+vector<SearchIndex::Result> SearchIndex::Find(const string &query, bool searchAttributes, size_t limit) const
+{
+	const string needle = Lower(query);
+	if(needle.empty() || !limit)
+		return {};
+	vector<uint32_t> codes;
+	Trigrams(needle, codes);
+	
+	lock_guard<mutex> lock(indexMutex);
+	// Queries that are too short to have any trigrams have to check everything.
+	vector<uint32_t> all;
+	if(codes.empty())
+		for(uint32_t id = 0; id < documents.size(); ++id)
+			all.push_back(id);
+	
+	map<string, vector<Result>> byType;
+	const vector<uint32_t> names = codes.empty() ? all : Intersect(nameTrigrams, codes);
+	for(uint32_t id : names)
+	{
+		const Document &document = documents[id];
+		if(document.isRemoved)
+			continue;
+		const int score = NameScore(document.name, needle);
+		if(score)
+			byType[document.key.first].push_back(Result{document.key, string(), score});
+	}
+	if(searchAttributes)
+	{
+		const vector<uint32_t> attributes = codes.empty() ? all : Intersect(attributeTrigrams, codes);
+		for(uint32_t id : attributes)
+		{
+			const Document &document = documents[id];
+			// Objects that are found by their name are only listed once.
+			if(document.isRemoved || NameScore(document.name, needle))
+				continue;
+			Result result{document.key, string(), 0};
+			for(const string &attribute : document.attributes)
+			{
+				const int score = AttributeScore(attribute, needle);
+				if(score > result.score)
+				{
+					result.score = score;
+					result.match = attribute;
+				}
+			}
+			if(result.score)
+				byType[document.key.first].push_back(std::move(result));
+		}
+	}
+	
+	// Rank the results of each kind separately, so that a kind of object with
+	// many matches doesn't hide every match of the other kinds.
+	vector<vector<Result> *> types;
+	for(auto &it : byType)
+	{
+		vector<Result> &results = it.second;
+		const auto better = [](const Result &a, const Result &b) noexcept -> bool
+		{
+			return a.score != b.score ? a.score > b.score : a.key.second < b.key.second;
+		};
+		if(results.size() > limit)
+		{
+			partial_sort(results.begin(), results.begin() + limit, results.end(), better);
+			results.resize(limit);
+		}
+		else
+			sort(results.begin(), results.end(), better);
+		types.push_back(&results);
+	}
+	stable_sort(types.begin(), types.end(),
+		[](const vector<Result> *a, const vector<Result> *b) { return a->front().score > b->front().score; });
+	
+	vector<Result> results;
+	for(vector<Result> *type : types)
+		move(type->begin(), type->end(), back_inserter(results));
+	return results;
+}
+
+
+
+// The number of objects that have been indexed.
+size_t SearchIndex::Size() const
+{
+	lock_guard<mutex> lock(indexMutex);
+	return ids.size();
+}
+
+
+
+bool SearchIndex::IsIndexing() const
+{
+	lock_guard<mutex> lock(indexMutex);
+#ifndef ES_NO_THREADS
+	return isIndexing;
+#else
+	return !queue.empty();
+#endif // ES_NO_THREADS
+}
+
+
+
+void SearchIndex::Queue(Change change)
+{
+#ifndef ES_NO_THREADS
+	lock_guard<mutex> lock(indexMutex);
+	queue.push_back(std::move(change));
+	if(!isIndexing)
+	{
+		// The previous thread has already finished indexing.
+		if(worker.joinable())
+			worker.join();
+		isIndexing = true;
+		worker = thread(&SearchIndex::IndexQueue, this);
+	}
+#else
+	{
+		lock_guard<mutex> lock(indexMutex);
+		queue.push_back(std::move(change));
+	}
+	IndexQueue();
+#endif // ES_NO_THREADS
+}
+
+
+
+void SearchIndex::IndexQueue()
+{
+	unique_lock<mutex> lock(indexMutex);
+	while(!queue.empty())
+	{
+		const uint64_t batchGeneration = generation;
+		vector<Change> batch;
+		while(!queue.empty() && batch.size() < BATCH_SIZE)
+		{
+			batch.push_back(std::move(queue.front()));
+			queue.pop_front();
+		}
+		
+		// Converting the text into trigrams doesn't need the index, so searches
+		// can still run in the meantime.
+		lock.unlock();
+		vector<Document> prepared(batch.size());
+		vector<vector<uint32_t>> names(batch.size());
+		vector<vector<uint32_t>> attributes(batch.size());
+		for(size_t i = 0; i < batch.size(); ++i)
+		{
+			if(batch[i].isRemoval)
+				continue;
+			Document &document = prepared[i];
+			document.key = std::move(batch[i].key);
+			document.name = Lower(document.key.second);
+			Trigrams(document.name, names[i]);
+			for(const string &attribute : batch[i].attributes)
+			{
+				document.attributes.push_back(Lower(attribute));
+				Trigrams(document.attributes.back(), attributes[i]);
+			}
+			sort(attributes[i].begin(), attributes[i].end());
+			attributes[i].erase(unique(attributes[i].begin(), attributes[i].end()), attributes[i].end());
+		}
+		lock.lock();
+		
+		if(generation != batchGeneration)
+			continue;
+		for(size_t i = 0; i < batch.size(); ++i)
+		{
+			if(batch[i].isRemoval)
+				Erase(batch[i].key);
+			else
+				Insert(std::move(prepared[i]), names[i], attributes[i]);
+		}
+		Compact();
+	}
+#ifndef ES_NO_THREADS
+	isIndexing = false;
+	idle.notify_all();
+#endif // ES_NO_THREADS
+}
+
+
+
+// Add an object whose text has already been converted to lower case, along
+// with the trigrams of its name and of its attributes.
+void SearchIndex::Insert(Document document, const vector<uint32_t> &names, const vector<uint32_t> &attributes)
+{
+	Erase(document.key);
+	
+	const uint32_t id = documents.size();
+	for(uint32_t code : names)
+		nameTrigrams[code].push_back(id);
+	for(uint32_t code : attributes)
+		attributeTrigrams[code].push_back(id);
+	ids[document.key] = id;
+	documents.push_back(std::move(document));
+}
+
+
+
+void SearchIndex::Erase(const Key &key)
+{
+	auto it = ids.find(key);
+	if(it == ids.end())
+		return;
+	
+	documents[it->second].isRemoved = true;
+	ids.erase(it);
+	++removed;
+}
+
+
+
+// Drop the removed objects from the index, once there are too many of them.
+void SearchIndex::Compact()
+{
+	if(removed < MIN_REMOVED || removed * 2 < documents.size())
+		return;
+	
+	vector<Document> remaining;
+	remaining.reserve(documents.size() - removed);
+	for(Document &document : documents)
+		if(!document.isRemoved)
+			remaining.push_back(std::move(document));
+	
+	documents.clear();
+	ids.clear();
+	removed = 0;
+	nameTrigrams.clear();
+	attributeTrigrams.clear();
+	for(Document &document : remaining)
+	{
+		vector<uint32_t> names;
+		Trigrams(document.name, names);
+		vector<uint32_t> attributes;
+		for(const string &attribute : document.attributes)
+			Trigrams(attribute, attributes);
+		sort(attributes.begin(), attributes.end());
+		attributes.erase(unique(attributes.begin(), attributes.end()), attributes.end());
+		Insert(std::move(document), names, attributes);
+	}
+}
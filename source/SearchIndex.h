@@ -0,0 +1,125 @@
+/* SearchIndex.h
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef SEARCH_INDEX_H_
+#define SEARCH_INDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#ifndef ES_NO_THREADS
+#include <condition_variable>
+#include <thread>
+#endif // ES_NO_THREADS
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+
+// Class for finding game objects of every kind by their name, or by the text of
+// their attributes (e.g. every outfit that does "ion damage"). The text of each
+// object is split into trigrams (every three consecutive characters), and each
+// trigram is mapped to the objects that contain it, so a search only needs to
+// look at the objects that contain every trigram of the query. Objects are
+// indexed on a background thread, so while the game data is still being indexed
+// searching returns whatever has been indexed so far.
+class SearchIndex {
+public:
+	using Key = std::pair<std::string, std::string>;
+	
+	class Result {
+	public:
+		Key key;
+		// The attribute that matched the query, or empty if the name matched.
+		std::string match;
+		int score;
+	};
+	
+	
+public:
+	SearchIndex() = default;
+	SearchIndex(const SearchIndex &) = delete;
+	SearchIndex &operator=(const SearchIndex &) = delete;
+	~SearchIndex();
+	
+	// Replace the attributes of the given object (its name is always searched).
+	void Add(const Key &object, std::vector<std::string> attributes = {});
+	void Remove(const Key &object);
+	void Clear();
+	// Block until every object that was added has been indexed.
+	void Wait();
+	
+	// Find the objects whose name (or attributes) contain the query, ignoring
+	// case. At most the given number of the best matches of each kind of object
+	// are returned, with the kinds that have the best matches first.
+	std::vector<Result> Find(const std::string &query, bool searchAttributes, size_t limit) const;
+	// The number of objects that have been indexed.
+	size_t Size() const;
+	bool IsIndexing() const;
+	
+	
+private:
+	class Document {
+	public:
+		Key key;
+		std::string name;
+		std::vector<std::string> attributes;
+		bool isRemoved = false;
+	};
+	
+	class Change {
+	public:
+		Key key;
+		std::vector<std::string> attributes;
+		bool isRemoval = false;
+	};
+	
+	
+private:
+	void Queue(Change change);
+	void IndexQueue();
+	// Add an object whose text has already been converted to lower case, along
+	// with the trigrams of its name and of its attributes.
+	void Insert(Document document, const std::vector<uint32_t> &names, const std::vector<uint32_t> &attributes);
+	void Erase(const Key &key);
+	// Drop the removed objects from the index, once there are too many of them.
+	void Compact();
+	
+	
+private:
+	mutable std::mutex indexMutex;
+	std::deque<Change> queue;
+	// Changes that were queued before the index was cleared are never indexed.
+	uint64_t generation = 0;
+#ifndef ES_NO_THREADS
+	std::condition_variable idle;
+	// The indexing thread only runs while there are objects in the queue.
+	std::thread worker;
+	bool isIndexing = false;
+#endif // ES_NO_THREADS
+
+	// Objects are never removed from the list of documents, only marked as
+	// removed, so that the lists of objects of each trigram stay sorted.
+	std::vector<Document> documents;
+	std::map<Key, uint32_t> ids;
+	size_t removed = 0;
+	std::unordered_map<uint32_t, std::vector<uint32_t>> nameTrigrams;
+	std::unordered_map<uint32_t, std::vector<uint32_t>> attributeTrigrams;
+};
+
+
+
+#endif
@@ -40,6 +40,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include <algorithm>
 #include <cmath>
+#include <iterator>
 #include <limits>
 #include <sstream>
 
@@ -1350,7 +1351,7 @@ const Command &Ship::Commands() const
 // Move this ship. A ship may create effects as it moves, in particular if
 // it is in the process of blowing up. If this returns false, the ship
 // should be deleted.
-void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
+void Ship::Move(vector<Visual> &visuals, vector<shared_ptr<Flotsam>> &flotsam)
 {
 	// Check if this ship has been in a different system from the player for so
 	// long that it should be "forgotten." Also eliminate ships that have no
@@ -1394,7 +1395,8 @@ void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 	if(!jettisoned.empty() && !forget)
 	{
 		jettisoned.front()->Place(*this);
-		flotsam.splice(flotsam.end(), jettisoned, jettisoned.begin());
+		flotsam.push_back(std::move(jettisoned.front()));
+		jettisoned.pop_front();
 	}
 	int requiredCrew = RequiredCrew();
 	double slowMultiplier = 1. / (1. + slowness * .05);
@@ -1478,7 +1480,8 @@ void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 						Jettison(it.first, Random::Binomial(it.second, .05));
 				for(shared_ptr<Flotsam> &it : jettisoned)
 					it->Place(*this);
-				flotsam.splice(flotsam.end(), jettisoned);
+				flotsam.insert(flotsam.end(), make_move_iterator(jettisoned.begin()), make_move_iterator(jettisoned.end()));
+				jettisoned.clear();
 				
 				// Any ships that failed to launch from this ship are destroyed.
 				for(Bay &bay : bays)
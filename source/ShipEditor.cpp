@@ -54,6 +54,22 @@ ShipEditor::ShipEditor(Editor &editor, bool &show) noexcept
 
 
 
+// Renames the current object, and updates everything that refers to it.
+void ShipEditor::Rename(const string &name)
+{
+	DeleteFromChanges();
+	editor.RenameObject(keyFor<Ship>(), object->TrueName(), name);
+	GameData::Ships().Rename(object->TrueName(), name);
+	if(!object->variantName.empty())
+		object->variantName = name;
+	else
+		object->modelName = name;
+	WriteToPlugin(object, false);
+	SetDirty();
+}
+
+
+
 void ShipEditor::Render()
 {
 	if(IsDirty())
@@ -93,14 +109,7 @@ void ShipEditor::Render()
 			if(ImGui::MenuItem("Reset", nullptr, false, object && IsDirty()))
 			{
 				SetClean();
-				bool found = false;
-				for(auto &&change : Changes())
-					if(change.TrueName() == object->TrueName())
-					{
-						*object = change;
-						found = true;
-						break;
-					}
+				bool found = RestoreSaved();
 
 				if(!found && GameData::baseShips.Has(object->TrueName()))
 					*object = *GameData::baseShips.Get(object->TrueName());
@@ -114,10 +123,7 @@ void ShipEditor::Render()
 			}
 			if(ImGui::MenuItem("Delete", nullptr, false, alreadyDefined))
 			{
-				if(find_if(Changes().begin(), Changes().end(), [this](const Ship &ship)
-							{
-								return ship.TrueName() == object->TrueName();
-							}) != Changes().end())
+				if(IsSaved())
 				{
 					SetDirty("[deleted]");
 					DeleteFromChanges();
@@ -169,18 +175,7 @@ void ShipEditor::Render()
 				object = newShip;
 				SetDirty();
 			});
-	ImGui::BeginSimpleRenameModal("Rename Ship", [this](const string &name)
-			{
-				DeleteFromChanges();
-				editor.RenameObject(keyFor<Ship>(), object->TrueName(), name);
-				GameData::Ships().Rename(object->TrueName(), name);
-				if(!object->variantName.empty())
-					object->variantName = name;
-				else
-					object->modelName = name;
-				WriteToPlugin(object, false);
-				SetDirty();
-			});
+	ImGui::BeginSimpleRenameModal("Rename Ship", [this](const string &name) { Rename(name); });
 	ImGui::BeginSimpleCloneModal("Clone Model", [this](const string &name)
 			{
 				auto *clone = const_cast<Ship *>(GameData::Ships().Get(name));
@@ -223,9 +218,9 @@ void ShipEditor::RenderShip()
 		ImGui::Text("model: %s", object->base->ModelName().c_str());
 		ImGui::Text("variant: %s", object->variantName.c_str());
 	}
-	if(ImGui::InputText("plural", &object->pluralModelName))
+	if(ImGui::InputText("plural", Track(object->pluralModelName)))
 		SetDirty();
-	if(ImGui::InputText("noun", &object->noun))
+	if(ImGui::InputText("noun", Track(object->noun)))
 		SetDirty();
 	RenderElement(object, "sprite");
 	static string thumbnail;
@@ -237,7 +232,7 @@ void ShipEditor::RenderShip()
 		object->thumbnail = thumbnailSprite;
 		SetDirty();
 	}
-	if(ImGui::Checkbox("never disabled", &object->neverDisabled))
+	if(ImGui::Checkbox("never disabled", Track(object->neverDisabled)))
 		SetDirty();
 	bool uncapturable = !object->isCapturable;
 	if(ImGui::Checkbox("uncapturable", &uncapturable))
@@ -245,7 +240,7 @@ void ShipEditor::RenderShip()
 		object->isCapturable = !uncapturable;
 		SetDirty();
 	}
-	if(ImGui::InputSwizzle("swizzle", &object->customSwizzle, true))
+	if(ImGui::InputSwizzle("swizzle", Track(object->customSwizzle), true))
 		SetDirty();
 
 	if(ImGui::TreeNode("attributes"))
@@ -267,7 +262,7 @@ void ShipEditor::RenderShip()
 			}
 			ImGui::EndCombo();
 		}
-		if(ImGui::InputInt64Ex("cost", &object->baseAttributes.cost))
+		if(ImGui::InputInt64Ex("cost", Track(object->baseAttributes.cost)))
 			SetDirty();
 
 		double oldMass = object->baseAttributes.mass;
@@ -324,13 +319,13 @@ void ShipEditor::RenderShip()
 			RenderEffect("jump effect", object->baseAttributes.jumpEffects);
 			ImGui::TreePop();
 		}
-		if(ImGui::InputDoubleEx("blast radius", &object->baseAttributes.blastRadius))
+		if(ImGui::InputDoubleEx("blast radius", Track(object->baseAttributes.blastRadius)))
 			SetDirty();
-		if(ImGui::InputDoubleEx("shield damage", &object->baseAttributes.damage[Weapon::SHIELD_DAMAGE]))
+		if(ImGui::InputDoubleEx("shield damage", Track(object->baseAttributes.damage[Weapon::SHIELD_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("hull damage", &object->baseAttributes.damage[Weapon::HULL_DAMAGE]))
+		if(ImGui::InputDoubleEx("hull damage", Track(object->baseAttributes.damage[Weapon::HULL_DAMAGE])))
 			SetDirty();
-		if(ImGui::InputDoubleEx("hit force", &object->baseAttributes.damage[Weapon::HIT_FORCE]))
+		if(ImGui::InputDoubleEx("hit force", Track(object->baseAttributes.damage[Weapon::HIT_FORCE])))
 			SetDirty();
 		for(auto &it : object->baseAttributes.attributes)
 			if(it.second)
@@ -391,13 +386,13 @@ void ShipEditor::RenderShip()
 		ImGui::TreePop();
 	}
 
-	if(ImGui::InputInt("crew", &object->crew))
+	if(ImGui::InputInt("crew", Track(object->crew)))
 		SetDirty();
-	if(ImGui::InputDoubleEx("fuel", &object->fuel))
+	if(ImGui::InputDoubleEx("fuel", Track(object->fuel)))
 		SetDirty();
-	if(ImGui::InputDoubleEx("shields", &object->shields))
+	if(ImGui::InputDoubleEx("shields", Track(object->shields)))
 		SetDirty();
-	if(ImGui::InputDoubleEx("hull", &object->hull))
+	if(ImGui::InputDoubleEx("hull", Track(object->hull)))
 		SetDirty();
 
 	int index = 0;
@@ -817,7 +812,7 @@ void ShipEditor::RenderShip()
 	RenderEffect("explode", object->explosionEffects);
 	RenderEffect("final explode", object->finalExplosions);
 
-	if(ImGui::InputTextMultiline("description", &object->description, ImVec2(), ImGuiInputTextFlags_EnterReturnsTrue))
+	if(ImGui::InputTextMultiline("description", Track(object->description), ImVec2(), ImGuiInputTextFlags_EnterReturnsTrue))
 		SetDirty();
 }
 
@@ -1260,3 +1255,33 @@ void ShipEditor::WriteToFile(DataWriter &writer, const Ship *ship)
 
 	writer.EndChild();
 }
+
+
+
+// Lists every object the given ship refers to.
+void ShipEditor::References(const Ship &ship, vector<ReferenceIndex::Key> &references) const
+{
+	// A variant refers to the ship model it is based on.
+	if(ship.base != &ship)
+		AddReference(references, ship.base);
+	AddReference(references, ship.explosionWeapon);
+	for(const auto &it : ship.outfits)
+		AddReference(references, it.first);
+	for(const auto &it : ship.explosionEffects)
+		AddReference(references, it.first);
+	for(const auto &it : ship.finalExplosions)
+		AddReference(references, it.first);
+}
+
+
+
+// Lists the category and attributes of the given ship.
+void ShipEditor::SearchTerms(const Ship &ship, vector<string> &terms) const
+{
+	const Outfit &attributes = ship.baseAttributes;
+	if(!attributes.Category().empty())
+		terms.push_back(attributes.Category());
+	for(const auto &it : attributes.Attributes())
+		if(it.second)
+			terms.emplace_back(it.first);
+}
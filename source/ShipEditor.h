@@ -32,7 +32,11 @@ public:
 	ShipEditor(Editor &editor, bool &show) noexcept;
 
 	void Render();
-	void WriteToFile(DataWriter &writer, const Ship *ship);
+	// Renames the current object, and updates everything that refers to it.
+	virtual void Rename(const std::string &name) override;
+	virtual void WriteToFile(DataWriter &writer, const Ship *ship) override;
+	virtual void References(const Ship &ship, std::vector<ReferenceIndex::Key> &references) const override;
+	virtual void SearchTerms(const Ship &ship, std::vector<std::string> &terms) const override;
 
 
 private:
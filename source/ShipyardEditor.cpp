@@ -54,6 +54,19 @@ ShipyardEditor::ShipyardEditor(Editor &editor, bool &show) noexcept
 
 
 
+// Renames the current object, and updates everything that refers to it.
+void ShipyardEditor::Rename(const string &name)
+{
+	DeleteFromChanges();
+	editor.RenameObject(keyFor<Sale<Ship>>(), object->name, name);
+	GameData::Shipyards().Rename(object->name, name);
+	object->name = name;
+	WriteToPlugin(object, false);
+	SetDirty();
+}
+
+
+
 void ShipyardEditor::Render()
 {
 	if(IsDirty())
@@ -91,14 +104,7 @@ void ShipyardEditor::Render()
 			if(ImGui::MenuItem("Reset", nullptr, false, object && IsDirty()))
 			{
 				SetClean();
-				bool found = false;
-				for(auto &&change : Changes())
-					if(change.Name() == object->Name())
-					{
-						*object = change;
-						found = true;
-						break;
-					}
+				bool found = RestoreSaved();
 				if(!found && GameData::baseShipSales.Has(object->name))
 					*object = *GameData::baseShipSales.Get(object->name);
 				else if(!found)
@@ -111,10 +117,7 @@ void ShipyardEditor::Render()
 			}
 			if(ImGui::MenuItem("Delete", nullptr, false, alreadyDefined))
 			{
-				if(find_if(Changes().begin(), Changes().end(), [this](const Sale<Ship> &shipyard)
-							{
-								return shipyard.name == object->name;
-							}) != Changes().end())
+				if(IsSaved())
 				{
 					SetDirty("[deleted]");
 					DeleteFromChanges();
@@ -142,15 +145,7 @@ void ShipyardEditor::Render()
 				object = newShipyard;
 				SetDirty();
 			});
-	ImGui::BeginSimpleRenameModal("Rename Shipyard", [this](const string &name)
-			{
-				DeleteFromChanges();
-				editor.RenameObject(keyFor<Sale<Ship>>(), object->name, name);
-				GameData::Shipyards().Rename(object->name, name);
-				object->name = name;
-				WriteToPlugin(object, false);
-				SetDirty();
-			});
+	ImGui::BeginSimpleRenameModal("Rename Shipyard", [this](const string &name) { Rename(name); });
 	ImGui::BeginSimpleCloneModal("Clone Shipyard", [this](const string &name)
 			{
 				auto *clone = const_cast<Sale<Ship> *>(GameData::Shipyards().Get(name));
@@ -176,30 +171,27 @@ void ShipyardEditor::Render()
 void ShipyardEditor::RenderShipyard()
 {
 	ImGui::Text("shipyard: %s", object->name.c_str());
-	int index = 0;
 	const Ship *toAdd = nullptr;
 	const Ship *toRemove = nullptr;
-	for(auto it = object->begin(); it != object->end(); ++it)
-	{
-		ImGui::PushID(index++);
-		string name = (*it)->TrueName();
-		Ship *change = nullptr;
-		if(ImGui::InputCombo("ship", &name, &change, GameData::Ships()))
-		{
-			if(name.empty())
-			{
-				toRemove = *it;
-				SetDirty();
-			}
-			else
+	ImGui::ClippedList(*object, [this, &toAdd, &toRemove](const Ship *ship)
 			{
-				toAdd = change;
-				toRemove = *it;
-				SetDirty();
-			}
-		}
-		ImGui::PopID();
-	}
+				string name = ship->TrueName();
+				Ship *change = nullptr;
+				if(ImGui::InputCombo("ship", &name, &change, GameData::Ships()))
+				{
+					if(name.empty())
+					{
+						toRemove = ship;
+						SetDirty();
+					}
+					else
+					{
+						toAdd = change;
+						toRemove = ship;
+						SetDirty();
+					}
+				}
+			});
 	if(toAdd)
 		object->insert(toAdd);
 	if(toRemove)
@@ -241,3 +233,12 @@ void ShipyardEditor::WriteToFile(DataWriter &writer, const Sale<Ship> *shipyard)
 			});
 	writer.EndChild();
 }
+
+
+
+// Lists every object the given shipyard refers to.
+void ShipyardEditor::References(const Sale<Ship> &shipyard, vector<ReferenceIndex::Key> &references) const
+{
+	for(const Ship *ship : shipyard)
+		AddReference(references, ship);
+}
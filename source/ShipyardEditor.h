@@ -32,7 +32,10 @@ public:
 	ShipyardEditor(Editor &editor, bool &show) noexcept;
 
 	void Render();
-	void WriteToFile(DataWriter &writer, const Sale<Ship> *shipyard);
+	// Renames the current object, and updates everything that refers to it.
+	virtual void Rename(const std::string &name) override;
+	virtual void WriteToFile(DataWriter &writer, const Sale<Ship> *shipyard) override;
+	virtual void References(const Sale<Ship> &shipyard, std::vector<ReferenceIndex::Key> &references) const override;
 
 private:
 	void RenderShipyard();
@@ -27,6 +27,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "PlayerInfo.h"
 #include "PointerShader.h"
 #include "Preferences.h"
+#include "Profiler.h"
 #include "Sale.h"
 #include "Screen.h"
 #include "Ship.h"
@@ -50,6 +51,9 @@ namespace {
 	constexpr int ICON_TILE = 62;
 	constexpr int ICON_COLS = 4;
 	constexpr float ICON_SIZE = ICON_TILE - 8;
+	// Items may also be bought or sold by a dialog on top of this panel, or be
+	// changed in the editor, so the layout is found again once in a while.
+	constexpr int LAYOUT_LIFETIME = 60;
 	
 	bool CanShowInSidebar(const Ship &ship, const System *here)
 	{
@@ -61,7 +65,7 @@ namespace {
 
 ShopPanel::ShopPanel(PlayerInfo &player, bool isOutfitter)
 	: player(player), day(player.GetDate().DaysSinceEpoch()),
-	planet(player.GetPlanet()), playerShip(player.Flagship()),
+	planet(player.GetPlanet()), isOutfitter(isOutfitter), playerShip(player.Flagship()),
 	categories(GameData::Category(isOutfitter ? CategoryType::OUTFIT : CategoryType::SHIP)),
 	collapsed(player.Collapsed(isOutfitter ? "outfitter" : "shipyard"))
 {
@@ -108,6 +112,9 @@ void ShopPanel::Draw()
 	// Clear the list of clickable zones.
 	zones.clear();
 	categoryZones.clear();
+	// A dialog on top of this panel may buy or sell something.
+	if(!GetUI()->IsTop(this))
+		InvalidateLayout();
 	
 	DrawShipsSidebar();
 	DrawDetailsSidebar();
@@ -387,6 +394,7 @@ void ShopPanel::DrawButtons()
 
 void ShopPanel::DrawMain()
 {
+	PROFILE_SCOPE("ShopPanel::DrawMain");
 	const Font &bigFont = FontSet::Get(18);
 	const Color &dim = *GameData::Colors().Get("medium");
 	const Color &bright = *GameData::Colors().Get("bright");
@@ -402,12 +410,87 @@ void ShopPanel::DrawMain()
 	// If the user horizontally compresses the window too far, draw nothing.
 	if(mainWidth < TILE_SIZE)
 		return;
+	UpdateLayout();
+	
+	// Every item that is shown can be clicked on, even if it is off screen,
+	// since the keyboard can be used to select it.
+	const Point scroll(0., -mainScroll);
+	for(const Tile &tile : layout)
+		if(tile.isShown)
+		{
+			if(tile.ship)
+				zones.emplace_back(tile.center + scroll, Point(TILE_SIZE, TILE_SIZE), tile.ship, tile.scrollY);
+			else
+				zones.emplace_back(tile.center + scroll, Point(TILE_SIZE, TILE_SIZE), tile.outfit, tile.scrollY);
+		}
+	for(const Tile &tile : layout)
+		if((selectedShip && tile.ship == selectedShip) || (selectedOutfit && tile.outfit == selectedOutfit))
+			selectedTopY = tile.center.Y() - mainScroll - TILE_SIZE / 2;
+	
+	for(const Heading &heading : headings)
+	{
+		const Point side = heading.side + scroll;
+		if(side.Y() + bigFont.Height() < Screen::Top() || side.Y() > Screen::Bottom())
+			continue;
+		Point size(heading.width + 25., bigFont.Height());
+		categoryZones.emplace_back(Point(Screen::Left(), side.Y()) + .5 * size, size, *heading.category);
+		SpriteShader::Draw(heading.isCollapsed ? collapsedArrow : expandedArrow, side + Point(10., 10.));
+		bigFont.Draw(*heading.category, side + Point(25., 0.), heading.isCollapsed ? dim : bright);
+	}
+	
+	// The tiles are in order from top to bottom, so only the ones that are on
+	// screen need to be looked at.
+	auto it = lower_bound(layout.begin(), layout.end(), Screen::Top() + mainScroll - TILE_SIZE / 2,
+		[](const Tile &tile, double y) noexcept -> bool { return tile.center.Y() < y; });
+	for( ; it != layout.end() && it->center.Y() - TILE_SIZE / 2 <= Screen::Bottom() + mainScroll; ++it)
+		if(it->isShown)
+			DrawItem(*it->name, it->center + scroll);
+	
+	// What amount would mainScroll have to equal to make the bottom of the
+	// layout equal the bottom of the screen? (Also leave space for the "key"
+	// at the bottom.)
+	maxMainScroll = max(0., layoutBottom - Screen::Height() / 2 - TILE_SIZE / 2 + 40.);
+	
+	PointerShader::Draw(Point(Screen::Right() - 10 - SIDE_WIDTH, Screen::Top() + 10),
+		Point(0., -1.), 10.f, 10.f, 5.f, Color(mainScroll > 0 ? .8f : .2f, 0.f));
+	PointerShader::Draw(Point(Screen::Right() - 10 - SIDE_WIDTH, Screen::Bottom() - 10),
+		Point(0., 1.), 10.f, 10.f, 5.f, Color(mainScroll < maxMainScroll ? .8f : .2f, 0.f));
+}
+
+
+
+// Lay out the items of the main panel again the next time it is drawn, e.g.
+// because the items that are shown may have changed.
+void ShopPanel::InvalidateLayout()
+{
+	isLayoutValid = false;
+}
+
+
+
+// Find where each item of the catalog goes, as if the main panel was not
+// scrolled, unless the layout is still valid.
+void ShopPanel::UpdateLayout()
+{
+	if(isLayoutValid && layoutWidth == Screen::Width() && layoutHeight == Screen::Height()
+			&& ++layoutAge < LAYOUT_LIFETIME)
+		return;
+	isLayoutValid = true;
+	layoutWidth = Screen::Width();
+	layoutHeight = Screen::Height();
+	layoutAge = 0;
+	layout.clear();
+	headings.clear();
+	
+	const Font &bigFont = FontSet::Get(18);
+	const int TILE_SIZE = TileSize();
+	const int mainWidth = (Screen::Width() - SIDE_WIDTH - 1);
 	const int columns = mainWidth / TILE_SIZE;
 	const int columnWidth = mainWidth / columns;
 	
 	const Point begin(
 		(Screen::Width() - columnWidth) / -2,
-		(Screen::Height() - TILE_SIZE) / -2 - mainScroll);
+		(Screen::Height() - TILE_SIZE) / -2);
 	Point point = begin;
 	const float endX = Screen::Right() - (SIDE_WIDTH + 1);
 	double nextY = begin.Y() + TILE_SIZE;
@@ -431,20 +514,26 @@ void ShopPanel::DrawMain()
 		bool isEmpty = true;
 		for(const string &name : it->second)
 		{
-			bool isSelected = (selectedShip && GameData::Ships().Get(name) == selectedShip)
-				|| (selectedOutfit && GameData::Outfits().Get(name) == selectedOutfit);
-			
-			if(isSelected)
-				selectedTopY = point.Y() - TILE_SIZE / 2;
+			// Items that are not shown are still listed, since one of them may
+			// be selected.
+			Tile tile;
+			tile.center = point;
+			tile.name = &name;
+			if(isOutfitter)
+				tile.outfit = GameData::Outfits().Get(name);
+			else
+				tile.ship = GameData::Ships().Get(name);
+			tile.scrollY = scrollY;
+			const bool hasItem = HasItem(name);
+			tile.isShown = hasItem && !isCollapsed;
+			layout.push_back(tile);
 			
-			if(!HasItem(name))
+			if(!hasItem)
 				continue;
 			isEmpty = false;
 			if(isCollapsed)
 				break;
 			
-			DrawItem(name, point, scrollY);
-			
 			point.X() += columnWidth;
 			if(point.X() >= endX)
 			{
@@ -457,10 +546,7 @@ void ShopPanel::DrawMain()
 		
 		if(!isEmpty)
 		{
-			Point size(bigFont.Width(category) + 25., bigFont.Height());
-			categoryZones.emplace_back(Point(Screen::Left(), side.Y()) + .5 * size, size, category);
-			SpriteShader::Draw(isCollapsed ? collapsedArrow : expandedArrow, side + Point(10., 10.));
-			bigFont.Draw(category, side + Point(25., 0.), isCollapsed ? dim : bright);
+			headings.push_back(Heading{side, &category, bigFont.Width(category), isCollapsed});
 			
 			if(point.X() != begin.X())
 			{
@@ -479,16 +565,7 @@ void ShopPanel::DrawMain()
 		}
 	}
 	// This is how much Y space was actually used.
-	nextY -= 40 + TILE_SIZE;
-	
-	// What amount would mainScroll have to equal to make nextY equal the
-	// bottom of the screen? (Also leave space for the "key" at the bottom.)
-	maxMainScroll = max(0., nextY + mainScroll - Screen::Height() / 2 - TILE_SIZE / 2 + 40.);
-	
-	PointerShader::Draw(Point(Screen::Right() - 10 - SIDE_WIDTH, Screen::Top() + 10),
-		Point(0., -1.), 10.f, 10.f, 5.f, Color(mainScroll > 0 ? .8f : .2f, 0.f));
-	PointerShader::Draw(Point(Screen::Right() - 10 - SIDE_WIDTH, Screen::Bottom() - 10),
-		Point(0., 1.), 10.f, 10.f, 5.f, Color(mainScroll < maxMainScroll ? .8f : .2f, 0.f));
+	layoutBottom = nextY - 40 - TILE_SIZE;
 }
 
 
@@ -565,6 +642,7 @@ void ShopPanel::DrawKey()
 void ShopPanel::ToggleForSale()
 {
 	sameSelectedTopY = true;
+	InvalidateLayout();
 }
 
 
@@ -572,6 +650,7 @@ void ShopPanel::ToggleForSale()
 void ShopPanel::ToggleCargo()
 {
 	sameSelectedTopY = true;
+	InvalidateLayout();
 }
 
 
@@ -580,6 +659,7 @@ void ShopPanel::ToggleCargo()
 bool ShopPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command, bool isNewPress)
 {
 	scrollDetailsIntoView = false;
+	InvalidateLayout();
 	bool toStorage = selectedOutfit && (key == 'r' || key == 'u');
 	if(key == 'l' || key == 'd' || key == SDLK_ESCAPE
 			|| (key == 'w' && (mod & (KMOD_CTRL | KMOD_GUI))))
@@ -699,6 +779,7 @@ bool ShopPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command, boo
 bool ShopPanel::Click(int x, int y, int /* clicks */)
 {
 	dragShip = nullptr;
+	InvalidateLayout();
 	// Handle clicks on the buttons.
 	char button = CheckButton(x, y);
 	if(button)
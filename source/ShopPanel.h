@@ -46,6 +46,9 @@ protected:
 	void DrawDetailsSidebar();
 	void DrawButtons();
 	void DrawMain();
+	// Lay out the items of the main panel again the next time it is drawn, e.g.
+	// because the items that are shown may have changed.
+	void InvalidateLayout();
 	
 	void DrawShip(const Ship &ship, const Point &center, bool isSelected);
 	
@@ -53,7 +56,8 @@ protected:
 	virtual int TileSize() const = 0;
 	virtual int DrawPlayerShipInfo(const Point &point) = 0;
 	virtual bool HasItem(const std::string &name) const = 0;
-	virtual void DrawItem(const std::string &name, const Point &point, int scrollY) = 0;
+	// Draw an item that is on screen. Its click zone is added by DrawMain().
+	virtual void DrawItem(const std::string &name, const Point &point) = 0;
 	virtual int DividerOffset() const = 0;
 	virtual int DetailWidth() const = 0;
 	virtual int DrawDetails(const Point &center) = 0;
@@ -97,6 +101,26 @@ protected:
 		const Outfit *outfit = nullptr;
 	};
 	
+	// Where an item of the catalog is drawn in the main panel.
+	class Tile {
+	public:
+		Point center;
+		const std::string *name = nullptr;
+		const Ship *ship = nullptr;
+		const Outfit *outfit = nullptr;
+		int scrollY = 0;
+		bool isShown = false;
+	};
+	
+	// Where the name of a category is drawn in the main panel.
+	class Heading {
+	public:
+		Point side;
+		const std::string *category;
+		int width;
+		bool isCollapsed;
+	};
+	
 	enum class ShopPane : int {
 		Main,
 		Sidebar,
@@ -118,6 +142,8 @@ protected:
 	// Remember the current day, for calculating depreciation.
 	int day;
 	const Planet *planet = nullptr;
+	// Whether this is the outfitter, rather than the shipyard.
+	const bool isOutfitter;
 	
 	// The player-owned ship that was first selected in the sidebar (or most recently purchased).
 	Ship *playerShip = nullptr;
@@ -155,6 +181,17 @@ protected:
 	const std::vector<std::string> &categories;
 	std::set<std::string> &collapsed;
 	
+	// The layout of the main panel, from top to bottom, as if it was not
+	// scrolled. It is only found again when the window is resized or when the
+	// items that are shown may have changed, rather than every frame.
+	std::vector<Tile> layout;
+	std::vector<Heading> headings;
+	double layoutBottom = 0.;
+	bool isLayoutValid = false;
+	int layoutWidth = 0;
+	int layoutHeight = 0;
+	int layoutAge = 0;
+	
 	ShipInfoDisplay shipInfo;
 	OutfitInfoDisplay outfitInfo;
 	
@@ -163,6 +200,7 @@ protected:
 	
 	
 private:
+	void UpdateLayout();
 	bool DoScroll(double dy);
 	void SideSelect(int count);
 	void SideSelect(Ship *ship);
@@ -12,6 +12,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "Sprite.h"
 
+#include "GameWindow.h"
 #include "ImageBuffer.h"
 #include "Preferences.h"
 #include "Screen.h"
@@ -54,6 +55,13 @@ void Sprite::AddFrames(ImageBuffer &buffer, bool is2x)
 		frames = buffer.Frames();
 	}
 	
+	// Without a graphics context, only the sprite's dimensions are needed.
+	if(!GameWindow::HasContext())
+	{
+		buffer.Clear();
+		return;
+	}
+	
 	// Check whether this sprite is large enough to require size reduction.
 	if(Preferences::Has("Reduce large graphics") && buffer.Width() * buffer.Height() >= 1000000)
 		buffer.ShrinkToHalfSize();
@@ -95,7 +103,8 @@ void Sprite::AddMasks(vector<Mask> &masks)
 // Free up all textures loaded for this sprite.
 void Sprite::Unload()
 {
-	glDeleteTextures(2, texture);
+	if(GameWindow::HasContext())
+		glDeleteTextures(2, texture);
 	texture[0] = texture[1] = 0;
 	
 	masks.clear();
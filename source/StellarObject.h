@@ -91,6 +91,7 @@ private:
 	// Let System handle setting all the values of an Object.
 	friend class System;
 	friend class SystemEditor;
+	friend class SystemGenerator;
 };
 
 
@@ -288,6 +288,8 @@ private:
 
 	friend class SystemEditor;
 	friend class MapEditorPanel;
+	friend class RegionGenerator;
+	friend class SystemGenerator;
 };
 
 
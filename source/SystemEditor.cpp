@@ -31,13 +31,49 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "SpriteSet.h"
 #include "Sprite.h"
 #include "System.h"
+#include "SystemGenerator.h"
 #include "UI.h"
 #include "Visual.h"
 
+#include <algorithm>
 #include <random>
 
 using namespace std;
 
+namespace {
+	// The smallest convex polygon that contains all of the given points, in order.
+	vector<Point> ConvexHull(vector<Point> points)
+	{
+		sort(points.begin(), points.end(), [](const Point &a, const Point &b)
+			{
+				return a.X() < b.X() || (a.X() == b.X() && a.Y() < b.Y());
+			});
+		if(points.size() < 3)
+			return points;
+
+		vector<Point> hull(2 * points.size());
+		size_t size = 0;
+		auto turn = [&hull, &size](const Point &point)
+		{
+			return (hull[size - 1] - hull[size - 2]).Cross(point - hull[size - 2]);
+		};
+		for(const Point &point : points)
+		{
+			while(size >= 2 && turn(point) <= 0.)
+				--size;
+			hull[size++] = point;
+		}
+		for(size_t i = points.size() - 1, lower = size + 1; i-- > 0; )
+		{
+			while(size >= lower && turn(points[i]) <= 0.)
+				--size;
+			hull[size++] = points[i];
+		}
+		hull.resize(size - 1);
+		return hull;
+	}
+}
+
 
 
 SystemEditor::SystemEditor(Editor &editor, bool &show) noexcept
@@ -47,10 +83,35 @@ SystemEditor::SystemEditor(Editor &editor, bool &show) noexcept
 
 
 
+// Called when an edit of the given system is undone or redone.
+void SystemEditor::Changed(const void *system)
+{
+	TemplateEditor<System>::Changed(system);
+	// The positions of the stellar objects depend on their orbits.
+	const_cast<System *>(static_cast<const System *>(system))->SetDate(PreviewDate());
+	// The map is only updated once the whole edit has been undone or redone.
+	batch.Touch(static_cast<const System *>(system));
+	isMapChanged = true;
+}
+
+
+
+// Called once every edit of an undone or redone group has been applied.
+void SystemEditor::EndChanges()
+{
+	CommitBatch();
+}
+
+
+
 void SystemEditor::UpdateSystemPosition(const System *system, Point dp)
 {
-	const_cast<System *>(system)->position += dp;
-	SetDirty(system);
+	Point &position = const_cast<System *>(system)->position;
+	Point oldPosition = position;
+	position += dp;
+	// Every step of a drag is merged into the same edit.
+	Record(system, position, oldPosition, true);
+	Touch(system);
 }
 
 
@@ -58,38 +119,181 @@ void SystemEditor::UpdateSystemPosition(const System *system, Point dp)
 void SystemEditor::UpdateStellarPosition(const StellarObject &object, Point dp, const System *system)
 {
 	auto &obj = const_cast<StellarObject &>(object);
-	double now = editor.Player().GetDate().DaysSinceEpoch();
+	double now = PreviewDate().DaysSinceEpoch();
 
 	auto newPos = obj.position + dp;
 	if(obj.parent != -1)
 		newPos -= this->object->objects[obj.parent].position;
 
+	// The object is recorded by its index, since adding or removing another one
+	// moves it in memory.
+	auto &objects = this->object->objects;
+	const size_t index = &obj - objects.data();
+	auto distance = EditJournal::Snapshot(objects, index, [](StellarObject &it) -> double & { return it.distance; });
+	auto speed = EditJournal::Snapshot(objects, index, [](StellarObject &it) -> double & { return it.speed; });
 	obj.distance = newPos.Length();
 	Angle newAngle(newPos);
 
 	obj.speed = (newAngle.Degrees() - obj.offset) / now;
-	const_cast<System *>(system)->SetDate(editor.Player().GetDate());
+	const_cast<System *>(system)->SetDate(PreviewDate());
 
-	SetDirty(this->object);
+	Record(this->object, std::move(distance), true);
+	Record(this->object, std::move(speed), true);
 }
 
 
 
-void SystemEditor::ToggleLink(const System *system)
+// Every map edit made between these calls (e.g. while dragging a region of the
+// map) is undone at once, and the map and the neighbors of the systems are only
+// updated after the last one.
+void SystemEditor::BeginBatch()
+{
+	if(!batchDepth++)
+		BeginEdit();
+}
+
+
+
+void SystemEditor::EndBatch()
 {
-	if(system == object)
+	if(!batchDepth || --batchDepth)
 		return;
+	EndEdit();
+	CommitBatch();
+}
 
-	auto it = object->links.find(system);
-	if(it != object->links.end())
-		object->Unlink(const_cast<System *>(system));
-	else
-		object->Link(const_cast<System *>(system));
-	GameData::UpdateSystem(object);
-	GameData::UpdateSystem(const_cast<System *>(system));
-	UpdateMap();
-	SetDirty();
-	SetDirty(system);
+
+
+void SystemEditor::ToggleLink(const System *system)
+{
+	if(object)
+		ToggleLinks({object}, system);
+}
+
+
+
+// Links each of the given systems to the target, or unlinks them if all of them
+// already are.
+void SystemEditor::ToggleLinks(const vector<const System *> &systems, const System *target)
+{
+	const bool isLinked = all_of(systems.begin(), systems.end(),
+		[target](const System *system) { return system == target || system->links.count(target); });
+
+	BeginBatch();
+	for(const System *system : systems)
+	{
+		if(system == target)
+			continue;
+		if(isLinked)
+			const_cast<System *>(system)->Unlink(const_cast<System *>(target));
+		else
+			const_cast<System *>(system)->Link(const_cast<System *>(target));
+		Touch(system);
+		SetDirty(system);
+	}
+	Touch(target);
+	SetDirty(target);
+	EndBatch();
+}
+
+
+
+// The given systems that aren't part of the base game, which are the only ones
+// that can be deleted.
+vector<const System *> SystemEditor::Deletable(const vector<const System *> &systems) const
+{
+	vector<const System *> deletable;
+	for(const System *system : systems)
+		if(!system->name.empty() && !GameData::baseSystems.Has(system->name))
+			deletable.push_back(system);
+	return deletable;
+}
+
+
+
+// Deletes each of the given systems that isn't part of the base game.
+void SystemEditor::Delete(const vector<const System *> &systems)
+{
+	BeginBatch();
+	for(const System *system : Deletable(systems))
+		DeleteSystem(const_cast<System *>(system));
+	EndBatch();
+}
+
+
+
+void SystemEditor::SetGovernment(const vector<const System *> &systems, const Government *government)
+{
+	BeginBatch();
+	for(const System *system : systems)
+		if(system->government != government)
+		{
+			const Government *&field = const_cast<System *>(system)->government;
+			const Government *oldGovernment = field;
+			field = government;
+			Record(system, field, oldGovernment);
+		}
+	isMapChanged = true;
+	EndBatch();
+}
+
+
+
+// Copies the given systems, or pastes copies of them with the first one at the
+// given position. Links between the copied systems are kept.
+void SystemEditor::Copy(const vector<const System *> &systems)
+{
+	clipboard.clear();
+	for(const System *system : systems)
+		if(system->IsValid())
+			clipboard.push_back(*system);
+}
+
+
+
+vector<const System *> SystemEditor::Paste(Point position)
+{
+	vector<const System *> pasted;
+	if(clipboard.empty())
+		return pasted;
+
+	BeginBatch();
+	const Point offset = position - clipboard.front().position;
+	map<string, System *> copies;
+	for(const System &original : clipboard)
+	{
+		string name = original.name + " copy";
+		for(int i = 2; GameData::Systems().Has(name); ++i)
+			name = original.name + " copy " + to_string(i);
+
+		auto *copy = const_cast<System *>(GameData::Systems().Get(name));
+		*copy = original;
+		copy->name = name;
+		copy->position += offset;
+		// Like a clone, the copy has no stellar objects, since a planet can only
+		// be in one system.
+		copy->objects.clear();
+		copy->attributes.insert("uninhabited");
+		editor.Player().Seen(*copy);
+		copies[original.name] = copy;
+		pasted.push_back(copy);
+	}
+	for(size_t i = 0; i < clipboard.size(); ++i)
+	{
+		auto *copy = const_cast<System *>(pasted[i]);
+		copy->links.clear();
+		for(const System *link : clipboard[i].links)
+		{
+			auto it = copies.find(link->name);
+			if(it != copies.end())
+				copy->links.insert(it->second);
+		}
+		Touch(copy);
+		SetDirty(copy);
+	}
+	object = const_cast<System *>(pasted.front());
+	EndBatch();
+	return pasted;
 }
 
 
@@ -102,6 +306,56 @@ void SystemEditor::CreateNewSystem(Point position)
 
 
 
+// Adds the systems of a generated region to the map, and returns them. The
+// neighbors of the systems are updated once, after all of them are added.
+vector<const System *> SystemEditor::AddRegion(const RegionGenerator &region)
+{
+	vector<const System *> added;
+	if(region.Systems().empty())
+		return added;
+
+	BeginBatch();
+	for(const System &generated : region.Systems())
+	{
+		string name = generated.name;
+		for(int i = 2; GameData::Systems().Has(name); ++i)
+			name = generated.name + " " + to_string(i);
+
+		auto *system = const_cast<System *>(GameData::Systems().Get(name));
+		*system = generated;
+		system->name = name;
+		system->SetDate(PreviewDate());
+		editor.Player().Seen(*system);
+		added.push_back(system);
+	}
+	for(const auto &link : region.Links())
+		const_cast<System *>(added[link.first])->Link(const_cast<System *>(added[link.second]));
+	for(const System *system : added)
+	{
+		Touch(system);
+		SetDirty(system);
+	}
+	object = const_cast<System *>(added.front());
+	EndBatch();
+	return added;
+}
+
+
+
+// Renames the current object, and updates everything that refers to it.
+void SystemEditor::Rename(const string &name)
+{
+	DeleteFromChanges();
+	editor.RenameObject(keyFor<System>(), object->name, name);
+	GameData::Systems().Rename(object->name, name);
+	object->name = name;
+	WriteToPlugin(object, false);
+	UpdateMap();
+	SetDirty();
+}
+
+
+
 void SystemEditor::Render()
 {
 	if(IsDirty())
@@ -126,6 +380,7 @@ void SystemEditor::Render()
 	bool showNewSystem = false;
 	bool showRenameSystem = false;
 	bool showCloneSystem = false;
+	bool showGenerateRegion = false;
 	if(ImGui::BeginMenuBar())
 	{
 		if(ImGui::BeginMenu("System"))
@@ -151,14 +406,7 @@ void SystemEditor::Render()
 						const_cast<Planet *>(stellar.planet)->RemoveSystem(object);
 
 				auto oldNeighbors = object->VisibleNeighbors();
-				bool found = false;
-				for(auto &&change : Changes())
-					if(change.Name() == object->Name())
-					{
-						*object = change;
-						found = true;
-						break;
-					}
+				bool found = RestoreSaved();
 
 				if(!found && GameData::baseSystems.Has(object->name))
 					*object = *GameData::baseSystems.Get(object->name);
@@ -195,37 +443,13 @@ void SystemEditor::Render()
 			}
 			if(ImGui::MenuItem("Delete", nullptr, false, alreadyDefined))
 			{
-				if(find_if(Changes().begin(), Changes().end(), [this](const System &system)
-							{
-								return system.name == object->name;
-							}) != Changes().end())
-				{
-					SetDirty("[deleted]");
-					DeleteFromChanges();
-				}
-				else
-					SetClean();
-				auto oldLinks = object->links;
-				for(auto &&link : oldLinks)
-				{
-					const_cast<System *>(link)->Unlink(object);
-					SetDirty(link);
-					GameData::UpdateSystem(const_cast<System *>(link));
-				}
-				for(auto &&stellar : object->Objects())
-					if(stellar.planet)
-						const_cast<Planet *>(stellar.planet)->RemoveSystem(object);
-
-				auto oldNeighbors = object->VisibleNeighbors();
-				GameData::Systems().Erase(object->name);
-				for(auto &&link : oldNeighbors)
-					GameData::UpdateSystem(const_cast<System *>(link));
-				object = nullptr;
+				BeginBatch();
+				DeleteSystem(object);
 				if(auto *panel = dynamic_cast<MapEditorPanel*>(editor.GetMenu().Top().get()))
 					panel->Select(object);
 				if(auto *panel = dynamic_cast<MainEditorPanel*>(editor.GetMenu().Top().get()))
 					panel->Select(object);
-				UpdateMap();
+				EndBatch();
 			}
 			ImGui::EndMenu();
 		}
@@ -237,6 +461,8 @@ void SystemEditor::Render()
 				RandomizeAsteroids();
 			if(ImGui::MenuItem("Randomize Minables", nullptr, false, object))
 				RandomizeMinables();
+			ImGui::Separator();
+			ImGui::MenuItem("Generate Region", nullptr, &showGenerateRegion);
 			ImGui::EndMenu();
 		}
 		ImGui::EndMenuBar();
@@ -246,17 +472,11 @@ void SystemEditor::Render()
 		ImGui::OpenPopup("Rename System");
 	if(showCloneSystem)
 		ImGui::OpenPopup("Clone System");
+	if(showGenerateRegion)
+		ImGui::OpenPopup("Generate Region");
 	AlwaysRender(showNewSystem);
-	ImGui::BeginSimpleRenameModal("Rename System", [this](const string &name)
-			{
-				DeleteFromChanges();
-				editor.RenameObject(keyFor<System>(), object->name, name);
-				GameData::Systems().Rename(object->name, name);
-				object->name = name;
-				WriteToPlugin(object, false);
-				UpdateMap();
-				SetDirty();
-			});
+	RenderGenerateRegion();
+	ImGui::BeginSimpleRenameModal("Rename System", [this](const string &name) { Rename(name); });
 	ImGui::BeginSimpleCloneModal("Clone System", [this](const string &name)
 			{
 				auto *clone = const_cast<System *>(GameData::Systems().Get(name));
@@ -269,10 +489,7 @@ void SystemEditor::Render()
 				object->links.clear();
 				object->attributes.insert("uninhabited");
 				editor.Player().Seen(*object);
-				GameData::UpdateSystem(object);
-				for(auto &&link : object->VisibleNeighbors())
-					GameData::UpdateSystem(const_cast<System *>(link));
-				UpdateMap();
+				Touch(object);
 				SetDirty();
 				if(auto *panel = dynamic_cast<MapEditorPanel*>(editor.GetMenu().Top().get()))
 					panel->Select(object);
@@ -318,10 +535,7 @@ void SystemEditor::AlwaysRender(bool showNewSystem)
 				newSystem->hasPosition = true;
 				editor.Player().Seen(*newSystem);
 				object = newSystem;
-				GameData::UpdateSystem(object);
-				for(auto &&link : object->VisibleNeighbors())
-					GameData::UpdateSystem(const_cast<System *>(link));
-				UpdateMap();
+				Touch(object);
 				SetDirty();
 				if(auto *panel = dynamic_cast<MapEditorPanel*>(editor.GetMenu().Top().get()))
 					panel->Select(object);
@@ -338,7 +552,7 @@ void SystemEditor::RenderSystem()
 	int index = 0;
 
 	ImGui::Text("name: %s", object->name.c_str());
-	if(ImGui::Checkbox("hidden", &object->hidden))
+	if(ImGui::Checkbox("hidden", Track(object->hidden)))
 		SetDirty();
 
 	if(ImGui::TreeNode("attributes"))
@@ -410,24 +624,25 @@ void SystemEditor::RenderSystem()
 			toAdd.erase(object);
 			toRemove.erase(object);
 		}
+		BeginBatch();
 		for(auto &sys : toAdd)
 		{
 			object->Link(sys);
-			GameData::UpdateSystem(sys);
+			Touch(sys);
 			SetDirty(sys);
 		}
 		for(auto &&sys : toRemove)
 		{
 			object->Unlink(sys);
-			GameData::UpdateSystem(sys);
+			Touch(sys);
 			SetDirty(sys);
 		}
 		if(!toAdd.empty() || !toRemove.empty())
 		{
-			GameData::UpdateSystem(object);
+			Touch(object);
 			SetDirty();
-			UpdateMap();
 		}
+		EndBatch();
 		ImGui::TreePop();
 	}
 
@@ -667,6 +882,7 @@ void SystemEditor::RenderSystem()
 	if(ImGui::InputDouble2Ex("pos", pos, ImGuiInputTextFlags_EnterReturnsTrue))
 	{
 		object->position.Set(pos[0], pos[1]);
+		Touch(object);
 		SetDirty();
 	}
 
@@ -678,9 +894,16 @@ void SystemEditor::RenderSystem()
 				const bool selected = &government.second == object->government;
 				if(ImGui::Selectable(government.first.c_str(), selected))
 				{
-					object->government = &government.second;
-					UpdateMap();
-					SetDirty();
+					// Every system that is selected on the map gets the new government.
+					auto *panel = dynamic_cast<MapEditorPanel *>(editor.GetMenu().Top().get());
+					if(panel && panel->selectedSystems.size() > 1)
+						SetGovernment(panel->selectedSystems, &government.second);
+					else
+					{
+						object->government = &government.second;
+						UpdateMap();
+						SetDirty();
+					}
 				}
 
 				if(selected)
@@ -690,14 +913,14 @@ void SystemEditor::RenderSystem()
 		}
 	}
 
-	if(ImGui::InputText("music", &object->music))
+	if(ImGui::InputText("music", Track(object->music)))
 		SetDirty();
 
-	if(ImGui::InputDoubleEx("habitable", &object->habitable))
+	if(ImGui::InputDoubleEx("habitable", Track(object->habitable)))
 		SetDirty();
-	if(ImGui::InputDoubleEx("belt", &object->asteroidBelt))
+	if(ImGui::InputDoubleEx("belt", Track(object->asteroidBelt)))
 		SetDirty();
-	if(ImGui::InputDoubleEx("jump range", &object->jumpRange))
+	if(ImGui::InputDoubleEx("jump range", Track(object->jumpRange)))
 		SetDirty();
 	if(object->jumpRange < 0.)
 		object->jumpRange = 0.;
@@ -748,10 +971,13 @@ void SystemEditor::RenderSystem()
 			openAddObject = true;
 		ImGui::EndPopup();
 	}
+	// Adding or removing objects is recorded as a change of the whole list, so
+	// that the edits of the other objects still apply once it is undone.
 	if(openAddObject)
 	{
+		auto oldObjects = object->objects;
 		object->objects.emplace_back();
-		SetDirty();
+		Record(object, object->objects, std::move(oldObjects));
 	}
 
 	if(openObjects)
@@ -785,7 +1011,7 @@ void SystemEditor::RenderSystem()
 		{
 			if(auto *planet = selected->GetPlanet())
 				const_cast<Planet *>(planet)->RemoveSystem(object);
-			SetDirty();
+			auto oldObjects = object->objects;
 			auto index = selected - object->objects.begin();
 			auto next = object->objects.erase(selected);
 			size_t removed = 1;
@@ -800,10 +1026,11 @@ void SystemEditor::RenderSystem()
 			for(auto it = next; it != object->objects.end(); ++it)
 				if(it->parent >= index)
 					it->parent -= removed;
+			Record(object, object->objects, std::move(oldObjects));
 		}
 		else if(selectedToAdd != object->objects.end())
 		{
-			SetDirty();
+			auto oldObjects = object->objects;
 			auto it = object->objects.emplace(selectedToAdd + 1);
 			it->parent = selectedToAdd - object->objects.begin();
 
@@ -811,6 +1038,7 @@ void SystemEditor::RenderSystem()
 			for(++it; it != object->objects.end(); ++it)
 				if(it->parent >= newParent)
 					++it->parent;
+			Record(object, object->objects, std::move(oldObjects));
 		}
 	}
 }
@@ -880,7 +1108,7 @@ void SystemEditor::RenderObject(StellarObject &object, int index, int &nested, b
 			SetDirty();
 
 		if(IsDirty())
-			this->object->SetDate(editor.Player().GetDate());
+			this->object->SetDate(PreviewDate());
 
 		if(index + 1 < static_cast<int>(this->object->objects.size()) && this->object->objects[index + 1].Parent() == index)
 		{
@@ -1094,6 +1322,22 @@ void SystemEditor::WriteToFile(DataWriter &writer, const System *system)
 
 
 
+// Lists every object the given system refers to.
+void SystemEditor::References(const System &system, vector<ReferenceIndex::Key> &references) const
+{
+	AddReference(references, system.government);
+	for(const System *link : system.links)
+		AddReference(references, link);
+	for(const StellarObject &stellar : system.objects)
+		AddReference(references, stellar.GetPlanet());
+	for(const auto &fleet : system.fleets)
+		AddReference(references, fleet.Get());
+	for(const auto &hazard : system.hazards)
+		AddReference(references, hazard.Get());
+}
+
+
+
 void SystemEditor::UpdateMap() const
 {
 	if(auto *mapPanel = dynamic_cast<MapPanel*>(editor.GetUI().Top().get()))
@@ -1115,339 +1359,165 @@ void SystemEditor::UpdateMain() const
 
 
 
-void SystemEditor::Randomize()
+// Remembers that the given system was moved, linked or deleted, and updates the
+// map unless a batch of edits is being made.
+void SystemEditor::Touch(const System *system)
 {
-	// Randomizes a star system. This code is adapted from
-	// the official ES map editor.
-	constexpr int STAR_DISTANCE = 40;
-	static random_device rd;
-	static mt19937 gen(rd());
-	static uniform_int_distribution<> randStarNum(0, 2);
-	static uniform_int_distribution<> randStarDist(0, STAR_DISTANCE);
-
-	auto getRadius = [](const StellarObject &stellar)
-	{
-		return stellar.sprite->Width() / 2. - 4.;
-	};
-	auto getMass = [&getRadius](const StellarObject &stellar)
-	{
-		constexpr double STAR_MASS_SCALE = .75;
-		const auto radius = getRadius(stellar);
-		return radius * radius * STAR_MASS_SCALE;
-	};
-
-	object->objects.clear();
-
-	// First we generate the (or 2) star(s).
-	const int numStars = 1 + !randStarNum(gen);
-	double mass;
-	if(numStars == 1)
-	{
-		StellarObject stellar;
-		stellar.sprite = RandomStarSprite();
-		stellar.speed = 36.;
-		mass = getMass(stellar);
-
-		object->objects.push_back(stellar);
-	}
-	else
-	{
-		StellarObject stellar1;
-		StellarObject stellar2;
-
-		stellar1.sprite = RandomStarSprite();
-		stellar2.sprite = RandomStarSprite();
-		stellar2.offset = 180.;
-
-		double radius1 = getRadius(stellar1);
-		double radius2 = getRadius(stellar2);
-		double mass1 = getMass(stellar1);
-		double mass2 = getMass(stellar2);
-		mass = mass1 + mass2;
-
-		double distance = radius1 + radius2 + randStarDist(gen) + STAR_DISTANCE;
-		stellar1.distance = (mass2 * distance) / mass;
-		stellar2.distance = (mass1 * distance) / mass;
-
-		double period = sqrt(distance * distance * distance / mass);
-		stellar1.speed = 360. / period;
-		stellar2.speed = 360. / period;
-
-		object->objects.push_back(stellar1);
-		object->objects.push_back(stellar2);
-	}
-
-	constexpr double HABITABLE_SCALE = 1.25;
-	object->habitable = mass / HABITABLE_SCALE;
-
-	// Now we generate lots of planets with moons.
-	uniform_int_distribution<> randPlanetCount(2, 5);
-	int planetCount = randPlanetCount(gen);
-	for(int i = 0; i < planetCount; ++i)
-	{
-		constexpr int RANDOM_SPACE = 100;
-		int space = RANDOM_SPACE;
-		for(const auto &stellar : object->objects)
-			if(!stellar.isStar && stellar.parent == -1)
-				space += RANDOM_SPACE / 2;
-
-		int distance = object->objects.back().distance;
-		if(object->objects.back().sprite)
-			distance += getRadius(object->objects.back());
-		if(object->objects.back().parent != -1)
-			distance += object->objects[object->objects.back().parent].distance;
-
-		uniform_int_distribution<> randSpace(0, space);
-		const int addSpace = randSpace(gen);
-		distance += (addSpace * addSpace) * .01 + 50.;
-
-		set<const Sprite *> used;
-		for(const auto &stellar : object->objects)
-			used.insert(stellar.sprite);
-
-		uniform_int_distribution<> rand10(0, 9);
-		uniform_int_distribution<> rand2000(0, 1999);
-		const bool isHabitable = distance > object->habitable * .5 && distance < object->habitable * 2.;
-		const bool isSmall = !rand10(gen);
-		const bool isTerrestrial = !isSmall && rand2000(gen) > distance;
-
-		const int rootIndex = static_cast<int>(object->objects.size());
-
-		const Sprite *planetSprite;
-		do {
-			if(isSmall)
-				planetSprite = RandomMoonSprite();
-			else if(isTerrestrial)
-				planetSprite = isHabitable ? RandomPlanetSprite() : RandomPlanetSprite();
-			else
-				planetSprite = RandomGiantSprite();
-		} while(used.count(planetSprite));
-
-		object->objects.emplace_back();
-		object->objects.back().sprite = planetSprite;
-		used.insert(planetSprite);
-		auto &planet = object->objects.back();
-
-		uniform_int_distribution<> oneOrTwo(1, 2);
-		uniform_int_distribution<> threeOrFive(3, 5);
-
-		const int randMoon = isTerrestrial ? oneOrTwo(gen) : threeOrFive(gen);
-		int moonCount = uniform_int_distribution<>(0, randMoon - 1)(gen);
-		if(getRadius(object->objects.back()) < 70.)
-			moonCount = 0;
-
-		auto calcPeriod = [this, &getRadius](StellarObject &stellar, bool isMoon)
-		{
-			const auto radius = getRadius(stellar);
-			constexpr double PLANET_MASS_SCALE = .015;
-			stellar.speed = isMoon ? 360. / (radius * radius * radius * PLANET_MASS_SCALE)
-				: object->habitable * HABITABLE_SCALE;
-		};
-
-		double moonDistance = getRadius(object->objects.back());
-		int randomMoonSpace = 50.;
-		for(int i = 0; i < moonCount; ++i)
-		{
-			uniform_int_distribution<> randMoonDist(10., randomMoonSpace);
-			moonDistance += randMoonDist(gen);
-			randomMoonSpace += 20.;
-
-			const Sprite *moonSprite;
-			do moonSprite = RandomMoonSprite();
-			while(used.count(moonSprite));
-			used.insert(moonSprite);
-
-			object->objects.emplace_back();
-			object->objects.back().sprite = moonSprite;
-			object->objects.back().parent = rootIndex;
-			object->objects.back().distance = moonDistance + getRadius(object->objects.back());
-			calcPeriod(object->objects.back(), true);
-			moonDistance += 2. * getRadius(object->objects.back());
-		}
-
-		planet.distance = distance + moonDistance;
-		calcPeriod(planet, false);
-	}
-
-	object->SetDate(editor.Player().GetDate());
-	SetDirty();
+	batch.Touch(system);
+	isMapChanged = true;
+	if(!batchDepth)
+		CommitBatch();
 }
 
 
 
-void SystemEditor::RandomizeAsteroids()
+void SystemEditor::CommitBatch()
 {
-	// Randomizes the asteroids in this system.
-	// Code adapted from the official ES map editor.
-	object->asteroids.erase(remove_if(object->asteroids.begin(), object->asteroids.end(),
-				[](const System::Asteroid &asteroid) { return !asteroid.Type(); }),
-			object->asteroids.end());
-
-	static random_device rd;
-	static mt19937 gen(rd());
-
-	uniform_int_distribution<> rand(0, 21);
-	const int total = rand(gen) * rand(gen) + 1;
-	const double energy = (rand(gen) + 10) * (rand(gen) + 10) * .01;
-	const string prefix[] = { "small", "medium", "large" };
-	const char *suffix[] = { " rock", " metal" };
-
-	uniform_int_distribution<> randCount(0, total - 1);
-	int amount[] = { randCount(gen), 0 };
-	amount[1] = total - amount[0];
-
-	for(int i = 0; i < 2; ++i)
+	if(!batch.IsEmpty())
+		GameData::UpdateSystems(batch);
+	if(isMapChanged)
 	{
-		if(!amount[i])
-			continue;
-
-		uniform_int_distribution<> randCount(0, amount[i] - 1);
-		int count[] = { 0, randCount(gen), 0 };
-		int remaining = amount[i] - count[1];
-		if(remaining)
-		{
-			uniform_int_distribution<> randRemaining(0, remaining - 1);
-			count[0] = randRemaining(gen);
-			count[2] = remaining - count[0];
-		}
-
-		for(int j = 0; j < 3; ++j)
-			if(count[j])
-			{
-				uniform_int_distribution<> randEnergy(50, 100);
-				object->asteroids.emplace_back(prefix[j] + suffix[i], count[j], energy * randEnergy(gen) * .01);
-			}
+		UpdateMap();
+		UpdateMain();
 	}
-
-	UpdateMain();
-	SetDirty();
+	isMapChanged = false;
 }
 
 
 
-void SystemEditor::RandomizeMinables()
+void SystemEditor::DeleteSystem(System *system)
 {
-	// Randomizes the minables in this system.
-	// Code adapted from the official ES map editor.
-	object->asteroids.erase(remove_if(object->asteroids.begin(), object->asteroids.end(),
-				[](const System::Asteroid &asteroid) { return asteroid.Type(); }),
-			object->asteroids.end());
-
-	static random_device rd;
-	static mt19937 gen(rd());
-
-	uniform_int_distribution<> randBelt(1000, 2000);
-	object->asteroidBelt = randBelt(gen);
-
-	int totalCount = 0;
-	double totalEnergy = 0.;
-	for(const auto &asteroid : object->asteroids)
+	object = system;
+	if(IsSaved())
 	{
-		totalCount += asteroid.count;
-		totalEnergy += asteroid.energy * asteroid.count;
+		SetDirty("[deleted]");
+		DeleteFromChanges();
 	}
-
-	if(!totalCount)
+	else
+		SetClean();
+	auto oldLinks = object->links;
+	for(auto &&link : oldLinks)
 	{
-		// This system has no other asteroids, so we generate a few minables only.
-		totalCount = 1;
-		uniform_real_distribution<> randEnergy(50., 100.);
-		totalEnergy = randEnergy(gen) * .01;
+		const_cast<System *>(link)->Unlink(object);
+		SetDirty(link);
+		Touch(link);
 	}
+	for(auto &&stellar : object->Objects())
+		if(stellar.planet)
+			const_cast<Planet *>(stellar.planet)->RemoveSystem(object);
+
+	// The systems that could see this one are found once it has been erased.
+	Touch(object);
+	GameData::Systems().Erase(object->name);
+	object = nullptr;
+}
 
-	double meanEnergy = totalEnergy / totalCount;
-	totalCount /= 4;
-
-	const unordered_map<const char *, double> probabilities = {
-        { "aluminum", 12 },
-        { "copper", 8 },
-        { "gold", 2 },
-        { "iron", 13 },
-        { "lead", 15 },
-        { "neodymium", 3 },
-        { "platinum", 1 },
-        { "silicon", 2 },
-        { "silver", 5 },
-        { "titanium", 11 },
-        { "tungsten", 6 },
-        { "uranium", 4 },
-	};
-
-	unordered_map<const char *, int> choices;
-	uniform_int_distribution<> rand100(0, 99);
-	for(int i = 0; i < 3; ++i)
-	{
-		uniform_int_distribution<> randCount(0, totalCount);
-		totalCount = randCount(gen);
-		if(!totalCount)
-			break;
 
-		int choice = rand100(gen);
-		for(const auto &pair : probabilities)
-		{
-			choice -= pair.second;
-			if(choice < 0)
-			{
-				choices[pair.first] += totalCount;
-				break;
-			}
-		}
-	}
-
-	for(const auto &pair : choices)
-	{
-		const double energy = randBelt(gen) * .001 * meanEnergy;
-		object->asteroids.emplace_back(GameData::Minables().Get(pair.first), pair.second, energy);
-	}
 
-	UpdateMain();
-	SetDirty();
+// The date the stellar objects are shown at, which is only different from the
+// player's date while the system's orbits are being previewed.
+Date SystemEditor::PreviewDate() const
+{
+	if(auto *panel = dynamic_cast<MainEditorPanel *>(editor.GetMenu().Top().get()))
+		return panel->GetDate();
+	return editor.Player().GetDate();
 }
 
 
 
-const Sprite *SystemEditor::RandomStarSprite()
+void SystemEditor::Randomize()
 {
-	static random_device rd;
-	static mt19937 gen(rd());
-
-	const auto &stars = GameData::Stars();
-	uniform_int_distribution<> randStar(0, stars.size() - 1);
-	return stars[randStar(gen)];
+	const auto palette = SystemGenerator::Palette::FromGameData();
+	auto oldObjects = object->objects;
+	SystemGenerator(palette, random_device()()).Stellars(*object);
+	object->SetDate(PreviewDate());
+	Record(object, object->objects, std::move(oldObjects));
 }
 
 
 
-const Sprite *SystemEditor::RandomPlanetSprite(bool recalculate)
+void SystemEditor::RandomizeAsteroids()
 {
-	static random_device rd;
-	static mt19937 gen(rd());
-
-	const auto &planets = GameData::PlanetSprites();
-	uniform_int_distribution<> randPlanet(0, planets.size() - 1);
-	return planets[randPlanet(gen)];
+	const auto palette = SystemGenerator::Palette::FromGameData();
+	SystemGenerator(palette, random_device()()).Asteroids(*object);
+	UpdateMain();
+	SetDirty();
 }
 
 
 
-const Sprite *SystemEditor::RandomMoonSprite()
+void SystemEditor::RandomizeMinables()
 {
-	static random_device rd;
-	static mt19937 gen(rd());
-
-	const auto &moons = GameData::MoonSprites();
-	uniform_int_distribution<> randMoon(0, moons.size() - 1);
-	return moons[randMoon(gen)];
+	const auto palette = SystemGenerator::Palette::FromGameData();
+	SystemGenerator(palette, random_device()()).Minables(*object);
+	UpdateMain();
+	SetDirty();
 }
 
 
 
-const Sprite *SystemEditor::RandomGiantSprite()
+void SystemEditor::RenderGenerateRegion()
 {
-	static random_device rd;
-	static mt19937 gen(rd());
+	if(!ImGui::BeginPopupModal("Generate Region", nullptr, ImGuiWindowFlags_AlwaysAutoResize))
+		return;
 
-	const auto &giants = GameData::GiantSprites();
-	uniform_int_distribution<> randGiant(0, giants.size() - 1);
-	return giants[randGiant(gen)];
+	// The region is either the area enclosed by the systems selected on the map,
+	// or a square around the selected system.
+	vector<Point> polygon;
+	const MapEditorPanel *map = dynamic_cast<MapEditorPanel *>(editor.GetMenu().Top().get());
+	if(map && map->Selection().size() >= 3)
+	{
+		vector<Point> corners;
+		for(const System *system : map->Selection())
+			corners.push_back(system->Position());
+		polygon = ConvexHull(std::move(corners));
+	}
+	if(polygon.size() < 3)
+	{
+		const Point center = object ? object->Position() : Point();
+		const double radius = regionSettings.spacing * sqrt(max(regionSettings.count, 1));
+		polygon = {center + Point(-radius, -radius), center + Point(radius, -radius),
+			center + Point(radius, radius), center + Point(-radius, radius)};
+		ImGui::Text("Region: a square around %s", object ? object->Name().c_str() : "the center of the map");
+	}
+	else
+		ImGui::Text("Region: the area enclosed by the selected systems");
+
+	ImGui::InputText("name", &regionSettings.prefix);
+	ImGui::InputInt("systems", &regionSettings.count);
+	ImGui::InputDoubleEx("spacing", &regionSettings.spacing);
+	ImGui::InputDoubleEx("link distance", &regionSettings.linkDistance);
+	ImGui::InputInt("links", &regionSettings.links);
+	int seed = regionSettings.seed;
+	if(ImGui::InputInt("seed", &seed))
+		regionSettings.seed = seed;
+	regionSettings.count = max(regionSettings.count, 0);
+	regionSettings.spacing = max(regionSettings.spacing, 1.);
+
+	if(ImGui::Button("Cancel"))
+		ImGui::CloseCurrentPopup();
+	ImGui::SameLine();
+	const bool canGenerate = regionSettings.count && !regionSettings.prefix.empty();
+	if(!canGenerate)
+		ImGui::PushDisabled();
+	if(ImGui::Button("Generate"))
+	{
+		regionSettings.polygon = std::move(polygon);
+		RegionGenerator region;
+		region.Generate(regionSettings, SystemGenerator::Palette::FromGameData());
+		const vector<const System *> added = AddRegion(region);
+		if(!added.empty())
+		{
+			if(auto *panel = dynamic_cast<MapEditorPanel*>(editor.GetMenu().Top().get()))
+				panel->Select(object);
+			if(auto *panel = dynamic_cast<MainEditorPanel*>(editor.GetMenu().Top().get()))
+				panel->Select(object);
+		}
+		// Generating again gives a different region.
+		++regionSettings.seed;
+		ImGui::CloseCurrentPopup();
+	}
+	else if(!canGenerate)
+		ImGui::PopDisabled();
+	ImGui::EndPopup();
 }
@@ -13,15 +13,20 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #ifndef SYSTEM_EDITOR_H_
 #define SYSTEM_EDITOR_H_
 
+#include "MapBatch.h"
+#include "RegionGenerator.h"
 #include "System.h"
 #include "TemplateEditor.h"
 
 #include <set>
 #include <string>
 #include <list>
+#include <vector>
 
 class DataWriter;
+class Date;
 class Editor;
+class Government;
 class MainEditorPanel;
 class MapEditorPanel;
 class StellarObject;
@@ -34,20 +39,45 @@ public:
 	SystemEditor(Editor &editor, bool &show) noexcept;
 
 	void Render();
+	// Renames the current object, and updates everything that refers to it.
+	virtual void Rename(const std::string &name) override;
 	void AlwaysRender(bool showNewSystem = false);
-	void WriteToFile(DataWriter &writer, const System *system);
+	// Called when an edit of the given system is undone or redone.
+	virtual void Changed(const void *system) override;
+	// Called once every edit of an undone or redone group has been applied.
+	virtual void EndChanges() override;
+	virtual void WriteToFile(DataWriter &writer, const System *system) override;
+	virtual void References(const System &system, std::vector<ReferenceIndex::Key> &references) const override;
 
 	// Updates the given system's position by the given delta.
 	void UpdateSystemPosition(const System *system, Point dp);
 	// Updates the given stellar's position by the given delta.
 	void UpdateStellarPosition(const StellarObject &object, Point dp, const System *system);
+	// Every map edit made between these calls (e.g. while dragging a region of
+	// the map) is undone at once, and the map and the neighbors of the systems
+	// are only updated after the last one.
+	void BeginBatch();
+	void EndBatch();
 	// Toggles a link between the current object and the given one.
 	void ToggleLink(const System *system);
+	// Links each of the given systems to the target, or unlinks them if all of
+	// them already are.
+	void ToggleLinks(const std::vector<const System *> &systems, const System *target);
+	// The given systems that aren't part of the base game, which are the only
+	// ones that can be deleted.
+	std::vector<const System *> Deletable(const std::vector<const System *> &systems) const;
+	// Deletes each of the given systems that isn't part of the base game. This
+	// can't be undone.
+	void Delete(const std::vector<const System *> &systems);
+	void SetGovernment(const std::vector<const System *> &systems, const Government *government);
+	// Copies the given systems, or pastes copies of them with the first one at the
+	// given position. Links between the copied systems are kept.
+	void Copy(const std::vector<const System *> &systems);
+	std::vector<const System *> Paste(Point position);
 	// Create a new system at the specified position.
 	void CreateNewSystem(Point position);
-
-	const System *Selected() const { return object; }
-	void Select(const System *system) { object = const_cast<System *>(system); }
+	// Adds the systems of a generated region to the map, and returns them.
+	std::vector<const System *> AddRegion(const RegionGenerator &region);
 
 
 private:
@@ -58,20 +88,29 @@ private:
 
 	void UpdateMap() const;
 	void UpdateMain() const;
+	// Remembers that the given system was moved, linked or deleted, and updates
+	// the map unless a batch of edits is being made.
+	void Touch(const System *system);
+	void CommitBatch();
+	void DeleteSystem(System *system);
+	// The date the stellar objects are shown at.
+	Date PreviewDate() const;
 
 	void Randomize();
 	void RandomizeAsteroids();
 	void RandomizeMinables();
-
-	const Sprite *RandomStarSprite();
-	const Sprite *RandomPlanetSprite(bool recalculate = false);
-	const Sprite *RandomMoonSprite();
-	const Sprite *RandomGiantSprite();
+	void RenderGenerateRegion();
 
 
 private:
 	Point position;
 	bool createNewSystem = false;
+
+	MapBatch batch;
+	int batchDepth = 0;
+	bool isMapChanged = false;
+	std::vector<System> clipboard;
+	RegionGenerator::Settings regionSettings;
 };
 
 
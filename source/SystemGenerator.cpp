@@ -0,0 +1,378 @@
+/* SystemGenerator.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "SystemGenerator.h"
+
+#include "GameData.h"
+#include "Hazard.h"
+#include "Minable.h"
+#include "Sprite.h"
+#include "StellarObject.h"
+#include "System.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <string>
+
+using namespace std;
+
+namespace {
+	// The chance (out of 100) of each minable being chosen, from the official
+	// ES map editor.
+	const pair<const char *, int> MINABLE_PROBABILITIES[] = {
+		{"aluminum", 12},
+		{"copper", 8},
+		{"gold", 2},
+		{"iron", 13},
+		{"lead", 15},
+		{"neodymium", 3},
+		{"platinum", 1},
+		{"silicon", 2},
+		{"silver", 5},
+		{"titanium", 11},
+		{"tungsten", 6},
+		{"uranium", 4},
+	};
+	
+	// One system in this many has a hazard.
+	constexpr int HAZARD_RARITY = 5;
+	
+	double Radius(const StellarObject &stellar)
+	{
+		return stellar.GetSprite()->Width() / 2. - 4.;
+	}
+	
+	double Mass(const StellarObject &stellar)
+	{
+		constexpr double STAR_MASS_SCALE = .75;
+		const double radius = Radius(stellar);
+		return radius * radius * STAR_MASS_SCALE;
+	}
+}
+
+
+
+// Look up everything that can be chosen in the game data.
+SystemGenerator::Palette SystemGenerator::Palette::FromGameData()
+{
+	Palette palette;
+	palette.stars = GameData::Stars();
+	palette.planets = GameData::PlanetSprites();
+	palette.moons = GameData::MoonSprites();
+	palette.giants = GameData::GiantSprites();
+	for(const auto &it : MINABLE_PROBABILITIES)
+		if(const Minable *minable = GameData::Minables().Find(it.first))
+			palette.minables.emplace_back(minable, it.second);
+	for(const auto &it : GameData::Hazards())
+		if(!it.first.empty())
+			palette.hazards.push_back(&it.second);
+	return palette;
+}
+
+
+
+bool SystemGenerator::Palette::HasSprites() const
+{
+	return !stars.empty() && !planets.empty() && !moons.empty() && !giants.empty();
+}
+
+
+
+SystemGenerator::SystemGenerator(const Palette &palette, uint_fast32_t seed)
+	: palette(palette), gen(seed)
+{
+}
+
+
+
+// Replace the stellar objects of the given system.
+void SystemGenerator::Stellars(System &system)
+{
+	constexpr int STAR_DISTANCE = 40;
+	uniform_int_distribution<> randStarNum(0, 2);
+	uniform_int_distribution<> randStarDist(0, STAR_DISTANCE);
+	
+	system.objects.clear();
+	if(!palette.HasSprites())
+		return;
+	
+	set<const Sprite *> used;
+	
+	// First we generate the (or 2) star(s).
+	const int numStars = 1 + !randStarNum(gen);
+	double mass;
+	if(numStars == 1)
+	{
+		StellarObject stellar;
+		stellar.sprite = Choose(palette.stars, used);
+		stellar.isStar = true;
+		stellar.speed = 36.;
+		mass = Mass(stellar);
+		
+		system.objects.push_back(stellar);
+	}
+	else
+	{
+		StellarObject stellar1;
+		StellarObject stellar2;
+		
+		stellar1.sprite = Choose(palette.stars, used);
+		stellar2.sprite = Choose(palette.stars, used);
+		stellar1.isStar = true;
+		stellar2.isStar = true;
+		stellar2.offset = 180.;
+		
+		double radius1 = Radius(stellar1);
+		double radius2 = Radius(stellar2);
+		double mass1 = Mass(stellar1);
+		double mass2 = Mass(stellar2);
+		mass = mass1 + mass2;
+		
+		double distance = radius1 + radius2 + randStarDist(gen) + STAR_DISTANCE;
+		stellar1.distance = (mass2 * distance) / mass;
+		stellar2.distance = (mass1 * distance) / mass;
+		
+		double period = sqrt(distance * distance * distance / mass);
+		stellar1.speed = 360. / period;
+		stellar2.speed = 360. / period;
+		
+		system.objects.push_back(stellar1);
+		system.objects.push_back(stellar2);
+	}
+	
+	constexpr double HABITABLE_SCALE = 1.25;
+	system.habitable = mass / HABITABLE_SCALE;
+	
+	auto calcPeriod = [&system](StellarObject &stellar, bool isMoon)
+	{
+		const double radius = Radius(stellar);
+		constexpr double PLANET_MASS_SCALE = .015;
+		stellar.speed = isMoon ? 360. / (radius * radius * radius * PLANET_MASS_SCALE)
+			: system.habitable * HABITABLE_SCALE;
+	};
+	
+	// Now we generate lots of planets with moons.
+	uniform_int_distribution<> randPlanetCount(2, 5);
+	int planetCount = randPlanetCount(gen);
+	for(int i = 0; i < planetCount; ++i)
+	{
+		constexpr int RANDOM_SPACE = 100;
+		int space = RANDOM_SPACE;
+		for(const auto &stellar : system.objects)
+			if(!stellar.isStar && stellar.parent == -1)
+				space += RANDOM_SPACE / 2;
+		
+		int distance = system.objects.back().distance;
+		if(system.objects.back().sprite)
+			distance += Radius(system.objects.back());
+		if(system.objects.back().parent != -1)
+			distance += system.objects[system.objects.back().parent].distance;
+		
+		uniform_int_distribution<> randSpace(0, space);
+		const int addSpace = randSpace(gen);
+		distance += (addSpace * addSpace) * .01 + 50.;
+		
+		uniform_int_distribution<> rand10(0, 9);
+		uniform_int_distribution<> rand2000(0, 1999);
+		const bool isSmall = !rand10(gen);
+		const bool isTerrestrial = !isSmall && rand2000(gen) > distance;
+		
+		const int rootIndex = static_cast<int>(system.objects.size());
+		
+		const Sprite *planetSprite;
+		if(isSmall)
+			planetSprite = Choose(palette.moons, used);
+		else if(isTerrestrial)
+			planetSprite = Choose(palette.planets, used);
+		else
+			planetSprite = Choose(palette.giants, used);
+		
+		system.objects.emplace_back();
+		system.objects.back().sprite = planetSprite;
+		
+		uniform_int_distribution<> oneOrTwo(1, 2);
+		uniform_int_distribution<> threeOrFive(3, 5);
+		
+		const int randMoon = isTerrestrial ? oneOrTwo(gen) : threeOrFive(gen);
+		int moonCount = uniform_int_distribution<>(0, randMoon - 1)(gen);
+		if(Radius(system.objects.back()) < 70.)
+			moonCount = 0;
+		
+		double moonDistance = Radius(system.objects.back());
+		int randomMoonSpace = 50.;
+		for(int i = 0; i < moonCount; ++i)
+		{
+			uniform_int_distribution<> randMoonDist(10., randomMoonSpace);
+			moonDistance += randMoonDist(gen);
+			randomMoonSpace += 20.;
+			
+			system.objects.emplace_back();
+			system.objects.back().sprite = Choose(palette.moons, used);
+			system.objects.back().parent = rootIndex;
+			system.objects.back().distance = moonDistance + Radius(system.objects.back());
+			calcPeriod(system.objects.back(), true);
+			moonDistance += 2. * Radius(system.objects.back());
+		}
+		
+		// Adding the moons may have moved the planet in memory.
+		StellarObject &planet = system.objects[rootIndex];
+		planet.distance = distance + moonDistance;
+		calcPeriod(planet, false);
+	}
+}
+
+
+
+// Replace the ordinary asteroids of the given system.
+void SystemGenerator::Asteroids(System &system)
+{
+	system.asteroids.erase(remove_if(system.asteroids.begin(), system.asteroids.end(),
+				[](const System::Asteroid &asteroid) { return !asteroid.Type(); }),
+			system.asteroids.end());
+	
+	uniform_int_distribution<> rand(0, 21);
+	const int total = rand(gen) * rand(gen) + 1;
+	const double energy = (rand(gen) + 10) * (rand(gen) + 10) * .01;
+	const string prefix[] = { "small", "medium", "large" };
+	const char *suffix[] = { " rock", " metal" };
+	
+	uniform_int_distribution<> randCount(0, total - 1);
+	int amount[] = { randCount(gen), 0 };
+	amount[1] = total - amount[0];
+	
+	for(int i = 0; i < 2; ++i)
+	{
+		if(!amount[i])
+			continue;
+		
+		uniform_int_distribution<> randCount(0, amount[i] - 1);
+		int count[] = { 0, randCount(gen), 0 };
+		int remaining = amount[i] - count[1];
+		if(remaining)
+		{
+			uniform_int_distribution<> randRemaining(0, remaining - 1);
+			count[0] = randRemaining(gen);
+			count[2] = remaining - count[0];
+		}
+		
+		for(int j = 0; j < 3; ++j)
+			if(count[j])
+			{
+				uniform_int_distribution<> randEnergy(50, 100);
+				system.asteroids.emplace_back(prefix[j] + suffix[i], count[j], energy * randEnergy(gen) * .01);
+			}
+	}
+}
+
+
+
+// Replace the minables of the given system, based on its other asteroids.
+void SystemGenerator::Minables(System &system)
+{
+	system.asteroids.erase(remove_if(system.asteroids.begin(), system.asteroids.end(),
+				[](const System::Asteroid &asteroid) { return asteroid.Type(); }),
+			system.asteroids.end());
+	
+	uniform_int_distribution<> randBelt(1000, 2000);
+	system.asteroidBelt = randBelt(gen);
+	
+	int totalCount = 0;
+	double totalEnergy = 0.;
+	for(const auto &asteroid : system.asteroids)
+	{
+		totalCount += asteroid.Count();
+		totalEnergy += asteroid.Energy() * asteroid.Count();
+	}
+	
+	if(!totalCount)
+	{
+		// This system has no other asteroids, so we generate a few minables only.
+		totalCount = 1;
+		uniform_real_distribution<> randEnergy(50., 100.);
+		totalEnergy = randEnergy(gen) * .01;
+	}
+	
+	double meanEnergy = totalEnergy / totalCount;
+	totalCount /= 4;
+	
+	// The minables are added in the order of the palette, so that the same
+	// seed always gives the same list.
+	map<size_t, int> choices;
+	uniform_int_distribution<> rand100(0, 99);
+	for(int i = 0; i < 3; ++i)
+	{
+		uniform_int_distribution<> randCount(0, totalCount);
+		totalCount = randCount(gen);
+		if(!totalCount)
+			break;
+		
+		int choice = rand100(gen);
+		for(size_t j = 0; j < palette.minables.size(); ++j)
+		{
+			choice -= palette.minables[j].second;
+			if(choice < 0)
+			{
+				choices[j] += totalCount;
+				break;
+			}
+		}
+	}
+	
+	for(const auto &it : choices)
+	{
+		const double energy = randBelt(gen) * .001 * meanEnergy;
+		system.asteroids.emplace_back(palette.minables[it.first].first, it.second, energy);
+	}
+}
+
+
+
+// Replace the hazards of the given system.
+void SystemGenerator::Hazards(System &system)
+{
+	system.hazards.clear();
+	if(palette.hazards.empty() || uniform_int_distribution<>(0, HAZARD_RARITY - 1)(gen))
+		return;
+	
+	uniform_int_distribution<size_t> randHazard(0, palette.hazards.size() - 1);
+	uniform_int_distribution<> randPeriod(10, 50);
+	system.hazards.emplace_back(palette.hazards[randHazard(gen)], randPeriod(gen) * 100);
+}
+
+
+
+// All of the above.
+void SystemGenerator::Randomize(System &system)
+{
+	Stellars(system);
+	Asteroids(system);
+	Minables(system);
+	Hazards(system);
+}
+
+
+
+// Choose a sprite that isn't used yet, if there is one.
+const Sprite *SystemGenerator::Choose(const vector<const Sprite *> &sprites, set<const Sprite *> &used)
+{
+	vector<const Sprite *> unused;
+	for(const Sprite *sprite : sprites)
+		if(!used.count(sprite))
+			unused.push_back(sprite);
+	const vector<const Sprite *> &choices = unused.empty() ? sprites : unused;
+	
+	uniform_int_distribution<size_t> randSprite(0, choices.size() - 1);
+	const Sprite *sprite = choices[randSprite(gen)];
+	used.insert(sprite);
+	return sprite;
+}
@@ -0,0 +1,83 @@
+/* SystemGenerator.h
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef SYSTEM_GENERATOR_H_
+#define SYSTEM_GENERATOR_H_
+
+#include <cstdint>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+class Hazard;
+class Minable;
+class Sprite;
+class System;
+
+
+
+// Class that fills a star system with random stars, planets, moons, asteroids,
+// minables and hazards. The rules are adapted from the official ES map editor.
+// Each generator has its own random number engine and only reads from its
+// palette, so several systems can be generated at once, and the same seed
+// always gives the same system.
+class SystemGenerator {
+public:
+	// The sprites, minables and hazards to choose from.
+	class Palette {
+	public:
+		// Look up everything that can be chosen in the game data.
+		static Palette FromGameData();
+		
+		// Check whether there are sprites to choose stellar objects from.
+		bool HasSprites() const;
+	
+	public:
+		std::vector<const Sprite *> stars;
+		std::vector<const Sprite *> planets;
+		std::vector<const Sprite *> moons;
+		std::vector<const Sprite *> giants;
+		// Each minable, with the chance (out of 100) that it is chosen.
+		std::vector<std::pair<const Minable *, int>> minables;
+		std::vector<const Hazard *> hazards;
+	};
+	
+	
+public:
+	SystemGenerator(const Palette &palette, uint_fast32_t seed);
+	
+	// Replace the stellar objects of the given system.
+	void Stellars(System &system);
+	// Replace the ordinary asteroids of the given system.
+	void Asteroids(System &system);
+	// Replace the minables of the given system, based on its other asteroids.
+	void Minables(System &system);
+	// Replace the hazards of the given system.
+	void Hazards(System &system);
+	// All of the above.
+	void Randomize(System &system);
+	
+	
+private:
+	// Choose a sprite that isn't used yet, if there is one, and mark it as used.
+	const Sprite *Choose(const std::vector<const Sprite *> &sprites, std::set<const Sprite *> &used);
+	
+	
+private:
+	const Palette &palette;
+	std::mt19937 gen;
+};
+
+
+
+#endif
@@ -0,0 +1,175 @@
+/* SystemPreview.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "SystemPreview.h"
+
+#include "BatchDrawList.h"
+#include "DrawList.h"
+#include "Flotsam.h"
+#include "Point.h"
+#include "System.h"
+
+#include <algorithm>
+#include <iterator>
+
+using namespace std;
+
+namespace {
+	// Remove the objects that have expired. Unlike the engine, which moves the last
+	// object into the place of a removed one, this keeps the objects in order.
+	void Prune(vector<Visual> &visuals)
+	{
+		visuals.erase(remove_if(visuals.begin(), visuals.end(),
+			[](const Visual &visual) { return visual.ShouldBeRemoved(); }), visuals.end());
+	}
+	
+	void Prune(vector<shared_ptr<Flotsam>> &flotsam)
+	{
+		flotsam.erase(remove_if(flotsam.begin(), flotsam.end(),
+			[](const shared_ptr<Flotsam> &object) { return object->ShouldBeRemoved(); }), flotsam.end());
+	}
+	
+	template <class Type>
+	void Append(vector<Type> &objects, vector<Type> &added)
+	{
+		objects.insert(objects.end(), make_move_iterator(added.begin()), make_move_iterator(added.end()));
+		added.clear();
+	}
+}
+
+
+
+SystemPreview::~SystemPreview()
+{
+	Clear();
+}
+
+
+
+// Start (or restart) previewing the given system. The date that is being
+// previewed stays the same, unless none has been chosen yet.
+void SystemPreview::Load(const System &system, const Date &today)
+{
+	if(this->system != &system)
+		Clear();
+	this->system = const_cast<System *>(&system);
+	this->today = today;
+	if(!date)
+		date = today;
+	this->system->SetDate(date);
+	
+	visuals.clear();
+	flotsam.clear();
+	asteroids.Clear();
+	for(const System::Asteroid &a : system.Asteroids())
+	{
+		// Check whether this is a minable or an ordinary asteroid.
+		if(a.Type())
+			asteroids.Add(a.Type(), a.Count(), a.Energy(), system.AsteroidBelt());
+		else
+			asteroids.Add(a.Name(), a.Count(), a.Energy());
+	}
+}
+
+
+
+// Stop previewing, and move the stellar objects back to today's positions.
+void SystemPreview::Clear()
+{
+	if(system)
+		system->SetDate(today);
+	system = nullptr;
+	
+	asteroids.Clear();
+	visuals.clear();
+	newVisuals.clear();
+	flotsam.clear();
+	newFlotsam.clear();
+}
+
+
+
+// Advance the simulation by one step, in the same order as the engine does.
+void SystemPreview::Step()
+{
+	asteroids.Step(newVisuals, newFlotsam, step);
+	
+	for(const shared_ptr<Flotsam> &it : flotsam)
+		it->Move(newVisuals);
+	Prune(flotsam);
+	
+	for(Visual &visual : visuals)
+		visual.Move();
+	Prune(visuals);
+	
+	// Objects created during this step only start moving on the next one.
+	Append(flotsam, newFlotsam);
+	Append(visuals, newVisuals);
+	++step;
+}
+
+
+
+// Move the stellar objects to their positions on the given date.
+void SystemPreview::SetDate(const Date &date)
+{
+	this->date = date;
+	if(system)
+		system->SetDate(date);
+}
+
+
+
+const Date &SystemPreview::GetDate() const
+{
+	return date;
+}
+
+
+
+const Date &SystemPreview::Today() const
+{
+	return today;
+}
+
+
+
+void SystemPreview::Draw(DrawList &draw, BatchDrawList &batchDraw, const Point &center, double zoom) const
+{
+	asteroids.Draw(draw, center, zoom);
+	for(const shared_ptr<Flotsam> &it : flotsam)
+		draw.Add(*it);
+	for(const Visual &visual : visuals)
+		batchDraw.AddVisual(visual);
+}
+
+
+
+// The number of steps simulated, and the number of objects in flight.
+int SystemPreview::Steps() const
+{
+	return step;
+}
+
+
+
+size_t SystemPreview::VisualCount() const
+{
+	return visuals.size();
+}
+
+
+
+size_t SystemPreview::FlotsamCount() const
+{
+	return flotsam.size();
+}
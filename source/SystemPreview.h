@@ -0,0 +1,80 @@
+/* SystemPreview.h
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef SYSTEM_PREVIEW_H_
+#define SYSTEM_PREVIEW_H_
+
+#include "AsteroidField.h"
+#include "Date.h"
+#include "Visual.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class BatchDrawList;
+class DrawList;
+class Flotsam;
+class Point;
+class System;
+
+
+
+// Class simulating a star system for the editor's view of it. The asteroids
+// drift, and the effects and flotsam they leave behind move and expire the same
+// way they do in flight. The stellar objects can be shown at their positions on
+// any date; once the preview is done with a system, its stellar objects are put
+// back where they are on the current date.
+class SystemPreview {
+public:
+	SystemPreview() = default;
+	SystemPreview(const SystemPreview &) = delete;
+	SystemPreview &operator=(const SystemPreview &) = delete;
+	~SystemPreview();
+	
+	// Start (or restart) previewing the given system. The date that is being
+	// previewed stays the same, unless none has been chosen yet.
+	void Load(const System &system, const Date &today);
+	// Stop previewing, and move the stellar objects back to today's positions.
+	void Clear();
+	
+	// Advance the simulation by one step.
+	void Step();
+	// Move the stellar objects to their positions on the given date.
+	void SetDate(const Date &date);
+	const Date &GetDate() const;
+	const Date &Today() const;
+	
+	void Draw(DrawList &draw, BatchDrawList &batchDraw, const Point &center, double zoom) const;
+	
+	// The number of steps simulated, and the number of objects in flight.
+	int Steps() const;
+	size_t VisualCount() const;
+	size_t FlotsamCount() const;
+	
+	
+private:
+	System *system = nullptr;
+	Date today;
+	Date date;
+	
+	AsteroidField asteroids;
+	std::vector<Visual> visuals;
+	std::vector<Visual> newVisuals;
+	std::vector<std::shared_ptr<Flotsam>> flotsam;
+	std::vector<std::shared_ptr<Flotsam>> newFlotsam;
+	int step = 0;
+};
+
+
+
+#endif
@@ -16,10 +16,14 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Audio.h"
 #include "Body.h"
 #include "DataWriter.h"
+#include "EditJournal.h"
+#include "EditLog.h"
 #include "Effect.h"
 #include "Fleet.h"
 #include "GameData.h"
 #include "Minable.h"
+#include "ReferenceIndex.h"
+#include "SearchIndex.h"
 #include "Sound.h"
 #include "Sprite.h"
 #include "SpriteSet.h"
@@ -28,8 +32,8 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "imgui_ex.h"
 #include "imgui_stdlib.h"
 
-#include <list>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <string_view>
@@ -41,6 +45,8 @@ class Editor;
 
 
 void AddNode(Editor &editor, const std::string &file, const std::string &key, const std::string &name);
+EditJournal &JournalFor(Editor &editor);
+void RestoreDefinition(Editor &editor, const std::string &definition);
 
 
 
@@ -79,54 +85,66 @@ std::string GetName(const T &obj) { return impl::GetName<T>(obj, 0); }
 
 // Base class common for any editor window.
 template <typename T>
-class TemplateEditor {
+class TemplateEditor : public EditJournal::Owner {
 public:
 	TemplateEditor(Editor &editor, bool &show) noexcept
 		: editor(editor), show(show) {}
 	TemplateEditor(const TemplateEditor &) = delete;
 	TemplateEditor& operator=(const TemplateEditor &) = delete;
+	virtual ~TemplateEditor() { JournalFor(editor).Forget(this); }
 
-	const std::list<T> &Changes() const { return changes; }
+	// Called when an edit of the given object is undone or redone.
+	virtual void Changed(const void *obj) override { SetDirty(static_cast<const T *>(obj)); }
+
+	// The definition of each object of the plugin as it was last saved, the way
+	// it is written to the plugin.
+	const std::map<std::string, std::string> &Saved() const { return saved; }
 	const std::map<const T *, std::string> &Dirty() const { return dirty; }
 
+	// Writes the given object the way it would be saved to the plugin.
+	virtual void WriteToFile(DataWriter &writer, const T *object) = 0;
+	// Lists every object the given object refers to (e.g. the outfits installed
+	// in a ship).
+	virtual void References(const T &object, std::vector<ReferenceIndex::Key> &references) const {}
+	// Lists the attributes of the given object that can be searched for, besides
+	// its name (e.g. "ion damage" for an outfit).
+	virtual void SearchTerms(const T &object, std::vector<std::string> &terms) const {}
+	// Renames the current object, and updates everything that refers to it.
+	virtual void Rename(const std::string &name) = 0;
+
+	const T *Selected() const { return object; }
+	void Select(const T *obj) { object = const_cast<T *>(obj); }
+	void Show() { show = true; }
+
 	void Clear()
 	{
 		searchBox.clear();
 		object = nullptr;
 		dirty.clear();
-		changes.clear();
+		saved.clear();
+		unlogged.clear();
+		cleaned.clear();
+		unindexed.clear();
+		tracked.reset();
+		JournalFor(editor).Forget(this);
 	}
 
-	// Saves the specified object.
-	void WriteToPlugin(const T *object, bool useDefault = true) { WriteToPlugin(object, useDefault, 0); }
-	template<typename U>
-	void WriteToPlugin(const U *object, bool useDefault, ...)
-	{
-		dirty.erase(object);
-		for(auto &&obj : changes)
-			if(obj.Name() == object->Name())
-			{
-				obj = *object;
-				return;
-			}
-		if(useDefault)
-			AddNode(editor, defaultFileFor<T>(), keyFor<T>(), object->Name());
-		changes.push_back(*object);
-	}
-	template <typename U>
-	void WriteToPlugin(const U *object, bool useDefault, typename std::decay<decltype(std::declval<U>().TrueName())>::type *)
+	// Saves the specified object. Only its definition is kept, not a copy of it.
+	void WriteToPlugin(const T *object, bool useDefault = true)
 	{
 		dirty.erase(object);
-		for(auto &&obj : changes)
-			if(obj.TrueName() == object->TrueName())
-			{
-				obj = *object;
-				return;
-			}
-		if(useDefault)
-			AddNode(editor, defaultFileFor<T>(), keyFor<T>(), object->TrueName());
-		changes.push_back(*object);
+		const std::string name = GetName(*object);
+		if(useDefault && !saved.count(name))
+			AddNode(editor, defaultFileFor<T>(), keyFor<T>(), name);
+		DataWriter writer;
+		WriteToFile(writer, object);
+		saved[name] = writer.SaveToString();
 	}
+	// Every edit made between these calls (e.g. while dragging something) is
+	// undone and redone at once.
+	void BeginEdit() { JournalFor(editor).BeginGroup(); }
+	void EndEdit() { JournalFor(editor).EndGroup(); }
+
 	// Saves every unsaved object.
 	void WriteAll()
 	{
@@ -139,26 +157,163 @@ public:
 				dirty.erase(obj.first);
 	}
 
+	// Adds the definition of every unsaved object that changed since the last
+	// call to the crash recovery log, or of every unsaved object, if the log is
+	// being rewritten. Objects that were reset or deleted since are logged
+	// without a definition, so that they are not recovered.
+	void Log(EditLog &log, bool all)
+	{
+		std::string_view deleted = "[deleted] ";
+		if(!all)
+			for(auto &&obj : cleaned)
+				if(!dirty.count(obj.first))
+					log.Append(keyFor<T>(), obj.second, "");
+		for(auto &&obj : dirty)
+		{
+			if(!all && !unlogged.count(obj.first))
+				continue;
+			if(obj.second.size() > deleted.size() && !obj.second.compare(0, deleted.size(), deleted))
+			{
+				if(!all)
+					log.Append(keyFor<T>(), obj.second.substr(deleted.size()), "");
+				continue;
+			}
+
+			DataWriter writer;
+			WriteToFile(writer, obj.first);
+			log.Append(keyFor<T>(), GetName(*obj.first), writer.SaveToString());
+		}
+		unlogged.clear();
+		cleaned.clear();
+	}
+
+	// Adds what the given object refers to to the reference index, and the
+	// object itself to the search index.
+	void Index(ReferenceIndex &index, SearchIndex &search, const std::string &name, const T &obj) const
+	{
+		const ReferenceIndex::Key key(keyFor<T>(), name);
+		std::vector<ReferenceIndex::Key> references;
+		References(obj, references);
+		index.Set(key, std::move(references));
+		std::vector<std::string> terms;
+		SearchTerms(obj, terms);
+		search.Add(key, std::move(terms));
+	}
+	// Updates the indexes with every object that changed since the last call,
+	// and adds the objects that were deleted since to the given list.
+	void UpdateIndex(ReferenceIndex &index, SearchIndex &search, std::vector<ReferenceIndex::Key> &deleted)
+	{
+		for(auto &&obj : unindexed)
+		{
+			const std::string name = GetName(*obj.first);
+			// The object may have been renamed or deleted since it changed.
+			if(name != obj.second)
+			{
+				const ReferenceIndex::Key key(keyFor<T>(), obj.second);
+				index.Remove(key);
+				search.Remove(key);
+				if(name.empty())
+					deleted.push_back(key);
+			}
+			if(!name.empty())
+				Index(index, search, name, *obj.first);
+		}
+		unindexed.clear();
+	}
+
 protected:
+	// Remembers the value of a field of the current object before it is given
+	// to a widget, so that if the widget changes it, SetDirty() can record the
+	// edit in the journal.
+	template <typename V>
+	V *Track(V &field) { tracked = EditJournal::Snapshot(field); return &field; }
+	// Like the above, for the field that the given function returns of an
+	// element of a container, which may be moved if elements are added or removed.
+	template <typename C, typename F>
+	auto Track(C &container, size_t index, F get)
+	{
+		tracked = EditJournal::Snapshot(container, index, get);
+		return &get(container[index]);
+	}
+	// Records an edit that changed a field of the given object.
+	template <typename V>
+	void Record(const T *obj, V &field, V oldValue, bool merge = false)
+	{
+		JournalFor(editor).Record(this, obj, field, std::move(oldValue), merge);
+		SetDirty(obj);
+	}
+	void Record(const T *obj, std::unique_ptr<EditJournal::Change> change, bool merge = false)
+	{
+		JournalFor(editor).Record(this, obj, std::move(change), merge);
+		SetDirty(obj);
+	}
+
 	// Marks the current object as dirty.
-	void SetDirty() { dirty[object] = GetName(*object); }
-	void SetDirty(const std::string &prefix) { dirty[object] = prefix + " " + GetName(*object); }
-	void SetDirty(const T *obj) { dirty[obj] = GetName(*obj); }
+	void SetDirty()
+	{
+		// Keep merging the edits of a widget until the user is done with it.
+		if(tracked && tracked->IsChanged())
+			JournalFor(editor).Record(this, object, std::move(tracked), ImGui::IsItemActive());
+		tracked.reset();
+		dirty[object] = GetName(*object);
+		unlogged.insert(object);
+		unindexed.emplace(object, GetName(*object));
+	}
+	void SetDirty(const std::string &prefix)
+	{
+		dirty[object] = prefix + " " + GetName(*object);
+		unlogged.insert(object);
+		unindexed.emplace(object, GetName(*object));
+	}
+	void SetDirty(const T *obj)
+	{
+		dirty[obj] = GetName(*obj);
+		unlogged.insert(obj);
+		unindexed.emplace(obj, GetName(*obj));
+	}
+	// Adds the given object to the list of objects the given one refers to.
+	template <typename U>
+	static void AddReference(std::vector<ReferenceIndex::Key> &references, const U *obj)
+	{
+		if(obj && !GetName(*obj).empty())
+			references.emplace_back(keyFor<U>(), GetName(*obj));
+	}
 	bool IsDirty() { return dirty.count(object); }
-	void SetClean() { dirty.erase(object); }
+	// The current object has been reset or deleted, so its edits can no longer be undone.
+	void SetClean()
+	{
+		if(dirty.erase(object))
+			cleaned[object] = GetName(*object);
+		JournalFor(editor).Forget(object);
+	}
 	void DeleteFromChanges()
 	{
 		assert(object && "can't delete null object from list");
-		auto it = std::find_if(changes.begin(), changes.end(), [this](const auto &obj)
-				{
-					return GetName(obj) == GetName(*object);
-				});
-		if(it != changes.end())
-			changes.erase(it);
+		JournalFor(editor).Forget(object);
+		saved.erase(GetName(*object));
+	}
+	// Whether the current object has been saved to the plugin.
+	bool IsSaved() const { return saved.count(GetName(*object)); }
+	// Restores the current object to the way it was last saved, and returns
+	// false if it never was.
+	bool RestoreSaved()
+	{
+		auto it = saved.find(GetName(*object));
+		if(it == saved.end())
+			return false;
+		RestoreDefinition(editor, it->second);
+		// Restoring the object marks it as changed, but it is now the same as
+		// what was saved.
+		dirty.erase(object);
+		return true;
 	}
 
 	void RenderSprites(const std::string &name, std::vector<std::pair<Body, int>> &map);
 	bool RenderElement(Body *sprite, const std::string &name);
+	// Renders the given sprite, and tracks each of its fields with the given
+	// function, which is given the member that is about to be edited.
+	template <typename F>
+	bool RenderElement(Body *sprite, const std::string &name, F track);
 	void RenderSound(const std::string &name, std::map<const Sound *, int> &map);
 	void RenderEffect(const std::string &name, std::map<const Effect *, int> &map);
 
@@ -173,7 +328,15 @@ protected:
 
 private:
 	std::map<const T *, std::string> dirty;
-	std::list<T> changes;
+	std::map<std::string, std::string> saved;
+	std::unique_ptr<EditJournal::Change> tracked;
+	// The unsaved objects that changed since they were last logged, and the
+	// names of those that were reset since.
+	std::set<const T *> unlogged;
+	std::map<const T *, std::string> cleaned;
+	// The objects that changed since the reference index was last updated, and
+	// their names at the time.
+	std::map<const T *, std::string> unindexed;
 };
 
 
@@ -186,17 +349,25 @@ void TemplateEditor<T>::RenderSprites(const std::string &name, std::vector<std::
 	ImGui::PushID(name.c_str());
 	for(auto it = map.begin(); it != map.end(); ++it)
 	{
-		ImGui::PushID(index++);
-		if(RenderElement(&it->first, name))
+		ImGui::PushID(index);
+		auto track = [this, &map, index](auto member)
+		{
+			return Track(map, index, [member](std::pair<Body, int> &element) -> auto & { return element.first.*member; });
+		};
+		if(RenderElement(&it->first, name, track))
 			found = it;
 		ImGui::PopID();
+		++index;
 	}
 	ImGui::PopID();
 
 	if(found != map.end())
 	{
+		// Removing a sprite is recorded as a change of the whole list, so that
+		// the edits of the sprites after it still apply once it is undone.
+		auto oldMap = map;
 		map.erase(found);
-		SetDirty();
+		Record(object, map, std::move(oldMap));
 	}
 }
 
@@ -204,6 +375,15 @@ void TemplateEditor<T>::RenderSprites(const std::string &name, std::vector<std::
 
 template <typename T>
 bool TemplateEditor<T>::RenderElement(Body *sprite, const std::string &name)
+{
+	return RenderElement(sprite, name, [this, sprite](auto member) { return Track(sprite->*member); });
+}
+
+
+
+template <typename T>
+template <typename F>
+bool TemplateEditor<T>::RenderElement(Body *sprite, const std::string &name, F track)
 {
 	static std::string spriteName;
 	spriteName.clear();
@@ -220,25 +400,29 @@ bool TemplateEditor<T>::RenderElement(Body *sprite, const std::string &name)
 	{
 		if(sprite->GetSprite())
 			spriteName = sprite->GetSprite()->Name();
-		if(ImGui::InputCombo("sprite", &spriteName, &sprite->sprite, SpriteSet::GetSprites()))
+		if(ImGui::InputCombo("sprite", &spriteName, track(&Body::sprite), SpriteSet::GetSprites()))
 			SetDirty();
 
 		double value = sprite->frameRate * 60.;
 		if(ImGui::InputDoubleEx("frame rate", &value, ImGuiInputTextFlags_EnterReturnsTrue))
 		{
+			track(&Body::frameRate);
 			sprite->frameRate = value / 60.;
 			SetDirty();
 		}
 
-		if(ImGui::InputInt("delay", &sprite->delay))
+		if(ImGui::InputInt("delay", track(&Body::delay)))
 			SetDirty();
-		if(ImGui::Checkbox("random start frame", &sprite->randomize))
+		if(ImGui::Checkbox("random start frame", track(&Body::randomize)))
 			SetDirty();
 		bool bvalue = !sprite->repeat;
 		if(ImGui::Checkbox("no repeat", &bvalue))
+		{
+			track(&Body::repeat);
+			sprite->repeat = !bvalue;
 			SetDirty();
-		sprite->repeat = !bvalue;
-		if(ImGui::Checkbox("rewind", &sprite->rewind))
+		}
+		if(ImGui::Checkbox("rewind", track(&Body::rewind)))
 			SetDirty();
 		ImGui::TreePop();
 	}
@@ -22,6 +22,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include <algorithm>
 #include <cstdint>
+#include <iterator>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -43,6 +44,12 @@ namespace ImGui
 
 	IMGUI_API bool InputSwizzle(const char *label, int *swizzle, bool allowNoSwizzle = false);
 
+	// Renders only the visible items of a list in which every item is a single
+	// row of the same height. Each item's ID is based on its address, so that
+	// removing an item doesn't change the state of the items after it.
+	template <typename C, typename F>
+	IMGUI_API void ClippedList(C &items, F &&f);
+
 	template <typename F>
 	IMGUI_API void BeginSimpleModal(const char *id, const char *label, const char *button, F &&f);
 	template <typename F>
@@ -216,6 +223,25 @@ IMGUI_API bool ImGui::InputCombo(const char *label, std::string *input, const T
 
 
 
+template <typename C, typename F>
+IMGUI_API void ImGui::ClippedList(C &items, F &&f)
+{
+	ImGuiListClipper clipper;
+	clipper.Begin(static_cast<int>(items.size()));
+	while(clipper.Step())
+	{
+		auto it = std::next(items.begin(), clipper.DisplayStart);
+		for(int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i, ++it)
+		{
+			PushID(static_cast<const void *>(&*it));
+			f(*it);
+			PopID();
+		}
+	}
+}
+
+
+
 template <typename F>
 IMGUI_API void ImGui::BeginSimpleModal(const char *id, const char *label, const char *button, F &&f)
 {
@@ -13,9 +13,12 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 */
 
 #include "Audio.h"
+#include "Batch.h"
+#include "Benchmark.h"
 #include "Command.h"
 #include "Conversation.h"
 #include "ConversationPanel.h"
+#include "DataCache.h"
 #include "DataFile.h"
 #include "DataNode.h"
 #include "Dialog.h"
@@ -25,6 +28,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "FrameTimer.h"
 #include "GameData.h"
 #include "GameWindow.h"
+#include "Logger.h"
 #include "imgui.h"
 #include "imgui_impl_sdl.h"
 #include "imgui_impl_opengl3.h"
@@ -32,6 +36,9 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Panel.h"
 #include "PlayerInfo.h"
 #include "Preferences.h"
+#include "Replay.h"
+#include "SaveIndex.h"
+#include "SaveQueue.h"
 #include "Screen.h"
 #include "SpriteSet.h"
 #include "SpriteShader.h"
@@ -39,6 +46,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "UI.h"
 
 #include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <map>
 
@@ -62,6 +70,7 @@ void PrintHelp();
 void PrintVersion();
 void GameLoop(PlayerInfo &player, const Conversation &conversation, const string &testToRun, bool debugMode);
 Conversation LoadConversation();
+int FinishSaving(int exitCode);
 #ifdef _WIN32
 void InitConsole();
 #endif
@@ -99,6 +108,12 @@ int main(int argc, char *argv[])
 	bool debugMode = false;
 	bool loadOnly = false;
 	string testToRunName = "";
+	string benchmarkName;
+	int benchmarkSteps = 0;
+	string replayPath;
+	string batchPath;
+	int batchJobs = 0;
+	int batchWorker = -1;
 
 	for(const char *const *it = argv + 1; *it; ++it)
 	{
@@ -121,17 +136,81 @@ int main(int argc, char *argv[])
 			loadOnly = true;
 		else if(arg == "--test" && *++it)
 			testToRunName = *it;
+		else if(arg == "--bench-sim" && *++it)
+			benchmarkName = *it;
+		else if(arg == "--steps" && *++it)
+			benchmarkSteps = atoi(*it);
+		else if(arg == "--record" && *++it)
+			Replay::SetRecordPath(*it);
+		else if(arg == "--replay" && *++it)
+			replayPath = *it;
+		else if(arg == "--cache")
+			DataCache::SetEnabled(true);
+		else if(arg == "--batch" && *++it)
+			batchPath = *it;
+		else if(arg == "--jobs" && *++it)
+			batchJobs = atoi(*it);
+		else if(arg == "--batch-worker" && *++it)
+			batchWorker = atoi(*it);
 	}
 	
+	// Write log messages in the background from now on, rather than making
+	// each thread wait for the console and the log file.
+	Logger::StartWriter();
+	
 	try {
+		// Find the resource and config directories, which everything else uses.
+		Files::Init(argv);
+		
+		// The plugins of a batch script are split between worker processes,
+		// which each load the game data on their own.
+		Batch batch;
+		if(!batchPath.empty())
+		{
+			if(!batch.Load(batchPath))
+				return FinishSaving(1);
+			if(batchWorker < 0 && batchJobs != 1 && batch.Plugins().size() > 1)
+				return FinishSaving(batch.Spawn(argv, batchJobs) ? 0 : 1);
+		}
+		
 		// Begin loading the game data. Exit early if we are not using the UI.
 		if(!GameData::BeginLoad(argv))
-			return 0;
+			return FinishSaving(0);
 		
 		if(!testToRunName.empty() && !GameData::Tests().Has(testToRunName))
 		{
 			Files::LogError("Test \"" + testToRunName + "\" not found.");
-			return 1;
+			return FinishSaving(1);
+		}
+		
+		// Benchmarks run the simulation headless, so no window is ever created.
+		if(!benchmarkName.empty())
+		{
+			if(!GameData::Benchmarks().Has(benchmarkName))
+			{
+				Files::LogError("Benchmark \"" + benchmarkName + "\" not found.");
+				return FinishSaving(1);
+			}
+			// Wait for all the sprites to be loaded, so that ships have masks.
+			GameData::FinishLoading();
+			return FinishSaving(GameData::Benchmarks().Get(benchmarkName)->Run(benchmarkSteps) ? 0 : 1);
+		}
+		// Replays are also simulated without a window.
+		if(!replayPath.empty())
+		{
+			Replay replay;
+			if(!replay.Load(replayPath))
+				return FinishSaving(1);
+			// The AI's behavior depends on some of the preferences.
+			Preferences::Load();
+			GameData::FinishLoading();
+			return FinishSaving(replay.Run() ? 0 : 1);
+		}
+		// Batch scripts edit and save plugins without a window.
+		if(!batchPath.empty())
+		{
+			GameData::FinishLoading();
+			return FinishSaving(batch.Run(max(batchWorker, 0), max(batchJobs, 1)) ? 0 : 1);
 		}
 		
 		// Load player data, including reference-checking.
@@ -142,7 +221,7 @@ int main(int argc, char *argv[])
 			if(!checkedReferences)
 				GameData::CheckReferences();
 			cout << "Parse completed." << endl;
-			return 0;
+			return FinishSaving(0);
 		}
 		
 		// On Windows, make sure that the sleep timer has at least 1 ms resolution
@@ -154,7 +233,7 @@ int main(int argc, char *argv[])
 		Preferences::Load();
 		
 		if(!GameWindow::Init())
-			return 1;
+			return FinishSaving(1);
 		
 		GameData::LoadShaders(!GameWindow::HasSwizzle());
 		
@@ -171,7 +250,7 @@ int main(int argc, char *argv[])
 		Audio::Quit();
 		bool doPopUp = testToRunName.empty();
 		GameWindow::ExitWithError(error.what(), doPopUp);
-		return 1;
+		return FinishSaving(1);
 	}
 	
 	// Remember the window state and preferences if quitting normally.
@@ -179,6 +258,10 @@ int main(int argc, char *argv[])
 	Preferences::Set("fullscreen", GameWindow::IsFullscreen());
 	Screen::SetRaw(GameWindow::Width(), GameWindow::Height());
 	Preferences::Save();
+	// Don't quit before the game has finished saving.
+	SaveQueue::Wait();
+	SaveIndex::Wait();
+	Logger::StopWriter();
 	
 	Audio::Quit();
 	GameWindow::Quit();
@@ -186,6 +269,16 @@ int main(int argc, char *argv[])
 	return 0;
 }
 
+// Wait for any saves and save headers that are still queued, then return the
+// given exit code. This must be done on every path out of main(), before the
+// static data that the background threads use is destroyed.
+int FinishSaving(int exitCode)
+{
+	SaveQueue::Wait();
+	SaveIndex::Wait();
+	return exitCode;
+}
+
 void GameLoop(PlayerInfo &player, const Conversation &conversation, const string &testToRunName, bool debugMode)
 {
 	// gamePanels is used for the main panel where you fly your spaceship.
@@ -390,6 +483,13 @@ void PrintHelp()
 	cerr << "    -p, --parse-save: load the most recent saved game and inspect it for content errors" << endl;
 	cerr << "    --tests: print table of available tests, then exit." << endl;
 	cerr << "    --test <name>: run given test from resources directory" << endl;
+	cerr << "    --bench-sim <name>: run given simulation benchmark without a window, then exit." << endl;
+	cerr << "    --steps <count>: number of steps to run the benchmark for." << endl;
+	cerr << "    --record <path>: record each flight to the given replay file." << endl;
+	cerr << "    --replay <path>: simulate the given replay file without a window, then exit." << endl;
+	cerr << "    --cache: keep a compiled copy of the game data, which may load faster from slow drives." << endl;
+	cerr << "    --batch <path>: apply the edits in the given script to the plugins it names without a window, then exit." << endl;
+	cerr << "    --jobs <count>: number of plugins to process at once in batch mode (default: one per processor)." << endl;
 	cerr << endl;
 	cerr << "Report bugs to: <https://github.com/endless-sky/endless-sky/issues>" << endl;
 	cerr << "Home page: <https://endless-sky.github.io>" << endl;
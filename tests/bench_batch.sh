@@ -0,0 +1,67 @@
+#!/bin/bash
+set -eo pipefail
+
+if [ -z "$1" ]; then
+  echo "You must supply a path to the binary as an argument, e.g."
+  echo "~$ ./tests/bench_batch.sh ./endless-sky [jobs]"
+  exit 1
+fi
+PLUGINS=50
+JOBS=${2:-0}
+# The plugins are created in their own config directory, so that the real one is left alone.
+CONFIG=$(mktemp -d)
+trap 'rm -rf "$CONFIG"' EXIT
+SCRIPT="$CONFIG/batch.txt"
+
+# Each plugin defines an outfit and a system of its own.
+for i in $(seq 1 $PLUGINS); do
+  mkdir -p "$CONFIG/plugins/Batch $i/data"
+  cat > "$CONFIG/plugins/Batch $i/data/batch.txt" <<EOF
+outfit "Batch Laser $i"
+	category "Guns"
+	cost $((i * 1000))
+	"mass" 5
+
+system "Batch System $i"
+	pos $((i * 10)) -1000
+	government "Uninhabited"
+EOF
+  echo "plugin \"Batch $i\"" >> "$SCRIPT"
+done
+
+# Every plugin gets the same new outfit, and each one's own objects are renamed.
+cat >> "$SCRIPT" <<EOF
+edit
+	outfit "Batch Cannon"
+		category "Guns"
+		cost 25000
+		"mass" 10
+EOF
+for i in $(seq 1 $PLUGINS); do
+  echo "rename outfit \"Batch Laser $i\" \"Batch Blaster $i\"" >> "$SCRIPT"
+  echo "rename system \"Batch System $i\" \"Batch Sector $i\"" >> "$SCRIPT"
+done
+
+START=$(date +%s.%N)
+if ! "$1" --config "$CONFIG" --batch "$SCRIPT" --jobs "$JOBS"; then
+  EXIT_CODE=$?
+  echo "Error executing file/command '$1'."
+  exit $EXIT_CODE
+fi
+END=$(date +%s.%N)
+
+# Assert that every edit was saved to every plugin.
+for i in $(seq 1 $PLUGINS); do
+  DATA="$CONFIG/plugins/Batch $i/data"
+  for NAME in "Batch Cannon" "Batch Blaster $i" "Batch Sector $i"; do
+    if ! grep -rqF "\"$NAME\"" "$DATA"; then
+      echo "Assertion failed: \"$NAME\" was not saved to plugin \"Batch $i\"."
+      exit 1
+    fi
+  done
+  if grep -rqF "\"Batch Laser $i\"" "$DATA"; then
+    echo "Assertion failed: \"Batch Laser $i\" was not renamed in plugin \"Batch $i\"."
+    exit 1
+  fi
+done
+echo "Batch benchmark completed successfully: $PLUGINS plugins in $(echo "$END - $START" | bc) s."
@@ -0,0 +1,39 @@
+/* temporary-directory.h
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef ES_TEST_HELPER_TEMPORARY_DIRECTORY_H_
+#define ES_TEST_HELPER_TEMPORARY_DIRECTORY_H_
+
+#include <string>
+
+
+
+// A new, empty directory for a test to write files to, which is deleted along
+// with everything in it once the test is done with it.
+class TemporaryDirectory {
+public:
+	TemporaryDirectory();
+	~TemporaryDirectory();
+	TemporaryDirectory(const TemporaryDirectory &) = delete;
+	TemporaryDirectory &operator=(const TemporaryDirectory &) = delete;
+	
+	// The path to the directory, ending in a slash.
+	const std::string &Path() const;
+	
+	
+private:
+	std::string path;
+};
+
+
+
+#endif
@@ -0,0 +1,43 @@
+/* temporary-directory.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "temporary-directory.h"
+
+#include <filesystem>
+#include <random>
+#include <string>
+
+
+
+// Create a directory with a name that no other directory has, in the system's
+// directory for temporary files.
+TemporaryDirectory::TemporaryDirectory()
+{
+	const std::filesystem::path root = std::filesystem::temp_directory_path();
+	std::random_device device;
+	std::filesystem::path directory;
+	do {
+		directory = root / ("es-test-" + std::to_string(device()));
+	} while(!std::filesystem::create_directory(directory));
+	path = directory.generic_string() + "/";
+}
+// Delete the directory and everything in it.
+TemporaryDirectory::~TemporaryDirectory()
+{
+	std::error_code error;
+	std::filesystem::remove_all(path, error);
+}
+// The path to the directory, ending in a slash.
+const std::string &TemporaryDirectory::Path() const
+{
+	return path;
+}
@@ -0,0 +1,189 @@
+/* test_batch.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/Batch.h"
+
+// ... and any system includes needed for the test file.
+#include "../../source/DataFile.h"
+#include "../../source/EditLog.h"
+#include "../../source/Files.h"
+// ... and a directory for the plugins it writes.
+#include "temporary-directory.h"
+
+#include <filesystem>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+DataFile AsDataFile(const std::string &text)
+{
+	std::istringstream in(text);
+	return DataFile(in);
+}
+
+// A script that edits and renames an outfit in each of its plugins.
+std::string MakeScript(int plugins)
+{
+	std::string script;
+	for(int i = 0; i < plugins; ++i)
+		script += "plugin \"Plugin " + std::to_string(i) + "\"\n";
+	script += "edit\n"
+		"\toutfit \"Laser\"\n"
+		"\t\tcost 5000\n"
+		"rename outfit \"Laser\" \"Blaster\"\n";
+	return script;
+}
+
+// Without a config directory, plugins are looked for in the working directory.
+const std::string PLUGINS = "plugins/";
+const std::string PLUGIN = "Batch Test";
+const std::string DATA = PLUGINS + PLUGIN + "/data/";
+const std::string LOG = PLUGINS + PLUGIN + ".edits";
+
+// Work in a new temporary directory for as long as this exists, so that no real
+// plugins can be changed.
+class TemporaryWorkingDirectory {
+public:
+	TemporaryWorkingDirectory()
+		: previous(std::filesystem::current_path())
+	{
+		std::filesystem::current_path(directory.Path());
+	}
+	~TemporaryWorkingDirectory()
+	{
+		std::filesystem::current_path(previous);
+	}
+	
+private:
+	TemporaryDirectory directory;
+	std::filesystem::path previous;
+};
+
+// Create an empty plugin, with a crash recovery log of an unsaved outfit.
+void MakePlugin()
+{
+	for(const std::string &directory : {PLUGINS, PLUGINS + PLUGIN, DATA})
+		Files::CreateNewDirectory(directory);
+	EditLog log;
+	log.Open(LOG);
+	log.Append("outfit", "Batch Cannon", "outfit \"Batch Cannon\"\n\tcategory \"Guns\"\n\tcost 3000\n");
+	log.Flush();
+}
+
+// Everything the plugin's data directory holds.
+std::string ReadData()
+{
+	std::string data;
+	for(const std::string &file : Files::RecursiveList(DATA))
+		data += Files::Read(file);
+	return data;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Loading a batch script", "[Batch]" ) {
+	GIVEN( "a script with plugins and edits" ) {
+		Batch batch;
+		REQUIRE( batch.Load(AsDataFile(MakeScript(3))) );
+		THEN( "the plugins are listed in order" ) {
+			CHECK( batch.Plugins() == std::vector<std::string>{"Plugin 0", "Plugin 1", "Plugin 2"} );
+		}
+		WHEN( "it is loaded again" ) {
+			REQUIRE( batch.Load(AsDataFile("plugin \"Other\"\n")) );
+			THEN( "only the new plugins are listed" ) {
+				CHECK( batch.Plugins() == std::vector<std::string>{"Other"} );
+			}
+		}
+	}
+	GIVEN( "a script without any plugins" ) {
+		Batch batch;
+		THEN( "it can't be loaded" ) {
+			CHECK_FALSE( batch.Load(AsDataFile("edit\n\toutfit \"Laser\"\n")) );
+			CHECK( batch.Plugins().empty() );
+		}
+	}
+}
+
+SCENARIO( "Sharing plugins between workers", "[Batch]" ) {
+	Batch batch;
+	REQUIRE( batch.Load(AsDataFile(MakeScript(50))) );
+	GIVEN( "several workers" ) {
+		const int workers = 8;
+		THEN( "each plugin is processed by exactly one of them" ) {
+			std::multiset<std::string> processed;
+			for(int i = 0; i < workers; ++i)
+				for(const std::string &plugin : batch.Share(i, workers))
+					processed.insert(plugin);
+			CHECK( processed == std::multiset<std::string>(batch.Plugins().begin(), batch.Plugins().end()) );
+		}
+		THEN( "no worker gets more than one plugin more than another" ) {
+			for(int i = 0; i < workers; ++i)
+			{
+				const size_t size = batch.Share(i, workers).size();
+				CHECK( size >= 6 );
+				CHECK( size <= 7 );
+			}
+		}
+	}
+	GIVEN( "a single worker" ) {
+		THEN( "it processes every plugin" ) {
+			CHECK( batch.Share(0, 1) == batch.Plugins() );
+		}
+	}
+	GIVEN( "more workers than plugins" ) {
+		THEN( "the extra workers have nothing to do" ) {
+			CHECK( batch.Share(49, 100).size() == 1 );
+			CHECK( batch.Share(50, 100).empty() );
+		}
+	}
+}
+
+SCENARIO( "Running a batch script on a plugin with unsaved changes", "[Batch]" ) {
+	GIVEN( "a plugin with a crash recovery log" ) {
+		TemporaryWorkingDirectory directory;
+		MakePlugin();
+		const std::string log = Files::Read(LOG);
+		REQUIRE_FALSE( log.empty() );
+		WHEN( "a script edits it" ) {
+			Batch batch;
+			REQUIRE( batch.Load(AsDataFile("plugin \"" + PLUGIN + "\"\n"
+				"edit\n"
+				"\toutfit \"Batch Laser\"\n"
+				"\t\tcost 5000\n")) );
+			REQUIRE( batch.Run() );
+			THEN( "the edit is saved to the plugin" ) {
+				CHECK( ReadData().find("outfit \"Batch Laser\"") != std::string::npos );
+			}
+			THEN( "the unsaved changes are neither recovered nor discarded" ) {
+				CHECK( ReadData().find("Batch Cannon") == std::string::npos );
+				REQUIRE( Files::Exists(LOG) );
+				CHECK( Files::Read(LOG) == log );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -171,8 +171,57 @@ SCENARIO( "Applying changes to conditions", "[ConditionSet][Usage]" ) {
 		}
 	}
 }
+
+SCENARIO( "Evaluating complex condition expressions", "[ConditionSet][Usage]" ) {
+	const auto conditions = ConditionSet::Conditions{
+		{"a", 3},
+		{"b", 4},
+	};
+	GIVEN( "an expression with parentheses and mixed precedence" ) {
+		const auto set = ConditionSet{AsDataNode("and\n\t( a + 2 ) * b == 20\n\ta + b * 2 - 1 == 10")};
+		REQUIRE_FALSE( set.IsEmpty() );
+		THEN( "operators are applied in the correct order" ) {
+			REQUIRE( set.Test(conditions) );
+		}
+	}
+	GIVEN( "an expression that uses a temporary condition" ) {
+		const auto set = ConditionSet{AsDataNode("and\n\ttemp = a * b\n\ttemp - 2 == 10")};
+		REQUIRE_FALSE( set.IsEmpty() );
+		THEN( "the temporary condition is used when testing" ) {
+			REQUIRE( set.Test(conditions) );
+		}
+	}
+	GIVEN( "an expression that refers to a missing condition" ) {
+		const auto set = ConditionSet{AsDataNode("and\n\tc + 1 == 1")};
+		THEN( "the missing condition has the value zero" ) {
+			REQUIRE( set.Test(conditions) );
+		}
+	}
+}
 // #endregion unit tests
 
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark ConditionSet::Test", "[!benchmark][ConditionSet]" ) {
+	auto conditions = ConditionSet::Conditions{};
+	for(int i = 0; i < 1000; ++i)
+		conditions.emplace("condition " + std::to_string(i), i);
+	const auto simpleSet = ConditionSet{AsDataNode("and\n\thas \"condition 10\"\n\tnot \"condition 0\"")};
+	const auto complexSet = ConditionSet{AsDataNode("and\n"
+		"\t\"condition 20\" + ( \"condition 5\" * 2 ) >= \"condition 29\"\n"
+		"\ttemp = \"condition 100\" / 4\n"
+		"\ttemp + random > 24\n")};
+	
+	BENCHMARK( "Simple expressions" ) {
+		return simpleSet.Test(conditions);
+	};
+	BENCHMARK( "Complex expressions" ) {
+		return complexSet.Test(conditions);
+	};
+}
+#endif
+// #endregion benchmarks
+
 
 
 } // test namespace
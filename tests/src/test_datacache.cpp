@@ -0,0 +1,185 @@
+/* test_datacache.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/DataCache.h"
+
+// Include helpers for creating and comparing DataFiles.
+#include "../../source/DataFile.h"
+#include "../../source/DataNode.h"
+#include "../../source/DataWriter.h"
+
+// ... and any system includes needed for the test file.
+#include <list>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+const std::string FIRST_FILE = "outfit \"Laser\"\n"
+	"\tcategory \"Guns\"\n"
+	"\tcost 12000\n"
+	"\t\"mass\" 3.5\n"
+	"\n"
+	"# A comment.\n"
+	"ship Sparrow\n"
+	"\tattributes\n"
+	"\t\t\"shields\" 1200\n"
+	"\t\t\"hull\" -3e2\n";
+const std::string SECOND_FILE = "system Sol\n\tpos 0 0\n";
+
+DataFile AsDataFile(const std::string &text)
+{
+	std::istringstream in(text);
+	return DataFile(in);
+}
+
+// Convert a file back to text, so two files can be compared.
+std::string AsText(const DataFile &file)
+{
+	DataWriter writer;
+	for(const DataNode &node : file)
+		writer.Write(node);
+	return writer.SaveToString();
+}
+
+std::vector<DataCache::Entry> MakeManifest()
+{
+	std::vector<DataCache::Entry> manifest(2);
+	manifest[0].path = "data/first.txt";
+	manifest[0].size = FIRST_FILE.size();
+	manifest[0].timestamp = 1000;
+	manifest[1].path = "data/second.txt";
+	manifest[1].size = SECOND_FILE.size();
+	manifest[1].timestamp = 2000;
+	return manifest;
+}
+
+// Read the given cache, and return the text of each file in it.
+std::vector<std::string> ReadCache(const std::string &data, const std::vector<DataCache::Entry> &manifest)
+{
+	std::vector<std::string> files;
+	DataCache::Read(data, manifest, [&files](const std::string &, const DataFile &file)
+		{
+			files.push_back(AsText(file));
+		});
+	return files;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Storing data files in a cache", "[DataCache]" ) {
+	GIVEN( "A cache of two files" ) {
+		const auto manifest = MakeManifest();
+		std::vector<DataFile> files;
+		files.push_back(AsDataFile(FIRST_FILE));
+		files.push_back(AsDataFile(SECOND_FILE));
+		const std::string data = DataCache::Write(manifest, files);
+		
+		WHEN( "it is read with the same manifest" ) {
+			const auto read = ReadCache(data, manifest);
+			THEN( "every file is read" ) {
+				REQUIRE( read.size() == 2 );
+				CHECK( read[0] == AsText(files[0]) );
+				CHECK( read[1] == AsText(files[1]) );
+			}
+		}
+		WHEN( "its nodes are read" ) {
+			std::vector<double> values;
+			DataCache::Read(data, manifest, [&values](const std::string &, const DataFile &file)
+				{
+					for(const DataNode &node : file)
+						for(const DataNode &child : node)
+							if(child.Size() >= 2 && child.IsNumber(1))
+								values.push_back(child.Value(1));
+				});
+			THEN( "numeric tokens have their values" ) {
+				CHECK( values == std::vector<double>{12000., 3.5, 0.} );
+			}
+		}
+		WHEN( "one of the files has changed" ) {
+			auto changed = manifest;
+			++changed[1].timestamp;
+			THEN( "no files are read" ) {
+				CHECK( ReadCache(data, changed).empty() );
+			}
+		}
+		WHEN( "a file has been added" ) {
+			auto changed = manifest;
+			changed.push_back(changed.back());
+			changed.back().path = "data/third.txt";
+			THEN( "no files are read" ) {
+				CHECK( ReadCache(data, changed).empty() );
+			}
+		}
+		WHEN( "the cache has been cut short" ) {
+			THEN( "only the complete files are read" ) {
+				CHECK( ReadCache(data.substr(0, data.size() - 4), manifest).size() == 1 );
+				CHECK( ReadCache(data.substr(0, 20), manifest).empty() );
+			}
+		}
+	}
+	GIVEN( "Something that is not a cache" ) {
+		THEN( "no files are read" ) {
+			CHECK( ReadCache("", {}).empty() );
+			CHECK( ReadCache(FIRST_FILE, MakeManifest()).empty() );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark loading data files", "[!benchmark][DataCache]" ) {
+	std::string text;
+	for(int i = 0; i < 2000; ++i)
+		text += FIRST_FILE;
+	std::vector<DataCache::Entry> manifest(1);
+	manifest[0].path = "data/outfits.txt";
+	manifest[0].size = text.size();
+	std::vector<DataFile> files;
+	files.push_back(AsDataFile(text));
+	const std::string data = DataCache::Write(manifest, files);
+	auto changed = manifest;
+	++changed[0].timestamp;
+	
+	BENCHMARK( "Parsing the text (cold)" ) {
+		return AsDataFile(text);
+	};
+	// Any way of loading has to build the same nodes, so this is as fast as
+	// reading the cache could ever be.
+	BENCHMARK( "Copying the parsed nodes (lower bound)" ) {
+		return std::list<DataNode>(files[0].begin(), files[0].end());
+	};
+	BENCHMARK( "Reading the cache (warm)" ) {
+		return DataCache::Read(data, manifest, [](const std::string &, const DataFile &) {});
+	};
+	BENCHMARK( "Rejecting the cache, then parsing and caching the text (invalidated)" ) {
+		DataCache::Read(data, changed, [](const std::string &, const DataFile &) {});
+		std::vector<DataFile> parsed;
+		parsed.push_back(AsDataFile(text));
+		return DataCache::Write(changed, parsed);
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
@@ -242,6 +242,54 @@ SCENARIO( "Determining if a token is numeric", "[IsNumber][Parsing][DataNode]" )
 		}
 	}
 }
+
+SCENARIO( "Reading the numeric value of a token", "[Value][Parsing][DataNode]" ) {
+	GIVEN( "A node loaded from text" ) {
+		const auto node = AsDataNode("key 1 -2.5 +3e2 .5e-1 1.2.3 abc \"\" 0.3");
+		REQUIRE( node.Size() == 9 );
+		THEN( "each token is correctly identified as a number or not" ) {
+			CHECK_FALSE( node.IsNumber(0) );
+			CHECK( node.IsNumber(1) );
+			CHECK( node.IsNumber(2) );
+			CHECK( node.IsNumber(3) );
+			CHECK( node.IsNumber(4) );
+			CHECK_FALSE( node.IsNumber(5) );
+			CHECK_FALSE( node.IsNumber(6) );
+			CHECK_FALSE( node.IsNumber(7) );
+			CHECK( node.IsNumber(8) );
+			CHECK_FALSE( node.IsNumber(9) );
+		}
+		THEN( "numeric tokens have the correct values" ) {
+			CHECK( node.Value(1) == 1. );
+			CHECK( node.Value(2) == -2.5 );
+			CHECK( node.Value(3) == 300. );
+			CHECK( node.Value(4) == Approx(.05) );
+		}
+		THEN( "the value of each token matches the value of the same string" ) {
+			for(int i = 0; i < node.Size(); ++i)
+				if(node.IsNumber(i))
+				{
+					CAPTURE( node.Token(i) );
+					CHECK( node.Value(i) == DataNode::Value(node.Token(i)) );
+				}
+		}
+		THEN( "copies of the node have the same values" ) {
+			const DataNode copy = node;
+			for(int i = 0; i < node.Size(); ++i)
+			{
+				CHECK( copy.IsNumber(i) == node.IsNumber(i) );
+				if(node.IsNumber(i))
+					CHECK( copy.Value(i) == node.Value(i) );
+			}
+		}
+	}
+	GIVEN( "A node that was not loaded from text" ) {
+		const DataNode node;
+		THEN( "it has no numeric tokens" ) {
+			CHECK_FALSE( node.IsNumber(0) );
+		}
+	}
+}
 // #endregion unit tests
 
 
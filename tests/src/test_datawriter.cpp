@@ -0,0 +1,155 @@
+/* test_datawriter.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/DataWriter.h"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+// ... and a directory for the files it writes.
+#include "temporary-directory.h"
+
+// ... and any system includes needed for the test file.
+#include "../../source/Files.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace { // test namespace
+
+// #region mock data
+
+// The format that numbers have always been written in.
+template <class T>
+std::string AsStreamed(T value)
+{
+	std::ostringstream out;
+	out.precision(8);
+	out << value;
+	return out.str();
+}
+
+template <class T>
+std::string AsWritten(T value)
+{
+	DataWriter writer;
+	writer.WriteToken(value);
+	return writer.SaveToString();
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Writing numbers with a DataWriter", "[DataWriter]" ) {
+	GIVEN( "integers" ) {
+		THEN( "they are written the same way an ostream writes them" ) {
+			CHECK( AsWritten(0) == AsStreamed(0) );
+			CHECK( AsWritten(-42) == AsStreamed(-42) );
+			CHECK( AsWritten(std::numeric_limits<int64_t>::min()) == AsStreamed(std::numeric_limits<int64_t>::min()) );
+			CHECK( AsWritten(std::numeric_limits<int64_t>::max()) == AsStreamed(std::numeric_limits<int64_t>::max()) );
+			CHECK( AsWritten(std::numeric_limits<uint64_t>::max()) == AsStreamed(std::numeric_limits<uint64_t>::max()) );
+			CHECK( AsWritten(true) == AsStreamed(true) );
+		}
+	}
+	GIVEN( "floating point numbers" ) {
+		THEN( "they are written the same way an ostream writes them" ) {
+			for(double value : {0., -0., 1., .1, -2.5, 1. / 3., 123456789., 1e-7, 3e20, .30000000000000004})
+				CHECK( AsWritten(value) == AsStreamed(value) );
+			CHECK( AsWritten(.1f) == AsStreamed(.1f) );
+			CHECK( AsWritten(std::numeric_limits<double>::infinity()) == AsStreamed(std::numeric_limits<double>::infinity()) );
+		}
+		THEN( "numbers of every magnitude are rounded the same way" ) {
+			int mismatches = 0;
+			for(int i = 0; i < 1000; ++i)
+			{
+				double value = std::ldexp(1. + i * .001234567, i % 80 - 40) * (i % 2 ? -1. : 1.);
+				mismatches += (AsWritten(value) != AsStreamed(value));
+			}
+			CHECK( mismatches == 0 );
+		}
+	}
+}
+
+SCENARIO( "Writing lines with a DataWriter", "[DataWriter]" ) {
+	GIVEN( "tokens that contain whitespace or quotes" ) {
+		DataWriter writer;
+		writer.Write("plain", "has space", "no\"space\"", "", "with \"both\" kinds");
+		THEN( "only the tokens that need quotes get them" ) {
+			CHECK( writer.SaveToString() == "plain \"has space\" no\"space\" \"\" `with \"both\" kinds`\n" );
+		}
+	}
+	GIVEN( "a node with children" ) {
+		const std::string text = "root 1\n\tchild \"two words\"\n\t\tgrandchild 2.5\n\tcomment\n";
+		DataWriter writer;
+		writer.Write(AsDataNode(text));
+		THEN( "the children are indented" ) {
+			CHECK( writer.SaveToString() == text );
+		}
+	}
+	GIVEN( "lines written by another DataWriter" ) {
+		DataWriter saved;
+		saved.Write(AsDataNode("outfit Laser\n\tcost 1000\n"));
+		DataWriter writer;
+		writer.Write("first");
+		writer.WriteLines(saved.SaveToString());
+		writer.Write("last");
+		THEN( "they are written unchanged, between the other lines" ) {
+			CHECK( writer.SaveToString() == "first\noutfit Laser\n\tcost 1000\nlast\n" );
+		}
+	}
+}
+
+SCENARIO( "Saving a file with a DataWriter", "[DataWriter]" ) {
+	TemporaryDirectory directory;
+	const std::string path = directory.Path() + "data.txt";
+	Files::Write(path, "old\n");
+	GIVEN( "output that fits in memory" ) {
+		{
+			DataWriter writer(path);
+			writer.Write("new");
+		}
+		THEN( "the file is replaced" ) {
+			CHECK( Files::Read(path) == "new\n" );
+			CHECK_FALSE( Files::Exists(path + "~") );
+		}
+	}
+	GIVEN( "output that is too large to keep in memory" ) {
+		const std::string line(1000, 'x');
+		std::string expected;
+		{
+			DataWriter writer(path);
+			for(int i = 0; i < 2000; ++i)
+			{
+				writer.Write(line);
+				expected += line + "\n";
+			}
+			THEN( "the old file is kept until the output is complete" ) {
+				CHECK( Files::Read(path) == "old\n" );
+			}
+		}
+		THEN( "the whole output replaces it at the end" ) {
+			CHECK( Files::Read(path) == expected );
+			CHECK_FALSE( Files::Exists(path + "~") );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
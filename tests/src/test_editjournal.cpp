@@ -0,0 +1,241 @@
+/* test_editjournal.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/EditJournal.h"
+
+// ... and any system includes needed for the test file.
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// An object with a few fields, and a large amount of other data that a copy of
+// the whole object would have to include.
+class Object {
+public:
+	double mass = 10.;
+	int crew = 3;
+	std::string name = "Sparrow";
+	std::vector<double> attributes = std::vector<double>(1000, 1.);
+	
+	bool operator==(const Object &other) const
+	{
+		return mass == other.mass && crew == other.crew && name == other.name && attributes == other.attributes;
+	}
+};
+
+class Owner : public EditJournal::Owner {
+public:
+	virtual void Changed(const void *object) override { changed.push_back(object); }
+	virtual void EndChanges() override { ++ended; }
+	
+	std::vector<const void *> changed;
+	int ended = 0;
+};
+
+// Change a field of the object, and record it.
+template <class V>
+void Edit(EditJournal &journal, Owner &owner, Object &object, V &field, V value, bool merge = false)
+{
+	auto change = EditJournal::Snapshot(field);
+	field = value;
+	journal.Record(&owner, &object, std::move(change), merge);
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Undoing and redoing edits", "[EditJournal]" ) {
+	EditJournal journal;
+	Owner owner;
+	Object object;
+	GIVEN( "two edits" ) {
+		Edit(journal, owner, object, object.mass, 20.);
+		Edit(journal, owner, object, object.name, std::string("Bastion"));
+		REQUIRE( journal.Size() == 2 );
+		
+		WHEN( "they are undone" ) {
+			journal.Undo();
+			journal.Undo();
+			THEN( "the fields have their old values" ) {
+				CHECK( object.mass == 10. );
+				CHECK( object.name == "Sparrow" );
+				CHECK_FALSE( journal.CanUndo() );
+				CHECK( owner.changed == std::vector<const void *>{&object, &object} );
+			}
+			AND_WHEN( "one is redone" ) {
+				journal.Redo();
+				THEN( "only that field has its new value" ) {
+					CHECK( object.mass == 20. );
+					CHECK( object.name == "Sparrow" );
+					CHECK( journal.CanRedo() );
+				}
+			}
+			AND_WHEN( "a new edit is made" ) {
+				Edit(journal, owner, object, object.crew, 4);
+				THEN( "the undone edits can no longer be redone" ) {
+					CHECK_FALSE( journal.CanRedo() );
+					CHECK( journal.Size() == 1 );
+				}
+			}
+		}
+		WHEN( "the edits of the object are forgotten" ) {
+			journal.Forget(&object);
+			THEN( "there is nothing to undo" ) {
+				CHECK_FALSE( journal.CanUndo() );
+			}
+		}
+	}
+	GIVEN( "edits that are merged" ) {
+		Edit(journal, owner, object, object.name, std::string("B"), true);
+		Edit(journal, owner, object, object.name, std::string("Ba"), true);
+		Edit(journal, owner, object, object.name, std::string("Bactrian"), true);
+		journal.Seal();
+		Edit(journal, owner, object, object.name, std::string("Falcon"), true);
+		THEN( "each run of them is a single edit" ) {
+			CHECK( journal.Size() == 2 );
+			journal.Undo();
+			CHECK( object.name == "Bactrian" );
+			journal.Undo();
+			CHECK( object.name == "Sparrow" );
+			journal.Redo();
+			CHECK( object.name == "Bactrian" );
+		}
+	}
+	GIVEN( "a group of edits" ) {
+		Object other;
+		journal.BeginGroup();
+		for(int i = 0; i < 100; ++i)
+		{
+			Edit(journal, owner, object, object.mass, object.mass + 1.);
+			Edit(journal, owner, other, other.mass, other.mass - 1.);
+		}
+		journal.EndGroup();
+		THEN( "repeated edits of each field are merged" ) {
+			CHECK( journal.Size() == 2 );
+		}
+		THEN( "they are undone at once" ) {
+			journal.Undo();
+			CHECK( object.mass == 10. );
+			CHECK( other.mass == 10. );
+			CHECK_FALSE( journal.CanUndo() );
+			CHECK( owner.changed.size() == 2 );
+			CHECK( owner.ended == 1 );
+		}
+	}
+}
+
+SCENARIO( "Undoing edits of the elements of a list", "[EditJournal]" ) {
+	EditJournal journal;
+	Owner owner;
+	Object object;
+	std::vector<Object> elements(2);
+	auto mass = [](Object &element) -> double & { return element.mass; };
+	// Change the mass of an element, and record it by its index.
+	auto editMass = [&](size_t index, double value)
+	{
+		auto change = EditJournal::Snapshot(elements, index, mass);
+		elements[index].mass = value;
+		journal.Record(&owner, &object, std::move(change));
+	};
+	// Change the list itself, and record it as a change of the whole list.
+	auto editList = [&](auto edit)
+	{
+		auto change = EditJournal::Snapshot(elements);
+		edit();
+		journal.Record(&owner, &object, std::move(change));
+	};
+	GIVEN( "an edit of an element" ) {
+		editMass(1, 20.);
+		WHEN( "an element is added, moving the others in memory" ) {
+			editList([&] { elements.resize(100); });
+			THEN( "both edits can be undone and redone" ) {
+				journal.Undo();
+				REQUIRE( elements.size() == 2 );
+				journal.Undo();
+				CHECK( elements[1].mass == 10. );
+				journal.Redo();
+				CHECK( elements[1].mass == 20. );
+				journal.Redo();
+				CHECK( elements.size() == 100 );
+			}
+		}
+		WHEN( "the element is erased" ) {
+			editList([&] { elements.erase(elements.begin()); });
+			editMass(0, 30.);
+			THEN( "the edits are undone in order" ) {
+				journal.Undo();
+				CHECK( elements[0].mass == 20. );
+				journal.Undo();
+				REQUIRE( elements.size() == 2 );
+				CHECK( elements[1].mass == 20. );
+				journal.Undo();
+				CHECK( elements[1].mass == 10. );
+				CHECK_FALSE( journal.CanUndo() );
+			}
+		}
+		WHEN( "the element is erased without recording it" ) {
+			elements.pop_back();
+			elements.shrink_to_fit();
+			THEN( "undoing the edit doesn't change anything" ) {
+				journal.Undo();
+				CHECK( elements.size() == 1 );
+				CHECK( elements[0].mass == 10. );
+			}
+		}
+	}
+	GIVEN( "edits of the same field of an element that are merged" ) {
+		auto change = EditJournal::Snapshot(elements, 0, mass);
+		elements[0].mass = 11.;
+		journal.Record(&owner, &object, std::move(change), true);
+		change = EditJournal::Snapshot(elements, 0, mass);
+		elements[0].mass = 12.;
+		journal.Record(&owner, &object, std::move(change), true);
+		change = EditJournal::Snapshot(elements, 1, mass);
+		elements[1].mass = 13.;
+		journal.Record(&owner, &object, std::move(change), true);
+		THEN( "only the edits of other elements are kept apart" ) {
+			CHECK( journal.Size() == 2 );
+			journal.Undo();
+			CHECK( elements[1].mass == 10. );
+			CHECK( elements[0].mass == 12. );
+			journal.Undo();
+			CHECK( elements[0].mass == 10. );
+		}
+	}
+}
+
+SCENARIO( "Measuring the memory used by edits", "[EditJournal]" ) {
+	EditJournal journal;
+	Owner owner;
+	Object object;
+	GIVEN( "a thousand edits of a number" ) {
+		for(int i = 0; i < 1000; ++i)
+			Edit(journal, owner, object, object.mass, object.mass + 1.);
+		THEN( "each one uses far less memory than a copy of the object" ) {
+			const size_t perEdit = journal.Memory() / journal.Size();
+			CHECK( perEdit <= 128 );
+			CHECK( perEdit * 50 < sizeof(object) + object.attributes.size() * sizeof(double) );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
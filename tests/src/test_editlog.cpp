@@ -0,0 +1,162 @@
+/* test_editlog.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/EditLog.h"
+
+// Include helpers for reading and writing files.
+#include "../../source/DataFile.h"
+#include "../../source/Files.h"
+
+// ... and any system includes needed for the test file.
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+const std::string PATH = "test-edit-log.edits";
+
+// The definition of a system, as the system editor would save it.
+std::string Definition(int index, int edit)
+{
+	return "system \"System " + std::to_string(index) + "\"\n"
+		"\tpos " + std::to_string(edit) + " " + std::to_string(-edit) + "\n"
+		"\tgovernment \"Republic\"\n"
+		"\tlink \"Sol\"\n"
+		"\thabitable 1250\n"
+		"\tbelt 1700\n"
+		"\tobject \"Earth\"\n"
+		"\t\tsprite \"planet/earth\"\n"
+		"\t\tdistance 1000\n"
+		"\t\tperiod 365\n";
+}
+
+void Remove(const std::string &path)
+{
+	if(Files::Exists(path))
+		Files::Delete(path);
+}
+
+// Replace the contents of a file, without translating any line endings.
+void Overwrite(const std::string &path, const std::string &data)
+{
+	Remove(path);
+	FILE *file = Files::Append(path);
+	Files::Write(file, data);
+	fclose(file);
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Recovering edits from the log", "[EditLog]" ) {
+	Remove(PATH);
+	EditLog log;
+	log.Open(PATH);
+	GIVEN( "a few batches of edits" ) {
+		log.Append("system", "Sol", Definition(0, 1));
+		log.Append("planet", "Earth", "planet Earth\n");
+		log.Flush();
+		log.Append("system", "Sol", Definition(0, 2));
+		log.Flush();
+		
+		WHEN( "the log is read" ) {
+			const auto records = EditLog::Read(PATH);
+			THEN( "only the last definition of each object is kept" ) {
+				REQUIRE( records.size() == 2 );
+				CHECK( records[0].key == "system" );
+				CHECK( records[0].name == "Sol" );
+				CHECK( records[0].definition == Definition(0, 2) );
+				CHECK( records[1].name == "Earth" );
+			}
+		}
+		WHEN( "the last batch was only partially written" ) {
+			log.Open("");
+			std::string data = Files::Read(PATH);
+			Overwrite(PATH, data.substr(0, data.size() - 10));
+			const auto records = EditLog::Read(PATH);
+			THEN( "the complete batches are recovered" ) {
+				REQUIRE( records.size() == 2 );
+				CHECK( records[0].definition == Definition(0, 1) );
+			}
+		}
+		WHEN( "the log is rewritten" ) {
+			log.Append("planet", "Earth", "planet Earth\n");
+			log.Rewrite();
+			THEN( "only the new batch is left" ) {
+				const auto records = EditLog::Read(PATH);
+				REQUIRE( records.size() == 1 );
+				CHECK( records[0].name == "Earth" );
+			}
+			AND_WHEN( "it is rewritten with nothing" ) {
+				log.Rewrite();
+				THEN( "the log is deleted" ) {
+					CHECK_FALSE( Files::Exists(PATH) );
+				}
+			}
+		}
+	}
+	GIVEN( "a file that is not an edit log" ) {
+		Overwrite(PATH, "system Sol\n");
+		THEN( "nothing is recovered from it" ) {
+			CHECK( EditLog::Read(PATH).empty() );
+		}
+	}
+	log.Open("");
+	Remove(PATH);
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark recovering a long editing session", "[!benchmark][EditLog]" ) {
+	// A session of 50,000 edits to 500 systems, logged once a second.
+	const int EDITS = 50000;
+	const int SYSTEMS = 500;
+	Remove(PATH);
+	{
+		EditLog log;
+		log.Open(PATH);
+		for(int i = 0; i < EDITS; ++i)
+		{
+			log.Append("system", "System " + std::to_string(i % SYSTEMS), Definition(i % SYSTEMS, i));
+			if(i % 1000 == 999)
+				log.Flush();
+		}
+		log.Flush();
+	}
+	
+	BENCHMARK( "Replaying the log" ) {
+		int nodes = 0;
+		for(const EditLog::Record &record : EditLog::Read(PATH))
+		{
+			std::istringstream in(record.definition);
+			const DataFile data(in);
+			nodes += data.begin() != data.end();
+		}
+		return nodes;
+	};
+	Remove(PATH);
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
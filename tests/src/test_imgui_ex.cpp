@@ -0,0 +1,162 @@
+/* test_imgui_ex.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/imgui_ex.h"
+
+// ... and any system includes needed for the test file.
+#include <set>
+#include <string>
+
+namespace { // test namespace
+
+// #region mock data
+
+// An item that can be chosen in a combo box, such as an outfit.
+class Item {
+public:
+	const std::string &Name() const { return name; }
+	
+	std::string name;
+};
+
+// An ImGui context that renders without any window or graphics backend.
+class Context {
+public:
+	Context()
+	{
+		ImGui::CreateContext();
+		ImGuiIO &io = ImGui::GetIO();
+		io.IniFilename = nullptr;
+		io.DisplaySize = ImVec2(1280.f, 720.f);
+		io.DeltaTime = 1.f / 60.f;
+		unsigned char *pixels = nullptr;
+		int width = 0;
+		int height = 0;
+		io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+	}
+	~Context() { ImGui::DestroyContext(); }
+};
+
+// Render one frame of an editor window with the given contents.
+template <typename F>
+void Frame(F &&f)
+{
+	ImGui::NewFrame();
+	ImGui::SetNextWindowPos(ImVec2(0.f, 0.f));
+	ImGui::SetNextWindowSize(ImVec2(600.f, 400.f));
+	ImGui::Begin("Outfitter");
+	f();
+	ImGui::End();
+	ImGui::Render();
+}
+
+// An outfitter selling the given number of items.
+class Outfitter {
+public:
+	explicit Outfitter(int count)
+	{
+		for(int i = 0; i < count; ++i)
+		{
+			const std::string name = "Outfit " + std::to_string(i);
+			Item *item = items.Get(name);
+			item->name = name;
+			sold.insert(item);
+		}
+	}
+	
+	// Render one row of the outfitter, as the outfitter editor does.
+	void Row(const Item *item)
+	{
+		std::string name = item->Name();
+		Item *change = nullptr;
+		ImGui::InputCombo("outfit", &name, &change, items);
+	}
+	
+	Set<Item> items;
+	std::set<const Item *> sold;
+};
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Rendering only the visible rows of a list", "[ImGui][ClippedList]" ) {
+	Context context;
+	GIVEN( "an outfitter with many outfits" ) {
+		Outfitter outfitter(2000);
+		WHEN( "it is rendered" ) {
+			int rows = 0;
+			Frame([&]() { ImGui::ClippedList(outfitter.sold, [&](const Item *item) { outfitter.Row(item); ++rows; }); });
+			THEN( "only the rows that fit in the window are submitted" ) {
+				CHECK( rows > 0 );
+				CHECK( rows < 50 );
+			}
+		}
+		WHEN( "an outfit before another one is removed" ) {
+			const Item *first = *outfitter.sold.begin();
+			const Item *second = *std::next(outfitter.sold.begin());
+			ImGuiID before = 0;
+			ImGuiID after = 0;
+			const auto idOf = [&](ImGuiID &id)
+			{
+				Frame([&]()
+				{
+					ImGui::ClippedList(outfitter.sold, [&](const Item *item)
+					{
+						outfitter.Row(item);
+						if(item == second)
+							id = ImGui::GetID("outfit");
+					});
+				});
+			};
+			idOf(before);
+			outfitter.sold.erase(first);
+			idOf(after);
+			THEN( "the other outfit's widgets keep their ID" ) {
+				CHECK( before != 0 );
+				CHECK( before == after );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark rendering a large outfitter", "[!benchmark][ImGui][ClippedList]" ) {
+	Context context;
+	Outfitter outfitter(2000);
+	BENCHMARK( "Rendering every row" ) {
+		Frame([&]()
+		{
+			int index = 0;
+			for(const Item *item : outfitter.sold)
+			{
+				ImGui::PushID(index++);
+				outfitter.Row(item);
+				ImGui::PopID();
+			}
+		});
+	};
+	BENCHMARK( "Rendering the visible rows" ) {
+		Frame([&]() { ImGui::ClippedList(outfitter.sold, [&](const Item *item) { outfitter.Row(item); }); });
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
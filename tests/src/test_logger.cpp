@@ -0,0 +1,72 @@
+/* test_logger.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/Logger.h"
+
+// ... and any system includes needed for the test file.
+#include <cstdint>
+#include <string>
+
+namespace { // test namespace
+
+// #region mock data
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Guessing the severity of a message", "[Logger]" ) {
+	GIVEN( "a message that starts with \"Warning\"" ) {
+		const std::string message = "Warning: ship \"Shuttle\" has no sprite.";
+		THEN( "it is a warning" ) {
+			CHECK( Logger::SeverityOf(message) == Logger::Severity::WARNING );
+		}
+	}
+	GIVEN( "a message that only mentions a warning later on" ) {
+		const std::string message = "Error: a \"Warning\" token is not allowed here.";
+		THEN( "it is an error" ) {
+			CHECK( Logger::SeverityOf(message) == Logger::Severity::SEVERE );
+		}
+	}
+	GIVEN( "a message shorter than \"Warning\"" ) {
+		THEN( "it is an error" ) {
+			CHECK( Logger::SeverityOf("Warn") == Logger::Severity::SEVERE );
+			CHECK( Logger::SeverityOf("") == Logger::Severity::SEVERE );
+		}
+	}
+}
+
+SCENARIO( "Logging a message", "[Logger]" ) {
+	GIVEN( "a warning" ) {
+		const std::string message = "Warning: this is only a test.";
+		WHEN( "it is logged with the guessed severity" ) {
+			const uint64_t count = Logger::Count();
+			Logger::Log(message, Logger::SeverityOf(message), "test.txt:1");
+			Logger::Flush();
+			THEN( "it is kept as a warning" ) {
+				REQUIRE( Logger::Count() == count + 1 );
+				const Logger::Entry entry = Logger::Recent().back();
+				CHECK( entry.message == message );
+				CHECK( entry.severity == Logger::Severity::WARNING );
+				CHECK( entry.location == "test.txt:1" );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
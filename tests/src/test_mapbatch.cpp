@@ -0,0 +1,201 @@
+/* test_mapbatch.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/MapBatch.h"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// ... and any system includes needed for the test file.
+#include "../../source/Planet.h"
+#include "../../source/System.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// A map with systems of the given names, which every ship can see 100 ly around.
+class Map {
+public:
+	System *Add(const std::string &name, double x, double y)
+	{
+		System *system = systems.Get(name);
+		Load(system, name, x, y);
+		return system;
+	}
+	void Move(System *system, double x, double y)
+	{
+		Load(system, system->Name(), x, y);
+	}
+	void Load(System *system, const std::string &name, double x, double y)
+	{
+		system->Load(AsDataNode("system \"" + name + "\"\n"
+			"\tpos " + std::to_string(x) + " " + std::to_string(y) + "\n"), planets, true);
+	}
+	void UpdateAll()
+	{
+		for(auto &it : systems)
+			it.second.UpdateSystem(systems, distances);
+	}
+	bool Sees(const System *system, const System *other) const
+	{
+		return system->VisibleNeighbors().count(other);
+	}
+	
+	Set<Planet> planets;
+	Set<System> systems;
+	const std::set<double> distances = {System::DEFAULT_NEIGHBOR_DISTANCE};
+};
+
+// A square grid of systems, 60 ly apart.
+class Grid : public Map {
+public:
+	explicit Grid(int size)
+	{
+		for(int x = 0; x < size; ++x)
+			for(int y = 0; y < size; ++y)
+				grid.push_back(Add("Grid " + std::to_string(x) + " " + std::to_string(y), x * 60., y * 60.));
+		UpdateAll();
+	}
+	
+	std::vector<System *> grid;
+};
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Updating the neighbors of systems after editing the map", "[MapBatch]" ) {
+	Map galaxy;
+	System *first = galaxy.Add("First", 0., 0.);
+	System *second = galaxy.Add("Second", 50., 0.);
+	System *far = galaxy.Add("Far", 500., 0.);
+	System *farther = galaxy.Add("Farther", 1000., 0.);
+	galaxy.UpdateAll();
+	REQUIRE( galaxy.Sees(first, second) );
+	REQUIRE_FALSE( galaxy.Sees(first, far) );
+	MapBatch batch;
+	
+	GIVEN( "a system that was moved close to others" ) {
+		galaxy.Move(far, 100., 0.);
+		batch.Touch(far);
+		WHEN( "the batch is committed" ) {
+			const size_t updated = batch.Commit(galaxy.systems, galaxy.distances);
+			THEN( "the systems near it see it" ) {
+				CHECK( galaxy.Sees(second, far) );
+				CHECK( galaxy.Sees(far, second) );
+				CHECK( galaxy.Sees(far, first) );
+			}
+			THEN( "the systems far from it are left alone" ) {
+				CHECK( updated == 3 );
+				CHECK( batch.IsEmpty() );
+			}
+			AND_WHEN( "it is moved away again" ) {
+				galaxy.Move(far, 500., 0.);
+				batch.Touch(far);
+				batch.Commit(galaxy.systems, galaxy.distances);
+				THEN( "they no longer see it" ) {
+					CHECK_FALSE( galaxy.Sees(first, far) );
+					CHECK_FALSE( galaxy.Sees(second, far) );
+				}
+			}
+		}
+	}
+	GIVEN( "two systems that were linked" ) {
+		first->Link(farther);
+		batch.Touch(first);
+		batch.Touch(farther);
+		batch.Commit(galaxy.systems, galaxy.distances);
+		THEN( "they see each other however far apart they are" ) {
+			CHECK( galaxy.Sees(first, farther) );
+			CHECK( galaxy.Sees(farther, first) );
+		}
+	}
+	GIVEN( "a system that was deleted" ) {
+		batch.Touch(second);
+		galaxy.systems.Erase("Second");
+		batch.Commit(galaxy.systems, galaxy.distances);
+		THEN( "the systems that saw it no longer do" ) {
+			CHECK_FALSE( galaxy.Sees(first, second) );
+		}
+	}
+	GIVEN( "nothing that changed" ) {
+		THEN( "nothing is updated" ) {
+			CHECK( batch.Commit(galaxy.systems, galaxy.distances) == 0 );
+		}
+	}
+}
+
+SCENARIO( "Moving a region of the map", "[MapBatch]" ) {
+	GIVEN( "a map of many systems" ) {
+		Grid galaxy(20);
+		MapBatch batch;
+		WHEN( "a corner of it is moved" ) {
+			for(int i = 0; i < 5; ++i)
+			{
+				System *system = galaxy.grid[i];
+				galaxy.Move(system, system->Position().X() - 1000., system->Position().Y());
+				batch.Touch(system);
+			}
+			const size_t updated = batch.Commit(galaxy.systems, galaxy.distances);
+			THEN( "only the systems around it are updated" ) {
+				CHECK( updated > 5 );
+				CHECK( updated < galaxy.grid.size() / 4 );
+			}
+			THEN( "each system has the same neighbors as if every system was updated" ) {
+				std::vector<std::set<const System *>> neighbors;
+				for(const System *system : galaxy.grid)
+					neighbors.push_back(system->VisibleNeighbors());
+				galaxy.UpdateAll();
+				for(size_t i = 0; i < galaxy.grid.size(); ++i)
+					CHECK( galaxy.grid[i]->VisibleNeighbors() == neighbors[i] );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark editing 500 systems at once", "[!benchmark][MapBatch]" ) {
+	Grid galaxy(50);
+	MapBatch batch;
+	BENCHMARK( "Updating every system" ) {
+		galaxy.UpdateAll();
+	};
+	BENCHMARK( "Updating after each edit" ) {
+		for(int i = 0; i < 500; ++i)
+		{
+			batch.Touch(galaxy.grid[i]);
+			batch.Commit(galaxy.systems, galaxy.distances);
+		}
+	};
+	BENCHMARK( "Updating once after every edit" ) {
+		for(int i = 0; i < 500; ++i)
+			batch.Touch(galaxy.grid[i]);
+		return batch.Commit(galaxy.systems, galaxy.distances);
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
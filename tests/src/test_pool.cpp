@@ -0,0 +1,185 @@
+/* test_pool.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/Pool.h"
+
+// ... and any system includes needed for the test file.
+#include <algorithm>
+#include <set>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// An object that lives for a given number of steps, like a projectile.
+struct Object {
+	int id = 0;
+	int lifetime = 0;
+	
+	void Move() { --lifetime; }
+	bool ShouldBeRemoved() const { return lifetime <= 0; }
+};
+
+// An object about as large as a projectile, which is costly to move.
+struct LargeObject : public Object {
+	double state[30] = {};
+};
+
+std::multiset<int> Ids(const Pool<Object> &pool)
+{
+	std::multiset<int> ids;
+	for(const Object &object : pool)
+		ids.insert(object.id);
+	return ids;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Adding and removing objects in a pool", "[Pool]" ) {
+	GIVEN( "a pool with several objects" ) {
+		Pool<Object> pool;
+		for(int i = 0; i < 5; ++i)
+			pool.Add(Object{i, i});
+		REQUIRE( pool.size() == 5 );
+		
+		WHEN( "the objects that should be removed are pruned" ) {
+			for(Object &object : pool)
+				object.Move();
+			pool.RemoveIf([](const Object &object) { return object.ShouldBeRemoved(); });
+			THEN( "only the others are left" ) {
+				CHECK( pool.size() == 3 );
+				CHECK( Ids(pool) == std::multiset<int>{2, 3, 4} );
+			}
+		}
+		WHEN( "every object is removed" ) {
+			pool.RemoveIf([](const Object &) { return true; });
+			THEN( "the pool is empty" ) {
+				CHECK( pool.empty() );
+			}
+		}
+		WHEN( "the pool is cleared" ) {
+			pool.clear();
+			THEN( "it is empty" ) {
+				CHECK( pool.empty() );
+			}
+			AND_WHEN( "another object is added" ) {
+				pool.Add(Object{5, 5});
+				THEN( "it is the only one in the pool" ) {
+					CHECK( Ids(pool) == std::multiset<int>{5} );
+				}
+			}
+		}
+	}
+	GIVEN( "a list of new objects" ) {
+		Pool<Object> pool;
+		std::vector<Object> added = {{1, 1}, {2, 2}};
+		WHEN( "they are appended to the pool" ) {
+			pool.Append(added);
+			THEN( "they are moved into it" ) {
+				CHECK( added.empty() );
+				CHECK( Ids(pool) == std::multiset<int>{1, 2} );
+			}
+		}
+	}
+}
+
+SCENARIO( "Reusing the memory of removed objects", "[Pool]" ) {
+	GIVEN( "a pool that has already held as many objects as it will at once" ) {
+		Pool<Object> pool;
+		std::vector<Object> added;
+		auto Step = [&pool, &added](int step)
+		{
+			for(Object &object : pool)
+				object.Move();
+			pool.RemoveIf([](const Object &object) { return object.ShouldBeRemoved(); });
+			// Each step adds objects that live for a varying number of steps.
+			for(int i = 0; i < 10; ++i)
+				added.push_back(Object{step, 1 + (step + i) % 20});
+			pool.Append(added);
+		};
+		int step = 0;
+		for( ; step < 100; ++step)
+			Step(step);
+		const size_t allocations = pool.Allocations();
+		REQUIRE( allocations > 0 );
+		
+		WHEN( "objects keep being added and removed" ) {
+			for( ; step < 1000; ++step)
+				Step(step);
+			THEN( "no more memory is allocated" ) {
+				CHECK( pool.Allocations() == allocations );
+			}
+		}
+		WHEN( "it is cleared and filled again" ) {
+			pool.clear();
+			const size_t cleared = pool.Allocations();
+			for(step = 0; step < 100; ++step)
+				Step(step);
+			THEN( "no more memory is allocated" ) {
+				CHECK( pool.Allocations() == cleared );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark pruning short-lived objects", "[!benchmark][Pool]" ) {
+	// Many objects, of which a few expire in each step.
+	const int OBJECTS = 10000;
+	std::vector<LargeObject> objects;
+	for(int i = 0; i < OBJECTS; ++i)
+	{
+		LargeObject object;
+		object.id = i;
+		object.lifetime = 1 + i % 50;
+		objects.push_back(object);
+	}
+	
+	BENCHMARK( "Compacting a vector in order" ) {
+		std::vector<LargeObject> list = objects;
+		for(int step = 0; step < 50; ++step)
+		{
+			for(LargeObject &object : list)
+				object.Move();
+			list.erase(std::remove_if(list.begin(), list.end(),
+				[](const LargeObject &object) { return object.ShouldBeRemoved(); }), list.end());
+		}
+		return list.size();
+	};
+	BENCHMARK( "Removing from a pool" ) {
+		Pool<LargeObject> pool;
+		std::vector<LargeObject> added = objects;
+		pool.Append(added);
+		for(int step = 0; step < 50; ++step)
+		{
+			for(LargeObject &object : pool)
+				object.Move();
+			pool.RemoveIf([](const LargeObject &object) { return object.ShouldBeRemoved(); });
+		}
+		return pool.size();
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
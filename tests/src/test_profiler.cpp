@@ -0,0 +1,86 @@
+/* test_profiler.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/Profiler.h"
+
+// ... and any system includes needed for the test file.
+#include <cstring>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+// Get the events recorded by the thread running the tests.
+std::vector<Profiler::Event> RecordedEvents()
+{
+	std::vector<Profiler::Event> events;
+	for(const auto &thread : Profiler::Events())
+		events.insert(events.end(), thread.events.begin(), thread.events.end());
+	return events;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Recording profiled scopes", "[Profiler]" ) {
+	Profiler::Clear();
+	GIVEN( "the profiler is not recording" ) {
+		Profiler::SetEnabled(false);
+		WHEN( "a scope is run" ) {
+			{
+				Profiler::Scope scope("outer");
+			}
+			THEN( "nothing is recorded" ) {
+				CHECK( RecordedEvents().empty() );
+			}
+		}
+	}
+	GIVEN( "the profiler is recording" ) {
+		Profiler::SetEnabled(true);
+		WHEN( "scopes are nested" ) {
+			{
+				Profiler::Scope outer("outer");
+				{
+					Profiler::Scope inner("inner");
+				}
+			}
+			Profiler::SetEnabled(false);
+			THEN( "both are recorded in the order they started" ) {
+				auto events = RecordedEvents();
+				REQUIRE( events.size() == 2 );
+				CHECK( std::strcmp(events[0].name, "outer") == 0 );
+				CHECK( events[0].depth == 0 );
+				CHECK( std::strcmp(events[1].name, "inner") == 0 );
+				CHECK( events[1].depth == 1 );
+				CHECK( events[1].start >= events[0].start );
+				CHECK( events[1].start + events[1].duration <= events[0].start + events[0].duration );
+			}
+			AND_WHEN( "the profiler is cleared" ) {
+				Profiler::Clear();
+				THEN( "the events are discarded" ) {
+					CHECK( RecordedEvents().empty() );
+				}
+			}
+		}
+	}
+	Profiler::SetEnabled(false);
+	Profiler::Clear();
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,142 @@
+/* test_referenceindex.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/ReferenceIndex.h"
+
+// ... and any system includes needed for the test file.
+#include <map>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+using Key = ReferenceIndex::Key;
+
+Key Outfit(const std::string &name) { return Key("outfit", name); }
+Key Ship(const std::string &name) { return Key("ship", name); }
+
+// Game data about the size of the base game: every ship has a few dozen outfits
+// installed, and most of them use the same common ones.
+class BaseGame {
+public:
+	BaseGame()
+	{
+		for(int i = 0; i < SHIPS; ++i)
+		{
+			std::vector<Key> &outfits = ships[Ship("Ship " + std::to_string(i))];
+			outfits.push_back(Outfit("Hydrogen Fuel Cell"));
+			for(int j = 0; j < OUTFITS_PER_SHIP; ++j)
+				outfits.push_back(Outfit("Outfit " + std::to_string((i * 7 + j * 13) % OUTFITS)));
+		}
+		for(const auto &it : ships)
+			index.Set(it.first, it.second);
+	}
+	
+	static const int SHIPS = 800;
+	static const int OUTFITS = 600;
+	static const int OUTFITS_PER_SHIP = 30;
+	
+	std::map<Key, std::vector<Key>> ships;
+	ReferenceIndex index;
+};
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Finding the objects that refer to an object", "[ReferenceIndex]" ) {
+	GIVEN( "two ships sharing an outfit" ) {
+		ReferenceIndex index;
+		index.Set(Ship("Bulk Freighter"), {Outfit("Cargo Expansion"), Outfit("Fuel Pod"), Outfit("Fuel Pod")});
+		index.Set(Ship("Shuttle"), {Outfit("Fuel Pod")});
+		THEN( "both are listed as users of the shared outfit" ) {
+			CHECK( index.Users(Outfit("Fuel Pod")).size() == 2 );
+			CHECK( index.Users(Outfit("Cargo Expansion")).size() == 1 );
+			CHECK( index.Users(Outfit("Hyperdrive")).empty() );
+		}
+		THEN( "each reference is only listed once" ) {
+			CHECK( index.References(Ship("Bulk Freighter")).size() == 2 );
+			CHECK( index.Size() == 2 );
+		}
+		WHEN( "a ship changes its outfits" ) {
+			index.Set(Ship("Bulk Freighter"), {Outfit("Hyperdrive")});
+			THEN( "it is only listed as a user of the new ones" ) {
+				CHECK( index.Users(Outfit("Fuel Pod")).size() == 1 );
+				CHECK( index.Users(Outfit("Cargo Expansion")).empty() );
+				CHECK( index.Users(Outfit("Hyperdrive")).count(Ship("Bulk Freighter")) );
+			}
+		}
+		WHEN( "a ship is removed" ) {
+			index.Remove(Ship("Shuttle"));
+			THEN( "it is no longer a user of anything" ) {
+				CHECK( index.Users(Outfit("Fuel Pod")).size() == 1 );
+				CHECK( index.References(Ship("Shuttle")).empty() );
+			}
+		}
+		WHEN( "the shared outfit is renamed" ) {
+			const auto users = index.Rename(Outfit("Fuel Pod"), "Fuel Tank");
+			THEN( "every ship that uses it is returned" ) {
+				CHECK( users.size() == 2 );
+			}
+			THEN( "the ships refer to the new name" ) {
+				CHECK( index.Users(Outfit("Fuel Pod")).empty() );
+				CHECK( index.Users(Outfit("Fuel Tank")).size() == 2 );
+				const auto &references = index.References(Ship("Shuttle"));
+				REQUIRE( references.size() == 1 );
+				CHECK( references[0] == Outfit("Fuel Tank") );
+			}
+		}
+		WHEN( "a ship is renamed" ) {
+			const auto users = index.Rename(Ship("Shuttle"), "Pilgrim");
+			THEN( "its references are kept under the new name" ) {
+				CHECK( users.empty() );
+				CHECK( index.References(Ship("Shuttle")).empty() );
+				CHECK( index.References(Ship("Pilgrim")).size() == 1 );
+				CHECK( index.Users(Outfit("Fuel Pod")).count(Ship("Pilgrim")) );
+				CHECK_FALSE( index.Users(Outfit("Fuel Pod")).count(Ship("Shuttle")) );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark finding the usages of a common outfit", "[!benchmark][ReferenceIndex]" ) {
+	const BaseGame data;
+	const Key outfit = Outfit("Hydrogen Fuel Cell");
+	BENCHMARK( "Searching every ship" ) {
+		size_t count = 0;
+		for(const auto &it : data.ships)
+			for(const Key &reference : it.second)
+				if(reference == outfit)
+				{
+					++count;
+					break;
+				}
+		return count;
+	};
+	BENCHMARK( "Looking up the index" ) {
+		return data.index.Users(outfit).size();
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
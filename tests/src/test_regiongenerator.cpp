@@ -0,0 +1,281 @@
+/* test_regiongenerator.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/RegionGenerator.h"
+
+// ... and any system includes needed for the test file.
+#include "../../source/Hazard.h"
+#include "../../source/Minable.h"
+#include "../../source/Sprite.h"
+#include "../../source/StellarObject.h"
+
+#include <cmath>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// A square with sides of the given length, centered on the origin.
+std::vector<Point> Square(double size)
+{
+	return {Point(-size / 2., -size / 2.), Point(size / 2., -size / 2.),
+		Point(size / 2., size / 2.), Point(-size / 2., size / 2.)};
+}
+
+// An L-shaped region, which isn't convex.
+const std::vector<Point> L_SHAPE = {Point(0., 0.), Point(1000., 0.), Point(1000., 300.),
+	Point(300., 300.), Point(300., 1000.), Point(0., 1000.)};
+
+// Sprites, minables and hazards to generate systems from.
+class Palette {
+public:
+	Palette()
+	{
+		for(int i = 0; i < 10; ++i)
+		{
+			sprites.emplace_back("star/" + std::to_string(i));
+			sprites.emplace_back("planet/" + std::to_string(i));
+			sprites.emplace_back("planet/moon" + std::to_string(i));
+			sprites.emplace_back("planet/giant" + std::to_string(i));
+		}
+		for(size_t i = 0; i < sprites.size(); i += 4)
+		{
+			palette.stars.push_back(&sprites[i]);
+			palette.planets.push_back(&sprites[i + 1]);
+			palette.moons.push_back(&sprites[i + 2]);
+			palette.giants.push_back(&sprites[i + 3]);
+		}
+		palette.minables = {{&minables[0], 40}, {&minables[1], 60}};
+		palette.hazards = {&hazard};
+	}
+	
+	std::vector<Sprite> sprites;
+	Minable minables[2];
+	Hazard hazard;
+	SystemGenerator::Palette palette;
+};
+
+// Check whether every point can be reached from the first one.
+bool IsConnected(size_t count, const std::vector<std::pair<size_t, size_t>> &links)
+{
+	std::vector<std::set<size_t>> neighbors(count);
+	for(const auto &link : links)
+	{
+		neighbors[link.first].insert(link.second);
+		neighbors[link.second].insert(link.first);
+	}
+	std::set<size_t> reached = {0};
+	std::vector<size_t> pending = {0};
+	while(!pending.empty())
+	{
+		const size_t next = pending.back();
+		pending.pop_back();
+		for(size_t neighbor : neighbors[next])
+			if(reached.insert(neighbor).second)
+				pending.push_back(neighbor);
+	}
+	return reached.size() == count;
+}
+
+// The length of the shortest distance between two of the given points.
+double MinimumDistance(const std::vector<Point> &points)
+{
+	double distance = INFINITY;
+	for(size_t i = 0; i < points.size(); ++i)
+		for(size_t j = i + 1; j < points.size(); ++j)
+			distance = std::min(distance, points[i].Distance(points[j]));
+	return distance;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Checking whether a point is within a region", "[RegionGenerator]" ) {
+	GIVEN( "a region that isn't convex" ) {
+		THEN( "points inside it are found" ) {
+			CHECK( RegionGenerator::Contains(L_SHAPE, Point(100., 100.)) );
+			CHECK( RegionGenerator::Contains(L_SHAPE, Point(900., 100.)) );
+			CHECK( RegionGenerator::Contains(L_SHAPE, Point(100., 900.)) );
+		}
+		THEN( "points outside of it are not" ) {
+			CHECK_FALSE( RegionGenerator::Contains(L_SHAPE, Point(500., 500.)) );
+			CHECK_FALSE( RegionGenerator::Contains(L_SHAPE, Point(-100., 100.)) );
+			CHECK_FALSE( RegionGenerator::Contains(L_SHAPE, Point(1100., 100.)) );
+		}
+	}
+	GIVEN( "an empty region" ) {
+		THEN( "nothing is within it" ) {
+			CHECK_FALSE( RegionGenerator::Contains({}, Point()) );
+		}
+	}
+}
+
+SCENARIO( "Placing systems within a region", "[RegionGenerator]" ) {
+	GIVEN( "a region with room for every system" ) {
+		const std::vector<Point> points = RegionGenerator::Place(L_SHAPE, 100, 50., 1);
+		THEN( "each one is placed within the region" ) {
+			REQUIRE( points.size() == 100 );
+			for(const Point &point : points)
+				CHECK( RegionGenerator::Contains(L_SHAPE, point) );
+		}
+		THEN( "no two are closer than the spacing" ) {
+			CHECK( MinimumDistance(points) >= 50. );
+		}
+		THEN( "the same seed places them in the same places" ) {
+			CHECK( RegionGenerator::Place(L_SHAPE, 100, 50., 1) == points );
+			CHECK_FALSE( RegionGenerator::Place(L_SHAPE, 100, 50., 2) == points );
+		}
+	}
+	GIVEN( "a region that is too small for every system" ) {
+		const std::vector<Point> points = RegionGenerator::Place(Square(200.), 100, 50., 1);
+		THEN( "only as many as fit are placed" ) {
+			CHECK( points.size() > 4 );
+			CHECK( points.size() < 100 );
+			CHECK( MinimumDistance(points) >= 50. );
+		}
+	}
+	GIVEN( "a region that isn't a polygon" ) {
+		THEN( "nothing is placed" ) {
+			CHECK( RegionGenerator::Place({Point(), Point(100., 100.)}, 10, 10., 1).empty() );
+			CHECK( RegionGenerator::Place({Point(), Point(100., 0.), Point(200., 0.)}, 10, 10., 1).empty() );
+		}
+	}
+}
+
+SCENARIO( "Linking the systems of a region", "[RegionGenerator]" ) {
+	GIVEN( "systems that are close together" ) {
+		const std::vector<Point> points = RegionGenerator::Place(Square(1000.), 200, 50., 3);
+		const auto links = RegionGenerator::Link(points, 100., 3);
+		THEN( "every system can be reached from every other" ) {
+			CHECK( IsConnected(points.size(), links) );
+		}
+		THEN( "each link is short" ) {
+			for(const auto &link : links)
+				CHECK( points[link.first].Distance(points[link.second]) <= 100. );
+		}
+		THEN( "no two links cross" ) {
+			for(size_t i = 0; i < links.size(); ++i)
+				for(size_t j = i + 1; j < links.size(); ++j)
+				{
+					const Point &a = points[links[i].first];
+					const Point &b = points[links[i].second];
+					const Point &c = points[links[j].first];
+					const Point &d = points[links[j].second];
+					if(a == c || a == d || b == c || b == d)
+						continue;
+					const bool crosses = ((b - a).Cross(c - a) > 0.) != ((b - a).Cross(d - a) > 0.)
+						&& ((d - c).Cross(a - c) > 0.) != ((d - c).Cross(b - c) > 0.);
+					CHECK_FALSE( crosses );
+				}
+		}
+	}
+	GIVEN( "groups of systems that are too far apart to be linked" ) {
+		const std::vector<Point> points = {Point(0., 0.), Point(50., 0.), Point(1000., 0.), Point(1050., 0.)};
+		const auto links = RegionGenerator::Link(points, 100., 3);
+		THEN( "they are linked anyway" ) {
+			CHECK( links.size() == 3 );
+			CHECK( IsConnected(points.size(), links) );
+		}
+	}
+}
+
+SCENARIO( "Generating a region", "[RegionGenerator]" ) {
+	Palette palette;
+	RegionGenerator::Settings settings;
+	settings.polygon = Square(1000.);
+	settings.count = 100;
+	settings.seed = 7;
+	settings.prefix = "Test";
+	GIVEN( "a generated region" ) {
+		RegionGenerator region;
+		region.Generate(settings, palette.palette);
+		const std::vector<System> &systems = region.Systems();
+		REQUIRE( systems.size() == 100 );
+		THEN( "each system is named and placed" ) {
+			CHECK( systems.front().Name() == "Test 1" );
+			CHECK( systems.back().Name() == "Test 100" );
+			for(const System &system : systems)
+				CHECK( RegionGenerator::Contains(settings.polygon, system.Position()) );
+		}
+		THEN( "each system has stars and planets" ) {
+			for(const System &system : systems)
+			{
+				REQUIRE( system.Objects().size() >= 3 );
+				CHECK( system.Objects().front().IsStar() );
+			}
+		}
+		THEN( "every system can be reached" ) {
+			CHECK( IsConnected(systems.size(), region.Links()) );
+		}
+		WHEN( "it is generated again with the same settings" ) {
+			RegionGenerator again;
+			again.Generate(settings, palette.palette);
+			THEN( "each system is the same" ) {
+				REQUIRE( again.Systems().size() == systems.size() );
+				for(size_t i = 0; i < systems.size(); ++i)
+				{
+					CHECK( again.Systems()[i].Position() == systems[i].Position() );
+					CHECK( again.Systems()[i].Objects() == systems[i].Objects() );
+					CHECK( again.Systems()[i].Asteroids() == systems[i].Asteroids() );
+					CHECK( again.Systems()[i].Hazards() == systems[i].Hazards() );
+				}
+				CHECK( again.Links() == region.Links() );
+			}
+		}
+	}
+	GIVEN( "a palette without sprites" ) {
+		palette.palette.stars.clear();
+		RegionGenerator region;
+		region.Generate(settings, palette.palette);
+		THEN( "the systems have no stellar objects" ) {
+			for(const System &system : region.Systems())
+				CHECK( system.Objects().empty() );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark generating a region", "[!benchmark][RegionGenerator]" ) {
+	Palette palette;
+	RegionGenerator::Settings settings;
+	settings.polygon = Square(3000.);
+	settings.count = 1000;
+	BENCHMARK( "Placing 1000 systems" ) {
+		return RegionGenerator::Place(settings.polygon, settings.count, settings.spacing, settings.seed);
+	};
+	const std::vector<Point> points = RegionGenerator::Place(settings.polygon, settings.count, settings.spacing, settings.seed);
+	BENCHMARK( "Linking 1000 systems" ) {
+		return RegionGenerator::Link(points, settings.linkDistance, settings.links);
+	};
+	BENCHMARK( "Generating 1000 systems" ) {
+		RegionGenerator region;
+		region.Generate(settings, palette.palette);
+		return region.Systems().size();
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
@@ -0,0 +1,161 @@
+/* test_savedgame.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/SavedGame.h"
+
+// Include helpers for creating DataFiles.
+#include "../../source/DataFile.h"
+#include "../../source/DataNode.h"
+#include "../../source/DataWriter.h"
+
+// ... and any system includes needed for the test file.
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// A saved game with the given number of ships, each with some outfits.
+std::string MakeSave(int ships)
+{
+	std::string text = "pilot Jane Doe\n"
+		"date 16 11 3013\n"
+		"system Sol\n"
+		"planet Earth\n"
+		"clearance\n"
+		"playtime 3725\n";
+	for(int i = 0; i < ships; ++i)
+	{
+		text += "ship \"Sparrow\"\n"
+			"\tname \"Ship " + std::to_string(i) + "\"\n"
+			"\tsprite \"ship/sparrow\"\n"
+			"\tattributes\n"
+			"\t\tcategory \"Interceptor\"\n"
+			"\t\t\"hull\" 400\n"
+			"\t\t\"shields\" 1200\n"
+			"\toutfits\n";
+		for(int j = 0; j < 20; ++j)
+			text += "\t\t\"Outfit " + std::to_string(j) + "\" 2\n";
+	}
+	text += "account\n"
+		"\tcredits 131000\n"
+		"\tscore 400\n";
+	return text;
+}
+
+DataFile AsDataFile(const std::string &text)
+{
+	std::istringstream in(text);
+	return DataFile(in);
+}
+
+// Write the header of the given saved game, and read it back in.
+SavedGame CopyHeader(const SavedGame &save)
+{
+	DataWriter writer;
+	writer.Write("save", save.Path());
+	writer.BeginChild();
+	{
+		save.SaveHeader(writer);
+	}
+	writer.EndChild();
+	
+	SavedGame copy;
+	const DataFile file = AsDataFile(writer.SaveToString());
+	for(const DataNode &node : file)
+		copy.LoadHeader(node);
+	return copy;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Caching the header of a saved game", "[SavedGame]" ) {
+	GIVEN( "A saved game" ) {
+		SavedGame save;
+		save.Load(AsDataFile(MakeSave(2)), "saves/Jane Doe.txt");
+		REQUIRE( save.IsLoaded() );
+		
+		WHEN( "its header is written and read back" ) {
+			const SavedGame copy = CopyHeader(save);
+			THEN( "everything the load panel shows is the same" ) {
+				CHECK( copy.Path() == save.Path() );
+				CHECK( copy.Name() == "Jane Doe" );
+				CHECK( copy.Credits() == save.Credits() );
+				CHECK( copy.GetDate() == save.GetDate() );
+				CHECK( copy.GetSystem() == "Sol" );
+				CHECK( copy.GetPlanet() == "Earth" );
+				CHECK( copy.GetPlayTime() == save.GetPlayTime() );
+				CHECK( copy.ShipName() == "Ship 0" );
+			}
+		}
+	}
+	GIVEN( "An empty saved game" ) {
+		SavedGame save;
+		save.Load(DataFile(), "saves/Nobody.txt");
+		THEN( "it is not loaded" ) {
+			CHECK_FALSE( save.IsLoaded() );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark browsing saved games", "[!benchmark][SavedGame]" ) {
+	// Browse through 200 saves, as a veteran player's snapshots would be.
+	const int SAVES = 200;
+	const std::string text = MakeSave(50);
+	std::string index;
+	{
+		SavedGame save;
+		save.Load(AsDataFile(text), "saves/Jane Doe.txt");
+		DataWriter writer;
+		for(int i = 0; i < SAVES; ++i)
+		{
+			writer.Write("save", "saves/Jane Doe~" + std::to_string(i) + ".txt", 1000, text.size());
+			writer.BeginChild();
+			{
+				save.SaveHeader(writer);
+			}
+			writer.EndChild();
+		}
+		index = writer.SaveToString();
+	}
+	
+	BENCHMARK( "Parsing every save" ) {
+		SavedGame save;
+		for(int i = 0; i < SAVES; ++i)
+			save.Load(AsDataFile(text), "saves/Jane Doe.txt");
+		return save;
+	};
+	BENCHMARK( "Reading every header from the index" ) {
+		std::vector<SavedGame> headers(SAVES);
+		const DataFile file = AsDataFile(index);
+		auto it = headers.begin();
+		for(const DataNode &node : file)
+			(it++)->LoadHeader(node);
+		return headers;
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
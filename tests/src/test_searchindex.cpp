@@ -0,0 +1,189 @@
+/* test_searchindex.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/SearchIndex.h"
+
+// ... and any system includes needed for the test file.
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+using Key = SearchIndex::Key;
+
+// Objects of every kind, about as many as the base game has.
+class BaseGame {
+public:
+	BaseGame()
+	{
+		const std::vector<std::pair<std::string, int>> COUNTS = {{"effect", 300}, {"fleet", 500},
+			{"government", 60}, {"hazard", 20}, {"outfit", 900}, {"outfitter", 100}, {"planet", 700},
+			{"ship", 600}, {"shipyard", 100}, {"system", 1200}};
+		const std::vector<std::string> ATTRIBUTES = {"shield damage", "hull damage", "heat damage",
+			"ion damage", "energy consumption", "outfit space", "weapon capacity", "thrust", "turn"};
+		for(const auto &it : COUNTS)
+			for(int i = 0; i < it.second; ++i)
+			{
+				std::vector<std::string> attributes;
+				if(it.first == "outfit" || it.first == "ship")
+					for(int j = 0; j < 3; ++j)
+						attributes.push_back(ATTRIBUTES[(i + j * 4) % ATTRIBUTES.size()]);
+				objects.emplace_back(Key(it.first, "Object " + std::to_string(i) + " of kind " + it.first), attributes);
+			}
+		for(const auto &it : objects)
+			index.Add(it.first, it.second);
+		index.Wait();
+	}
+	
+	std::vector<std::pair<Key, std::vector<std::string>>> objects;
+	SearchIndex index;
+};
+
+// Check whether the text contains the query, ignoring case.
+bool Contains(std::string text, std::string query)
+{
+	for(char &c : text)
+		c = std::tolower(static_cast<unsigned char>(c));
+	for(char &c : query)
+		c = std::tolower(static_cast<unsigned char>(c));
+	return text.find(query) != std::string::npos;
+}
+
+std::vector<std::string> Names(const std::vector<SearchIndex::Result> &results)
+{
+	std::vector<std::string> names;
+	for(const auto &result : results)
+		names.push_back(result.key.second);
+	return names;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Searching for objects of every kind", "[SearchIndex]" ) {
+	GIVEN( "a few outfits and ships" ) {
+		SearchIndex index;
+		index.Add(Key("outfit", "Ion Cannon"), {"Guns", "ion damage", "shield damage"});
+		index.Add(Key("outfit", "Ion Rain Gun"), {"Guns", "ion damage"});
+		index.Add(Key("outfit", "Heavy Laser"), {"Guns", "shield damage", "hull damage"});
+		index.Add(Key("ship", "Falcon"), {"Heavy Warship", "outfit space"});
+		index.Add(Key("ship", "Lionheart"), {"Heavy Warship"});
+		index.Wait();
+		REQUIRE( index.Size() == 5 );
+		
+		WHEN( "searching by name" ) {
+			const auto results = index.Find("ion", false, 10);
+			THEN( "every object containing the query is found, ignoring case" ) {
+				CHECK( Names(results) == std::vector<std::string>{"Ion Cannon", "Ion Rain Gun", "Lionheart"} );
+			}
+			THEN( "the matches of each kind are listed together" ) {
+				REQUIRE( results.size() == 3 );
+				CHECK( results[0].key.first == "outfit" );
+				CHECK( results[1].key.first == "outfit" );
+				CHECK( results[2].key.first == "ship" );
+			}
+		}
+		WHEN( "a name matches the query exactly" ) {
+			const auto results = index.Find("ion rain gun", false, 10);
+			THEN( "it is the only match" ) {
+				CHECK( Names(results) == std::vector<std::string>{"Ion Rain Gun"} );
+			}
+		}
+		WHEN( "a query is shorter than a trigram" ) {
+			const auto results = index.Find("fa", false, 10);
+			THEN( "it is still found" ) {
+				CHECK( Names(results) == std::vector<std::string>{"Falcon"} );
+			}
+		}
+		WHEN( "searching by attribute" ) {
+			const auto results = index.Find("ion damage", true, 10);
+			THEN( "the objects with that attribute are found" ) {
+				CHECK( Names(results) == std::vector<std::string>{"Ion Cannon", "Ion Rain Gun"} );
+				for(const auto &result : results)
+					CHECK( result.match == "ion damage" );
+			}
+			AND_THEN( "attributes are only searched if asked to" ) {
+				CHECK( index.Find("ion damage", false, 10).empty() );
+			}
+		}
+		WHEN( "fewer results are asked for" ) {
+			const auto results = index.Find("heavy", true, 1);
+			THEN( "only the best ones of each kind are returned" ) {
+				CHECK( Names(results) == std::vector<std::string>{"Heavy Laser", "Falcon"} );
+			}
+		}
+		WHEN( "an object is renamed" ) {
+			index.Remove(Key("ship", "Falcon"));
+			index.Add(Key("ship", "Osprey"), {"Heavy Warship"});
+			index.Wait();
+			THEN( "it is only found by its new name" ) {
+				CHECK( index.Find("falcon", false, 10).empty() );
+				CHECK( Names(index.Find("osprey", false, 10)) == std::vector<std::string>{"Osprey"} );
+				CHECK( index.Size() == 5 );
+			}
+		}
+		WHEN( "the index is cleared" ) {
+			index.Clear();
+			THEN( "nothing is found" ) {
+				CHECK( index.Find("ion", true, 10).empty() );
+				CHECK( index.Size() == 0 );
+			}
+		}
+	}
+	GIVEN( "many objects that are changed many times" ) {
+		SearchIndex index;
+		for(int i = 0; i < 5000; ++i)
+			index.Add(Key("system", "System " + std::to_string(i % 100)), {"edit " + std::to_string(i)});
+		index.Wait();
+		THEN( "only the last version of each object is found" ) {
+			CHECK( index.Size() == 100 );
+			CHECK( index.Find("system 42", false, 10).size() == 1 );
+			CHECK( index.Find("edit 4999", true, 10).size() == 1 );
+			CHECK( index.Find("edit 100", true, 10).empty() );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark searching every object", "[!benchmark][SearchIndex]" ) {
+	const BaseGame game;
+	BENCHMARK( "Scanning every name and attribute" ) {
+		int count = 0;
+		for(const auto &it : game.objects)
+			count += Contains(it.first.second, "object 42 of kind s")
+				|| std::any_of(it.second.begin(), it.second.end(),
+					[](const std::string &attribute) { return Contains(attribute, "object 42 of kind s"); });
+		return count;
+	};
+	BENCHMARK( "Searching by name" ) {
+		return game.index.Find("object 42 of kind s", true, 50).size();
+	};
+	BENCHMARK( "Searching by attribute" ) {
+		return game.index.Find("ion damage", true, 50).size();
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
@@ -0,0 +1,135 @@
+/* test_systempreview.cpp
+Copyright (c) 2022 quyykk
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/SystemPreview.h"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// ... and any system includes needed for the test file.
+#include "../../source/Planet.h"
+#include "../../source/Point.h"
+#include "../../source/Set.h"
+#include "../../source/StellarObject.h"
+#include "../../source/System.h"
+
+namespace { // test namespace
+
+// #region mock data
+
+// A system with a planet that orbits its star every ten days, and an asteroid belt.
+class Fixture {
+public:
+	Fixture()
+	{
+		system.Load(AsDataNode("system Preview\n"
+			"\tpos 0 0\n"
+			"\tasteroids \"small rock\" 20 1.5\n"
+			"\tobject\n"
+			"\t\tdistance 0\n"
+			"\tobject\n"
+			"\t\tdistance 1000\n"
+			"\t\tperiod 10\n"), planets, true);
+		system.SetDate(today);
+	}
+	
+	// The position of the orbiting planet.
+	Point Position() const { return system.Objects().back().Position(); }
+	
+	Set<Planet> planets;
+	System system;
+	const Date today = Date(1, 1, 3014);
+};
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Previewing a star system", "[SystemPreview]" ) {
+	Fixture fixture;
+	const Point position = fixture.Position();
+	GIVEN( "a preview of the system" ) {
+		SystemPreview preview;
+		preview.Load(fixture.system, fixture.today);
+		THEN( "it starts on the current date" ) {
+			CHECK( preview.GetDate() == fixture.today );
+			CHECK( fixture.Position().Distance(position) == Approx(0.) );
+		}
+		WHEN( "half an orbit later is previewed" ) {
+			preview.SetDate(fixture.today + 5);
+			THEN( "the planet is on the other side of the star" ) {
+				CHECK( fixture.Position().Distance(position) == Approx(2000.) );
+			}
+			AND_WHEN( "the system is reloaded after being edited" ) {
+				fixture.system.SetDate(fixture.today);
+				preview.Load(fixture.system, fixture.today);
+				THEN( "the date that is previewed stays the same" ) {
+					CHECK( preview.GetDate() == fixture.today + 5 );
+					CHECK( fixture.Position().Distance(position) == Approx(2000.) );
+				}
+			}
+			AND_WHEN( "the preview is done" ) {
+				preview.Clear();
+				THEN( "the planet is back at today's position" ) {
+					CHECK( fixture.Position().Distance(position) == Approx(0.) );
+				}
+			}
+		}
+		WHEN( "it is simulated" ) {
+			for(int i = 0; i < 600; ++i)
+				preview.Step();
+			THEN( "the stellar objects don't move on their own" ) {
+				CHECK( preview.Steps() == 600 );
+				CHECK( fixture.Position().Distance(position) == Approx(0.) );
+			}
+			THEN( "nothing is left behind" ) {
+				CHECK( preview.VisualCount() == 0 );
+				CHECK( preview.FlotsamCount() == 0 );
+			}
+		}
+	}
+	GIVEN( "a preview that is destroyed on another date" ) {
+		{
+			SystemPreview preview;
+			preview.Load(fixture.system, fixture.today);
+			preview.SetDate(fixture.today + 5);
+		}
+		THEN( "the planet is back at today's position" ) {
+			CHECK( fixture.Position().Distance(position) == Approx(0.) );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark previewing a star system", "[!benchmark][SystemPreview]" ) {
+	Fixture fixture;
+	SystemPreview preview;
+	preview.Load(fixture.system, fixture.today);
+	BENCHMARK( "Simulating one step" ) {
+		preview.Step();
+	};
+	BENCHMARK( "Moving the stellar objects to another day" ) {
+		preview.SetDate(preview.GetDate() + 1);
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace